@@ -0,0 +1,72 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include "../include/CXLibrary.h"
+
+using namespace cx_lib;
+
+template <typename F>
+static double seconds(size_t reps, F&& f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < reps; r++)
+        f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / reps;
+}
+
+static std::vector<cx> signal(size_t n, size_t period)
+{
+    std::vector<cx> x(n);
+    for (size_t i = 0; i < n; i++)
+        x[i] = cx(static_cast<float>(i % period) * 0.25f, static_cast<float>(i % 5) - 2.0f);
+    return x;
+}
+
+int main()
+{
+    // Matched filter: a long signal against kernels of growing length.
+    std::cout << "Vector convolution (ms)\n"
+              << std::setw(10) << "n" << std::setw(8) << "m" << std::setw(12) << "direct"
+              << std::setw(12) << "fft" << std::setw(12) << "auto" << std::setw(14) << "overlap-save\n"
+              << std::fixed << std::setprecision(3);
+
+    for (size_t n : {size_t(1) << 16, size_t(1) << 20})
+        for (size_t m : {size_t(8), size_t(64), size_t(512), size_t(4096)})
+        {
+            const std::vector<cx> x = signal(n, 17), h = signal(m, 7);
+            const cx_vector a(x), v(h);
+            const size_t reps = std::max<size_t>(1, (size_t(1) << 22) / n);
+            double t_direct = seconds(1, [&]() { convolve(a, v, CONV_FULL, CONV_DIRECT); });
+            double t_fft = seconds(reps, [&]() { convolve(a, v, CONV_FULL, CONV_FFT); });
+            double t_auto = seconds(reps, [&]() { convolve(a, v); });
+
+            std::vector<cx> y(n);
+            double t_ols = seconds(reps, [&]() {
+                cx_overlap_save filter(h);
+                for (size_t i = 0; i < n; i += 4096)
+                    filter.process(x.data() + i, std::min<size_t>(4096, n - i), y.data() + i);
+            });
+
+            std::cout << std::setw(10) << n << std::setw(8) << m << std::setw(12) << t_direct * 1e3
+                      << std::setw(12) << t_fft * 1e3 << std::setw(12) << t_auto * 1e3
+                      << std::setw(13) << t_ols * 1e3 << "\n";
+        }
+
+    std::cout << "\n2-D convolution (ms)\n"
+              << std::setw(12) << "image" << std::setw(10) << "kernel" << std::setw(12) << "direct"
+              << std::setw(12) << "fft" << std::setw(12) << "auto\n";
+
+    for (size_t k : {size_t(3), size_t(15), size_t(63)})
+    {
+        const cx_tensor image({512, 512}, signal(512 * 512, 13));
+        const cx_tensor kernel({k, k}, signal(k * k, 3));
+        double t_direct = seconds(1, [&]() { convolve(image, kernel, CONV_SAME, CONV_DIRECT); });
+        double t_fft = seconds(3, [&]() { convolve(image, kernel, CONV_SAME, CONV_FFT); });
+        double t_auto = seconds(3, [&]() { convolve(image, kernel, CONV_SAME); });
+        std::cout << std::setw(12) << "512x512" << std::setw(10) << (std::to_string(k) + "x" + std::to_string(k))
+                  << std::setw(12) << t_direct * 1e3 << std::setw(12) << t_fft * 1e3 << std::setw(12) << t_auto * 1e3 << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include "../include/CXLibrary.h"
+
+using namespace cx_lib;
+
+// Plain loops over cx values, written the way the vector and tensor code
+// writes them: whether they run fast depends entirely on the compiler
+// seeing through the cx operators.
+
+template <typename F>
+static double seconds(size_t reps, F&& f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < reps; r++)
+        f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / reps;
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    size_t reps = std::max<size_t>(1, (size_t(1) << 26) / n);
+
+    std::vector<cx> a(n, cx(0, 0)), b(n, cx(0, 0)), c(n, cx(0, 0));
+    std::vector<float> mag(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        a[i] = cx(static_cast<float>(i % 17) * 0.25f, 1.0f);
+        b[i] = cx(0.5f, static_cast<float>(i % 5) - 2.0f);
+    }
+
+    volatile float sink = 0.0f;
+    double t_fma = seconds(reps, [&]() {
+        for (size_t i = 0; i < n; i++)
+            c[i] = a[i] * b[i] + c[i] * cx(0.5f, 0);
+    });
+    double t_div = seconds(reps, [&]() {
+        for (size_t i = 0; i < n; i++)
+            c[i] = a[i] / b[i];
+    });
+    double t_udiv = seconds(reps, [&]() {
+        for (size_t i = 0; i < n; i++)
+            c[i] = a[i].div(b[i]);
+    });
+    double t_mod = seconds(reps, [&]() {
+        for (size_t i = 0; i < n; i++)
+            mag[i] = a[i].mod();
+    });
+    double t_mod2 = seconds(reps, [&]() {
+        float acc = 0.0f;
+        for (size_t i = 0; i < n; i++)
+            acc += a[i].mod2();
+        sink = sink + acc;
+    });
+    double t_conj = seconds(reps, [&]() {
+        for (size_t i = 0; i < n; i++)
+            c[i] = a[i].conjugate() * b[i];
+    });
+
+    std::cout << "n = " << n << std::fixed << std::setprecision(2) << "\n"
+              << std::setw(16) << "a*b + c*s" << std::setw(12) << n / t_fma * 1e-6 << " M/s\n"
+              << std::setw(16) << "a / b" << std::setw(12) << n / t_div * 1e-6 << " M/s\n"
+              << std::setw(16) << "a.div(b)" << std::setw(12) << n / t_udiv * 1e-6 << " M/s\n"
+              << std::setw(16) << "mod" << std::setw(12) << n / t_mod * 1e-6 << " M/s\n"
+              << std::setw(16) << "sum mod2" << std::setw(12) << n / t_mod2 * 1e-6 << " M/s\n"
+              << std::setw(16) << "conj(a) * b" << std::setw(12) << n / t_conj * 1e-6 << " M/s\n";
+
+    return 0;
+}
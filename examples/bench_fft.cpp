@@ -0,0 +1,102 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "../include/CXLibrary.h"
+
+using namespace cx_lib;
+
+// Reference implementation: textbook in-place radix-2 with bit reversal,
+// twiddles computed on the fly (power-of-two sizes only).
+static void reference_fft(std::vector<cx>& a)
+{
+    const size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; i++)
+    {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(a[i], a[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+        const double angle = -2.0 * 3.14159265358979323846 / static_cast<double>(len);
+        for (size_t i = 0; i < n; i += len)
+            for (size_t k = 0; k < len / 2; k++)
+            {
+                const cx w(static_cast<float>(std::cos(angle * k)), static_cast<float>(std::sin(angle * k)));
+                const cx u = a[i + k], v = a[i + k + len / 2] * w;
+                a[i + k] = u + v;
+                a[i + k + len / 2] = u - v;
+            }
+    }
+}
+
+template <typename F>
+static double seconds(size_t reps, F&& f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < reps; r++)
+        f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / reps;
+}
+
+int main()
+{
+    std::cout << std::setw(10) << "n" << std::setw(14) << "reference" << std::setw(14) << "plan"
+              << std::setw(14) << "plan (MT)" << "   (GFlop/s, 5 n log2 n)\n" << std::fixed << std::setprecision(2);
+
+    for (size_t n : {size_t(1024), size_t(4096), size_t(1) << 16, size_t(1) << 20, size_t(1000), size_t(3) * 5 * 7 * 1024, size_t(4099)})
+    {
+        const size_t reps = std::max<size_t>(4, (size_t(1) << 24) / n);
+        const double flops = 5.0 * n * std::log2(static_cast<double>(n));
+        std::vector<cx> x(n), y(n);
+        for (size_t i = 0; i < n; i++)
+            x[i] = cx(static_cast<float>(i % 17) * 0.25f, static_cast<float>(i % 5) - 2.0f);
+
+        auto plan = fft_plan<float>(n);
+        plan->execute(x.data(), y.data());
+        double t_plan = seconds(reps, [&]() { plan->execute(x.data(), y.data()); });
+        enable_multithreading(true);
+        plan->execute(x.data(), y.data());
+        double t_mt = seconds(reps, [&]() { plan->execute(x.data(), y.data()); });
+        enable_multithreading(false);
+
+        std::cout << std::setw(10) << n;
+        if ((n & (n - 1)) == 0)
+        {
+            double t_ref = seconds(reps, [&]() { y = x; reference_fft(y); });
+            std::cout << std::setw(14) << flops / t_ref * 1e-9;
+        }
+        else
+            std::cout << std::setw(14) << "-";
+        std::cout << std::setw(14) << flops / t_plan * 1e-9 << std::setw(14) << flops / t_mt * 1e-9 << "\n";
+    }
+
+    std::cout << "\n" << std::setw(18) << "tensor" << std::setw(14) << "axis -1" << std::setw(14) << "axis 0"
+              << std::setw(14) << "all axes" << "   (GFlop/s)\n";
+    for (auto shape : {std::vector<size_t>{1024, 1024}, std::vector<size_t>{128, 128, 128}})
+    {
+        size_t total = 1;
+        for (size_t d : shape)
+            total *= d;
+        cx_tensor t(shape, cx(0.5f, -0.25f));
+        const double flops_last = 5.0 * total * std::log2(static_cast<double>(shape.back()));
+        const double flops_first = 5.0 * total * std::log2(static_cast<double>(shape.front()));
+        const double flops_all = 5.0 * total * std::log2(static_cast<double>(total));
+
+        double t_last = seconds(4, [&]() { fft_inplace(t, {shape.size() - 1}); });
+        double t_first = seconds(4, [&]() { fft_inplace(t, {0}); });
+        double t_all = seconds(4, [&]() { fft_inplace(t); });
+
+        std::cout << std::setw(18) << (shape.size() == 2 ? "1024 x 1024" : "128 x 128 x 128")
+                  << std::setw(14) << flops_last / t_last * 1e-9 << std::setw(14) << flops_first / t_first * 1e-9
+                  << std::setw(14) << flops_all / t_all * 1e-9 << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include "../include/CXLibrary.h"
+
+using namespace cx_lib;
+
+// Reference implementation: element-wise loop through the out-of-line cx
+// operators, as the vector and tensor code did before the kernel layer.
+static void reference_mul(size_t n, const cx* a, const cx* b, cx* out)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = a[i] * b[i];
+}
+
+template <typename F>
+static double seconds(size_t reps, F&& f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < reps; r++)
+        f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / reps;
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    size_t reps = std::max<size_t>(1, (size_t(1) << 26) / n);
+
+    std::vector<cx> a(n, cx(0, 0)), b(n, cx(0, 0)), out(n, cx(0, 0));
+    std::vector<float> mag(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        a[i] = cx(static_cast<float>(i % 17) * 0.25f, 1.0f);
+        b[i] = cx(0.5f, static_cast<float>(i % 5) - 2.0f);
+    }
+
+    const char* names[] = {"scalar", "sse2", "avx2", "avx512"};
+    const double ref = seconds(reps, [&]() { reference_mul(n, a.data(), b.data(), out.data()); });
+    std::cout << "n = " << n << ", reference mul " << std::fixed << std::setprecision(2)
+              << n / ref * 1e-6 << " M/s\n";
+
+    std::cout << std::setw(8) << "level"
+              << std::setw(12) << "add M/s"
+              << std::setw(12) << "mul M/s"
+              << std::setw(12) << "axpy M/s"
+              << std::setw(12) << "dotc M/s"
+              << std::setw(12) << "abs M/s"
+              << std::setw(14) << "mul speedup" << "\n";
+
+    for (int l = SIMD_SCALAR; l <= simd_detect(); l++)
+    {
+        set_simd_level(static_cast<__cx_simd_level__>(l));
+        volatile float sink = 0.0f;
+        double t_add = seconds(reps, [&]() { kernels::add(n, a.data(), b.data(), out.data()); });
+        double t_mul = seconds(reps, [&]() { kernels::mul(n, a.data(), b.data(), out.data()); });
+        double t_axpy = seconds(reps, [&]() { kernels::axpy(n, cx(1e-6f, 0), a.data(), out.data()); });
+        double t_dotc = seconds(reps, [&]() { sink = sink + kernels::dotc(n, a.data(), b.data()).real; });
+        double t_abs = seconds(reps, [&]() { kernels::abs(n, a.data(), mag.data()); });
+
+        std::cout << std::setw(8) << names[l]
+                  << std::setw(12) << n / t_add * 1e-6
+                  << std::setw(12) << n / t_mul * 1e-6
+                  << std::setw(12) << n / t_axpy * 1e-6
+                  << std::setw(12) << n / t_dotc * 1e-6
+                  << std::setw(12) << n / t_abs * 1e-6
+                  << std::setw(14) << ref / t_mul << "\n";
+    }
+    set_simd_level(simd_detect());
+
+    return 0;
+}
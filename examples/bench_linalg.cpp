@@ -0,0 +1,193 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "../include/CXLibrary.h"
+
+using namespace cx_lib;
+
+// Reference implementation: textbook unblocked LU with partial pivoting.
+static void reference_lu(cx_matrix& a)
+{
+    const size_t n = a.rows();
+    for (size_t j = 0; j < n; j++)
+    {
+        size_t p = j;
+        for (size_t i = j + 1; i < n; i++)
+            if (a(i, j).mod2() > a(p, j).mod2())
+                p = i;
+        for (size_t c = 0; c < n; c++)
+            std::swap(a(j, c), a(p, c));
+        for (size_t i = j + 1; i < n; i++)
+        {
+            a(i, j) /= a(j, j);
+            for (size_t c = j + 1; c < n; c++)
+                a(i, c) -= a(i, j) * a(j, c);
+        }
+    }
+}
+
+template <typename F>
+static double seconds(size_t reps, F&& f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < reps; r++)
+        f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / reps;
+}
+
+static cx_matrix sample(size_t n, size_t cols = 0)
+{
+    cols = cols ? cols : n;
+    cx_matrix a(n, cols, cx(0, 0));
+    unsigned state = 12345;
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < cols; j++)
+        {
+            state = state * 1664525u + 1013904223u;
+            const float re = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+            state = state * 1664525u + 1013904223u;
+            a(i, j) = cx(re, static_cast<float>(state >> 8) / 8388608.0f - 1.0f);
+        }
+    return a;
+}
+
+int main()
+{
+    std::cout << std::setw(8) << "n" << std::setw(14) << "reference" << std::setw(14) << "lu"
+              << std::setw(14) << "lu (MT)" << std::setw(14) << "solve 1 rhs" << "   (GFlop/s, 8/3 n^3; solve in ms)\n"
+              << std::fixed << std::setprecision(2);
+
+    for (size_t n : {size_t(256), size_t(512), size_t(1024), size_t(2048)})
+    {
+        const cx_matrix a = sample(n);
+        const double flops = 8.0 / 3.0 * n * n * n;
+        const size_t reps = std::max<size_t>(1, (size_t(1) << 29) / (n * n * n));
+
+        double t_lu = seconds(reps, [&]() { lu(a); });
+        enable_multithreading(true);
+        double t_mt = seconds(reps, [&]() { lu(a); });
+        enable_multithreading(false);
+
+        const cx_lu f = lu(a);
+        const cx_vector b(n, cx(1, 0));
+        double t_solve = seconds(10, [&]() { f.solve(b); });
+
+        std::cout << std::setw(8) << n;
+        if (n <= 1024)
+        {
+            cx_matrix r(a);
+            double t_ref = seconds(1, [&]() { r = a; reference_lu(r); });
+            std::cout << std::setw(14) << flops / t_ref * 1e-9;
+        }
+        else
+            std::cout << std::setw(14) << "-";
+        std::cout << std::setw(14) << flops / t_lu * 1e-9 << std::setw(14) << flops / t_mt * 1e-9
+                  << std::setw(14) << t_solve * 1e3 << "\n";
+    }
+
+    // Cholesky of sample covariance matrices against LU, and keeping the factor current
+    // with one rank-1 update per new sample instead of refactoring.
+    std::cout << "\n" << std::setw(8) << "n" << std::setw(14) << "lu" << std::setw(14) << "cholesky"
+              << std::setw(14) << "chol (MT)" << std::setw(14) << "update" << std::setw(14) << "downdate"
+              << "   (ms)\n";
+    for (size_t n : {size_t(256), size_t(512), size_t(1024), size_t(2048)})
+    {
+        const cx_matrix x = sample(n, 2 * n);
+        cx_matrix r(n, n, cx(0, 0));
+        gemm(NO_TRANS, CONJ_TRANS, n, n, 2 * n, cx(0.5f / n, 0), x.data(), x.row_stride(),
+             x.data(), x.row_stride(), cx(0, 0), r.data(), r.row_stride());
+        const size_t reps = std::max<size_t>(1, (size_t(1) << 29) / (n * n * n));
+        double t_lu = seconds(reps, [&]() { lu(r); });
+        double t_chol = seconds(reps, [&]() { cholesky(r); });
+        enable_multithreading(true);
+        double t_mt = seconds(reps, [&]() { cholesky(r); });
+        enable_multithreading(false);
+
+        cx_cholesky f = cholesky(r);
+        std::vector<cx> column(n);
+        for (size_t i = 0; i < n; i++)
+            column[i] = x(i, 0) * cx(0.1f, 0);
+        const cx_vector v(column);
+        double t_up = seconds(10, [&]() { f.update(v); });
+        double t_down = seconds(10, [&]() { f.downdate(v); });
+        std::cout << std::setw(8) << n << std::setw(14) << t_lu * 1e3 << std::setw(14) << t_chol * 1e3
+                  << std::setw(14) << t_mt * 1e3 << std::setw(14) << t_up * 1e3 << std::setw(14) << t_down * 1e3 << "\n";
+    }
+
+    std::cout << "\n" << std::setw(8) << "n" << std::setw(14) << "qr" << std::setw(14) << "qr (MT)"
+              << "   (GFlop/s, 16/3 n^3)\n";
+    for (size_t n : {size_t(256), size_t(512), size_t(1024), size_t(2048)})
+    {
+        const cx_matrix a = sample(n);
+        const double flops = 16.0 / 3.0 * n * n * n;
+        const size_t reps = std::max<size_t>(1, (size_t(1) << 29) / (n * n * n));
+        double t_qr = seconds(reps, [&]() { qr(a); });
+        enable_multithreading(true);
+        double t_mt = seconds(reps, [&]() { qr(a); });
+        enable_multithreading(false);
+        std::cout << std::setw(8) << n << std::setw(14) << flops / t_qr * 1e-9 << std::setw(14) << flops / t_mt * 1e-9 << "\n";
+    }
+
+    // Tall and skinny least squares: TSQR against a single blocked QR.
+    std::cout << "\n" << std::setw(10) << "m x n" << std::setw(14) << "qr solve" << std::setw(14) << "lstsq"
+              << std::setw(14) << "lstsq (MT)" << "   (ms)\n";
+    for (size_t m : {size_t(1) << 16, size_t(1) << 19})
+    {
+        const size_t n = 64;
+        const cx_matrix a = sample(m, n);
+        const cx_vector b(m, cx(1, 0));
+        double t_qr = seconds(1, [&]() { qr(a).solve(b); });
+        double t_ls = seconds(3, [&]() { lstsq(a, b); });
+        enable_multithreading(true);
+        double t_mt = seconds(3, [&]() { lstsq(a, b); });
+        enable_multithreading(false);
+        std::cout << std::setw(10) << (std::to_string(m) + "x" + std::to_string(n)) << std::setw(14) << t_qr * 1e3
+                  << std::setw(14) << t_ls * 1e3 << std::setw(14) << t_mt * 1e3 << "\n";
+    }
+    // Hermitian eigenproblems of sample covariance matrices, X X^H / snapshots.
+    std::cout << "\n" << std::setw(8) << "n" << std::setw(14) << "eigvalsh" << std::setw(14) << "eigh"
+              << std::setw(14) << "eigh (MT)" << std::setw(14) << "4 largest" << "   (ms)\n";
+    for (size_t n : {size_t(64), size_t(256), size_t(512), size_t(1024)})
+    {
+        const cx_matrix x = sample(n, 2 * n);
+        cx_matrix r(n, n, cx(0, 0));
+        gemm(NO_TRANS, CONJ_TRANS, n, n, 2 * n, cx(0.5f / n, 0), x.data(), x.row_stride(),
+             x.data(), x.row_stride(), cx(0, 0), r.data(), r.row_stride());
+        const size_t reps = std::max<size_t>(1, (size_t(1) << 26) / (n * n * n));
+        double t_val = seconds(reps, [&]() { eigvalsh(r); });
+        double t_vec = seconds(reps, [&]() { eigh(r); });
+        double t_top = seconds(reps, [&]() { eigh(r, EIG_LARGEST, 4); });
+        enable_multithreading(true);
+        double t_mt = seconds(reps, [&]() { eigh(r); });
+        enable_multithreading(false);
+        std::cout << std::setw(8) << n << std::setw(14) << t_val * 1e3 << std::setw(14) << t_vec * 1e3
+                  << std::setw(14) << t_mt * 1e3 << std::setw(14) << t_top * 1e3 << "\n";
+    }
+
+    // SVD of channel-like matrices: full, and rank-16 truncated of a rank-16 matrix plus noise.
+    std::cout << "\n" << std::setw(8) << "n" << std::setw(14) << "svdvals" << std::setw(14) << "svd"
+              << std::setw(14) << "svd (MT)" << std::setw(14) << "rank 16" << std::setw(14) << "rank 16 (MT)"
+              << "   (ms)\n";
+    for (size_t n : {size_t(64), size_t(256), size_t(512), size_t(1024)})
+    {
+        const cx_matrix x = sample(n, 16), y = sample(16, n), noise = sample(n);
+        cx_matrix h(noise);
+        gemm(NO_TRANS, NO_TRANS, n, n, 16, cx(1, 0), x.data(), x.row_stride(), y.data(), y.row_stride(),
+             cx(1e-3f, 0), h.data(), h.row_stride());
+        const size_t reps = std::max<size_t>(1, (size_t(1) << 26) / (n * n * n));
+        double t_val = seconds(reps, [&]() { svdvals(h); });
+        double t_full = seconds(reps, [&]() { svd(h); });
+        double t_low = seconds(reps, [&]() { svd_truncated(h, 16); });
+        enable_multithreading(true);
+        double t_mt = seconds(reps, [&]() { svd(h); });
+        double t_low_mt = seconds(reps, [&]() { svd_truncated(h, 16); });
+        enable_multithreading(false);
+        std::cout << std::setw(8) << n << std::setw(14) << t_val * 1e3 << std::setw(14) << t_full * 1e3
+                  << std::setw(14) << t_mt * 1e3 << std::setw(14) << t_low * 1e3 << std::setw(14)
+                  << t_low_mt * 1e3 << "\n";
+    }
+    return 0;
+}
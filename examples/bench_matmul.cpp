@@ -0,0 +1,105 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../include/CXLibrary.h"
+
+using namespace cx_lib;
+
+// Reference implementation: the column-by-column scheme cx_lib::matmul used
+// before the blocked kernel (one get_col() allocation per output column,
+// column-strided reads, one dot product per output element), computing the
+// plain product like matprod.
+static cx_matrix reference_matmul(const cx_matrix& a, const cx_matrix& b)
+{
+    cx_matrix new_(a.rows(), b.cols(), cx(0, 0));
+    for (size_t j = 0; j < b.cols(); j++)
+    {
+        cx_vector elem = b.get_col(j);
+        for (size_t i = 0; i < a.rows(); i++)
+        {
+            cx sum_(0, 0);
+            for (size_t k = 0; k < a.cols(); k++)
+                sum_ += a(i, k) * elem[k];
+            new_(i, j) = sum_;
+        }
+    }
+    return new_;
+}
+
+static cx_matrix random_matrix(size_t n, std::mt19937& gen)
+{
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    cx_matrix m(n, n, cx(0, 0));
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+            m(i, j) = cx(dist(gen), dist(gen));
+    return m;
+}
+
+template <typename F>
+static double seconds(F&& f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<size_t> sizes = {128, 256, 512, 1024};
+    if (argc > 1)
+    {
+        sizes.clear();
+        for (int i = 1; i < argc; i++)
+            sizes.push_back(std::strtoul(argv[i], nullptr, 10));
+    }
+
+    // The reference is O(n^3) with poor locality; skip it on large inputs.
+    const size_t reference_limit = 1024;
+    std::mt19937 gen(42);
+
+    std::cout << std::setw(6) << "n"
+              << std::setw(16) << "reference GF/s"
+              << std::setw(16) << "gemm GF/s"
+              << std::setw(10) << "speedup"
+              << std::setw(14) << "max |diff|" << "\n";
+
+    for (size_t n : sizes)
+    {
+        cx_matrix a = random_matrix(n, gen);
+        cx_matrix b = random_matrix(n, gen);
+        double flops = 8.0 * n * n * n;
+
+        cx_matrix fast;
+        double t_fast = seconds([&]() { fast = matprod(a, b); });
+
+        std::cout << std::setw(6) << n;
+        if (n <= reference_limit)
+        {
+            cx_matrix slow;
+            double t_slow = seconds([&]() { slow = reference_matmul(a, b); });
+
+            float diff = 0.0f;
+            for (size_t i = 0; i < n; i++)
+                for (size_t j = 0; j < n; j++)
+                    diff = std::max(diff, (fast(i, j) - slow(i, j)).mod());
+
+            std::cout << std::setw(16) << std::fixed << std::setprecision(2) << flops / t_slow * 1e-9
+                      << std::setw(16) << flops / t_fast * 1e-9
+                      << std::setw(10) << t_slow / t_fast
+                      << std::setw(14) << std::scientific << std::setprecision(2) << diff << "\n";
+        }
+        else
+        {
+            std::cout << std::setw(16) << "-"
+                      << std::setw(16) << std::fixed << std::setprecision(2) << flops / t_fast * 1e-9
+                      << std::setw(10) << "-" << std::setw(14) << "-" << "\n";
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "../include/CXLibrary.h"
+
+using namespace cx_lib;
+
+// Reference implementation: the scheme cx_tensor::transpose used before
+// strided views (one index vector allocated and decoded per element).
+static cx_tensor reference_transpose(const cx_tensor& t, const std::vector<size_t>& axes)
+{
+    const std::vector<size_t>& shape = t.shape();
+    std::vector<size_t> new_shape(shape.size());
+    for (size_t i = 0; i < axes.size(); ++i)
+        new_shape[i] = shape[axes[i]];
+
+    cx_tensor result(new_shape, cx(0, 0));
+
+    std::vector<size_t> old_strides(shape.size(), 1);
+    for (size_t i = shape.size() - 1; i-- > 0;)
+        old_strides[i] = old_strides[i + 1] * shape[i + 1];
+
+    std::vector<size_t> new_strides(new_shape.size(), 1);
+    for (size_t i = new_shape.size() - 1; i-- > 0;)
+        new_strides[i] = new_strides[i + 1] * new_shape[i + 1];
+
+    for (size_t i = 0; i < t.size(); ++i)
+    {
+        std::vector<size_t> old_indices(shape.size(), 0);
+        size_t temp = i;
+        for (size_t j = 0; j < shape.size(); ++j)
+        {
+            old_indices[j] = temp / old_strides[j];
+            temp %= old_strides[j];
+        }
+
+        size_t new_index = 0;
+        for (size_t j = 0; j < axes.size(); ++j)
+            new_index += old_indices[axes[j]] * new_strides[j];
+
+        result[new_index] = t[i];
+    }
+    return result;
+}
+
+template <typename F>
+static double seconds(F&& f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 64;
+    std::vector<size_t> shape = {n, n, n, n};
+    std::vector<std::vector<size_t>> perms = {
+        {0, 1, 3, 2}, {0, 2, 1, 3}, {3, 2, 1, 0}, {1, 0, 3, 2}, {2, 3, 0, 1}
+    };
+
+    cx_tensor t(shape, cx(0, 0));
+    for (size_t i = 0; i < t.size(); i++)
+        t[i] = cx(static_cast<float>(i % 977), static_cast<float>(i % 13));
+
+    // Every copy reads and writes the whole tensor once.
+    const double bytes = 2.0 * t.size() * sizeof(cx);
+
+    std::vector<cx> dst(t.size());
+    double t_copy = seconds([&]() { std::copy(&t[0], &t[0] + t.size(), dst.data()); });
+    std::cout << "shape " << n << "^4, plain copy " << std::fixed << std::setprecision(2)
+              << bytes / t_copy * 1e-9 << " GB/s\n";
+
+    std::cout << std::setw(14) << "axes"
+              << std::setw(18) << "reference GB/s"
+              << std::setw(18) << "contiguous GB/s"
+              << std::setw(10) << "speedup"
+              << std::setw(8) << "equal" << "\n";
+
+    for (const auto& axes : perms)
+    {
+        std::unique_ptr<cx_tensor> fast, slow;
+        double t_fast = seconds([&]() { fast.reset(new cx_tensor(t.transpose(axes).contiguous())); });
+        double t_slow = seconds([&]() { slow.reset(new cx_tensor(reference_transpose(t, axes))); });
+
+        bool equal = true;
+        for (size_t i = 0; i < t.size() && equal; i++)
+            equal = (*fast)[i] == (*slow)[i];
+
+        std::cout << std::setw(6) << "{" << axes[0] << "," << axes[1] << "," << axes[2] << "," << axes[3] << "}"
+                  << std::setw(18) << std::fixed << std::setprecision(2) << bytes / t_slow * 1e-9
+                  << std::setw(18) << bytes / t_fast * 1e-9
+                  << std::setw(10) << t_slow / t_fast
+                  << std::setw(8) << (equal ? "yes" : "NO") << "\n";
+    }
+
+    return 0;
+}
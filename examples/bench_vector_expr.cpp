@@ -0,0 +1,55 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include "../include/CXLibrary.h"
+
+using namespace cx_lib;
+
+// Reference implementation: one temporary and one pass per operator, as
+// the cx_vector operators did before expressions were fused.
+static void reference_expr(size_t n, const cx* a, const cx* b, const cx* c, const cx& s,
+                           std::vector<cx>& t1, std::vector<cx>& t2, cx* out)
+{
+    kernels::scale(n, s, b, t1.data());
+    kernels::add(n, a, t1.data(), t2.data());
+    kernels::sub(n, t2.data(), c, out);
+}
+
+template <typename F>
+static double seconds(size_t reps, F&& f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < reps; r++)
+        f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / reps;
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : (size_t(1) << 20);
+    size_t reps = std::max<size_t>(1, (size_t(1) << 26) / n);
+
+    std::vector<cx> da(n, cx(0, 0)), db(n, cx(0, 0)), dc(n, cx(0, 0));
+    for (size_t i = 0; i < n; i++)
+    {
+        da[i] = cx(static_cast<float>(i % 17) * 0.25f, 1.0f);
+        db[i] = cx(0.5f, static_cast<float>(i % 5) - 2.0f);
+        dc[i] = cx(1.0f, static_cast<float>(i % 3));
+    }
+    cx_vector a(da), b(db), c(dc), out(n, cx(0, 0));
+    const cx s(0.5f, -1.0f);
+
+    std::vector<cx> t1(n), t2(n), ref(n);
+    double t_ref = seconds(reps, [&]() { reference_expr(n, da.data(), db.data(), dc.data(), s, t1, t2, ref.data()); });
+    double t_expr = seconds(reps, [&]() { out = a + b * s - c; });
+
+    std::cout << "n = " << n << std::fixed << std::setprecision(2) << "\n"
+              << std::setw(16) << "three passes" << std::setw(12) << n / t_ref * 1e-6 << " M/s\n"
+              << std::setw(16) << "fused" << std::setw(12) << n / t_expr * 1e-6 << " M/s\n"
+              << std::setw(16) << "speedup" << std::setw(12) << t_ref / t_expr << "\n";
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "../include/CXLibrary.h"
+
+using namespace cx_lib;
+
+// Sliding window: one sample replaced per tick, statistics read every tick.
+template <typename W>
+static double seconds(size_t ticks, cx_vector& v, W&& write)
+{
+    volatile float sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t t = 0; t < ticks; t++)
+    {
+        write(t % v.dim(), cx(static_cast<float>(t % 101) * 0.01f, 1.0f));
+        sink = sink + v.mean().real + v.max().real + v.min().imag;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / ticks;
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : (size_t(1) << 16);
+    size_t ticks = std::max<size_t>(16, (size_t(1) << 26) / n);
+
+    cx_vector lazy(n, cx(0.5f, 0)), incremental(n, cx(0.5f, 0));
+    incremental.set_stats_mode(STATS_INCREMENTAL);
+
+    double t_lazy = seconds(ticks, lazy, [&](size_t i, const cx& x) { lazy[i] = x; });
+    double t_inc = seconds(ticks * 64, incremental, [&](size_t i, const cx& x) { incremental.set(i, x); });
+
+    std::cout << "n = " << n << std::fixed << std::setprecision(3) << "\n"
+              << std::setw(16) << "lazy" << std::setw(12) << t_lazy * 1e6 << " us/tick\n"
+              << std::setw(16) << "incremental" << std::setw(12) << t_inc * 1e6 << " us/tick\n"
+              << std::setw(16) << "speedup" << std::setw(12) << t_lazy / t_inc << "\n";
+
+    return 0;
+}
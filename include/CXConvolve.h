@@ -0,0 +1,156 @@
+#ifndef CX_CONVOLVE_H
+#define CX_CONVOLVE_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "ComplexNumber.h"
+#include "ComplexVector.h"
+#include "ComplexTensor.h"
+#include "CXFFT.h"
+
+namespace cx_lib
+{
+    template <typename T> class basic_cx_fft_plan;
+
+    /** @brief Part of the full convolution returned by convolve and correlate */
+    enum __cx_conv_mode__
+    {
+        CONV_FULL,  ///< Every point of overlap: n + m - 1 elements per axis
+        CONV_SAME,  ///< Centered, same extents as the first operand
+        CONV_VALID  ///< Only where the kernel fits entirely: n - m + 1 elements per axis
+    };
+
+    /** @brief How convolve and correlate are evaluated */
+    enum __cx_conv_method__
+    {
+        CONV_AUTO,    ///< Direct or FFT, whichever needs fewer operations
+        CONV_DIRECT,  ///< Sums of products with the SIMD kernels, O(n * m)
+        CONV_FFT      ///< Product of the spectra, O(L log L) with L about n + m
+    };
+
+    /**
+     * @brief Convolution of two vectors, (a * v)[k] = sum a[j] v[k - j]
+     *
+     * The direct method computes every output as one dot product with the
+     * reversed kernel. The FFT method zero-pads both operands to a length
+     * with factors 2, 3 and 5 only; when the signal is much longer than the
+     * kernel it switches to overlap-add, transforming blocks of a few times
+     * the kernel length instead of the whole signal. Outputs (direct) and
+     * blocks (overlap-add) are split across threads when multithreading is
+     * enabled.
+     *
+     * @param a Signal
+     * @param v Kernel
+     * @param mode Part of the full convolution to return
+     * @param method Evaluation method
+     * @throws std::invalid_argument if v is longer than a in CONV_VALID mode,
+     *         or if the result would have less than 2 elements
+     */
+    cx_vector convolve(const cx_vector& a, const cx_vector& v,
+                       __cx_conv_mode__ mode = CONV_FULL, __cx_conv_method__ method = CONV_AUTO);
+    /** @brief Double precision convolve */
+    cxd_vector convolve(const cxd_vector& a, const cxd_vector& v,
+                        __cx_conv_mode__ mode = CONV_FULL, __cx_conv_method__ method = CONV_AUTO);
+    /** @brief Cross-correlation of two vectors, sum a[j + k] conj(v[j]) (see convolve)
+     *
+     * In CONV_FULL mode, element k is the lag k - (m - 1), as in numpy.correlate.
+     */
+    cx_vector correlate(const cx_vector& a, const cx_vector& v,
+                        __cx_conv_mode__ mode = CONV_FULL, __cx_conv_method__ method = CONV_AUTO);
+    /** @brief Double precision correlate */
+    cxd_vector correlate(const cxd_vector& a, const cxd_vector& v,
+                         __cx_conv_mode__ mode = CONV_FULL, __cx_conv_method__ method = CONV_AUTO);
+    /** @brief convolve evaluated through the FFT */
+    cx_vector fftconvolve(const cx_vector& a, const cx_vector& v, __cx_conv_mode__ mode = CONV_FULL);
+    /** @brief Double precision fftconvolve */
+    cxd_vector fftconvolve(const cxd_vector& a, const cxd_vector& v, __cx_conv_mode__ mode = CONV_FULL);
+
+    /**
+     * @brief N-dimensional convolution of two tensors of the same rank
+     *
+     * Same modes and methods as the vector convolve, applied along every
+     * axis. The direct method accumulates shifted rows of a with axpy
+     * kernels, one output row per task; the FFT method zero-pads both
+     * operands and multiplies their N-dimensional spectra.
+     *
+     * @throws std::invalid_argument if the ranks differ, if an operand is
+     *         empty, or if v is larger than a along an axis in CONV_VALID mode
+     */
+    cx_tensor convolve(const cx_tensor_const_view& a, const cx_tensor_const_view& v,
+                       __cx_conv_mode__ mode = CONV_FULL, __cx_conv_method__ method = CONV_AUTO);
+    /** @brief Double precision tensor convolve */
+    cxd_tensor convolve(const cxd_tensor_const_view& a, const cxd_tensor_const_view& v,
+                        __cx_conv_mode__ mode = CONV_FULL, __cx_conv_method__ method = CONV_AUTO);
+    /** @brief N-dimensional cross-correlation (convolution with the flipped, conjugated kernel) */
+    cx_tensor correlate(const cx_tensor_const_view& a, const cx_tensor_const_view& v,
+                        __cx_conv_mode__ mode = CONV_FULL, __cx_conv_method__ method = CONV_AUTO);
+    /** @brief Double precision tensor correlate */
+    cxd_tensor correlate(const cxd_tensor_const_view& a, const cxd_tensor_const_view& v,
+                         __cx_conv_mode__ mode = CONV_FULL, __cx_conv_method__ method = CONV_AUTO);
+    /** @brief Tensor convolve evaluated through the FFT */
+    cx_tensor fftconvolve(const cx_tensor_const_view& a, const cx_tensor_const_view& v, __cx_conv_mode__ mode = CONV_FULL);
+    /** @brief Double precision tensor fftconvolve */
+    cxd_tensor fftconvolve(const cxd_tensor_const_view& a, const cxd_tensor_const_view& v, __cx_conv_mode__ mode = CONV_FULL);
+
+    /**
+     * @brief Streaming FIR filter evaluated with overlap-save
+     *
+     * Filters a signal that arrives in chunks: every call to process
+     * continues the convolution of the whole stream with the kernel, as if
+     * the samples before the first one were zero. Each block of
+     * block_size() new samples costs one forward and one inverse FFT of
+     * fft_size() points, with the last taps() - 1 samples of the previous
+     * block kept in front of it. Chunks that end in the middle of a block
+     * are answered immediately by transforming the partial block, which is
+     * transformed again when it fills up, so large chunks are cheaper.
+     *
+     * @tparam T Precision (float or double)
+     */
+    template <typename T>
+    class basic_cx_overlap_save
+    {
+    public:
+        /** @brief Element type */
+        using cx = basic_cx<T>;
+
+    private:
+        size_t __taps__;                                     ///< Kernel length m
+        std::shared_ptr<const basic_cx_fft_plan<T>> forward;  ///< Plan of the block transforms
+        std::shared_ptr<const basic_cx_fft_plan<T>> backward; ///< Plan of the inverse block transforms
+        std::vector<cx> spectrum;  ///< FFT of the zero-padded kernel, divided by fft_size()
+        std::vector<cx> window;    ///< Last taps() - 1 samples, then the samples of the current block
+        std::vector<cx> buffer;    ///< Block being transformed
+        size_t pending = 0;        ///< Samples of the current block received so far
+        size_t emitted = 0;        ///< Samples of the current block already filtered
+
+    public:
+        /** @brief Build the filter of a kernel
+         * @param kernel Filter taps
+         * @param fft_size Block transform length (0 = a power of two of about 8 times the kernel length)
+         * @throws std::invalid_argument if the kernel is empty or fft_size < 2 * kernel length
+         */
+        explicit basic_cx_overlap_save(const std::vector<cx>& kernel, size_t fft_size = 0);
+
+        /** @brief Number of kernel taps */
+        size_t taps() const noexcept { return __taps__; }
+        /** @brief Length of the block transforms */
+        size_t fft_size() const noexcept { return forward->size(); }
+        /** @brief New samples filtered by one block transform */
+        size_t block_size() const noexcept { return fft_size() - __taps__ + 1; }
+
+        /** @brief Filter the next n samples of the stream into out[0, n) */
+        void process(const cx* in, size_t n, cx* out);
+        /** @brief Filter the next samples of the stream */
+        std::vector<cx> process(const std::vector<cx>& in);
+        /** @brief Forget the past samples and start a new stream */
+        void reset() noexcept;
+    };
+
+    /** @brief Single precision overlap-save filter */
+    using cx_overlap_save = basic_cx_overlap_save<float>;
+    /** @brief Double precision overlap-save filter */
+    using cxd_overlap_save = basic_cx_overlap_save<double>;
+}
+
+#endif
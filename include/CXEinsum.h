@@ -0,0 +1,73 @@
+#ifndef CX_EINSUM_H
+#define CX_EINSUM_H
+
+#include <string>
+#include <vector>
+
+namespace cx_lib
+{
+    template <typename T> class basic_cx_tensor;
+    template <typename T> class basic_cx_tensor_const_view;
+
+    using cx_tensor = basic_cx_tensor<float>;
+    using cxd_tensor = basic_cx_tensor<double>;
+    using cx_tensor_const_view = basic_cx_tensor_const_view<float>;
+    using cxd_tensor_const_view = basic_cx_tensor_const_view<double>;
+
+    /**
+     * @brief Einstein summation over any number of tensors
+     *
+     * Subscripts follow numpy.einsum: one group of letters per operand,
+     * separated by commas, optionally followed by "->" and the letters of
+     * the output (e.g. "ij,jk->ik", "bij,bjk->bik", "ii->i", "ij->").
+     * Without "->" the output holds the letters appearing exactly once, in
+     * alphabetical order. Repeated letters within an operand take its
+     * diagonal; letters missing from the output are summed over.
+     *
+     * Operands are contracted two at a time, always picking the pair whose
+     * result is smallest. Each pairwise contraction is lowered to batched
+     * cx_lib::gemm calls on (transposed/reshaped) views, so no outer product
+     * is ever built and strided operands are only copied when no leading
+     * dimension can describe them.
+     *
+     * @param subscripts Subscripts of the operands and of the output
+     * @param operands Tensors (or views) to combine
+     * @return Result with one axis per output letter (shape {1} for a scalar)
+     * @throws std::invalid_argument if the subscripts are malformed or the extents of a letter differ
+     */
+    cx_tensor einsum(const std::string& subscripts, const std::vector<cx_tensor_const_view>& operands);
+
+    /** @brief Einstein summation of a single tensor (see einsum) */
+    cx_tensor einsum(const std::string& subscripts, const cx_tensor_const_view& a);
+
+    /** @brief Einstein summation of two tensors (see einsum) */
+    cx_tensor einsum(const std::string& subscripts, const cx_tensor_const_view& a, const cx_tensor_const_view& b);
+
+    /**
+     * @brief Sum of products over pairs of axes, like numpy.tensordot
+     *
+     * Axis axes_a[i] of a is contracted with axis axes_b[i] of b. The result
+     * has the remaining axes of a followed by the remaining axes of b
+     * (shape {1} when every axis is contracted).
+     * @throws std::invalid_argument if the axes are invalid or their extents differ
+     */
+    cx_tensor tensordot(const cx_tensor_const_view& a, const cx_tensor_const_view& b,
+                        const std::vector<size_t>& axes_a, const std::vector<size_t>& axes_b);
+
+    /** @brief Contract the last n axes of a with the first n axes of b (see tensordot) */
+    cx_tensor tensordot(const cx_tensor_const_view& a, const cx_tensor_const_view& b, size_t n);
+
+    /** @brief Double precision einsum (accumulates in double precision) */
+    cxd_tensor einsum(const std::string& subscripts, const std::vector<cxd_tensor_const_view>& operands);
+    /** @brief Double precision einsum of a single tensor */
+    cxd_tensor einsum(const std::string& subscripts, const cxd_tensor_const_view& a);
+    /** @brief Double precision einsum of two tensors */
+    cxd_tensor einsum(const std::string& subscripts, const cxd_tensor_const_view& a, const cxd_tensor_const_view& b);
+    /** @brief Double precision tensordot */
+    cxd_tensor tensordot(const cxd_tensor_const_view& a, const cxd_tensor_const_view& b,
+                         const std::vector<size_t>& axes_a, const std::vector<size_t>& axes_b);
+    /** @brief Double precision tensordot over the last n axes of a and the first n of b */
+    cxd_tensor tensordot(const cxd_tensor_const_view& a, const cxd_tensor_const_view& b, size_t n);
+}
+
+#endif
@@ -0,0 +1,329 @@
+#ifndef CX_ELEMENTWISE_H
+#define CX_ELEMENTWISE_H
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "ComplexNumber.h"
+#include "CXKernels.h"
+#include "CXThreadPool.h"
+
+namespace cx_lib
+{
+    /** @brief Minimum number of elements handed to a chunk by the element-wise engine */
+    constexpr size_t __cx_elementwise_grain__ = 4096;
+
+    /**
+     * @brief Broadcast shape of two shapes (NumPy rule)
+     *
+     * Shapes are aligned on their trailing dimensions; two dimensions are
+     * compatible when they are equal or one of them is 1.
+     * @throws std::invalid_argument if the shapes are incompatible
+     */
+    inline std::vector<size_t> broadcast_shape(const std::vector<size_t>& a, const std::vector<size_t>& b)
+    {
+        size_t rank = std::max(a.size(), b.size());
+        std::vector<size_t> out(rank);
+        for (size_t i = 0; i < rank; i++)
+        {
+            size_t da = (i < rank - a.size()) ? 1 : a[i - (rank - a.size())];
+            size_t db = (i < rank - b.size()) ? 1 : b[i - (rank - b.size())];
+            if (da != db && da != 1 && db != 1)
+                throw std::invalid_argument("Cannot broadcast: dimensions mismatch.");
+            out[i] = std::max(da, db);
+        }
+        return out;
+    }
+
+    /**
+     * @brief Express the strides of an operand on the axes of a broadcast shape
+     *
+     * Missing leading axes and axes of extent 1 get stride 0, so the same
+     * element is read along them.
+     * @param shape Shape of the operand
+     * @param strides Strides (in elements) of the operand
+     * @param out_shape Broadcast shape
+     */
+    inline std::vector<ptrdiff_t> broadcast_strides(const std::vector<size_t>& shape,
+                                                    const std::vector<ptrdiff_t>& strides,
+                                                    const std::vector<size_t>& out_shape)
+    {
+        std::vector<ptrdiff_t> out(out_shape.size(), 0);
+        size_t offset = out_shape.size() - shape.size();
+        for (size_t i = 0; i < shape.size(); i++)
+            out[offset + i] = (shape[i] == 1) ? 0 : strides[i];
+        return out;
+    }
+
+    /** @brief Row-major (C order) strides of a shape, in elements */
+    inline std::vector<ptrdiff_t> contiguous_strides(const std::vector<size_t>& shape)
+    {
+        std::vector<ptrdiff_t> strides(shape.size(), 1);
+        for (size_t i = shape.size(); i-- > 1;)
+            strides[i - 1] = strides[i] * static_cast<ptrdiff_t>(shape[i]);
+        return strides;
+    }
+
+    /**
+     * @brief N-dimensional loop over an output and N inputs sharing one shape
+     *
+     * Before iterating, axes of extent 1 are dropped and adjacent axes that
+     * are contiguous with each other in every operand are merged, so that
+     * e.g. two dense tensors of any rank are walked as one flat inner loop.
+     *
+     * @tparam N Number of input operands
+     */
+    template <size_t N>
+    class cx_nd_loop
+    {
+    private:
+        std::vector<size_t> __shape__;                        ///< Collapsed shape
+        std::vector<std::array<ptrdiff_t, N + 1>> __strides__; ///< Per axis: output stride, then input strides
+        size_t __size__ = 1;                                  ///< Total number of elements
+
+    public:
+        /** @brief Build the loop from the (broadcast) shape and the strides of every operand
+         * @param shape Iteration shape
+         * @param out_strides Strides of the output on shape
+         * @param in_strides Strides of each input on shape (0 on broadcast axes)
+         */
+        cx_nd_loop(const std::vector<size_t>& shape,
+                   const std::vector<ptrdiff_t>& out_strides,
+                   const std::array<std::vector<ptrdiff_t>, N>& in_strides)
+        {
+            for (size_t d = 0; d < shape.size(); d++)
+            {
+                __size__ *= shape[d];
+                if (shape[d] == 1)
+                    continue;
+
+                std::array<ptrdiff_t, N + 1> s;
+                s[0] = out_strides[d];
+                for (size_t k = 0; k < N; k++)
+                    s[k + 1] = in_strides[k][d];
+
+                if (!__shape__.empty())
+                {
+                    // Merge with the previous axis if, for every operand, a
+                    // step on the previous axis equals a full sweep of this one.
+                    bool mergeable = true;
+                    for (size_t k = 0; k <= N; k++)
+                        if (__strides__.back()[k] != s[k] * static_cast<ptrdiff_t>(shape[d]))
+                            mergeable = false;
+
+                    if (mergeable)
+                    {
+                        __shape__.back() *= shape[d];
+                        __strides__.back() = s;
+                        continue;
+                    }
+                }
+
+                __shape__.push_back(shape[d]);
+                __strides__.push_back(s);
+            }
+
+            if (__shape__.empty())
+            {
+                __shape__.push_back(1);
+                __strides__.push_back(std::array<ptrdiff_t, N + 1>{});
+            }
+        }
+
+        /** @brief Get total number of elements */
+        size_t size() const noexcept { return __size__; }
+        /** @brief Get rank after collapsing */
+        size_t rank() const noexcept { return __shape__.size(); }
+
+        /**
+         * @brief Run the loop
+         *
+         * inner(n, out, out_step, in, in_steps) is called on runs of n
+         * elements along the innermost collapsed axis; in and in_steps are
+         * std::array of the N input pointers and steps. Runs are distributed
+         * across the thread pool in disjoint chunks of the output.
+         * @tparam C Element type (cx or cxd)
+         */
+        template <typename C, typename Inner>
+        void run(C* out, const std::array<const C*, N>& in, Inner&& inner) const
+        {
+            const size_t rank = __shape__.size();
+            const size_t last = rank - 1;
+            const size_t inner_len = __shape__[last];
+
+            parallel_for(0, __size__, __cx_elementwise_grain__, [&](size_t start, size_t end) {
+                std::vector<size_t> idx(rank, 0);
+                std::array<ptrdiff_t, N + 1> off{};
+                size_t rem = start;
+                for (size_t d = rank; d-- > 0;)
+                {
+                    idx[d] = rem % __shape__[d];
+                    rem /= __shape__[d];
+                    for (size_t k = 0; k <= N; k++)
+                        off[k] += static_cast<ptrdiff_t>(idx[d]) * __strides__[d][k];
+                }
+
+                std::array<ptrdiff_t, N> steps;
+                for (size_t k = 0; k < N; k++)
+                    steps[k] = __strides__[last][k + 1];
+
+                size_t pos = start;
+                while (pos < end)
+                {
+                    size_t len = std::min(inner_len - idx[last], end - pos);
+                    std::array<const C*, N> ptrs;
+                    for (size_t k = 0; k < N; k++)
+                        ptrs[k] = in[k] + off[k + 1];
+                    inner(len, out + off[0], __strides__[last][0], ptrs, steps);
+                    pos += len;
+
+                    // Rewind the innermost axis and carry into the outer ones.
+                    for (size_t k = 0; k <= N; k++)
+                        off[k] -= static_cast<ptrdiff_t>(idx[last]) * __strides__[last][k];
+                    idx[last] = 0;
+                    for (size_t d = last; d-- > 0;)
+                    {
+                        for (size_t k = 0; k <= N; k++)
+                            off[k] += __strides__[d][k];
+                        if (++idx[d] < __shape__[d])
+                            break;
+                        for (size_t k = 0; k <= N; k++)
+                            off[k] -= static_cast<ptrdiff_t>(__shape__[d]) * __strides__[d][k];
+                        idx[d] = 0;
+                    }
+                }
+            });
+        }
+    };
+
+    /**
+     * @brief out = op(a) element by element
+     *
+     * All operands are described by a base pointer and strides on shape.
+     */
+    template <typename C, typename Op>
+    void nd_unary_map(const std::vector<size_t>& shape,
+                      C* out, const std::vector<ptrdiff_t>& out_strides,
+                      const C* a, const std::vector<ptrdiff_t>& a_strides,
+                      Op&& op)
+    {
+        cx_nd_loop<1> loop(shape, out_strides, {a_strides});
+        loop.run(out, {a}, [&](size_t n, C* o, ptrdiff_t so, const std::array<const C*, 1>& p, const std::array<ptrdiff_t, 1>& s) {
+            const C* pa = p[0];
+            if (so == 1 && s[0] == 1)
+                for (size_t j = 0; j < n; j++)
+                    o[j] = op(pa[j]);
+            else
+                for (size_t j = 0; j < n; j++)
+                    o[j * so] = op(pa[j * s[0]]);
+        });
+    }
+
+    /** @brief Whether a functor provides Op::span(n, a, b, out), a kernel over dense spans of C */
+    template <typename Op, typename C, typename = void>
+    struct cx_has_span_kernel : std::false_type { };
+    /** @copydoc cx_has_span_kernel */
+    template <typename Op, typename C>
+    struct cx_has_span_kernel<Op, C, std::void_t<decltype(Op::span(size_t(), std::declval<const C*>(),
+                                                                   std::declval<const C*>(), std::declval<C*>()))>>
+        : std::true_type { };
+
+    /**
+     * @brief out = op(a, b) element by element
+     *
+     * All operands are described by a base pointer and strides on shape;
+     * broadcast axes of a and b carry stride 0. The inner loop has dedicated
+     * paths for dense operands and for an operand broadcast along the
+     * innermost axis, so that it compiles to a straight vectorizable loop.
+     * Dense runs of functors with a span kernel go to the SIMD kernels.
+     */
+    template <typename C, typename Op>
+    void nd_binary_map(const std::vector<size_t>& shape,
+                       C* out, const std::vector<ptrdiff_t>& out_strides,
+                       const C* a, const std::vector<ptrdiff_t>& a_strides,
+                       const C* b, const std::vector<ptrdiff_t>& b_strides,
+                       Op&& op)
+    {
+        cx_nd_loop<2> loop(shape, out_strides, {a_strides, b_strides});
+        loop.run(out, {a, b}, [&](size_t n, C* o, ptrdiff_t so, const std::array<const C*, 2>& p, const std::array<ptrdiff_t, 2>& s) {
+            const C* pa = p[0];
+            const C* pb = p[1];
+            if (so == 1 && s[0] == 1 && s[1] == 1)
+            {
+                if constexpr (cx_has_span_kernel<std::decay_t<Op>, C>::value)
+                    std::decay_t<Op>::span(n, pa, pb, o);
+                else
+                    for (size_t j = 0; j < n; j++)
+                        o[j] = op(pa[j], pb[j]);
+            }
+            else if (so == 1 && s[0] == 1 && s[1] == 0)
+            {
+                const C vb = *pb;
+                for (size_t j = 0; j < n; j++)
+                    o[j] = op(pa[j], vb);
+            }
+            else if (so == 1 && s[0] == 0 && s[1] == 1)
+            {
+                const C va = *pa;
+                for (size_t j = 0; j < n; j++)
+                    o[j] = op(va, pb[j]);
+            }
+            else
+            {
+                for (size_t j = 0; j < n; j++)
+                    o[j * so] = op(pa[j * s[0]], pb[j * s[1]]);
+            }
+        });
+    }
+
+    /** @brief Element-wise functors used by the built-in tensor operators (on cx and cxd) */
+    struct cx_add_op
+    {
+        template <typename C>
+        C operator ()(const C& a, const C& b) const noexcept { return C(a.real + b.real, a.imag + b.imag); }
+        template <typename C>
+        static void span(size_t n, const C* a, const C* b, C* out) noexcept { kernels::add(n, a, b, out); }
+    };
+    /** @copydoc cx_add_op */
+    struct cx_sub_op
+    {
+        template <typename C>
+        C operator ()(const C& a, const C& b) const noexcept { return C(a.real - b.real, a.imag - b.imag); }
+        template <typename C>
+        static void span(size_t n, const C* a, const C* b, C* out) noexcept { kernels::sub(n, a, b, out); }
+    };
+    /** @copydoc cx_add_op */
+    struct cx_mul_op
+    {
+        template <typename C>
+        C operator ()(const C& a, const C& b) const noexcept
+        {
+            return C(a.real * b.real - a.imag * b.imag, a.real * b.imag + a.imag * b.real);
+        }
+        template <typename C>
+        static void span(size_t n, const C* a, const C* b, C* out) noexcept { kernels::mul(n, a, b, out); }
+    };
+    /** @copydoc cx_add_op */
+    struct cx_div_op
+    {
+        template <typename C>
+        C operator ()(const C& a, const C& b) const { return a / b; }
+        /** @brief Validates the whole divisor span first, so the division loop itself has no throw path */
+        template <typename C>
+        static void span(size_t n, const C* a, const C* b, C* out)
+        {
+            bool zero = false;
+            for (size_t j = 0; j < n; j++)
+                zero |= (b[j].real == 0) & (b[j].imag == 0);
+            if (zero)
+                __cx_division_by_zero__();
+            for (size_t j = 0; j < n; j++)
+                out[j] = a[j].div(b[j]);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef CX_FFT_H
+#define CX_FFT_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "ComplexNumber.h"
+#include "ComplexVector.h"
+#include "ComplexTensor.h"
+
+namespace cx_lib
+{
+    /** @brief Direction of a discrete Fourier transform */
+    enum __cx_fft_direction__
+    {
+        FFT_FORWARD,  ///< X[k] = sum x[j] e^{-2 pi i jk / n}
+        FFT_BACKWARD  ///< x[j] = sum X[k] e^{+2 pi i jk / n} (not divided by n)
+    };
+
+    /**
+     * @brief Precomputed plan for complex FFTs of one size and direction
+     *
+     * Sizes whose prime factors are all small are factored into radix-4,
+     * radix-2 and generic small-prime passes of a self-sorting (Stockham)
+     * FFT: every pass reads one buffer and writes the other, and the
+     * output comes out in natural order without a bit-reversal step. The
+     * radix-2 and radix-4 butterflies go through the SIMD kernels. Any other
+     * size (e.g. a large prime) is computed with Bluestein's algorithm, as
+     * a circular convolution through a power-of-two plan.
+     *
+     * All twiddle factors are computed once, in double precision, when the
+     * plan is built; a plan is immutable afterwards and can be shared by
+     * threads. When multithreading is enabled, the passes of large
+     * transforms are split across the thread pool.
+     *
+     * @tparam T Precision (float or double)
+     */
+    template <typename T>
+    class basic_cx_fft_plan
+    {
+    public:
+        /** @brief Element type */
+        using cx = basic_cx<T>;
+
+    private:
+        /** @brief One pass of the Stockham FFT */
+        struct pass
+        {
+            size_t radix;              ///< Butterfly size p
+            size_t len;                ///< Length of the sub-transforms split by this pass
+            size_t stride;             ///< Distance between the elements of a sub-transform
+            std::vector<cx> twiddles;  ///< w^{jt} for j < len / p and 0 < t < p, t fastest
+            std::vector<cx> roots;     ///< p-th roots of unity (generic radices only)
+        };
+
+        size_t __size__;                                       ///< Transform length
+        __cx_fft_direction__ __direction__;                    ///< Transform direction
+        std::vector<pass> passes;                              ///< Stockham passes (empty with Bluestein)
+        std::vector<cx> chirp;                                 ///< Bluestein chirp e^{-+pi i k^2 / n}
+        std::vector<cx> chirp_spectrum;                        ///< FFT of the conjugate chirp, divided by its length
+        std::shared_ptr<const basic_cx_fft_plan> convolution;  ///< Power-of-two forward plan used by Bluestein
+
+        /** @brief Stockham transform of in into out, work holds size() elements */
+        void stockham(const cx* in, cx* out, cx* work) const;
+        /** @brief Bluestein transform of in into out, work holds work_size() elements */
+        void bluestein(const cx* in, cx* out, cx* work) const;
+        /** @brief Run one pass from src into dst */
+        void run_pass(const pass&, const cx* src, cx* dst) const;
+
+    public:
+        /** @brief Build the plan of the transforms of length n
+         * @throws std::invalid_argument if n is 0
+         */
+        explicit basic_cx_fft_plan(size_t n, __cx_fft_direction__ direction = FFT_FORWARD);
+
+        /** @brief Transform length */
+        size_t size() const noexcept { return __size__; }
+        /** @brief Transform direction */
+        __cx_fft_direction__ direction() const noexcept { return __direction__; }
+        /** @brief Whether the plan uses Bluestein's algorithm */
+        bool uses_bluestein() const noexcept { return convolution != nullptr; }
+        /** @brief Number of scratch elements needed by execute(in, out, work) */
+        size_t work_size() const noexcept;
+
+        /** @brief out = transform of in (unnormalized); in and out may be the same buffer
+         *
+         * Scratch buffers of up to 65536 elements are owned by the calling
+         * thread and reused across calls; larger ones are allocated for the
+         * call only. Use execute(in, out, work) to manage the scratch.
+         */
+        void execute(const cx* in, cx* out) const;
+        /** @brief Transform data in place */
+        void execute(cx* data) const { execute(data, data); }
+        /** @brief execute(in, out) with a caller-provided scratch buffer of work_size() elements */
+        void execute(const cx* in, cx* out, cx* work) const;
+    };
+
+    /** @brief Single precision FFT plan */
+    using cx_fft_plan = basic_cx_fft_plan<float>;
+    /** @brief Double precision FFT plan */
+    using cxd_fft_plan = basic_cx_fft_plan<double>;
+
+    /** @brief Get the cached plan of size n and the given direction, building it on first use
+     *
+     * Plans are kept in a process-wide cache (guarded by a mutex), so
+     * repeated transforms of the same size only pay for the planning once.
+     * @throws std::invalid_argument if n is 0
+     */
+    template <typename T>
+    std::shared_ptr<const basic_cx_fft_plan<T>> fft_plan(size_t n, __cx_fft_direction__ direction = FFT_FORWARD);
+
+    /** @brief Drop every cached FFT plan (plans still referenced stay alive) */
+    void clear_fft_plans();
+
+    /** @brief Discrete Fourier transform of a vector */
+    cx_vector fft(const cx_vector&);
+    /** @brief Double precision fft */
+    cxd_vector fft(const cxd_vector&);
+    /** @brief Inverse discrete Fourier transform of a vector (divided by its dimension) */
+    cx_vector ifft(const cx_vector&);
+    /** @brief Double precision ifft */
+    cxd_vector ifft(const cxd_vector&);
+    /** @brief Replace a vector with its discrete Fourier transform */
+    void fft_inplace(cx_vector&);
+    /** @brief Double precision fft_inplace */
+    void fft_inplace(cxd_vector&);
+    /** @brief Replace a vector with its inverse discrete Fourier transform */
+    void ifft_inplace(cx_vector&);
+    /** @brief Double precision ifft_inplace */
+    void ifft_inplace(cxd_vector&);
+
+    /**
+     * @brief Multi-dimensional discrete Fourier transform of a tensor
+     *
+     * Runs batched 1-D transforms along each of the given axes (all axes
+     * when empty), one axis after the other. Lines along the last axis are
+     * contiguous and transformed where they are; along any other axis,
+     * tiles of neighbouring lines are transposed into a per-task buffer of
+     * at most 8192 elements (a single line when the axis is longer),
+     * transformed and written back. Every task also owns the scratch of
+     * one line transform. The input is copied once, into the result; the
+     * in-place variants only use these buffers. Independent lines are
+     * split across threads when multithreading is enabled.
+     *
+     * @param x Tensor (or view) to transform
+     * @param axes Axes to transform (an axis may be repeated)
+     * @throws std::invalid_argument if an axis is out of range
+     */
+    cx_tensor fft(const cx_tensor_const_view& x, const std::vector<size_t>& axes = {});
+    /** @brief Double precision tensor fft */
+    cxd_tensor fft(const cxd_tensor_const_view& x, const std::vector<size_t>& axes = {});
+    /** @brief Inverse of the tensor fft (divided by the number of points transformed) */
+    cx_tensor ifft(const cx_tensor_const_view& x, const std::vector<size_t>& axes = {});
+    /** @brief Double precision tensor ifft */
+    cxd_tensor ifft(const cxd_tensor_const_view& x, const std::vector<size_t>& axes = {});
+    /** @brief Tensor fft overwriting the tensor (and the views sharing its storage) */
+    void fft_inplace(cx_tensor& x, const std::vector<size_t>& axes = {});
+    /** @brief Double precision tensor fft_inplace */
+    void fft_inplace(cxd_tensor& x, const std::vector<size_t>& axes = {});
+    /** @brief Tensor ifft overwriting the tensor (and the views sharing its storage) */
+    void ifft_inplace(cx_tensor& x, const std::vector<size_t>& axes = {});
+    /** @brief Double precision tensor ifft_inplace */
+    void ifft_inplace(cxd_tensor& x, const std::vector<size_t>& axes = {});
+}
+
+#endif
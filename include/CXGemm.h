@@ -0,0 +1,63 @@
+#ifndef CX_GEMM_H
+#define CX_GEMM_H
+
+#include <cstddef>
+#include "ComplexNumber.h"
+
+namespace cx_lib
+{
+    /** @brief Operation applied to an operand of cx_lib::gemm */
+    enum __cx_gemm_op__
+    {
+        NO_TRANS,   ///< Use the operand as is
+        TRANS,      ///< Use the transpose of the operand
+        CONJ_TRANS  ///< Use the conjugate transpose of the operand
+    };
+
+    /** @brief Complex multiply-adds per thread below which gemm does not split C across threads */
+    constexpr size_t __cx_gemm_thread_work__ = size_t(1) << 18;
+
+    /**
+     * @brief General complex matrix multiply on raw row-major buffers
+     *
+     * Computes C = alpha * op(A) * op(B) + beta * C, where op(A) is m x k,
+     * op(B) is k x n and C is m x n. Every operand is stored row-major with
+     * unit column stride and the given leading dimension (distance between
+     * two consecutive rows).
+     *
+     * The product is evaluated by a cache-blocked kernel: op(B) is packed
+     * into KC x NC panels, op(A) into MC x KC panels (both with real and
+     * imaginary parts split), and a register-tiled MR x NR micro-kernel
+     * accumulates each tile of C. When multithreading is enabled and the
+     * product is large enough, C is split into a 2-D grid of tiles that are
+     * computed concurrently.
+     *
+     * @param op_a Operation applied to A
+     * @param op_b Operation applied to B
+     * @param m Rows of op(A) and C
+     * @param n Columns of op(B) and C
+     * @param k Columns of op(A) and rows of op(B)
+     * @param alpha Scalar multiplying op(A) * op(B)
+     * @param a Pointer to A
+     * @param lda Leading dimension of A
+     * @param b Pointer to B
+     * @param ldb Leading dimension of B
+     * @param beta Scalar multiplying C (when zero, C is not read)
+     * @param c Pointer to C
+     * @param ldc Leading dimension of C
+     */
+    void gemm(__cx_gemm_op__ op_a, __cx_gemm_op__ op_b,
+              size_t m, size_t n, size_t k,
+              const cx& alpha, const cx* a, size_t lda,
+              const cx* b, size_t ldb,
+              const cx& beta, cx* c, size_t ldc);
+
+    /** @brief Double precision gemm (see above) */
+    void gemm(__cx_gemm_op__ op_a, __cx_gemm_op__ op_b,
+              size_t m, size_t n, size_t k,
+              const cxd& alpha, const cxd* a, size_t lda,
+              const cxd* b, size_t ldb,
+              const cxd& beta, cxd* c, size_t ldc);
+}
+
+#endif
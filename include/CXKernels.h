@@ -0,0 +1,151 @@
+#ifndef CX_KERNELS_H
+#define CX_KERNELS_H
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include "ComplexNumber.h"
+
+namespace cx_lib
+{
+    /** @brief Instruction sets the complex kernels are built for */
+    enum __cx_simd_level__
+    {
+        SIMD_SCALAR,  ///< Portable C++ loops
+        SIMD_SSE2,    ///< 128-bit, 2 complex numbers per register
+        SIMD_AVX2,    ///< 256-bit with FMA, 4 complex numbers per register
+        SIMD_AVX512   ///< 512-bit (AVX-512F), 8 complex numbers per register
+    };
+
+    /** @brief Best instruction set supported by the CPU and the OS (queried through CPUID once) */
+    __cx_simd_level__ simd_detect() noexcept;
+    /** @brief Instruction set currently used by the kernels */
+    __cx_simd_level__ get_simd_level() noexcept;
+    /** @brief Select the instruction set used by the kernels
+     *
+     * Levels above simd_detect() are capped to it, so the call is always
+     * safe; lowering the level is mostly useful for testing and benchmarks.
+     */
+    void set_simd_level(__cx_simd_level__) noexcept;
+
+    /** @brief Global flag for accumulating single precision reductions in double precision */
+    extern std::atomic<bool> __cx_double_accumulation__;
+
+    /** @brief Enable or disable double precision accumulators for single precision data
+     *
+     * When enabled, the sums, means, norms and products of tensors, the
+     * dot products, norms and sums of vectors and the matrix-vector
+     * products of single precision containers are accumulated in double
+     * precision and rounded once at the end; the data itself stays in
+     * single precision, so memory traffic is unchanged. Matrix products
+     * (gemm, einsum) always accumulate in the precision of their operands.
+     * @param enable True to enable, false to disable
+     */
+    void enable_double_accumulation(bool enable) noexcept;
+
+    /** @brief Whether reductions over elements of precision T accumulate in double precision */
+    template <typename T>
+    inline bool double_accumulation() noexcept
+    {
+        return std::is_same<T, float>::value && __cx_double_accumulation__.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Element-wise kernels on spans of interleaved complex numbers
+     *
+     * Every kernel works on n consecutive cx values (real and imaginary parts
+     * interleaved, no alignment required) and is dispatched at runtime to
+     * the variant matching get_simd_level(). Output spans may alias input
+     * spans exactly, but must not overlap them partially.
+     *
+     * The double precision overloads are portable loops left to the
+     * compiler's vectorizer.
+     */
+    namespace kernels
+    {
+        /** @brief out[i] = a[i] + b[i] */
+        void add(size_t n, const cx* a, const cx* b, cx* out) noexcept;
+        /** @brief out[i] = a[i] - b[i] */
+        void sub(size_t n, const cx* a, const cx* b, cx* out) noexcept;
+        /** @brief out[i] = a[i] * b[i] */
+        void mul(size_t n, const cx* a, const cx* b, cx* out) noexcept;
+        /** @brief out[i] = conj(a[i]) * b[i] */
+        void conj_mul(size_t n, const cx* a, const cx* b, cx* out) noexcept;
+        /** @brief out[i] = alpha * x[i] */
+        void scale(size_t n, const cx& alpha, const cx* x, cx* out) noexcept;
+        /** @brief y[i] += alpha * x[i] */
+        void axpy(size_t n, const cx& alpha, const cx* x, cx* y) noexcept;
+        /** @brief Sum of a[i] * b[i] */
+        cx dot(size_t n, const cx* a, const cx* b) noexcept;
+        /** @brief Sum of conj(a[i]) * b[i] */
+        cx dotc(size_t n, const cx* a, const cx* b) noexcept;
+        /** @brief out[i] = |x[i]| */
+        void abs(size_t n, const cx* x, float* out) noexcept;
+        /** @brief out[i] = |x[i]|^2 */
+        void abs2(size_t n, const cx* x, float* out) noexcept;
+
+        /** @brief Radix-2 FFT butterfly: y[i] = x[i] + x[xs + i], y[ys + i] = (x[i] - x[xs + i]) * w
+         *
+         * Output spans must not overlap the input spans.
+         */
+        void fft_radix2(size_t n, const cx* x, size_t xs, const cx& w, cx* y, size_t ys) noexcept;
+        /** @brief Radix-4 FFT butterfly: the 4-point DFT of x[r * xs + i] (r < 4) goes to y[t * ys + i],
+         * output t > 0 multiplied by w[t - 1]; inverse uses e^{+2 pi i / 4} as root of unity
+         *
+         * Output spans must not overlap the input spans.
+         */
+        void fft_radix4(size_t n, const cx* x, size_t xs, const cx* w, bool inverse, cx* y, size_t ys) noexcept;
+
+        /** @brief Sum of a[i] * b[i], accumulated in double precision */
+        cxd dot_wide(size_t n, const cx* a, const cx* b) noexcept;
+        /** @brief Sum of conj(a[i]) * b[i], accumulated in double precision */
+        cxd dotc_wide(size_t n, const cx* a, const cx* b) noexcept;
+
+        /** @brief out[i] = a[i] + b[i] */
+        void add(size_t n, const cxd* a, const cxd* b, cxd* out) noexcept;
+        /** @brief out[i] = a[i] - b[i] */
+        void sub(size_t n, const cxd* a, const cxd* b, cxd* out) noexcept;
+        /** @brief out[i] = a[i] * b[i] */
+        void mul(size_t n, const cxd* a, const cxd* b, cxd* out) noexcept;
+        /** @brief out[i] = conj(a[i]) * b[i] */
+        void conj_mul(size_t n, const cxd* a, const cxd* b, cxd* out) noexcept;
+        /** @brief out[i] = alpha * x[i] */
+        void scale(size_t n, const cxd& alpha, const cxd* x, cxd* out) noexcept;
+        /** @brief y[i] += alpha * x[i] */
+        void axpy(size_t n, const cxd& alpha, const cxd* x, cxd* y) noexcept;
+        /** @brief Sum of a[i] * b[i] */
+        cxd dot(size_t n, const cxd* a, const cxd* b) noexcept;
+        /** @brief Sum of conj(a[i]) * b[i] */
+        cxd dotc(size_t n, const cxd* a, const cxd* b) noexcept;
+        /** @brief out[i] = |x[i]| */
+        void abs(size_t n, const cxd* x, double* out) noexcept;
+        /** @brief out[i] = |x[i]|^2 */
+        void abs2(size_t n, const cxd* x, double* out) noexcept;
+        /** @brief Radix-2 FFT butterfly (see above) */
+        void fft_radix2(size_t n, const cxd* x, size_t xs, const cxd& w, cxd* y, size_t ys) noexcept;
+        /** @brief Radix-4 FFT butterfly (see above) */
+        void fft_radix4(size_t n, const cxd* x, size_t xs, const cxd* w, bool inverse, cxd* y, size_t ys) noexcept;
+
+        /** @brief dot, accumulated in double precision when double_accumulation<T>() */
+        template <typename T>
+        inline basic_cx<T> accumulate_dot(size_t n, const basic_cx<T>* a, const basic_cx<T>* b) noexcept
+        {
+            if constexpr (std::is_same<T, float>::value)
+                if (double_accumulation<T>())
+                    return cx(dot_wide(n, a, b));
+            return dot(n, a, b);
+        }
+
+        /** @brief dotc, accumulated in double precision when double_accumulation<T>() */
+        template <typename T>
+        inline basic_cx<T> accumulate_dotc(size_t n, const basic_cx<T>* a, const basic_cx<T>* b) noexcept
+        {
+            if constexpr (std::is_same<T, float>::value)
+                if (double_accumulation<T>())
+                    return cx(dotc_wide(n, a, b));
+            return dotc(n, a, b);
+        }
+    }
+}
+
+#endif
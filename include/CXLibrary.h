@@ -5,46 +5,82 @@
 #include "ComplexVector.h"
 #include "ComplexMatrix.h"
 #include "ComplexTensor.h"
+#include "CXGemm.h"
+#include "CXEinsum.h"
+#include "CXFFT.h"
+#include "CXConvolve.h"
+#include "CXLinalg.h"
+#include "CXKernels.h"
+#include "CXThreadPool.h"
 #include <atomic>
 #include <mutex>
 #include <thread>
 
 namespace cx_lib
 {
-    struct cx;
-    class cx_vector;
-    class cx_matrix;
-    class cx_tensor;
+    template <typename T> class basic_cx_vector;
+    template <typename T> class basic_cx_matrix;
+    template <typename T> class basic_cx_tensor;
+    template <typename T> class basic_cx_tensor_const_view;
 
-    /** @brief Global flag for enabling/disabling multithreading (can use only on tensors)*/
-    extern std::atomic<bool> __cx_multithread_enabled__;
-    
-    /** @brief Enable or disable multithreading for operations
-     * @param enable True to enable, false to disable
-     */
-    void enable_multithreading(bool enable) noexcept;
+    using cx_vector = basic_cx_vector<float>;
+    using cxd_vector = basic_cx_vector<double>;
+    using cx_matrix = basic_cx_matrix<float>;
+    using cxd_matrix = basic_cx_matrix<double>;
+    using cx_tensor = basic_cx_tensor<float>;
+    using cxd_tensor = basic_cx_tensor<double>;
+    using cx_tensor_const_view = basic_cx_tensor_const_view<float>;
+    using cxd_tensor_const_view = basic_cx_tensor_const_view<double>;
 
-    /** @brief Matrix multiplication of two matrices
+    /** @brief Matrix multiplication of two matrices, conjugating the right operand
+     *
+     * Element (i, j) is the cx_vector::dot of row i of a with column j of
+     * b, i.e. sum_k a(i, k) * conj(b(k, j)). Use matprod for the plain
+     * product a × b.
      * @param a Left matrix
      * @param b Right matrix
-     * @return Result of a × b
-     * @throws std::invalid_argument if dimensions mismatch
+     * @return Result of a × conj(b)
+     * @throws std::runtime_error if dimensions mismatch
      */
     cx_matrix matmul(const cx_matrix& a, const cx_matrix& b);
+    /** @brief Double precision matmul */
+    cxd_matrix matmul(const cxd_matrix& a, const cxd_matrix& b);
 
-    /** @brief Matrix multiplication of vector and matrix
+    /** @brief Matrix multiplication of vector and matrix, conjugating the matrix (see matmul)
      * @param a Vector (treated as row vector)
      * @param b Matrix
      * @return Result vector
      */
     cx_vector matmul(const cx_vector& a, const cx_matrix& b);
+    /** @brief Double precision matmul */
+    cxd_vector matmul(const cxd_vector& a, const cxd_matrix& b);
 
-    /** @brief Matrix multiplication of matrix and vector
+    /** @brief Matrix multiplication of matrix and vector, conjugating the vector (see matmul)
      * @param a Matrix
      * @param b Vector (treated as column vector)
      * @return Result vector
      */
     cx_vector matmul(const cx_matrix& a, const cx_vector& b);
+    /** @brief Double precision matmul */
+    cxd_vector matmul(const cxd_matrix& a, const cxd_vector& b);
+
+    /** @brief Matrix product a × b, without conjugation (through gemm)
+     * @param a Left matrix
+     * @param b Right matrix
+     * @return Result of a × b
+     * @throws std::runtime_error if dimensions mismatch
+     */
+    cx_matrix matprod(const cx_matrix& a, const cx_matrix& b);
+    /** @brief Double precision matprod */
+    cxd_matrix matprod(const cxd_matrix& a, const cxd_matrix& b);
+    /** @brief Product of a row vector and a matrix, without conjugation */
+    cx_vector matprod(const cx_vector& a, const cx_matrix& b);
+    /** @brief Double precision matprod */
+    cxd_vector matprod(const cxd_vector& a, const cxd_matrix& b);
+    /** @brief Product of a matrix and a column vector, without conjugation */
+    cx_vector matprod(const cx_matrix& a, const cx_vector& b);
+    /** @brief Double precision matprod */
+    cxd_vector matprod(const cxd_matrix& a, const cxd_vector& b);
 
     /** @brief Element-wise product of two vectors
      * @param a First vector
@@ -52,6 +88,8 @@ namespace cx_lib
      * @return Result of element-wise multiplication
      */
     cx_vector hadamard_vprod(const cx_vector& a, const cx_vector& b);
+    /** @brief Double precision hadamard_vprod */
+    cxd_vector hadamard_vprod(const cxd_vector& a, const cxd_vector& b);
 
     /** @brief Element-wise product of two matrices
      * @param a First matrix
@@ -59,13 +97,18 @@ namespace cx_lib
      * @return Result of element-wise multiplication
      */
     cx_matrix hadamard_prod(const cx_matrix& a, const cx_matrix& b);
+    /** @brief Double precision hadamard_prod */
+    cxd_matrix hadamard_prod(const cxd_matrix& a, const cxd_matrix& b);
 
-    /** @brief Element-wise product of two tensors
+    /** @brief Element-wise product of two tensors (with NumPy-style broadcasting)
      * @param a First tensor
      * @param b Second tensor
      * @return Result of element-wise multiplication
+     * @throws std::invalid_argument if shapes can't be broadcast together
      */
-    cx_tensor hadamard_prod(const cx_tensor& a, const cx_tensor& b);
+    cx_tensor hadamard_prod(const cx_tensor_const_view& a, const cx_tensor_const_view& b);
+    /** @brief Double precision hadamard_prod */
+    cxd_tensor hadamard_prod(const cxd_tensor_const_view& a, const cxd_tensor_const_view& b);
 
     /** @brief Tensor (outer) product of two vectors
      * @param a First vector
@@ -73,13 +116,26 @@ namespace cx_lib
      * @return Result of tensor product
      */
     cx_vector tensor_prod(const cx_vector& a, const cx_vector& b) noexcept;
+    /** @brief Double precision tensor_prod */
+    cxd_vector tensor_prod(const cxd_vector& a, const cxd_vector& b) noexcept;
 
     /** @brief Tensor (outer) product of two tensors
      * @param a First tensor
      * @param b Second tensor
      * @return Result of tensor product
      */
-    cx_tensor tensor_prod(const cx_tensor& a, const cx_tensor& b) noexcept;
+    cx_tensor tensor_prod(const cx_tensor_const_view& a, const cx_tensor_const_view& b) noexcept;
+    /** @brief Double precision tensor_prod */
+    cxd_tensor tensor_prod(const cxd_tensor_const_view& a, const cxd_tensor_const_view& b) noexcept;
+
+    /** @brief Kronecker product of two matrices
+     * @param a First matrix
+     * @param b Second matrix
+     * @return Block matrix of size (a.rows() * b.rows()) x (a.cols() * b.cols()) whose block (i, j) is a(i, j) * b
+     */
+    cx_matrix kron(const cx_matrix& a, const cx_matrix& b);
+    /** @brief Double precision kron */
+    cxd_matrix kron(const cxd_matrix& a, const cxd_matrix& b);
 }
 
 #endif
\ No newline at end of file
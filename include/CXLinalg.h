@@ -0,0 +1,507 @@
+#ifndef CX_LINALG_H
+#define CX_LINALG_H
+
+#include <cstddef>
+#include <vector>
+#include "ComplexNumber.h"
+#include "ComplexVector.h"
+#include "ComplexMatrix.h"
+
+namespace cx_lib
+{
+    /**
+     * @brief LU decomposition with partial pivoting, P A = L U
+     *
+     * The factorization is blocked and right-looking: each panel of
+     * columns is factored with row pivoting, the rows of U to its right are
+     * obtained with a triangular solve, and the trailing submatrix is
+     * updated with one call to gemm, which carries almost all the flops and
+     * is multithreaded when multithreading is enabled. L (unit lower
+     * triangular) and U overwrite a single copy of the matrix; factoring an
+     * rvalue reuses its storage.
+     *
+     * A zero pivot does not stop the factorization: the matrix is marked as
+     * singular, det() returns 0 and solve() and inverse() throw.
+     *
+     * @tparam T Precision (float or double)
+     */
+    template <typename T>
+    class basic_cx_lu
+    {
+    public:
+        /** @brief Element type */
+        using cx = basic_cx<T>;
+
+    private:
+        basic_cx_matrix<T> __factors__;  ///< L below the diagonal (unit diagonal implied), U on and above it
+        std::vector<size_t> __pivots__;  ///< Row i was swapped with row __pivots__[i] >= i at step i
+        bool __singular__ = false;       ///< Whether a pivot was exactly zero
+
+        /** @brief Factor __factors__ in place */
+        void factor();
+
+    public:
+        /** @brief Factor a square matrix
+         * @throws std::invalid_argument if the matrix is not square
+         */
+        explicit basic_cx_lu(const basic_cx_matrix<T>&);
+        /** @brief Factor a square matrix in its own storage */
+        explicit basic_cx_lu(basic_cx_matrix<T>&&);
+
+        /** @brief Order of the matrix */
+        size_t size() const noexcept { return __factors__.rows(); }
+        /** @brief Whether the matrix is singular */
+        bool is_singular() const noexcept { return __singular__; }
+        /** @brief L and U packed in one matrix (the unit diagonal of L is not stored) */
+        const basic_cx_matrix<T>& factors() const noexcept { return __factors__; }
+        /** @brief Row interchanges, in the order they were applied (LAPACK ipiv, 0-based) */
+        const std::vector<size_t>& pivots() const noexcept { return __pivots__; }
+        /** @brief Row i of L U is row permutation()[i] of the factored matrix */
+        std::vector<size_t> permutation() const;
+        /** @brief Unit lower triangular factor */
+        basic_cx_matrix<T> lower() const;
+        /** @brief Upper triangular factor */
+        basic_cx_matrix<T> upper() const;
+
+        /** @brief Determinant of the factored matrix */
+        cx det() const noexcept;
+        /** @brief Solve A x = b
+         * @throws std::invalid_argument if b has the wrong dimension
+         * @throws std::runtime_error if the matrix is singular
+         */
+        basic_cx_vector<T> solve(const basic_cx_vector<T>&) const;
+        /** @brief Solve A X = B, one column of X per column of B
+         * @throws std::invalid_argument if B has the wrong number of rows
+         * @throws std::runtime_error if the matrix is singular
+         */
+        basic_cx_matrix<T> solve(const basic_cx_matrix<T>&) const;
+        /** @brief Inverse of the factored matrix
+         * @throws std::runtime_error if the matrix is singular
+         */
+        basic_cx_matrix<T> inverse() const;
+    };
+
+    /** @brief Single precision LU decomposition */
+    using cx_lu = basic_cx_lu<float>;
+    /** @brief Double precision LU decomposition */
+    using cxd_lu = basic_cx_lu<double>;
+
+    /** @brief LU decomposition of a square matrix (see basic_cx_lu)
+     * @throws std::invalid_argument if the matrix is not square
+     */
+    cx_lu lu(const cx_matrix& a);
+    /** @brief Double precision lu */
+    cxd_lu lu(const cxd_matrix& a);
+    /** @brief LU decomposition overwriting the storage of an expiring matrix */
+    cx_lu lu(cx_matrix&& a);
+    /** @brief Double precision lu of an expiring matrix */
+    cxd_lu lu(cxd_matrix&& a);
+
+    /** @brief Solve the linear system a x = b
+     * @throws std::invalid_argument if a is not square or b has the wrong dimension
+     * @throws std::runtime_error if a is singular
+     */
+    cx_vector solve(const cx_matrix& a, const cx_vector& b);
+    /** @brief Double precision solve */
+    cxd_vector solve(const cxd_matrix& a, const cxd_vector& b);
+    /** @brief Solve the linear systems a X = b, one per column of b (see above) */
+    cx_matrix solve(const cx_matrix& a, const cx_matrix& b);
+    /** @brief Double precision solve */
+    cxd_matrix solve(const cxd_matrix& a, const cxd_matrix& b);
+
+    /** @brief Determinant of a square matrix
+     * @throws std::invalid_argument if a is not square
+     */
+    cx det(const cx_matrix& a);
+    /** @brief Double precision det */
+    cxd det(const cxd_matrix& a);
+    /** @brief Inverse of a square matrix
+     * @throws std::invalid_argument if a is not square
+     * @throws std::runtime_error if a is singular
+     */
+    cx_matrix inverse(const cx_matrix& a);
+    /** @brief Double precision inverse */
+    cxd_matrix inverse(const cxd_matrix& a);
+
+    /**
+     * @brief Cholesky decomposition of a Hermitian positive-definite matrix, A = L L^H
+     *
+     * Only the lower triangle of the matrix is read. The factorization is
+     * blocked like basic_cx_lu: each diagonal block is factored directly,
+     * the panel below it is obtained with a triangular solve on its adjoint
+     * (column chunks in parallel) and the trailing submatrix is updated with
+     * gemm, one block column at a time so that only its lower triangle is
+     * computed. It needs no pivoting and about half the flops of LU.
+     *
+     * update() and downdate() turn the factor of A into the factor of
+     * A + x x^H or A - x x^H with n Givens rotations, in O(n^2) instead of
+     * the O(n^3) of a new factorization, e.g. to track a covariance matrix
+     * as samples arrive.
+     *
+     * @tparam T Precision (float or double)
+     */
+    template <typename T>
+    class basic_cx_cholesky
+    {
+    public:
+        /** @brief Element type */
+        using cx = basic_cx<T>;
+
+    private:
+        basic_cx_matrix<T> __factors__;  ///< L on and below the diagonal (real and positive), zeros above it
+
+        /** @brief Factor __factors__ in place */
+        void factor();
+
+    public:
+        /** @brief Factor a Hermitian positive-definite matrix
+         * @throws std::invalid_argument if the matrix is not square
+         * @throws std::runtime_error if the matrix is not positive definite
+         */
+        explicit basic_cx_cholesky(const basic_cx_matrix<T>&);
+        /** @brief Factor a Hermitian positive-definite matrix in its own storage */
+        explicit basic_cx_cholesky(basic_cx_matrix<T>&&);
+
+        /** @brief Order of the matrix */
+        size_t size() const noexcept { return __factors__.rows(); }
+        /** @brief Lower triangular factor L */
+        const basic_cx_matrix<T>& lower() const noexcept { return __factors__; }
+        /** @brief Upper triangular factor L^H */
+        basic_cx_matrix<T> upper() const;
+
+        /** @brief Solve A x = b
+         * @throws std::invalid_argument if b has the wrong dimension
+         */
+        basic_cx_vector<T> solve(const basic_cx_vector<T>&) const;
+        /** @brief Solve A X = B, one column of X per column of B
+         * @throws std::invalid_argument if B has the wrong number of rows
+         */
+        basic_cx_matrix<T> solve(const basic_cx_matrix<T>&) const;
+        /** @brief Inverse of the factored matrix */
+        basic_cx_matrix<T> inverse() const;
+        /** @brief Determinant of the factored matrix, the product of the squared diagonal of L */
+        T det() const noexcept;
+
+        /** @brief Rank-1 update: become the factor of A + x x^H
+         * @throws std::invalid_argument if x has the wrong dimension
+         */
+        void update(const basic_cx_vector<T>& x);
+        /** @brief Rank-1 downdate: become the factor of A - x x^H
+         * @throws std::invalid_argument if x has the wrong dimension
+         * @throws std::runtime_error if A - x x^H is not positive definite (the factor is left unchanged)
+         */
+        void downdate(const basic_cx_vector<T>& x);
+    };
+
+    /** @brief Single precision Cholesky decomposition */
+    using cx_cholesky = basic_cx_cholesky<float>;
+    /** @brief Double precision Cholesky decomposition */
+    using cxd_cholesky = basic_cx_cholesky<double>;
+
+    /** @brief Cholesky decomposition of a Hermitian positive-definite matrix (see basic_cx_cholesky)
+     * @throws std::invalid_argument if the matrix is not square
+     * @throws std::runtime_error if the matrix is not positive definite
+     */
+    cx_cholesky cholesky(const cx_matrix& a);
+    /** @brief Double precision cholesky */
+    cxd_cholesky cholesky(const cxd_matrix& a);
+    /** @brief Cholesky decomposition overwriting the storage of an expiring matrix */
+    cx_cholesky cholesky(cx_matrix&& a);
+    /** @brief Double precision cholesky of an expiring matrix */
+    cxd_cholesky cholesky(cxd_matrix&& a);
+
+    /** @brief Solve A x = b with the Cholesky factor of A
+     * @throws std::invalid_argument if b has the wrong dimension
+     */
+    cx_vector cho_solve(const cx_cholesky& c, const cx_vector& b);
+    /** @brief Double precision cho_solve */
+    cxd_vector cho_solve(const cxd_cholesky& c, const cxd_vector& b);
+    /** @brief Solve A X = B with the Cholesky factor of A, one column of X per column of B (see above) */
+    cx_matrix cho_solve(const cx_cholesky& c, const cx_matrix& b);
+    /** @brief Double precision cho_solve */
+    cxd_matrix cho_solve(const cxd_cholesky& c, const cxd_matrix& b);
+
+    /**
+     * @brief Householder QR decomposition, A = Q R
+     *
+     * Q is the product H_0 H_1 ... H_{k-1} of k = min(rows, cols)
+     * Householder reflections H_i = I - tau_i v_i v_i^H, kept in compact WY
+     * form: every panel of columns is represented as I - V T V^H, with T
+     * upper triangular, so that applying it to the rest of the matrix (or
+     * to a right-hand side) takes three matrix multiplies through gemm.
+     * Inside a panel the columns are factored recursively, half by half,
+     * which moves most of the panel work to gemm as well.
+     *
+     * R overwrites the upper triangle of a copy of the matrix and the
+     * vectors v_i (whose first entry is an implied 1) its strict lower
+     * triangle, like LAPACK's geqrf. The diagonal of R is real.
+     *
+     * @tparam T Precision (float or double)
+     */
+    template <typename T>
+    class basic_cx_qr
+    {
+    public:
+        /** @brief Element type */
+        using cx = basic_cx<T>;
+
+    private:
+        basic_cx_matrix<T> __factors__;  ///< R on and above the diagonal, Householder vectors below it
+        std::vector<cx> __tau__;         ///< Householder scalars, min(rows, cols) of them
+        std::vector<cx> __t__;           ///< Triangular factor T of each panel, one square block per panel
+
+        /** @brief Factor __factors__ in place */
+        void factor();
+        /** @brief Multiply the rows x cols row-major block b by Q^H (adjoint) or by Q */
+        void apply(bool adjoint, cx* b, size_t ldb, size_t cols) const;
+
+    public:
+        /** @brief Factor a matrix */
+        explicit basic_cx_qr(const basic_cx_matrix<T>&);
+        /** @brief Factor a matrix in its own storage */
+        explicit basic_cx_qr(basic_cx_matrix<T>&&);
+
+        /** @brief Rows of the factored matrix */
+        size_t rows() const noexcept { return __factors__.rows(); }
+        /** @brief Columns of the factored matrix */
+        size_t cols() const noexcept { return __factors__.cols(); }
+        /** @brief R and the Householder vectors packed in one matrix */
+        const basic_cx_matrix<T>& factors() const noexcept { return __factors__; }
+        /** @brief Householder scalars tau_i */
+        const std::vector<cx>& tau() const noexcept { return __tau__; }
+        /** @brief Thin Q: the first min(rows, cols) columns, with orthonormal columns */
+        basic_cx_matrix<T> q() const;
+        /** @brief Upper triangular (trapezoidal when rows < cols) min(rows, cols) x cols factor */
+        basic_cx_matrix<T> r() const;
+
+        /** @brief Q^H b, with the full rows x rows Q
+         * @throws std::invalid_argument if b has the wrong dimension
+         */
+        basic_cx_vector<T> apply_qh(const basic_cx_vector<T>&) const;
+        /** @brief Q^H B, with the full rows x rows Q (see above) */
+        basic_cx_matrix<T> apply_qh(const basic_cx_matrix<T>&) const;
+        /** @brief Q b, with the full rows x rows Q (see above) */
+        basic_cx_vector<T> apply_q(const basic_cx_vector<T>&) const;
+        /** @brief Q B, with the full rows x rows Q (see above) */
+        basic_cx_matrix<T> apply_q(const basic_cx_matrix<T>&) const;
+
+        /** @brief Least-squares solution of A x = b (minimizes |A x - b|)
+         * @throws std::invalid_argument if A has more columns than rows or b has the wrong dimension
+         * @throws std::runtime_error if A is rank deficient (a diagonal entry of R is zero)
+         */
+        basic_cx_vector<T> solve(const basic_cx_vector<T>&) const;
+        /** @brief Least-squares solution of A X = B, one column of X per column of B (see above) */
+        basic_cx_matrix<T> solve(const basic_cx_matrix<T>&) const;
+    };
+
+    /** @brief Single precision QR decomposition */
+    using cx_qr = basic_cx_qr<float>;
+    /** @brief Double precision QR decomposition */
+    using cxd_qr = basic_cx_qr<double>;
+
+    /** @brief QR decomposition of a matrix (see basic_cx_qr) */
+    cx_qr qr(const cx_matrix& a);
+    /** @brief Double precision qr */
+    cxd_qr qr(const cxd_matrix& a);
+    /** @brief QR decomposition overwriting the storage of an expiring matrix */
+    cx_qr qr(cx_matrix&& a);
+    /** @brief Double precision qr of an expiring matrix */
+    cxd_qr qr(cxd_matrix&& a);
+
+    /**
+     * @brief Least-squares solution of the overdetermined system a x = b
+     *
+     * Tall and skinny systems (many more rows than columns) are solved with
+     * TSQR: blocks of rows small enough to stay in cache are factored
+     * independently, in parallel when multithreading is enabled, and only
+     * their R factors (with the transformed right-hand sides) are stacked
+     * and factored again, until a single block is left. The matrix is never
+     * copied as a whole. Other systems go through basic_cx_qr.
+     *
+     * @throws std::invalid_argument if a has more columns than rows or b has the wrong dimension
+     * @throws std::runtime_error if a is rank deficient
+     */
+    cx_vector lstsq(const cx_matrix& a, const cx_vector& b);
+    /** @brief Double precision lstsq */
+    cxd_vector lstsq(const cxd_matrix& a, const cxd_vector& b);
+    /** @brief Least-squares solutions of a X = b, one per column of b (see above) */
+    cx_matrix lstsq(const cx_matrix& a, const cx_matrix& b);
+    /** @brief Double precision lstsq */
+    cxd_matrix lstsq(const cxd_matrix& a, const cxd_matrix& b);
+
+    /**
+     * @brief Orthonormal basis of the span of a set of vectors
+     *
+     * The k vectors are the columns of a Householder QR; the result is the
+     * thin Q, with the phases chosen so that R has a positive diagonal. For
+     * linearly independent vectors this is the Gram-Schmidt basis, computed
+     * stably; for dependent ones the result is still orthonormal.
+     *
+     * @throws std::invalid_argument if the set is empty, the dimensions
+     *         differ or there are more vectors than dimensions
+     */
+    std::vector<cx_vector> orthonormalize(const std::vector<cx_vector>& vectors);
+    /** @brief Double precision orthonormalize */
+    std::vector<cxd_vector> orthonormalize(const std::vector<cxd_vector>& vectors);
+
+    /** @brief Part of the spectrum computed by eigh */
+    enum __cx_eig_range__
+    {
+        EIG_ALL,       ///< Every eigenvalue
+        EIG_SMALLEST,  ///< The count smallest eigenvalues
+        EIG_LARGEST    ///< The count largest eigenvalues
+    };
+
+    /**
+     * @brief Eigenvalues and eigenvectors of a Hermitian matrix
+     *
+     * The matrix is reduced to a real symmetric tridiagonal one with
+     * blocked Householder transformations: the reflections of each panel
+     * are accumulated and applied to the rest of the matrix as a rank-2k
+     * update through gemm, and the matrix-vector products of the panel are
+     * split across threads. The whole spectrum of the tridiagonal matrix is
+     * then computed by divide and conquer (cuppen's method with deflation
+     * and Gu-Eisenstat eigenvectors), while a range of eigenvalues is
+     * found by bisection and its eigenvectors by inverse iteration, so
+     * asking for a few eigenpairs skips most of the work. The tridiagonal
+     * problem is solved in double precision; the eigenvectors are brought
+     * back with the compact WY form of the Householder reflections.
+     *
+     * Only the lower triangle (and the real part of the diagonal) of the
+     * matrix is read; the upper triangle is assumed to be its conjugate.
+     *
+     * @tparam T Precision (float or double)
+     */
+    template <typename T>
+    class basic_cx_eigh
+    {
+    private:
+        std::vector<T> __values__;                    ///< Eigenvalues, ascending
+        std::vector<basic_cx_vector<T>> __vectors__;  ///< Unit eigenvectors, in the order of the eigenvalues
+
+    public:
+        /** @brief Compute the eigenvalues (and eigenvectors) of a Hermitian matrix
+         * @param a Hermitian matrix
+         * @param range Part of the spectrum to compute
+         * @param count Number of eigenvalues for EIG_SMALLEST and EIG_LARGEST (ignored with EIG_ALL)
+         * @param vectors Whether to compute the eigenvectors too
+         * @throws std::invalid_argument if a is not square or count is 0 or larger than its order
+         */
+        explicit basic_cx_eigh(const basic_cx_matrix<T>& a, __cx_eig_range__ range = EIG_ALL,
+                               size_t count = 0, bool vectors = true);
+
+        /** @brief Number of eigenpairs computed */
+        size_t size() const noexcept { return __values__.size(); }
+        /** @brief Eigenvalues in ascending order */
+        const std::vector<T>& values() const noexcept { return __values__; }
+        /** @brief Eigenvectors, vectors()[i] belonging to values()[i] (empty if not computed) */
+        const std::vector<basic_cx_vector<T>>& vectors() const noexcept { return __vectors__; }
+    };
+
+    /** @brief Single precision Hermitian eigendecomposition */
+    using cx_eigh = basic_cx_eigh<float>;
+    /** @brief Double precision Hermitian eigendecomposition */
+    using cxd_eigh = basic_cx_eigh<double>;
+
+    /** @brief Eigenvalues and eigenvectors of a Hermitian matrix (see basic_cx_eigh) */
+    cx_eigh eigh(const cx_matrix& a, __cx_eig_range__ range = EIG_ALL, size_t count = 0);
+    /** @brief Double precision eigh */
+    cxd_eigh eigh(const cxd_matrix& a, __cx_eig_range__ range = EIG_ALL, size_t count = 0);
+    /** @brief Eigenvalues of a Hermitian matrix in ascending order, without the eigenvectors */
+    std::vector<float> eigvalsh(const cx_matrix& a, __cx_eig_range__ range = EIG_ALL, size_t count = 0);
+    /** @brief Double precision eigvalsh */
+    std::vector<double> eigvalsh(const cxd_matrix& a, __cx_eig_range__ range = EIG_ALL, size_t count = 0);
+
+    /**
+     * @brief Singular value decomposition A = U S V^H of a complex matrix
+     *
+     * The full (thin) decomposition factors tall matrices with QR first,
+     * reduces the square factor to a real bidiagonal matrix with blocked
+     * Householder transformations (each panel applied to the rest of the
+     * matrix with gemm) and diagonalizes it with the implicit shifted QR
+     * iteration of Golub and Kahan, in double precision. Wide matrices are
+     * handled through their adjoint.
+     *
+     * truncated() computes only the leading singular triplets with the
+     * randomized range finder of Halko, Martinsson and Tropp: A is applied
+     * to a random block of rank + oversampling vectors (plus a few power
+     * iterations with A^H A for slowly decaying spectra), the result is
+     * orthonormalized by QR, and the small projected matrix Q^H A is
+     * decomposed exactly. The work is a handful of gemm calls, O(m n k)
+     * instead of O(m n min(m, n)).
+     *
+     * @tparam T Precision (float or double)
+     */
+    template <typename T>
+    class basic_cx_svd
+    {
+    public:
+        /** @brief Element type */
+        using cx = basic_cx<T>;
+
+    private:
+        size_t __rows__ = 0;                     ///< Rows of the decomposed matrix
+        size_t __cols__ = 0;                     ///< Columns of the decomposed matrix
+        std::vector<T> __values__;               ///< Singular values, descending
+        std::vector<basic_cx_vector<T>> __u__;   ///< Left singular vectors, one per singular value
+        std::vector<basic_cx_vector<T>> __v__;   ///< Right singular vectors, one per singular value
+
+        basic_cx_svd() = default;
+
+    public:
+        /** @brief Thin SVD: min(rows, cols) singular values (and vectors) of a
+         * @param a Matrix to decompose
+         * @param vectors Whether to compute the singular vectors too
+         * @throws std::runtime_error if the QR iteration does not converge
+         */
+        explicit basic_cx_svd(const basic_cx_matrix<T>& a, bool vectors = true);
+
+        /** @brief Randomized SVD of the rank leading singular triplets
+         * @param a Matrix to decompose
+         * @param rank Number of singular triplets to return
+         * @param oversampling Extra random vectors, which make the leading subspace more accurate
+         * @param power_iterations Applications of A^H A to the random block, for slowly decaying singular values
+         * @throws std::invalid_argument if rank is 0 or larger than min(rows, cols)
+         */
+        static basic_cx_svd truncated(const basic_cx_matrix<T>& a, size_t rank,
+                                      size_t oversampling = 10, size_t power_iterations = 2);
+
+        /** @brief Rows of the decomposed matrix */
+        size_t rows() const noexcept { return __rows__; }
+        /** @brief Columns of the decomposed matrix */
+        size_t cols() const noexcept { return __cols__; }
+        /** @brief Number of singular triplets */
+        size_t size() const noexcept { return __values__.size(); }
+        /** @brief Singular values in descending order */
+        const std::vector<T>& values() const noexcept { return __values__; }
+        /** @brief Left singular vectors, u()[i] belonging to values()[i] (empty if not computed) */
+        const std::vector<basic_cx_vector<T>>& u() const noexcept { return __u__; }
+        /** @brief Right singular vectors, v()[i] belonging to values()[i] (empty if not computed) */
+        const std::vector<basic_cx_vector<T>>& v() const noexcept { return __v__; }
+
+        /** @brief U S V^H with the computed triplets: A itself, or its best rank size() approximation
+         * @throws std::runtime_error if the singular vectors were not computed
+         */
+        basic_cx_matrix<T> reconstruct() const;
+    };
+
+    /** @brief Single precision SVD */
+    using cx_svd = basic_cx_svd<float>;
+    /** @brief Double precision SVD */
+    using cxd_svd = basic_cx_svd<double>;
+
+    /** @brief Thin SVD of a matrix (see basic_cx_svd) */
+    cx_svd svd(const cx_matrix& a);
+    /** @brief Double precision svd */
+    cxd_svd svd(const cxd_matrix& a);
+    /** @brief Singular values of a matrix in descending order, without the singular vectors */
+    std::vector<float> svdvals(const cx_matrix& a);
+    /** @brief Double precision svdvals */
+    std::vector<double> svdvals(const cxd_matrix& a);
+    /** @brief Randomized SVD of the rank leading singular triplets (see basic_cx_svd::truncated) */
+    cx_svd svd_truncated(const cx_matrix& a, size_t rank, size_t oversampling = 10, size_t power_iterations = 2);
+    /** @brief Double precision svd_truncated */
+    cxd_svd svd_truncated(const cxd_matrix& a, size_t rank, size_t oversampling = 10, size_t power_iterations = 2);
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef CX_MEMORY_H
+#define CX_MEMORY_H
+
+#include <cstddef>
+#include <new>
+#include <limits>
+
+namespace cx_lib
+{
+    /** @brief Alignment (in bytes) used for the contiguous buffers of the library */
+    constexpr std::size_t __cx_buffer_alignment__ = 64;
+
+    /**
+     * @brief Minimal allocator returning storage aligned to a cache line
+     *
+     * Used as the allocator of the flat buffers backing matrices, so that the
+     * first element of every buffer starts on a cache line boundary and can be
+     * loaded with aligned SIMD instructions.
+     */
+    template <typename T, std::size_t Align = __cx_buffer_alignment__>
+    struct cx_aligned_allocator
+    {
+        using value_type = T;
+
+        template <typename U>
+        struct rebind { using other = cx_aligned_allocator<U, Align>; };
+
+        cx_aligned_allocator() noexcept = default;
+        template <typename U>
+        cx_aligned_allocator(const cx_aligned_allocator<U, Align>&) noexcept { }
+
+        /** @brief Allocate room for n objects, aligned to Align bytes
+         * @throws std::bad_alloc if the request can't be satisfied
+         */
+        T* allocate(std::size_t n)
+        {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+                throw std::bad_alloc();
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+        }
+
+        /** @brief Release storage obtained from allocate() */
+        void deallocate(T* p, std::size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t(Align));
+        }
+
+        template <typename U>
+        bool operator ==(const cx_aligned_allocator<U, Align>&) const noexcept { return true; }
+        template <typename U>
+        bool operator !=(const cx_aligned_allocator<U, Align>&) const noexcept { return false; }
+    };
+}
+
+#endif
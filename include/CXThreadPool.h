@@ -0,0 +1,154 @@
+#ifndef CX_THREAD_POOL_H
+#define CX_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cx_lib
+{
+    /** @brief Global flag for enabling/disabling multithreading (tensor, matrix and vector products)*/
+    extern std::atomic<bool> __cx_multithread_enabled__;
+
+    /** @brief Enable or disable multithreading for operations
+     * @param enable True to enable, false to disable
+     */
+    void enable_multithreading(bool enable) noexcept;
+
+    /**
+     * @brief Library-owned pool of persistent worker threads
+     *
+     * The pool is created lazily on the first parallel call and reused by
+     * every parallel kernel of the library, so a call only pays for waking
+     * the workers instead of spawning and joining threads. The calling thread
+     * always takes part in the work, hence a pool of size n owns n - 1 workers.
+     *
+     * Parallel calls issued from inside a task (on a worker or on the thread
+     * that submitted the job), or while another thread is already using the
+     * pool, run inline on the calling thread.
+     */
+    class cx_thread_pool
+    {
+    private:
+        std::vector<std::thread> workers;               ///< Worker threads (size() - 1 of them)
+        std::atomic<size_t> __size__{0};                ///< Requested parallelism (0 = hardware concurrency)
+        std::atomic<bool> __pinned__{false};            ///< Whether workers are pinned to cores
+
+        std::mutex submit_mutex;                        ///< Serializes jobs submitted to the pool
+        std::mutex state_mutex;                         ///< Protects the job state below
+        std::condition_variable work_cv;                ///< Signals workers that a job is available
+        std::condition_variable done_cv;                ///< Signals the submitter that workers are done
+        const std::function<void(size_t)>* job = nullptr; ///< Task of the current job
+        size_t job_tasks = 0;                           ///< Number of tasks in the current job
+        std::atomic<size_t> next_task{0};               ///< Next task index to be claimed
+        size_t active_workers = 0;                      ///< Workers that haven't finished the current job
+        uint64_t generation = 0;                        ///< Incremented for every job
+        bool stopping = false;                          ///< Set when workers must exit
+        std::exception_ptr error;                       ///< First exception thrown by a task
+
+        cx_thread_pool() = default;
+
+        /** @brief Stop and join the workers (submit_mutex must be held) */
+        void shutdown_locked();
+        /** @brief Spawn the workers if they are not running */
+        void start();
+        /** @brief Body of every worker thread, waiting for the jobs after generation seen */
+        void worker_loop(uint64_t seen);
+        /** @brief Claim and execute tasks of the current job until none is left */
+        void drain() noexcept;
+        /** @brief Pin a worker to a core (no-op where unsupported) */
+        void pin(std::thread&, size_t core) noexcept;
+
+    public:
+        cx_thread_pool(const cx_thread_pool&) = delete;
+        cx_thread_pool& operator =(const cx_thread_pool&) = delete;
+        /** @brief Joins the workers */
+        ~cx_thread_pool();
+
+        /** @brief Get the process-wide pool */
+        static cx_thread_pool& instance();
+
+        /** @brief Set the number of threads used by parallel kernels (0 = hardware concurrency)
+         * @note Running workers are stopped and respawned lazily with the new size.
+         */
+        void resize(size_t);
+        /** @brief Get the number of threads used by parallel kernels, caller included */
+        size_t size() const noexcept;
+        /** @brief Pin (or unpin) worker i to core i, round robin over the available cores */
+        void set_affinity(bool);
+        /** @brief Whether workers are pinned to cores */
+        bool affinity() const noexcept;
+        /** @brief Stop and join all workers; they are respawned on the next parallel call */
+        void shutdown();
+
+        /** @brief Whether the calling thread is one of the pool workers */
+        static bool in_worker() noexcept;
+        /** @brief Whether the calling thread is running tasks of a job, as a worker or as its submitter */
+        static bool in_parallel_region() noexcept;
+
+        /** @brief Run task(0) ... task(num_tasks - 1) on the pool and wait for completion
+         * @throws Rethrows the first exception thrown by a task
+         */
+        void run(size_t, const std::function<void(size_t)>&);
+    };
+
+    /** @brief Set the number of threads used by parallel kernels (0 = hardware concurrency) */
+    void set_num_threads(size_t);
+    /** @brief Get the number of threads used by parallel kernels */
+    size_t get_num_threads() noexcept;
+    /** @brief Pin (or unpin) the pool workers to cores */
+    void set_thread_affinity(bool);
+    /** @brief Stop the pool workers (they are respawned lazily) */
+    void shutdown_thread_pool();
+
+    /**
+     * @brief Parallel loop over [begin, end)
+     *
+     * Splits the range into contiguous chunks of at least grain items and
+     * calls fn(chunk_begin, chunk_end) on each of them through the thread
+     * pool. Runs fn(begin, end) inline when multithreading is disabled or
+     * the range is too small to be worth splitting.
+     *
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Minimum number of items per chunk
+     * @param fn Callable taking (size_t chunk_begin, size_t chunk_end)
+     */
+    template <typename F>
+    void parallel_for(size_t begin, size_t end, size_t grain, F&& fn)
+    {
+        if (end <= begin)
+            return;
+
+        size_t count = end - begin;
+        size_t chunks = 1;
+        if (__cx_multithread_enabled__ && !cx_thread_pool::in_parallel_region())
+        {
+            // A few chunks per thread let faster threads pick up the slack.
+            size_t threads = cx_thread_pool::instance().size();
+            if (threads > 1)
+                chunks = std::min(4 * threads, count / (grain ? grain : 1));
+        }
+
+        if (chunks <= 1)
+        {
+            fn(begin, end);
+            return;
+        }
+
+        cx_thread_pool::instance().run(chunks, [&](size_t t) {
+            size_t start = begin + (count * t) / chunks;
+            size_t stop = begin + (count * (t + 1)) / chunks;
+            fn(start, stop);
+        });
+    }
+}
+
+#endif
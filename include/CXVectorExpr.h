@@ -0,0 +1,156 @@
+#ifndef CX_VECTOR_EXPR_H
+#define CX_VECTOR_EXPR_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "ComplexNumber.h"
+#include "CXElementwise.h"
+
+namespace cx_lib
+{
+    template <typename T>
+    class basic_cx_vector;
+
+    /**
+     * @brief Base of the lazy cx_vector expressions
+     *
+     * a + b * s - c does not compute anything: it builds a tree of
+     * expression nodes, and the whole tree is evaluated in a single loop
+     * when it is assigned to (or used to construct) a cx_vector. Vectors
+     * are held by reference and nested nodes by value, so an expression
+     * must not outlive the vectors it reads (e.g. do not keep one in an
+     * `auto` variable past the lifetime of its operands).
+     *
+     * @tparam E Concrete expression (CRTP)
+     */
+    template <typename E>
+    struct cx_vector_expr
+    {
+        /** @brief The concrete expression */
+        const E& self() const noexcept { return static_cast<const E&>(*this); }
+    };
+
+    /** @brief How an expression node stores its operand: vectors by reference, nodes by value */
+    template <typename E>
+    struct cx_vector_operand { using type = const E; };
+    /** @copydoc cx_vector_operand */
+    template <typename T>
+    struct cx_vector_operand<basic_cx_vector<T>> { using type = const basic_cx_vector<T>&; };
+
+    /** @brief Element-wise Op(l[i], r[i]) of two expressions of the same dimension */
+    template <typename L, typename R, typename Op>
+    class cx_vector_binary : public cx_vector_expr<cx_vector_binary<L, R, Op>>
+    {
+    public:
+        /** @brief Element type */
+        using cx = typename L::cx;
+        static_assert(std::is_same<cx, typename R::cx>::value, "cx_vector expressions must have the same precision");
+
+        /** @throws std::runtime_error if the dimensions differ */
+        cx_vector_binary(const L& l, const R& r)
+            : __l__(l), __r__(r)
+        {
+            if (l.dim() != r.dim())
+                throw std::runtime_error("Dimensions don't match.");
+        }
+
+        /** @brief Number of elements */
+        size_t dim() const noexcept { return __l__.dim(); }
+        /** @brief Element i of the result */
+        cx operator [](size_t i) const noexcept { return Op()(__l__[i], __r__[i]); }
+
+        /** @brief Write the result to out[0, dim()) */
+        void eval(cx* out) const
+        {
+            // Two plain vectors go through the SIMD span kernel of Op.
+            if constexpr (std::is_same<L, basic_cx_vector<typename cx::value_type>>::value &&
+                          std::is_same<R, L>::value && cx_has_span_kernel<Op, cx>::value)
+            {
+                if (dim() > 0)
+                    Op::span(dim(), &__l__[0], &__r__[0], out);
+            }
+            else
+            {
+                for (size_t i = 0; i < dim(); i++)
+                    out[i] = (*this)[i];
+            }
+        }
+
+    private:
+        typename cx_vector_operand<L>::type __l__;
+        typename cx_vector_operand<R>::type __r__;
+    };
+
+    /** @brief e[i] * s for an expression e and a complex scalar s */
+    template <typename E>
+    class cx_vector_scaled : public cx_vector_expr<cx_vector_scaled<E>>
+    {
+    public:
+        /** @brief Element type */
+        using cx = typename E::cx;
+
+        cx_vector_scaled(const E& e, const cx& s)
+            : __e__(e), __s__(s)
+        {
+        }
+
+        /** @brief Number of elements */
+        size_t dim() const noexcept { return __e__.dim(); }
+        /** @brief Element i of the result */
+        cx operator [](size_t i) const noexcept { return __e__[i] * __s__; }
+
+        /** @brief Write the result to out[0, dim()) */
+        void eval(cx* out) const
+        {
+            if constexpr (std::is_same<E, basic_cx_vector<typename cx::value_type>>::value)
+            {
+                if (dim() > 0)
+                    kernels::scale(dim(), __s__, &__e__[0], out);
+            }
+            else
+            {
+                for (size_t i = 0; i < dim(); i++)
+                    out[i] = (*this)[i];
+            }
+        }
+
+    private:
+        typename cx_vector_operand<E>::type __e__;
+        cx __s__;
+    };
+
+    /** @brief Lazy element-wise sum
+     * @throws std::runtime_error if the dimensions differ
+     */
+    template <typename L, typename R>
+    cx_vector_binary<L, R, cx_add_op> operator +(const cx_vector_expr<L>& a, const cx_vector_expr<R>& b)
+    {
+        return cx_vector_binary<L, R, cx_add_op>(a.self(), b.self());
+    }
+
+    /** @brief Lazy element-wise difference
+     * @throws std::runtime_error if the dimensions differ
+     */
+    template <typename L, typename R>
+    cx_vector_binary<L, R, cx_sub_op> operator -(const cx_vector_expr<L>& a, const cx_vector_expr<R>& b)
+    {
+        return cx_vector_binary<L, R, cx_sub_op>(a.self(), b.self());
+    }
+
+    /** @brief Lazy multiplication by a complex scalar */
+    template <typename E>
+    cx_vector_scaled<E> operator *(const cx_vector_expr<E>& a, const typename E::cx& s) noexcept
+    {
+        return cx_vector_scaled<E>(a.self(), s);
+    }
+
+    /** @brief Lazy multiplication by a real scalar */
+    template <typename E>
+    cx_vector_scaled<E> operator *(const cx_vector_expr<E>& a, typename E::cx::value_type s) noexcept
+    {
+        return cx_vector_scaled<E>(a.self(), typename E::cx(s, 0));
+    }
+}
+
+#endif
@@ -5,48 +5,154 @@
 #include <stdexcept>
 #include <vector>
 #include <ostream>
+#include <type_traits>
+#include <algorithm>
 #include "ComplexNumber.h"
 #include "ComplexVector.h"
+#include "CXMemory.h"
 
 namespace cx_lib
 {
+    /**
+     * @brief Non-owning strided view over a sequence of complex numbers
+     *
+     * Used to expose a row (or a column) of a cx_matrix without copying it.
+     * The view is only valid as long as the matrix it refers to is alive
+     * and is not resized.
+     *
+     * @tparam T cx, const cx, cxd or const cxd
+     */
+    template <typename T>
+    class cx_strided_view
+    {
+    private:
+        T* ptr = nullptr;      ///< Pointer to the first element
+        size_t len = 0;        ///< Number of elements
+        size_t step = 1;       ///< Distance (in elements) between consecutive entries
+
+    public:
+        /** @brief Construct a view over len elements starting at ptr, step elements apart */
+        cx_strided_view(T* __ptr, size_t __len, size_t __step = 1) noexcept
+            : ptr(__ptr), len(__len), step(__step) { }
+        /** @brief Allow conversion from a mutable view to a read-only one */
+        template <typename U, typename = std::enable_if_t<std::is_same<const U, T>::value && !std::is_same<U, T>::value>>
+        cx_strided_view(const cx_strided_view<U>& obj) noexcept
+            : ptr(obj.data()), len(obj.dim()), step(obj.stride()) { }
+
+        /** @brief Element access (no bounds checking) */
+        T& operator [](size_t index) const noexcept { return ptr[index * step]; }
+        /** @brief Safe element access with bounds checking
+         * @throws std::runtime_error if index is invalid
+         */
+        T& at(size_t index) const
+        {
+            if (index >= len)
+                throw std::runtime_error("Index out of range.");
+            return ptr[index * step];
+        }
+
+        /** @brief Get number of elements in the view */
+        size_t dim() const noexcept { return len; }
+        /** @brief Get distance (in elements) between consecutive entries */
+        size_t stride() const noexcept { return step; }
+        /** @brief Get pointer to the first element */
+        T* data() const noexcept { return ptr; }
+
+        /** @brief Owning vector type with the precision of the elements */
+        using vector_type = basic_cx_vector<typename std::remove_const_t<T>::value_type>;
+
+        /** @brief Materialize the view into an owning vector */
+        vector_type to_vector() const
+        {
+            std::vector<std::remove_const_t<T>> vec(len);
+            for (size_t i = 0; i < len; i++)
+                vec[i] = ptr[i * step];
+            return vector_type(vec);
+        }
+        /** @brief Implicit conversion to an owning vector */
+        operator vector_type() const { return to_vector(); }
+
+        /** @brief Stream output operator */
+        friend std::ostream& operator <<(std::ostream& os, const cx_strided_view& obj)
+        {
+            bool print_all = (obj.dim() <= 10);
+            os << "[";
+            for (size_t i = 0; i < std::min(obj.dim(), size_t(10)); i++)
+            {
+                os << obj[i];
+                if (i < obj.dim() - 1)
+                    os << ", ";
+            }
+            if (!print_all)
+                os << " ...";
+            os << "]";
+            return os;
+        }
+    };
+
+    /** @brief Mutable view over a row of a cx_matrix */
+    using cx_row_view = cx_strided_view<cx>;
+    /** @brief Read-only view over a row of a cx_matrix */
+    using cx_const_row_view = cx_strided_view<const cx>;
+
     /**
      * @brief Complex matrix class for mathematical operations
      * 
+     * Elements are stored in a single contiguous, cache-line aligned buffer
+     * in row-major order; element (i, j) lives at i * row_stride() + j * col_stride().
+     *
      * Provides functionality for:
      * - Basic matrix operations (+, -, *)  
      * - Matrix-vector operations
      * - Element access and modification
      * - Matrix transformations
+     *
+     * cx_matrix stores single precision elements and cxd_matrix double
+     * precision ones.
      */
-    class cx_matrix
+    template <typename T>
+    class basic_cx_matrix
     {
+    public:
+        /** @brief Element type (cx in cx_matrix, cxd in cxd_matrix) */
+        using cx = basic_cx<T>;
+        /** @brief Mutable view over a row or a column */
+        using row_view = cx_strided_view<cx>;
+        /** @brief Read-only view over a row or a column */
+        using const_row_view = cx_strided_view<const cx>;
+
     private:
-        std::vector<cx_vector> mat; ///< Storage for matrix rows as complex vectors
+        std::vector<cx, cx_aligned_allocator<cx>> buf; ///< Contiguous row-major storage
+        size_t __rows__ = 0;                           ///< Number of rows
+        size_t __cols__ = 0;                           ///< Number of columns
+        size_t __row_stride__ = 0;                     ///< Distance (in elements) between two rows
+        size_t __col_stride__ = 1;                     ///< Distance (in elements) between two columns
 
     public:
         /** @brief Default constructor creating empty matrix */
-        cx_matrix()  = default;
+        basic_cx_matrix()  = default;
         /** @brief Default destructor */
-        ~cx_matrix() = default;
+        ~basic_cx_matrix() = default;
         /** @brief Construct matrix with dimensions and fill value
          * @param rows Number of rows
          * @param cols Number of columns
          * @param value Value to fill matrix with
          */
-        cx_matrix(size_t, size_t, const cx&);
+        basic_cx_matrix(size_t, size_t, const cx&);
         /** @brief Construct from 2D vector of complex numbers
          * @param mat 2D vector to initialize from
          */
-        cx_matrix(const std::vector<std::vector<cx>>&);
+        basic_cx_matrix(const std::vector<std::vector<cx>>&);
         /** @brief Construct from vector of complex vectors
          * @param vecs Vector of complex vectors representing rows
          */
-        cx_matrix(const std::vector<cx_vector>&);
+        basic_cx_matrix(const std::vector<basic_cx_vector<T>>&);
         /** @brief Copy constructor
          * @param other Matrix to copy
          */
-        cx_matrix(const cx_matrix&) noexcept;
+        basic_cx_matrix(const basic_cx_matrix&) noexcept;
+        /** @brief Move constructor (leaves other empty) */
+        basic_cx_matrix(basic_cx_matrix&&) noexcept;
 
         /** @brief Access element with parentheses operator
          * @param i Row index
@@ -55,10 +161,10 @@ namespace cx_lib
         cx& operator ()(size_t, size_t) noexcept;
         /** @brief Const access element with parentheses operator */
         const cx& operator()(size_t, size_t) const noexcept;
-        /** @brief Access row with subscript operator */
-        cx_vector& operator[](size_t) noexcept;
-        /** @brief Const access row with subscript operator */
-        const cx_vector& operator[](size_t) const noexcept;
+        /** @brief Access row with subscript operator (non-owning view) */
+        row_view operator[](size_t) noexcept;
+        /** @brief Const access row with subscript operator (non-owning view) */
+        const_row_view operator[](size_t) const noexcept;
         /** @brief Safe element access with bounds checking
          * @throws std::out_of_range if indices invalid
          */
@@ -67,15 +173,41 @@ namespace cx_lib
         const cx& at(size_t, size_t) const;
 
         /** @brief Copy assignment operator */
-        cx_matrix& operator =(const cx_matrix&) noexcept;
+        basic_cx_matrix& operator =(const basic_cx_matrix&) noexcept;
+        /** @brief Move assignment operator (leaves other empty) */
+        basic_cx_matrix& operator =(basic_cx_matrix&&) noexcept;
         /** @brief Matrix addition operator */
-        cx_matrix operator +(const cx_matrix&) const;
+        basic_cx_matrix operator +(const basic_cx_matrix&) const&;
+        /** @brief Matrix addition reusing the storage of an expiring left operand */
+        basic_cx_matrix operator +(const basic_cx_matrix&) &&;
         /** @brief Matrix subtraction operator */
-        cx_matrix operator -(const cx_matrix&) const;
+        basic_cx_matrix operator -(const basic_cx_matrix&) const&;
+        /** @brief Matrix subtraction reusing the storage of an expiring left operand */
+        basic_cx_matrix operator -(const basic_cx_matrix&) &&;
+        /** @brief In-place matrix addition
+         * @throws std::invalid_argument if dimensions mismatch
+         */
+        basic_cx_matrix& operator +=(const basic_cx_matrix&);
+        /** @brief In-place matrix subtraction
+         * @throws std::invalid_argument if dimensions mismatch
+         */
+        basic_cx_matrix& operator -=(const basic_cx_matrix&);
+        /** @brief In-place multiplication by a complex scalar */
+        basic_cx_matrix& operator *=(const cx&) noexcept;
+        /** @brief In-place multiplication by a real scalar */
+        basic_cx_matrix& operator *=(T) noexcept;
+        /** @brief this += alpha * x, in place
+         * @throws std::invalid_argument if dimensions mismatch
+         */
+        basic_cx_matrix& axpy(const cx& alpha, const basic_cx_matrix& x);
+        /** @brief this = alpha * x + beta * this, in place
+         * @throws std::invalid_argument if dimensions mismatch
+         */
+        basic_cx_matrix& axpby(const cx& alpha, const basic_cx_matrix& x, const cx& beta);
         /** @brief Equality comparison operator */
-        bool operator ==(const cx_matrix&) const noexcept;
+        bool operator ==(const basic_cx_matrix&) const noexcept;
         /** @brief Inequality comparison operator */
-        bool operator !=(const cx_matrix&) const noexcept;
+        bool operator !=(const basic_cx_matrix&) const noexcept;
 
         /** @brief Get number of rows */
         size_t rows() const noexcept;
@@ -83,17 +215,36 @@ namespace cx_lib
         size_t cols() const noexcept;
         /** @brief Get matrix dimensions as (rows, cols) */
         std::pair<size_t, size_t> dim() const noexcept;
+        /** @brief Get distance (in elements) between two consecutive rows */
+        size_t row_stride() const noexcept;
+        /** @brief Get distance (in elements) between two consecutive columns */
+        size_t col_stride() const noexcept;
+        /** @brief Get pointer to the first element of the underlying buffer */
+        cx* data() noexcept;
+        /** @brief Get const pointer to the first element of the underlying buffer */
+        const cx* data() const noexcept;
         /** @brief Get specified column as vector */
-        cx_vector get_col(size_t) const;
+        basic_cx_vector<T> get_col(size_t) const;
+        /** @brief Get non-owning view over the specified column
+         * @throws std::runtime_error if index is invalid
+         */
+        const_row_view col_view(size_t) const;
 
         /** @brief Create identity matrix of given size */
-        static cx_matrix get_identity(size_t);
+        static basic_cx_matrix get_identity(size_t);
         /** @brief Get underlying vector representation */
-        std::vector<cx_vector> get() noexcept;
+        std::vector<basic_cx_vector<T>> get() noexcept;
 
-        /** @brief Stream output operator */
-        friend std::ostream& operator <<(std::ostream&, const cx_matrix&);
     };
+
+    /** @brief Stream output operator */
+    template <typename T>
+    std::ostream& operator <<(std::ostream&, const basic_cx_matrix<T>&);
+
+    /** @brief Matrix of single precision complex numbers */
+    using cx_matrix = basic_cx_matrix<float>;
+    /** @brief Matrix of double precision complex numbers */
+    using cxd_matrix = basic_cx_matrix<double>;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,90 +1,145 @@
 #ifndef COMPLEX_NUMBER_H
 #define COMPLEX_NUMBER_H
 
+#include <cmath>
 #include <ostream>
 #include <utility>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 
 namespace cx_lib
 {
+    /** @brief Throws the std::runtime_error raised by a division by zero
+     *
+     * Kept out of line so the inline division operators stay small enough
+     * to be inlined and vectorized.
+     */
+    [[noreturn]] void __cx_division_by_zero__();
+
     /**
      * @brief Complex number struct representing numbers in the form a + bi
+     *
+     * The precision of the parts is a template parameter: cx is the single
+     * precision instantiation used throughout the library, cxd the double
+     * precision one.
      * 
      * Provides basic complex number operations including:
      * - Arithmetic operations (+, -, *, /)
      * - Conversion to/from polar form
      * - Common complex functions (e.g. pow, modulus, conjugate)
      * - String parsing and formatting
+     *
+     * The arithmetic is defined inline (and constexpr where possible) so
+     * loops over cx values can be inlined and auto-vectorized.
      */
-    struct cx
+    template <typename T>
+    struct basic_cx
     {
-        float real;  ///< Real part of the complex number
-        float imag;  ///< Imaginary part of the complex number
+        static_assert(std::is_floating_point<T>::value, "basic_cx requires a floating point type");
+
+        using value_type = T;  ///< Type of the real and imaginary parts
+        /** @brief The complex type itself, so that cx names it inside the class */
+        using cx = basic_cx;
+
+        T real;  ///< Real part of the complex number
+        T imag;  ///< Imaginary part of the complex number
         
         /** @brief Default constructor initializing to 0 + 0i */
-        cx()  = default;
+        basic_cx()  = default;
         /** @brief Default destructor */
-        ~cx() = default;
+        ~basic_cx() = default;
         /** @brief Construct from real part, imaginary part set to 0 
          * @param r Real part value
          */
-        explicit cx(float r): real(r), imag(0) { }
+        constexpr explicit basic_cx(T r): real(r), imag(0) { }
         /** @brief Construct from real and imaginary parts
          * @param r Real part value
          * @param i Imaginary part value
          */
-        explicit cx(float r, float i): real(r), imag(i) { }
+        constexpr explicit basic_cx(T r, T i): real(r), imag(i) { }
         /** @brief Copy constructor 
          * @param obj Complex number to copy
          */
-        cx(const cx&) noexcept;
+        constexpr basic_cx(const basic_cx&) noexcept = default;
+        /** @brief Convert from another precision (rounding when narrowing)
+         * @param obj Complex number to convert
+         */
+        template <typename U, typename = std::enable_if_t<!std::is_same<T, U>::value>>
+        constexpr explicit basic_cx(const basic_cx<U>& obj) noexcept
+            : real(static_cast<T>(obj.real)), imag(static_cast<T>(obj.imag)) { }
         /** @brief Construct from pair (real, imaginary)
          * @param p Pair containing (real, imaginary) parts
          */
-        explicit cx(const std::pair<float, float>& p): real(p.first), imag(p.second) { }
+        constexpr explicit basic_cx(const std::pair<T, T>& p): real(p.first), imag(p.second) { }
 
         /** @brief Convert to std::pair(real, imaginary) */
-        explicit operator std::pair<float, float>() const noexcept;    
+        constexpr explicit operator std::pair<T, T>() const noexcept { return {real, imag}; }
         /** @brief Assignment operator */
-        cx& operator =(const cx&) noexcept = default;
+        constexpr cx& operator =(const cx&) noexcept = default;
         /** @brief Addition operator */
-        cx operator +(const cx&) const noexcept;
+        constexpr cx operator +(const cx& obj) const noexcept { return cx(real + obj.real, imag + obj.imag); }
         /** @brief Addition assignment operator */
-        cx& operator +=(const cx&) noexcept;
+        constexpr cx& operator +=(const cx& obj) noexcept
+        {
+            real += obj.real;
+            imag += obj.imag;
+            return *this;
+        }
         /** @brief Subtraction operator */
-        cx operator -(const cx&) const noexcept;
+        constexpr cx operator -(const cx& obj) const noexcept { return cx(real - obj.real, imag - obj.imag); }
         /** @brief Subtraction assignment operator */
-        cx& operator -=(const cx&) noexcept;
+        constexpr cx& operator -=(const cx& obj) noexcept
+        {
+            real -= obj.real;
+            imag -= obj.imag;
+            return *this;
+        }
         /** @brief Multiplication operator */
-        cx operator *(const cx&) const noexcept;
+        constexpr cx operator *(const cx& obj) const noexcept
+        {
+            return cx(real * obj.real - imag * obj.imag, real * obj.imag + imag * obj.real);
+        }
         /** @brief Multiplication assignment operator */
-        cx& operator *=(const cx&) noexcept;
+        constexpr cx& operator *=(const cx& obj) noexcept { return *this = *this * obj; }
+        /** @brief Division without the zero check
+         *
+         * Dividing by 0 + 0i follows IEEE float rules (inf/NaN parts) instead
+         * of throwing; meant for loops whose divisors are already validated.
+         */
+        constexpr cx div(const cx& obj) const noexcept
+        {
+            const T inv = T(1) / (obj.real * obj.real + obj.imag * obj.imag);
+            return cx((real * obj.real + imag * obj.imag) * inv, (imag * obj.real - real * obj.imag) * inv);
+        }
         /** @brief Division operator
          * @throws std::runtime_error if dividing by zero
          */
-        cx operator /(const cx&) const;
+        cx operator /(const cx& obj) const
+        {
+            if (obj.real == 0 && obj.imag == 0)
+                __cx_division_by_zero__();
+            return div(obj);
+        }
         /** @brief Division assignment operator
          * @throws std::runtime_error if dividing by zero
          */
-        cx& operator /=(const cx&);
-        /** @brief Stream output operator */
-        friend std::ostream& operator <<(std::ostream&, const cx&);
+        cx& operator /=(const cx& obj) { return *this = *this / obj; }
         /** @brief Equality comparison operator */
-        bool operator ==(const cx&) const noexcept;
+        constexpr bool operator ==(const cx& obj) const noexcept { return real == obj.real && imag == obj.imag; }
         /** @brief Inequality comparison operator */
-        bool operator !=(const cx&) const noexcept;
+        constexpr bool operator !=(const cx& obj) const noexcept { return real != obj.real || imag != obj.imag; }
         /** @brief Unary minus operator */
-        cx operator -() const noexcept;
+        constexpr cx operator -() const noexcept { return cx(-real, -imag); }
         
         /** @brief Calculate modulus (magnitude) */
-        float mod() const noexcept;
+        T mod() const noexcept { return std::sqrt(mod2()); }
         /** @brief Calculate squared modulus */
-        float mod2() const noexcept;
+        constexpr T mod2() const noexcept { return real * real + imag * imag; }
         /** @brief Calculate phase angle in radians */
-        float phase() const noexcept;
+        T phase() const noexcept;
         /** @brief Get complex conjugate */
-        cx conjugate() const noexcept;
+        constexpr cx conjugate() const noexcept { return cx(real, -imag); }
         /** @brief Raise to integer power
          * @param n Power to raise to
          */
@@ -95,7 +150,7 @@ namespace cx_lib
         /** @brief Create from pair (real, imaginary)
          * @param p Pair containing (real, imaginary) parts
          */
-        static cx from_pair(const std::pair<float, float>&) noexcept;
+        static constexpr cx from_pair(const std::pair<T, T>& p) noexcept { return cx(p.first, p.second); }
         /** @brief Parse from string in format "a+bi"
          * @param str String to parse
          * @throws std::invalid_argument if string format is invalid
@@ -104,8 +159,17 @@ namespace cx_lib
         /** @brief Convert to polar form (r, θ)
          * @return Pair containing (modulus, phase in radians)
          */
-        std::pair<float, float> to_polar() const noexcept;
+        std::pair<T, T> to_polar() const noexcept;
     };
+
+    /** @brief Stream output operator */
+    template <typename T>
+    std::ostream& operator <<(std::ostream&, const basic_cx<T>&);
+
+    /** @brief Single precision complex number */
+    using cx = basic_cx<float>;
+    /** @brief Double precision complex number */
+    using cxd = basic_cx<double>;
 }
 
 #endif
\ No newline at end of file
@@ -2,11 +2,13 @@
 #define COMPLEX_TENSOR_H
 
 #include <vector>
+#include <memory>
 #include <stdexcept>
 #include <numeric>
 #include <algorithm>
 #include "CXLibrary.h"
 #include "ComplexNumber.h"
+#include "CXElementwise.h"
 
 namespace cx_lib
 {
@@ -18,20 +20,41 @@ namespace cx_lib
         BY_PHASE
     };
 
+    template <typename T>
+    class basic_cx_tensor_const_view;
+    template <typename T>
+    class basic_cx_tensor_view;
+
     /**
      * @brief N-dimensional tensor of complex numbers
-     * 
+     *
      * Provides functionality for:
      * - Basic tensor operations (+, -)
      * - Tensor transformations (reshape, transpose)
      * - Broadcasting operations
      * - Element access and slicing
      * - Reduction operations
+     *
+     * A tensor owns a dense row-major buffer. slice() and transpose() return
+     * cx_tensor_view objects sharing that buffer (cx_tensor_const_view ones
+     * on a const tensor); copying a tensor always copies its elements.
+     *
+     * cx_tensor stores single precision elements and cxd_tensor double
+     * precision ones.
      */
-    class cx_tensor
+    template <typename T>
+    class basic_cx_tensor
     {
+    public:
+        /** @brief Element type (cx in cx_tensor, cxd in cxd_tensor) */
+        using cx = basic_cx<T>;
+        /** @brief View type over tensors of this precision */
+        using view_type = basic_cx_tensor_view<T>;
+        /** @brief Read-only view type over tensors of this precision */
+        using const_view_type = basic_cx_tensor_const_view<T>;
+
     private:
-        std::vector<cx> data;              ///< Flattened storage for tensor elements
+        std::shared_ptr<std::vector<cx>> data;  ///< Flattened storage for tensor elements (shared with views)
         std::vector<size_t> __shape__;     ///< Dimensions of the tensor
         size_t __size__ = 0;               ///< Total number of elements
 
@@ -40,60 +63,162 @@ namespace cx_lib
          * @return Linear index into data array
          */
         size_t lindex(const std::vector<size_t>&) const;
-    
+
+        /** @brief this[i] = op(this[i], obj[i]) in place, obj broadcast to the shape of this */
+        template <typename Op>
+        basic_cx_tensor& update(const const_view_type&, Op);
+
+        friend class basic_cx_tensor_const_view<T>;
+        friend class basic_cx_tensor_view<T>;
+
     public:
         /** @brief Default constructor creating empty tensor */
-        cx_tensor() = default;
-        /** @brief Copy constructor */
-        cx_tensor(const cx_tensor&) = default;
+        basic_cx_tensor();
+        /** @brief Copy constructor (copies the elements) */
+        basic_cx_tensor(const basic_cx_tensor&);
+        /** @brief Move constructor (leaves other empty, no copy) */
+        basic_cx_tensor(basic_cx_tensor&&) noexcept;
+        /** @brief Materialize a view into a new dense tensor */
+        basic_cx_tensor(const const_view_type&);
         /** @brief Construct tensor with given shape and fill value
          * @param shape Vector of dimensions
          * @param value Value to fill tensor with
          */
-        cx_tensor(const std::vector<size_t>&, const cx&);
+        basic_cx_tensor(const std::vector<size_t>&, const cx&);
         /** @brief Construct tensor with given shape and data
          * @param shape Vector of dimensions
          * @param data Vector of values to initialize with
          */
-        cx_tensor(const std::vector<size_t>&, const std::vector<cx>&);
+        basic_cx_tensor(const std::vector<size_t>&, const std::vector<cx>&);
+
+        /** @brief Copy assignment operator (copies the elements)
+         *
+         * The current buffer is reused when it has the right size and no
+         * view shares it.
+         */
+        basic_cx_tensor& operator =(const basic_cx_tensor&);
+        /** @brief Move assignment operator (leaves other empty, no copy) */
+        basic_cx_tensor& operator =(basic_cx_tensor&&) noexcept;
 
         /** @brief Linear index access operator */
         cx& operator [](size_t) noexcept;
         /** @brief Const linear index access operator */
         const cx& operator [](size_t) const noexcept;
-        /** @brief Multi-dimensional index access 
+        /** @brief Multi-dimensional index access
          * @throws std::invalid_argument if indices don't match tensor shape
          */
         cx& at(const std::vector<size_t>&);
         /** @brief Const multi-dimensional index access */
         const cx& at(const std::vector<size_t>&) const;
-    
-        /** @brief Element-wise addition */
-        cx_tensor operator +(const cx_tensor&) const;
-        /** @brief Element-wise subtraction */
-        cx_tensor operator -(const cx_tensor&) const;
-    
+
+        /** @brief Element-wise addition (with broadcasting, see broadcast_add) */
+        basic_cx_tensor operator +(const const_view_type&) const&;
+        /** @brief Element-wise addition reusing the storage of an expiring left operand when possible */
+        basic_cx_tensor operator +(const const_view_type&) &&;
+        /** @brief Element-wise subtraction (with broadcasting, see broadcast_add) */
+        basic_cx_tensor operator -(const const_view_type&) const&;
+        /** @brief Element-wise subtraction reusing the storage of an expiring left operand when possible */
+        basic_cx_tensor operator -(const const_view_type&) &&;
+
+        /** @brief In-place element-wise addition
+         *
+         * The operand is broadcast to the shape of this tensor; writes are
+         * visible through the views sharing its buffer. Operands overlapping
+         * the buffer are copied first when needed.
+         * @throws std::invalid_argument if the operand can't be broadcast to the shape of this tensor
+         */
+        basic_cx_tensor& operator +=(const const_view_type&);
+        /** @brief In-place element-wise subtraction (see operator +=) */
+        basic_cx_tensor& operator -=(const const_view_type&);
+        /** @brief In-place element-wise multiplication (see operator +=) */
+        basic_cx_tensor& operator *=(const const_view_type&);
+        /** @brief In-place multiplication by a complex scalar */
+        basic_cx_tensor& operator *=(const cx&);
+        /** @brief this += alpha * x, in place (see operator +=) */
+        basic_cx_tensor& axpy(const cx& alpha, const const_view_type& x);
+        /** @brief this = alpha * x + beta * this, in place (see operator +=) */
+        basic_cx_tensor& axpby(const cx& alpha, const const_view_type& x, const cx& beta);
+
         /** @brief Reshape tensor to new dimensions
          * @throws std::invalid_argument if new shape is invalid
          */
-        cx_tensor& reshape(const std::vector<size_t>&);
-        /** @brief Extract slice of tensor
-         * @param start Starting indices
-         * @param end Ending indices
+        basic_cx_tensor& reshape(const std::vector<size_t>&);
+        /** @brief View the tensor as a cx_tensor_view (no copy) */
+        view_type view();
+        /** @brief Read-only view of a const tensor (no copy) */
+        const_view_type view() const;
+        /** @brief View of a sub-range of the tensor (no copy)
+         * @param start Starting indices (inclusive)
+         * @param end Ending indices (exclusive)
+         * @throws std::invalid_argument if the ranges are invalid
+         */
+        view_type slice(const std::vector<size_t>&, const std::vector<size_t>&);
+        /** @brief Read-only slice of a const tensor (see slice) */
+        const_view_type slice(const std::vector<size_t>&, const std::vector<size_t>&) const;
+        /** @brief Add with NumPy-style broadcasting
+         *
+         * Shapes are aligned on their trailing dimensions; each pair of
+         * dimensions must be equal or one of them must be 1. The result has
+         * the broadcast shape of both operands.
+         * @throws std::invalid_argument if shapes incompatible
+         */
+        basic_cx_tensor broadcast_add(const const_view_type&) const;
+        /** @brief Subtract with NumPy-style broadcasting
+         * @throws std::invalid_argument if shapes incompatible
+         */
+        basic_cx_tensor broadcast_sub(const const_view_type&) const;
+        /** @brief Multiply element-wise with NumPy-style broadcasting
+         * @throws std::invalid_argument if shapes incompatible
+         */
+        basic_cx_tensor broadcast_mul(const const_view_type&) const;
+        /** @brief Divide element-wise with NumPy-style broadcasting
+         * @throws std::invalid_argument if shapes incompatible
+         * @throws std::runtime_error if an element of the divisor is zero
+         */
+        basic_cx_tensor broadcast_div(const const_view_type&) const;
+        /** @brief Apply a unary functor to every element
+         * @param f Callable with signature cx(const cx&)
+         * @return New tensor with the same shape
          */
-        cx_tensor slice(const std::vector<size_t>&, const std::vector<size_t>&) const;
-        /** @brief Add with broadcasting
+        template <typename F>
+        basic_cx_tensor apply(F&& f) const;
+        /** @brief Combine with another tensor through a binary functor, with broadcasting
+         * @param obj Right operand
+         * @param f Callable with signature cx(const cx&, const cx&)
          * @throws std::invalid_argument if shapes incompatible
          */
-        cx_tensor broadcast_add(const cx_tensor&) const;
-        /** @brief Transpose tensor along given axes
+        template <typename F>
+        basic_cx_tensor apply(const const_view_type&, F&& f) const;
+        /** @brief View with permuted axes (no copy)
          * @param axes Permutation of dimensions
          */
-        cx_tensor transpose(const std::vector<size_t>&) const;
+        view_type transpose(const std::vector<size_t>&);
+        /** @brief Read-only transpose of a const tensor (see transpose) */
+        const_view_type transpose(const std::vector<size_t>&) const;
+        /** @brief View of the diagonal of two axes (no copy, see cx_tensor_const_view::diagonal) */
+        view_type diagonal(size_t, size_t);
+        /** @brief Read-only diagonal of a const tensor (see diagonal) */
+        const_view_type diagonal(size_t, size_t) const;
         /** @brief Sum reduction along specified axis
          * @param axis Dimension to reduce
          */
-        cx_tensor reduce_sum(size_t) const;
+        basic_cx_tensor reduce_sum(size_t) const;
+        /** @brief Sum over the given axes (see cx_tensor_const_view::sum) */
+        basic_cx_tensor sum(const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief Mean over the given axes (see cx_tensor_const_view::sum) */
+        basic_cx_tensor mean(const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief Product over the given axes (see cx_tensor_const_view::sum) */
+        basic_cx_tensor prod(const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief L2 norm over the given axes (see cx_tensor_const_view::norm) */
+        basic_cx_tensor norm(const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief Maximum over the given axes (see cx_tensor_const_view::max) */
+        basic_cx_tensor max(__cx_comparison_criteria__, const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief Minimum over the given axes (see cx_tensor_const_view::max) */
+        basic_cx_tensor min(__cx_comparison_criteria__, const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief Position of the maximum over the given axes (see cx_tensor_const_view::argmax) */
+        std::vector<size_t> argmax(__cx_comparison_criteria__, const std::vector<size_t>& = {}) const;
+        /** @brief Position of the minimum over the given axes (see cx_tensor_const_view::argmax) */
+        std::vector<size_t> argmin(__cx_comparison_criteria__, const std::vector<size_t>& = {}) const;
 
         /** @brief Get total number of elements */
         size_t size() const noexcept;
@@ -101,12 +226,272 @@ namespace cx_lib
         const std::vector<size_t>& shape() const noexcept;
         /** @brief Check if tensor is empty */
         std::vector<size_t> unravel_index(size_t) const;
-        
+
         /** @brief Normalize tensor elements, according to min and max values in it */
         void normalize(__cx_comparison_criteria__);
         /** @brief Flatten tensor to 1D vector */
         void flatten() noexcept;
     };
+
+    /**
+     * @brief Non-owning, read-only strided view over the elements of a cx_tensor
+     *
+     * A view is described by the buffer it shares with a tensor, an offset
+     * and one stride per axis, so slicing, transposing and (most) reshapes
+     * cost O(rank) and never touch the elements. The buffer is reference
+     * counted: a view stays valid after the tensor it was taken from is
+     * destroyed.
+     *
+     * The accessors of a cx_tensor_const_view return const references and
+     * pointers, and the views derived from it are read-only as well. It is
+     * what the const overloads of cx_tensor (view(), slice(), ...) return,
+     * and what operations taking tensor operands accept: tensors and
+     * cx_tensor_view objects convert to it without copying.
+     *
+     * Element-wise operations accept views directly; contiguous() (or the
+     * conversion to cx_tensor) materializes a dense copy when needed.
+     */
+    template <typename T>
+    class basic_cx_tensor_const_view
+    {
+    public:
+        /** @brief Element type (cx in cx_tensor_const_view, cxd in cxd_tensor_const_view) */
+        using cx = basic_cx<T>;
+        /** @brief Tensor type of this precision */
+        using tensor_type = basic_cx_tensor<T>;
+
+    protected:
+        std::shared_ptr<std::vector<cx>> storage;  ///< Shared buffer
+        size_t __offset__ = 0;                     ///< Offset (in elements) of the first element
+        std::vector<size_t> __shape__;             ///< Extent of each axis
+        std::vector<ptrdiff_t> __strides__;        ///< Stride (in elements) of each axis
+        size_t __size__ = 0;                       ///< Total number of elements
+
+        basic_cx_tensor_const_view(std::shared_ptr<std::vector<cx>>, size_t, std::vector<size_t>, std::vector<ptrdiff_t>);
+
+        /** @brief Offset of a row-major linear index */
+        size_t offset_of(size_t) const noexcept;
+        /** @brief Offset of a multi-dimensional index
+         * @throws std::invalid_argument if indices don't match view shape
+         */
+        size_t offset_of(const std::vector<size_t>&) const;
+
+    public:
+        /** @brief Read-only view over a whole tensor (no copy) */
+        basic_cx_tensor_const_view(const tensor_type&);
+
+        /** @brief Element at a row-major linear index of the view */
+        const cx& operator [](size_t) const noexcept;
+        /** @brief Multi-dimensional index access
+         * @throws std::invalid_argument if indices don't match view shape
+         */
+        const cx& at(const std::vector<size_t>&) const;
+
+        /** @brief Get total number of elements */
+        size_t size() const noexcept;
+        /** @brief Get view dimensions */
+        const std::vector<size_t>& shape() const noexcept;
+        /** @brief Get stride (in elements) of each axis */
+        const std::vector<ptrdiff_t>& strides() const noexcept;
+        /** @brief Get offset (in elements) of the first element in the shared buffer */
+        size_t offset() const noexcept;
+        /** @brief Get pointer to the first element of the view */
+        const cx* data() const noexcept;
+        /** @brief Whether elements are laid out densely in row-major order */
+        bool is_contiguous() const noexcept;
+        /** @brief Multi-dimensional index of a row-major linear index */
+        std::vector<size_t> unravel_index(size_t) const;
+
+        /** @brief Sub-range of the view (no copy)
+         * @param start Starting indices (inclusive)
+         * @param end Ending indices (exclusive)
+         */
+        basic_cx_tensor_const_view slice(const std::vector<size_t>&, const std::vector<size_t>&) const;
+        /** @brief View with permuted axes (no copy) */
+        basic_cx_tensor_const_view transpose(const std::vector<size_t>&) const;
+        /** @brief View of the diagonal of two axes (no copy)
+         *
+         * The first axis is kept and walks the elements with equal indices
+         * along both axes; the second axis is dropped.
+         * @throws std::invalid_argument if the axes are equal, out of range or of different extents
+         */
+        basic_cx_tensor_const_view diagonal(size_t, size_t) const;
+        /** @brief View with a new shape
+         *
+         * No copy is made when the strides of the view allow it (always the
+         * case for contiguous views); otherwise the elements are copied
+         * into a new buffer, like numpy.reshape.
+         * @throws std::invalid_argument if new shape is invalid
+         */
+        basic_cx_tensor_const_view reshape(const std::vector<size_t>&) const;
+        /** @brief 1-D view over all elements (see reshape) */
+        basic_cx_tensor_const_view flatten() const;
+        /** @brief Copy the elements into a new dense tensor */
+        tensor_type contiguous() const;
+
+        /** @brief Sum over the given axes
+         *
+         * Reductions accept any set of distinct axes (an empty set means all
+         * of them). Reduced axes are dropped from the result, or kept with
+         * extent 1 when keepdims is true; reducing every axis without
+         * keepdims gives a tensor of shape {1}. Partial results are combined
+         * pairwise, both inside a thread and across threads.
+         * @param axes Axes to reduce
+         * @param keepdims Keep reduced axes with extent 1
+         * @throws std::invalid_argument if an axis is out of range or repeated
+         */
+        tensor_type sum(const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief Mean over the given axes (see sum) */
+        tensor_type mean(const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief Product over the given axes (see sum) */
+        tensor_type prod(const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief L2 norm sqrt(sum |z|^2) over the given axes (see sum)
+         * @return Tensor with the norms as real parts
+         */
+        tensor_type norm(const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief Maximum over the given axes, according to a comparison criteria (see sum)
+         *
+         * On ties the first element in row-major order wins.
+         */
+        tensor_type max(__cx_comparison_criteria__, const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief Minimum over the given axes, according to a comparison criteria (see max) */
+        tensor_type min(__cx_comparison_criteria__, const std::vector<size_t>& = {}, bool = false) const;
+        /** @brief Position of the maximum over the given axes
+         * @return For every element of the reduced shape (in row-major order),
+         *         the row-major index of the maximum within the reduced axes
+         */
+        std::vector<size_t> argmax(__cx_comparison_criteria__, const std::vector<size_t>& = {}) const;
+        /** @brief Position of the minimum over the given axes (see argmax) */
+        std::vector<size_t> argmin(__cx_comparison_criteria__, const std::vector<size_t>& = {}) const;
+
+        /** @brief Element-wise addition (with broadcasting) */
+        tensor_type operator +(const basic_cx_tensor_const_view&) const;
+        /** @brief Element-wise subtraction (with broadcasting) */
+        tensor_type operator -(const basic_cx_tensor_const_view&) const;
+        /** @brief Add with NumPy-style broadcasting */
+        tensor_type broadcast_add(const basic_cx_tensor_const_view&) const;
+        /** @brief Subtract with NumPy-style broadcasting */
+        tensor_type broadcast_sub(const basic_cx_tensor_const_view&) const;
+        /** @brief Multiply element-wise with NumPy-style broadcasting */
+        tensor_type broadcast_mul(const basic_cx_tensor_const_view&) const;
+        /** @brief Divide element-wise with NumPy-style broadcasting */
+        tensor_type broadcast_div(const basic_cx_tensor_const_view&) const;
+
+        /** @brief Apply a unary functor to every element
+         * @param f Callable with signature cx(const cx&)
+         */
+        template <typename F>
+        tensor_type apply(F&& f) const
+        {
+            tensor_type new_(this->__shape__, cx(0, 0));
+            nd_unary_map(this->__shape__,
+                         new_.data->data(), contiguous_strides(this->__shape__),
+                         this->data(), this->__strides__,
+                         f);
+            return new_;
+        }
+
+        /** @brief Combine with another view through a binary functor, with broadcasting
+         * @param obj Right operand
+         * @param f Callable with signature cx(const cx&, const cx&)
+         * @throws std::invalid_argument if shapes incompatible
+         */
+        template <typename F>
+        tensor_type apply(const basic_cx_tensor_const_view& obj, F&& f) const
+        {
+            std::vector<size_t> out_shape = broadcast_shape(this->__shape__, obj.__shape__);
+            tensor_type new_(out_shape, cx(0, 0));
+            nd_binary_map(out_shape,
+                          new_.data->data(), contiguous_strides(out_shape),
+                          this->data(), broadcast_strides(this->__shape__, this->__strides__, out_shape),
+                          obj.data(), broadcast_strides(obj.__shape__, obj.__strides__, out_shape),
+                          f);
+            return new_;
+        }
+    };
+
+    /**
+     * @brief Non-owning strided view over the elements of a non-const cx_tensor
+     *
+     * A cx_tensor_const_view whose non-const accessors return mutable
+     * references and pointers: writes through it are visible in the tensor.
+     * The non-const overloads of cx_tensor (view(), slice(), ...) return it;
+     * a const cx_tensor_view gives read-only access only.
+     */
+    template <typename T>
+    class basic_cx_tensor_view : public basic_cx_tensor_const_view<T>
+    {
+    public:
+        /** @brief Element type (cx in cx_tensor_view, cxd in cxd_tensor_view) */
+        using cx = basic_cx<T>;
+        /** @brief Tensor type of this precision */
+        using tensor_type = basic_cx_tensor<T>;
+        /** @brief Read-only view type of this precision */
+        using const_view_type = basic_cx_tensor_const_view<T>;
+
+    private:
+        /** @brief Mutable view over the elements of a view derived from this one */
+        explicit basic_cx_tensor_view(const_view_type&&) noexcept;
+
+    public:
+        /** @brief View over a whole tensor (no copy) */
+        basic_cx_tensor_view(tensor_type&);
+
+        using const_view_type::operator [];
+        /** @brief Element at a row-major linear index of the view */
+        cx& operator [](size_t) noexcept;
+        using const_view_type::at;
+        /** @brief Multi-dimensional index access
+         * @throws std::invalid_argument if indices don't match view shape
+         */
+        cx& at(const std::vector<size_t>&);
+        using const_view_type::data;
+        /** @brief Get pointer to the first element of the view */
+        cx* data() noexcept;
+
+        using const_view_type::slice;
+        /** @brief Sub-range of the view (see cx_tensor_const_view::slice) */
+        basic_cx_tensor_view slice(const std::vector<size_t>&, const std::vector<size_t>&);
+        using const_view_type::transpose;
+        /** @brief View with permuted axes (see cx_tensor_const_view::transpose) */
+        basic_cx_tensor_view transpose(const std::vector<size_t>&);
+        using const_view_type::diagonal;
+        /** @brief View of the diagonal of two axes (see cx_tensor_const_view::diagonal) */
+        basic_cx_tensor_view diagonal(size_t, size_t);
+        using const_view_type::reshape;
+        /** @brief View with a new shape (see cx_tensor_const_view::reshape) */
+        basic_cx_tensor_view reshape(const std::vector<size_t>&);
+        using const_view_type::flatten;
+        /** @brief 1-D view over all elements (see reshape) */
+        basic_cx_tensor_view flatten();
+    };
+
+    template <typename T>
+    template <typename F>
+    basic_cx_tensor<T> basic_cx_tensor<T>::apply(F&& f) const
+    {
+        return this->view().apply(std::forward<F>(f));
+    }
+
+    template <typename T>
+    template <typename F>
+    basic_cx_tensor<T> basic_cx_tensor<T>::apply(const const_view_type& obj, F&& f) const
+    {
+        return this->view().apply(obj, std::forward<F>(f));
+    }
+
+    /** @brief Tensor of single precision complex numbers */
+    using cx_tensor = basic_cx_tensor<float>;
+    /** @brief Tensor of double precision complex numbers */
+    using cxd_tensor = basic_cx_tensor<double>;
+    /** @brief Read-only view over a cx_tensor */
+    using cx_tensor_const_view = basic_cx_tensor_const_view<float>;
+    /** @brief Read-only view over a cxd_tensor */
+    using cxd_tensor_const_view = basic_cx_tensor_const_view<double>;
+    /** @brief View over a cx_tensor */
+    using cx_tensor_view = basic_cx_tensor_view<float>;
+    /** @brief View over a cxd_tensor */
+    using cxd_tensor_view = basic_cx_tensor_view<double>;
 }
 
 #endif
\ No newline at end of file
@@ -3,9 +3,11 @@
 
 #include <vector>
 #include <cmath>
+#include <memory>
 #include <stdexcept>
 #include <ostream>
 #include "ComplexNumber.h"
+#include "CXVectorExpr.h"
 
 namespace cx_lib
 {
@@ -17,9 +19,26 @@ namespace cx_lib
      * - Vector products (dot, cross)
      * - Statistical operations (mean, sum, max, min)
      * - Vector transformations (normalize, projection)
+     *
+     * cx_vector stores single precision elements and cxd_vector double
+     * precision ones. The arithmetic operators build lazy expressions
+     * (see cx_vector_expr) evaluated in one pass on assignment, and the
+     * statistics are only computed when first requested.
      */
-    class cx_vector
+    /** @brief How a cx_vector maintains its statistics (sum, mean, max, min) */
+    enum __cx_stats_mode__
     {
+        STATS_LAZY,        ///< Recomputed in one pass at the first query after a write; nothing is kept per write (default)
+        STATS_INCREMENTAL  ///< Kept up to date by set(): O(1) for sum and mean, O(log n) for max and min
+    };
+
+    template <typename T>
+    class basic_cx_vector : public cx_vector_expr<basic_cx_vector<T>>
+    {
+    public:
+        /** @brief Element type (cx in cx_vector, cxd in cxd_vector) */
+        using cx = basic_cx<T>;
+
     private:
         std::vector<cx> arr;      ///< Storage for complex numbers
         cx __sum__;               ///< Cached sum of elements
@@ -27,65 +46,105 @@ namespace cx_lib
         cx __max__;              ///< Cached maximum element
         cx __min__;              ///< Cached minimum element
         bool cache_valid = false; ///< Flag indicating if cache is valid
+        __cx_stats_mode__ stats_mode = STATS_LAZY; ///< How the cache is maintained
+
+        /** @brief State kept up to date by set() in STATS_INCREMENTAL mode */
+        struct incremental_stats
+        {
+            basic_cx<double> running_sum;   ///< Sum of elements
+            std::vector<size_t> max_tree;   ///< Tournament tree of the largest modulus
+            std::vector<size_t> min_tree;   ///< Tournament tree of the smallest modulus
+        };
+        std::unique_ptr<incremental_stats> __incremental__; ///< Allocated by the first query in STATS_INCREMENTAL mode
 
     public:
         /** @brief Default constructor creating empty vector */
-        cx_vector() = default;
+        basic_cx_vector() = default;
         /** @brief Construct from vector of complex numbers
          * @param vec Vector of complex numbers to copy
          */
-        cx_vector(const std::vector<cx>&);
+        basic_cx_vector(const std::vector<cx>&);
         /** @brief Copy constructor
          * @param other Vector to copy
          */
-        cx_vector(const cx_vector&) noexcept;
-        /** @brief Move constructor */
-        cx_vector(cx_vector&&) noexcept = default;
+        basic_cx_vector(const basic_cx_vector&) noexcept;
+        /** @brief Move constructor (leaves other empty, with no cached statistics) */
+        basic_cx_vector(basic_cx_vector&&) noexcept;
         /** @brief Construct vector with size elements of value
          * @param size Number of elements
          * @param value Value to fill with
          */
-        cx_vector(size_t size, const cx& value);
+        basic_cx_vector(size_t size, const cx& value);
+
+        /** @brief Evaluate an expression (a + b * s - c, ...) in a single pass
+         * @param expr Expression built from the +, - and * operators
+         */
+        template <typename E>
+        basic_cx_vector(const cx_vector_expr<E>& expr);
 
         /** @brief Copy assignment operator */
-        cx_vector& operator =(const cx_vector&) noexcept;
-        /** @brief Vector addition operator */
-        cx_vector operator  +(const cx_vector&) const;
-        /** @brief Vector subtraction operator */
-        cx_vector operator  -(const cx_vector&) const;
-        /** @brief Scalar multiplication with complex number */
-        cx_vector operator  *(const cx&) const noexcept;
-        /** @brief Scalar multiplication with float */
-        cx_vector operator  *(float) const noexcept;
+        basic_cx_vector& operator =(const basic_cx_vector&) noexcept;
+        /** @brief Evaluate an expression into this vector in a single pass (operands may alias it) */
+        template <typename E>
+        basic_cx_vector& operator =(const cx_vector_expr<E>& expr);
+        /** @brief Move assignment operator (leaves other empty, with no cached statistics) */
+        basic_cx_vector& operator =(basic_cx_vector&&) noexcept;
+
+        /** @brief Add an expression in place, in a single pass and without allocating
+         * @throws std::runtime_error if the dimensions differ
+         */
+        template <typename E>
+        basic_cx_vector& operator +=(const cx_vector_expr<E>& expr) { return *this = *this + expr; }
+        /** @brief Subtract an expression in place (see operator +=) */
+        template <typename E>
+        basic_cx_vector& operator -=(const cx_vector_expr<E>& expr) { return *this = *this - expr; }
+        /** @brief Multiply by a complex scalar in place */
+        basic_cx_vector& operator *=(const cx&) noexcept;
+        /** @brief Multiply by a real scalar in place */
+        basic_cx_vector& operator *=(T) noexcept;
+        /** @brief this += alpha * x, in place
+         * @throws std::runtime_error if the dimensions differ
+         */
+        basic_cx_vector& axpy(const cx& alpha, const basic_cx_vector& x);
+        /** @brief this = alpha * x + beta * this, in place
+         * @throws std::runtime_error if the dimensions differ
+         */
+        basic_cx_vector& axpby(const cx& alpha, const basic_cx_vector& x, const cx& beta);
         /** @brief Array subscript operator */
-        cx& operator [](size_t index) noexcept;
+        cx& operator [](size_t index) noexcept { cache_valid = false; return arr[index]; }
+        /** @brief Write one element, updating the statistics incrementally in STATS_INCREMENTAL mode
+         *
+         * Writes through operator [] cannot be tracked and invalidate the
+         * statistics; the next query then rebuilds them in O(n).
+         */
+        void set(size_t index, const cx& value) noexcept;
         /** @brief Const array subscript operator */
-        const cx& operator [](size_t index) const noexcept;
+        const cx& operator [](size_t index) const noexcept { return arr[index]; }
         /** @brief Equality comparison operator */
-        bool operator ==(const cx_vector&) const noexcept;
+        bool operator ==(const basic_cx_vector&) const noexcept;
         /** @brief Inequality comparison operator */
-        bool operator !=(const cx_vector&) const noexcept;
+        bool operator !=(const basic_cx_vector&) const noexcept;
 
         /** @brief Safe element access with bounds checking
          * @throws std::out_of_range if index is invalid
          */
         const cx& at(size_t index) const;
         /** @brief Get vector dimension */
-        size_t dim() const noexcept;
+        size_t dim() const noexcept { return arr.size(); }
         /** @brief Normalize vector in-place */
         void normalize();
         /** @brief Calculate vector magnitude */
-        float mod() const noexcept;
+        T mod() const noexcept;
         /** @brief Calculate cumulative sum vector */
-        cx_vector cumulative_sum() const noexcept;
+        basic_cx_vector cumulative_sum() const noexcept;
         /** @brief Calculate vector projection onto another vector */
-        cx_vector projection(const cx_vector&) const;
+        basic_cx_vector projection(const basic_cx_vector&) const;
         /** @brief Calculate complex conjugate of vector */
-        cx_vector conjugate() const noexcept;
+        basic_cx_vector conjugate() const noexcept;
         /** @brief Calculate dot product with another vector */
-        cx dot(const cx_vector&) const;
+        cx dot(const basic_cx_vector&) const;
         /** @brief Calculate cross product with another vector */
-        cx_vector cross(const cx_vector&) const;
+        basic_cx_vector cross(const basic_cx_vector&) const;
 
         /** @brief Get sum of all elements */
         cx sum() const noexcept;
@@ -95,18 +154,97 @@ namespace cx_lib
         cx max() const noexcept;
         /** @brief Get minimum element */
         cx min() const noexcept;
+        /** @brief How the statistics are maintained */
+        __cx_stats_mode__ get_stats_mode() const noexcept { return stats_mode; }
+        /** @brief Select how the statistics are maintained
+         *
+         * STATS_INCREMENTAL suits vectors updated one element at a time
+         * (e.g. sliding windows) and costs two index trees of 2 * dim()
+         * entries, allocated by the first query; its sum is accumulated in
+         * double precision. STATS_LAZY releases them, and vectors that never
+         * use STATS_INCREMENTAL only carry a null pointer for them.
+         */
+        void set_stats_mode(__cx_stats_mode__ mode) noexcept;
 
         /** @brief Create zero vector of given size */
-        static cx_vector null_vector(size_t);
+        static basic_cx_vector null_vector(size_t);
         /** @brief Get underlying vector */
         std::vector<cx> get() noexcept;
-        /** @brief Stream output operator */
-        friend std::ostream& operator <<(std::ostream&, const cx_vector&);
         
     private:
         /** @brief Reset cached values */
         void reset_values();
+        /** @brief Refresh the cached values from the running sum and the trees */
+        void read_incremental() noexcept;
     };
+
+    template <typename T>
+    template <typename E>
+    basic_cx_vector<T>::basic_cx_vector(const cx_vector_expr<E>& expr)
+        : arr(expr.self().dim())
+    {
+        expr.self().eval(arr.data());
+    }
+
+    template <typename T>
+    template <typename E>
+    basic_cx_vector<T>& basic_cx_vector<T>::operator =(const cx_vector_expr<E>& expr)
+    {
+        // Element i of the result only reads element i of the operands,
+        // so evaluating in place is safe when they alias this vector.
+        arr.resize(expr.self().dim());
+        expr.self().eval(arr.data());
+        cache_valid = false;
+        return *this;
+    }
+
+    /** @brief Sum reusing the storage of an expiring left operand (no allocation) */
+    template <typename T, typename R>
+    basic_cx_vector<T> operator +(basic_cx_vector<T>&& a, const cx_vector_expr<R>& b)
+    {
+        a += b;
+        return std::move(a);
+    }
+
+    /** @brief Difference reusing the storage of an expiring left operand (no allocation) */
+    template <typename T, typename R>
+    basic_cx_vector<T> operator -(basic_cx_vector<T>&& a, const cx_vector_expr<R>& b)
+    {
+        a -= b;
+        return std::move(a);
+    }
+
+    /** @brief Product by a complex scalar reusing the storage of an expiring vector */
+    template <typename T>
+    basic_cx_vector<T> operator *(basic_cx_vector<T>&& a, const typename basic_cx_vector<T>::cx& s) noexcept
+    {
+        a *= s;
+        return std::move(a);
+    }
+
+    /** @brief Product by a real scalar reusing the storage of an expiring vector */
+    template <typename T>
+    basic_cx_vector<T> operator *(basic_cx_vector<T>&& a, typename basic_cx_vector<T>::cx::value_type s) noexcept
+    {
+        a *= s;
+        return std::move(a);
+    }
+
+    /** @brief Stream output operator */
+    template <typename T>
+    std::ostream& operator <<(std::ostream&, const basic_cx_vector<T>&);
+
+    /** @brief Stream output of a lazy expression (evaluated into a cx_vector first) */
+    template <typename E>
+    std::ostream& operator <<(std::ostream& os, const cx_vector_expr<E>& expr)
+    {
+        return os << basic_cx_vector<typename E::cx::value_type>(expr);
+    }
+
+    /** @brief Vector of single precision complex numbers */
+    using cx_vector = basic_cx_vector<float>;
+    /** @brief Vector of double precision complex numbers */
+    using cxd_vector = basic_cx_vector<double>;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,423 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include "CXConvolve.h"
+#include "CXElementwise.h"
+#include "CXKernels.h"
+#include "CXThreadPool.h"
+
+namespace cx_lib
+{
+    namespace
+    {
+        // Multiply-adds per chunk when direct convolutions are split across threads.
+        constexpr size_t parallel_grain = size_t(1) << 14;
+
+        // Smallest length >= n whose only prime factors are 2, 3 and 5.
+        size_t fast_length(size_t n)
+        {
+            for (size_t len = std::max<size_t>(n, 1);; len++)
+            {
+                size_t r = len;
+                for (size_t p : {2, 3, 5})
+                    while (r % p == 0)
+                        r /= p;
+                if (r == 1)
+                    return len;
+            }
+        }
+
+        size_t next_power_of_two(size_t n)
+        {
+            size_t len = 1;
+            while (len < n)
+                len <<= 1;
+            return len;
+        }
+
+        // A complex multiply-add per pair of elements against three
+        // transforms of L points (about 5 L log2 L flops each). The N-D
+        // transforms go through transposed tiles and the direct method
+        // through long axpy rows, hence the larger weight for tensors.
+        bool direct_is_cheaper(size_t n, size_t m, size_t fft_len, double weight = 2.0)
+        {
+            const double l = static_cast<double>(fft_len);
+            return static_cast<double>(n) * static_cast<double>(m) <= weight * l * std::log2(std::max(l, 2.0));
+        }
+
+        // First element and length, along one axis, of the part of the full
+        // convolution returned by mode.
+        std::pair<size_t, size_t> mode_window(size_t n, size_t m, __cx_conv_mode__ mode)
+        {
+            switch (mode)
+            {
+                case CONV_SAME:
+                    return {(m - 1) / 2, n};
+                case CONV_VALID:
+                    if (m > n)
+                        throw std::invalid_argument("Kernel larger than the signal in valid mode.");
+                    return {m - 1, n - m + 1};
+                default:
+                    return {0, n + m - 1};
+            }
+        }
+
+        template <typename C>
+        void direct_1d(const C* a, size_t n, const C* v, size_t m, C* out)
+        {
+            // out[k] = sum a[j] v[k - j] is a dot product with the reversed kernel.
+            const std::vector<C> rev(std::make_reverse_iterator(v + m), std::make_reverse_iterator(v));
+            parallel_for(0, n + m - 1, std::max<size_t>(1, parallel_grain / m), [&](size_t k0, size_t k1) {
+                for (size_t k = k0; k < k1; k++)
+                {
+                    const size_t j0 = (k + 1 >= m) ? k + 1 - m : 0, j1 = std::min(k + 1, n);
+                    out[k] = kernels::accumulate_dot(j1 - j0, a + j0, rev.data() + (m - 1 - k + j0));
+                }
+            });
+        }
+
+        template <typename T>
+        void fft_1d(const basic_cx<T>* a, size_t n, const basic_cx<T>* v, size_t m, basic_cx<T>* out)
+        {
+            using C = basic_cx<T>;
+            const size_t full = n + m - 1, whole = fast_length(full);
+            const size_t block_len = next_power_of_two(std::max<size_t>(8 * m, 256));
+            const size_t len = (2 * block_len < whole) ? block_len : whole;
+            const auto forward = fft_plan<T>(len, FFT_FORWARD), backward = fft_plan<T>(len, FFT_BACKWARD);
+            const C norm(T(1) / static_cast<T>(len), 0);
+
+            std::vector<C> kernel(len, C(0, 0));
+            std::copy(v, v + m, kernel.begin());
+            forward->execute(kernel.data());
+
+            // Overlap-add: block b of the signal contributes to out[b * step, b * step + step + m - 1).
+            // Blocks of the same parity never overlap, so each phase runs in parallel.
+            const size_t step = len - m + 1, blocks = (n + step - 1) / step;
+            if (blocks > 1)
+                std::fill(out, out + full, C(0, 0));
+            for (size_t phase = 0; phase < 2; phase++)
+                parallel_for(0, (blocks + 1 - phase) / 2, 1, [&](size_t i0, size_t i1) {
+                    std::vector<C> buffer(len);
+                    for (size_t i = i0; i < i1; i++)
+                    {
+                        const size_t start = (2 * i + phase) * step, count = std::min(step, n - start);
+                        std::copy(a + start, a + start + count, buffer.begin());
+                        std::fill(buffer.begin() + count, buffer.end(), C(0, 0));
+                        forward->execute(buffer.data());
+                        kernels::mul(len, buffer.data(), kernel.data(), buffer.data());
+                        backward->execute(buffer.data());
+                        const size_t span = std::min(count + m - 1, full - start);
+                        if (blocks > 1)
+                            kernels::axpy(span, norm, buffer.data(), out + start);
+                        else
+                            kernels::scale(span, norm, buffer.data(), out);
+                    }
+                });
+        }
+
+        template <typename T>
+        void convolve_full(const basic_cx<T>* a, size_t n, const basic_cx<T>* v, size_t m, basic_cx<T>* out,
+                           __cx_conv_method__ method)
+        {
+            if (method == CONV_AUTO)
+                method = direct_is_cheaper(n, m, fast_length(n + m - 1)) ? CONV_DIRECT : CONV_FFT;
+            if (method == CONV_DIRECT)
+                direct_1d(a, n, v, m, out);
+            else
+                fft_1d(a, n, v, m, out);
+        }
+
+        template <typename T>
+        basic_cx_vector<T> convolve_vector(const basic_cx_vector<T>& a, const std::vector<basic_cx<T>>& v,
+                                           __cx_conv_mode__ mode, __cx_conv_method__ method)
+        {
+            const size_t n = a.dim(), m = v.size();
+            if (n == 0 || m == 0)
+                throw std::invalid_argument("Cannot convolve an empty vector.");
+            const auto w = mode_window(n, m, mode);
+
+            std::vector<basic_cx<T>> full(n + m - 1);
+            convolve_full(&a[0], n, v.data(), m, full.data(), method);
+            return basic_cx_vector<T>(std::vector<basic_cx<T>>(full.begin() + w.first, full.begin() + w.first + w.second));
+        }
+
+        template <typename T>
+        std::vector<basic_cx<T>> elements(const basic_cx_vector<T>& v)
+        {
+            return std::vector<basic_cx<T>>(&v[0], &v[0] + v.dim());
+        }
+
+        // conj(v[m - 1 - j]): correlating with v is convolving with it.
+        template <typename T>
+        std::vector<basic_cx<T>> correlation_kernel(const basic_cx_vector<T>& v)
+        {
+            std::vector<basic_cx<T>> k(v.dim());
+            for (size_t j = 0; j < v.dim(); j++)
+                k[j] = v[v.dim() - 1 - j].conjugate();
+            return k;
+        }
+
+        size_t shape_size(const std::vector<size_t>& shape)
+        {
+            size_t size = 1;
+            for (size_t d : shape)
+                size *= d;
+            return size;
+        }
+
+        // Full N-D convolution of dense a and v into dense out (shape a + v - 1).
+        template <typename C>
+        void direct_nd(const C* a, const std::vector<size_t>& na, const C* v, const std::vector<size_t>& nv,
+                       C* out, const std::vector<size_t>& nf)
+        {
+            const size_t rank = na.size(), last = rank - 1;
+            const size_t nl = na[last], ml = nv[last], fl = nf[last];
+            const size_t rows = shape_size(nf) / fl, kernel_rows = shape_size(nv) / ml;
+
+            std::fill(out, out + rows * fl, C(0, 0));
+            // Output rows are independent: each one gathers the rows of a
+            // shifted by every kernel row that reaches it.
+            parallel_for(0, rows, std::max<size_t>(1, parallel_grain / (kernel_rows * ml * nl)), [&](size_t r0, size_t r1) {
+                std::vector<size_t> oi(last), ki(last);
+                for (size_t r = r0; r < r1; r++)
+                {
+                    for (size_t d = last, rem = r; d-- > 0; rem /= nf[d])
+                        oi[d] = rem % nf[d];
+                    C* out_row = out + r * fl;
+                    for (size_t kr = 0; kr < kernel_rows; kr++)
+                    {
+                        size_t a_row = 0;
+                        bool inside = true;
+                        for (size_t d = last, rem = kr; d-- > 0; rem /= nv[d])
+                            ki[d] = rem % nv[d];
+                        for (size_t d = 0; d < last && inside; d++)
+                        {
+                            inside = oi[d] >= ki[d] && oi[d] - ki[d] < na[d];
+                            a_row = a_row * na[d] + (oi[d] - ki[d]);
+                        }
+                        if (!inside)
+                            continue;
+                        for (size_t j = 0; j < ml; j++)
+                            kernels::axpy(nl, v[kr * ml + j], a + a_row * nl, out_row + j);
+                    }
+                }
+            });
+        }
+
+        template <typename T>
+        basic_cx_tensor<T> convolve_tensor(const basic_cx_tensor_const_view<T>& a, const basic_cx_tensor_const_view<T>& v,
+                                           __cx_conv_mode__ mode, __cx_conv_method__ method)
+        {
+            using C = basic_cx<T>;
+            const std::vector<size_t>& na = a.shape();
+            const std::vector<size_t>& nv = v.shape();
+            if (na.size() != nv.size())
+                throw std::invalid_argument("Convolution operands must have the same rank.");
+            if (a.size() == 0 || v.size() == 0)
+                throw std::invalid_argument("Cannot convolve an empty tensor.");
+
+            const size_t rank = na.size();
+            std::vector<size_t> nf(rank), nl(rank), start(rank), extent(rank);
+            for (size_t d = 0; d < rank; d++)
+            {
+                nf[d] = na[d] + nv[d] - 1;
+                nl[d] = fast_length(nf[d]);
+                std::tie(start[d], extent[d]) = mode_window(na[d], nv[d], mode);
+            }
+            const basic_cx_tensor<T> dense_a = a.is_contiguous() ? basic_cx_tensor<T>() : a.contiguous();
+            const basic_cx_tensor<T> dense_v = v.is_contiguous() ? basic_cx_tensor<T>() : v.contiguous();
+            const C* pa = a.is_contiguous() ? a.data() : &dense_a[0];
+            const C* pv = v.is_contiguous() ? v.data() : &dense_v[0];
+
+            if (method == CONV_AUTO)
+                method = direct_is_cheaper(a.size(), v.size(), shape_size(nl), rank == 1 ? 2.0 : 16.0) ? CONV_DIRECT : CONV_FFT;
+
+            basic_cx_tensor<T> full;
+            std::vector<size_t> full_shape = nf;
+            if (rank == 1)
+            {
+                full = basic_cx_tensor<T>(nf, C(0, 0));
+                convolve_full(pa, na[0], pv, nv[0], &full[0], method);
+            }
+            else if (method == CONV_DIRECT)
+            {
+                full = basic_cx_tensor<T>(nf, C(0, 0));
+                direct_nd(pa, na, pv, nv, &full[0], nf);
+            }
+            else
+            {
+                // Zero-pad both operands to fast lengths and multiply the spectra.
+                auto identity = [](const C& z) { return z; };
+                const std::vector<ptrdiff_t> padded = contiguous_strides(nl);
+                full = basic_cx_tensor<T>(nl, C(0, 0));
+                basic_cx_tensor<T> kernel(nl, C(0, 0));
+                nd_unary_map(na, &full[0], padded, pa, contiguous_strides(na), identity);
+                nd_unary_map(nv, &kernel[0], padded, pv, contiguous_strides(nv), identity);
+                fft_inplace(full);
+                fft_inplace(kernel);
+                kernels::mul(full.size(), &full[0], &kernel[0], &full[0]);
+                ifft_inplace(full);
+                full_shape = nl;
+            }
+
+            size_t offset = 0;
+            const std::vector<ptrdiff_t> full_strides = contiguous_strides(full_shape);
+            for (size_t d = 0; d < rank; d++)
+                offset += start[d] * full_strides[d];
+            basic_cx_tensor<T> out(extent, C(0, 0));
+            nd_unary_map(extent, &out[0], contiguous_strides(extent), &full[0] + offset, full_strides,
+                         [](const C& z) { return z; });
+            return out;
+        }
+
+        // Kernel flipped along every axis and conjugated.
+        template <typename T>
+        basic_cx_tensor<T> correlation_kernel(const basic_cx_tensor_const_view<T>& v)
+        {
+            const std::vector<size_t>& shape = v.shape();
+            std::vector<ptrdiff_t> strides = v.strides();
+            const basic_cx<T>* last = v.data();
+            for (size_t d = 0; d < shape.size(); d++)
+            {
+                last += static_cast<ptrdiff_t>(shape[d] - 1) * strides[d];
+                strides[d] = -strides[d];
+            }
+            basic_cx_tensor<T> k(shape, basic_cx<T>(0, 0));
+            nd_unary_map(shape, &k[0], contiguous_strides(shape), last, strides,
+                         [](const basic_cx<T>& z) { return z.conjugate(); });
+            return k;
+        }
+    }
+
+    cx_vector convolve(const cx_vector& a, const cx_vector& v, __cx_conv_mode__ mode, __cx_conv_method__ method)
+    {
+        return convolve_vector(a, elements(v), mode, method);
+    }
+
+    cxd_vector convolve(const cxd_vector& a, const cxd_vector& v, __cx_conv_mode__ mode, __cx_conv_method__ method)
+    {
+        return convolve_vector(a, elements(v), mode, method);
+    }
+
+    cx_vector correlate(const cx_vector& a, const cx_vector& v, __cx_conv_mode__ mode, __cx_conv_method__ method)
+    {
+        return convolve_vector(a, correlation_kernel(v), mode, method);
+    }
+
+    cxd_vector correlate(const cxd_vector& a, const cxd_vector& v, __cx_conv_mode__ mode, __cx_conv_method__ method)
+    {
+        return convolve_vector(a, correlation_kernel(v), mode, method);
+    }
+
+    cx_vector fftconvolve(const cx_vector& a, const cx_vector& v, __cx_conv_mode__ mode)
+    {
+        return convolve(a, v, mode, CONV_FFT);
+    }
+
+    cxd_vector fftconvolve(const cxd_vector& a, const cxd_vector& v, __cx_conv_mode__ mode)
+    {
+        return convolve(a, v, mode, CONV_FFT);
+    }
+
+    cx_tensor convolve(const cx_tensor_const_view& a, const cx_tensor_const_view& v, __cx_conv_mode__ mode, __cx_conv_method__ method)
+    {
+        return convolve_tensor(a, v, mode, method);
+    }
+
+    cxd_tensor convolve(const cxd_tensor_const_view& a, const cxd_tensor_const_view& v, __cx_conv_mode__ mode, __cx_conv_method__ method)
+    {
+        return convolve_tensor(a, v, mode, method);
+    }
+
+    cx_tensor correlate(const cx_tensor_const_view& a, const cx_tensor_const_view& v, __cx_conv_mode__ mode, __cx_conv_method__ method)
+    {
+        return convolve_tensor(a, correlation_kernel(v).view(), mode, method);
+    }
+
+    cxd_tensor correlate(const cxd_tensor_const_view& a, const cxd_tensor_const_view& v, __cx_conv_mode__ mode, __cx_conv_method__ method)
+    {
+        return convolve_tensor(a, correlation_kernel(v).view(), mode, method);
+    }
+
+    cx_tensor fftconvolve(const cx_tensor_const_view& a, const cx_tensor_const_view& v, __cx_conv_mode__ mode)
+    {
+        return convolve(a, v, mode, CONV_FFT);
+    }
+
+    cxd_tensor fftconvolve(const cxd_tensor_const_view& a, const cxd_tensor_const_view& v, __cx_conv_mode__ mode)
+    {
+        return convolve(a, v, mode, CONV_FFT);
+    }
+
+    template <typename T>
+    basic_cx_overlap_save<T>::basic_cx_overlap_save(const std::vector<cx>& kernel, size_t fft_size)
+        : __taps__(kernel.size())
+    {
+        if (kernel.empty())
+            throw std::invalid_argument("Kernel cannot be empty.");
+        if (fft_size == 0)
+            fft_size = next_power_of_two(std::max<size_t>(8 * kernel.size(), 256));
+        if (fft_size < 2 * kernel.size())
+            throw std::invalid_argument("FFT size must be at least twice the kernel length.");
+
+        forward = fft_plan<T>(fft_size, FFT_FORWARD);
+        backward = fft_plan<T>(fft_size, FFT_BACKWARD);
+        spectrum.assign(fft_size, cx(0, 0));
+        std::copy(kernel.begin(), kernel.end(), spectrum.begin());
+        forward->execute(spectrum.data());
+        kernels::scale(fft_size, cx(T(1) / static_cast<T>(fft_size), 0), spectrum.data(), spectrum.data());
+        window.assign(fft_size, cx(0, 0));
+        buffer.resize(fft_size);
+    }
+
+    template <typename T>
+    void basic_cx_overlap_save<T>::process(const cx* in, size_t n, cx* out)
+    {
+        const size_t m = __taps__, block = block_size();
+        while (n > 0)
+        {
+            const size_t take = std::min(n, block - pending);
+            std::copy(in, in + take, window.begin() + (m - 1) + pending);
+            pending += take;
+            in += take;
+            n -= take;
+            if (pending < block && n > 0)
+                continue;
+
+            // The circular wrap-around only spoils the first m - 1 outputs,
+            // which belong to the samples kept from the previous block.
+            std::copy(window.begin(), window.begin() + (m - 1) + pending, buffer.begin());
+            std::fill(buffer.begin() + (m - 1) + pending, buffer.end(), cx(0, 0));
+            forward->execute(buffer.data());
+            kernels::mul(buffer.size(), buffer.data(), spectrum.data(), buffer.data());
+            backward->execute(buffer.data());
+            out = std::copy(buffer.begin() + (m - 1) + emitted, buffer.begin() + (m - 1) + pending, out);
+            emitted = pending;
+
+            if (pending == block)
+            {
+                std::copy(window.begin() + block, window.end(), window.begin());
+                pending = emitted = 0;
+            }
+        }
+    }
+
+    template <typename T>
+    std::vector<basic_cx<T>> basic_cx_overlap_save<T>::process(const std::vector<cx>& in)
+    {
+        std::vector<cx> out(in.size());
+        this->process(in.data(), in.size(), out.data());
+        return out;
+    }
+
+    template <typename T>
+    void basic_cx_overlap_save<T>::reset() noexcept
+    {
+        std::fill(window.begin(), window.end(), cx(0, 0));
+        pending = emitted = 0;
+    }
+
+    template class basic_cx_overlap_save<float>;
+    template class basic_cx_overlap_save<double>;
+}
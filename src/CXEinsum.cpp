@@ -0,0 +1,479 @@
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include "CXEinsum.h"
+#include "ComplexTensor.h"
+#include "CXElementwise.h"
+#include "CXGemm.h"
+#include "CXKernels.h"
+#include "CXThreadPool.h"
+
+namespace cx_lib
+{
+    namespace
+    {
+        // Minimum number of complex multiply-adds handed to a chunk of batches
+        // when the batches are spread over the pool. That only happens when a
+        // single product is too small for gemm to split it across threads;
+        // larger products run one batch after the other, each on the pool.
+        constexpr size_t BATCH_GRAIN = size_t(1) << 15;
+
+        /*
+         * Operand of a contraction: a view and one label per axis. An operand
+         * without labels is a scalar held in a view of shape {1}.
+         */
+        template <typename T>
+        struct labelled
+        {
+            basic_cx_tensor_const_view<T> view;
+            std::vector<int> labels;
+        };
+
+        using label_extents = std::map<int, size_t>;
+
+        bool contains(const std::vector<int>& labels, int label)
+        {
+            return std::find(labels.begin(), labels.end(), label) != labels.end();
+        }
+
+        size_t position(const std::vector<int>& labels, int label)
+        {
+            return static_cast<size_t>(std::find(labels.begin(), labels.end(), label) - labels.begin());
+        }
+
+        size_t volume(const std::vector<int>& labels, const label_extents& extents)
+        {
+            size_t n = 1;
+            for (int label : labels)
+                n *= extents.at(label);
+            return n;
+        }
+
+        std::vector<size_t> shape_of(const std::vector<int>& labels, const label_extents& extents)
+        {
+            std::vector<size_t> shape;
+            for (int label : labels)
+                shape.push_back(extents.at(label));
+            if (shape.empty())
+                shape.push_back(1);
+            return shape;
+        }
+
+        /*
+         * Take the diagonal of repeated labels and sum over the labels that
+         * are not in keep, so that every label left is shared with another
+         * operand or with the output.
+         */
+        template <typename T>
+        labelled<T> prepare(labelled<T> op, const std::vector<int>& keep)
+        {
+            for (size_t i = 0; i < op.labels.size(); i++)
+                for (size_t j = op.labels.size(); j-- > i + 1;)
+                    if (op.labels[j] == op.labels[i])
+                    {
+                        op.view = op.view.diagonal(i, j);
+                        op.labels.erase(op.labels.begin() + j);
+                    }
+
+            std::vector<size_t> axes;
+            std::vector<int> kept;
+            for (size_t d = 0; d < op.labels.size(); d++)
+            {
+                if (contains(keep, op.labels[d]))
+                    kept.push_back(op.labels[d]);
+                else
+                    axes.push_back(d);
+            }
+
+            if (!axes.empty())
+            {
+                op.view = op.view.sum(axes);
+                op.labels = kept;
+            }
+            return op;
+        }
+
+        /*
+         * A (batch, rows, cols) view as an operand of gemm: NO_TRANS when
+         * the columns are contiguous, TRANS when the rows are, otherwise a
+         * dense copy.
+         */
+        template <typename T>
+        struct gemm_operand
+        {
+            basic_cx_tensor_const_view<T> view;
+            __cx_gemm_op__ op = NO_TRANS;
+            size_t ld = 1;
+            ptrdiff_t batch_stride = 0;
+
+            explicit gemm_operand(const basic_cx_tensor_const_view<T>& v)
+                : view(v)
+            {
+                const size_t rows = v.shape()[1], cols = v.shape()[2];
+                const ptrdiff_t rs = v.strides()[1], cs = v.strides()[2];
+
+                if ((cols == 1 || cs == 1) && (rows == 1 || rs >= static_cast<ptrdiff_t>(cols)))
+                {
+                    ld = (rows == 1) ? cols : static_cast<size_t>(rs);
+                }
+                else if ((rows == 1 || rs == 1) && (cols == 1 || cs >= static_cast<ptrdiff_t>(rows)))
+                {
+                    op = TRANS;
+                    ld = (cols == 1) ? rows : static_cast<size_t>(cs);
+                }
+                else
+                {
+                    view = basic_cx_tensor_const_view<T>(v.contiguous());
+                    ld = cols;
+                }
+
+                batch_stride = (v.shape()[0] == 1) ? 0 : view.strides()[0];
+            }
+        };
+
+        /*
+         * Contract two prepared operands. Labels in both operands are batch
+         * axes if they are in keep and summed over otherwise; the others are
+         * free. a is viewed as (batch, free_a, summed) and b as (batch,
+         * summed, free_b), which turns the contraction into one GEMM per
+         * batch. Pairs with nothing summed are an element-wise product and
+         * pairs with nothing free a dot product per batch; neither goes
+         * through gemm. The result has labels batch + free_a + free_b.
+         */
+        template <typename T>
+        labelled<T> contract(const labelled<T>& a, const labelled<T>& b, const std::vector<int>& keep,
+                          const label_extents& extents)
+        {
+            std::vector<int> batch, free_a, free_b, summed;
+            for (int label : a.labels)
+            {
+                if (!contains(b.labels, label))
+                    free_a.push_back(label);
+                else if (contains(keep, label))
+                    batch.push_back(label);
+                else
+                    summed.push_back(label);
+            }
+            for (int label : b.labels)
+                if (!contains(a.labels, label))
+                    free_b.push_back(label);
+
+            const size_t nb = volume(batch, extents), m = volume(free_a, extents);
+            const size_t n = volume(free_b, extents), k = volume(summed, extents);
+
+            labelled<T> out{basic_cx_tensor<T>(), batch};
+            out.labels.insert(out.labels.end(), free_a.begin(), free_a.end());
+            out.labels.insert(out.labels.end(), free_b.begin(), free_b.end());
+            basic_cx_tensor<T> new_(shape_of(out.labels, extents), basic_cx<T>(0, 0));
+            basic_cx<T>* c = new_.view().data();
+
+            auto arrange = [](const labelled<T>& op, const std::vector<std::vector<int>>& groups,
+                              const std::vector<size_t>& shape) {
+                std::vector<size_t> perm;
+                for (const auto& group : groups)
+                    for (int label : group)
+                        perm.push_back(position(op.labels, label));
+                basic_cx_tensor_const_view<T> v = op.labels.empty() ? op.view : op.view.transpose(perm);
+                return v.reshape(shape);
+            };
+            const basic_cx_tensor_const_view<T> va = arrange(a, {batch, free_a, summed}, {nb, m, k});
+            const basic_cx_tensor_const_view<T> vb = arrange(b, {batch, summed, free_b}, {nb, k, n});
+
+            if (k == 1)
+            {
+                // Nothing summed (Hadamard and outer products): one element-wise
+                // product over (batch, free_a, free_b).
+                const std::vector<size_t> shape = {nb, m, n};
+                nd_binary_map(shape, c, contiguous_strides(shape),
+                              va.data(), {va.strides()[0], va.strides()[1], 0},
+                              vb.data(), {vb.strides()[0], 0, vb.strides()[2]},
+                              cx_mul_op());
+            }
+            else if (m == 1 && n == 1)
+            {
+                // Nothing free: one dot product per batch, on rows with unit stride.
+                auto rows = [](const basic_cx_tensor_const_view<T>& v, size_t axis) {
+                    return v.strides()[axis] == 1 ? v : basic_cx_tensor_const_view<T>(v.contiguous());
+                };
+                const basic_cx_tensor_const_view<T> ra = rows(va, 2), rb = rows(vb, 1);
+                parallel_for(0, nb, std::max<size_t>(1, BATCH_GRAIN / k), [&](size_t start, size_t end) {
+                    for (size_t t = start; t < end; t++)
+                    {
+                        const ptrdiff_t i = static_cast<ptrdiff_t>(t);
+                        c[t] = kernels::dot(k, ra.data() + i * ra.strides()[0], rb.data() + i * rb.strides()[0]);
+                    }
+                });
+            }
+            else
+            {
+                const gemm_operand<T> ga(va), gb(vb);
+                auto batches = [&](size_t start, size_t end) {
+                    for (size_t t = start; t < end; t++)
+                    {
+                        const ptrdiff_t i = static_cast<ptrdiff_t>(t);
+                        gemm(ga.op, gb.op, m, n, k,
+                             basic_cx<T>(1, 0), ga.view.data() + i * ga.batch_stride, ga.ld,
+                             gb.view.data() + i * gb.batch_stride, gb.ld,
+                             basic_cx<T>(0, 0), c + t * m * n, n);
+                    }
+                };
+
+                // gemm splits C across threads from two threads' worth of work.
+                const size_t work = m * n * k;
+                if (nb == 1 || work >= 2 * __cx_gemm_thread_work__)
+                    batches(0, nb);
+                else
+                    parallel_for(0, nb, std::max<size_t>(1, BATCH_GRAIN / std::max<size_t>(work, 1)), batches);
+            }
+
+            out.view = new_;
+            return out;
+        }
+
+        /*
+         * Labels that must survive once operands i and j (if any) are
+         * consumed: those of the output and of every other operand.
+         */
+        template <typename T>
+        std::vector<int> needed(const std::vector<labelled<T>>& ops, const std::vector<int>& output, size_t i, size_t j)
+        {
+            std::vector<int> keep(output);
+            for (size_t q = 0; q < ops.size(); q++)
+                if (q != i && q != j)
+                    keep.insert(keep.end(), ops[q].labels.begin(), ops[q].labels.end());
+            return keep;
+        }
+
+        template <typename T>
+        basic_cx_tensor<T> contract_all(std::vector<labelled<T>> ops, const std::vector<int>& output, const label_extents& extents)
+        {
+            for (size_t i = 0; i < ops.size(); i++)
+                ops[i] = prepare(ops[i], needed(ops, output, i, i));
+
+            while (ops.size() > 1)
+            {
+                // Greedy order: the pair with the smallest result, then the fewest multiply-adds.
+                size_t bi = 0, bj = 1, best_size = 0, best_work = 0;
+                for (size_t i = 0; i < ops.size(); i++)
+                    for (size_t j = i + 1; j < ops.size(); j++)
+                    {
+                        std::vector<int> keep = needed(ops, output, i, j);
+                        std::vector<int> all(ops[i].labels), kept;
+                        for (int label : ops[j].labels)
+                            if (!contains(all, label))
+                                all.push_back(label);
+                        for (int label : all)
+                            if (contains(keep, label))
+                                kept.push_back(label);
+
+                        size_t size = volume(kept, extents), work = volume(all, extents);
+                        if ((i == 0 && j == 1) || size < best_size || (size == best_size && work < best_work))
+                        {
+                            bi = i;
+                            bj = j;
+                            best_size = size;
+                            best_work = work;
+                        }
+                    }
+
+                labelled<T> c = contract(ops[bi], ops[bj], needed(ops, output, bi, bj), extents);
+                ops.erase(ops.begin() + bj);
+                ops.erase(ops.begin() + bi);
+                ops.push_back(c);
+            }
+
+            const labelled<T>& result = ops[0];
+            if (output.empty())
+                return result.view.contiguous();
+
+            std::vector<size_t> perm;
+            for (int label : output)
+                perm.push_back(position(result.labels, label));
+            return result.view.transpose(perm).contiguous();
+        }
+
+        void record_extent(label_extents& extents, int label, size_t extent)
+        {
+            auto it = extents.find(label);
+            if (it == extents.end())
+                extents[label] = extent;
+            else if (it->second != extent)
+                throw std::invalid_argument("Mismatched extents for a contracted index.");
+        }
+
+        template <typename T>
+        basic_cx_tensor<T> einsum_impl(const std::string& subscripts, const std::vector<basic_cx_tensor_const_view<T>>& operands)
+        {
+            std::string spec;
+            for (char ch : subscripts)
+                if (!std::isspace(static_cast<unsigned char>(ch)))
+                    spec.push_back(ch);
+
+            const size_t arrow = spec.find("->");
+            const std::string inputs = spec.substr(0, arrow);
+
+            std::vector<std::string> terms(1);
+            for (char ch : inputs)
+            {
+                if (ch == ',')
+                    terms.emplace_back();
+                else if (std::isalpha(static_cast<unsigned char>(ch)))
+                    terms.back().push_back(ch);
+                else
+                    throw std::invalid_argument("Invalid einsum subscripts.");
+            }
+            if (terms.size() != operands.size())
+                throw std::invalid_argument("Number of einsum subscripts does not match the number of operands.");
+
+            std::vector<labelled<T>> ops;
+            label_extents extents;
+            std::map<int, size_t> count;
+            for (size_t i = 0; i < operands.size(); i++)
+            {
+                if (terms[i].size() != operands[i].shape().size())
+                    throw std::invalid_argument("Einsum subscripts do not match the operand dimensions.");
+
+                labelled<T> op{operands[i], {}};
+                for (size_t d = 0; d < terms[i].size(); d++)
+                {
+                    record_extent(extents, terms[i][d], operands[i].shape()[d]);
+                    op.labels.push_back(terms[i][d]);
+                    count[terms[i][d]]++;
+                }
+                ops.push_back(op);
+            }
+
+            std::vector<int> output;
+            if (arrow == std::string::npos)
+            {
+                for (const auto& c : count)
+                    if (c.second == 1)
+                        output.push_back(c.first);
+            }
+            else
+            {
+                for (char ch : spec.substr(arrow + 2))
+                {
+                    if (!std::isalpha(static_cast<unsigned char>(ch)) || !count.count(ch) || contains(output, ch))
+                        throw std::invalid_argument("Invalid einsum output subscripts.");
+                    output.push_back(ch);
+                }
+            }
+
+            return contract_all(ops, output, extents);
+        }
+
+        template <typename T>
+        basic_cx_tensor<T> tensordot_impl(const basic_cx_tensor_const_view<T>& a, const basic_cx_tensor_const_view<T>& b,
+                                          const std::vector<size_t>& axes_a, const std::vector<size_t>& axes_b)
+        {
+            const size_t rank_a = a.shape().size(), rank_b = b.shape().size();
+            if (axes_a.size() != axes_b.size())
+                throw std::invalid_argument("Axes of both operands must have the same size.");
+
+            // Axis d of a gets label d and axis d of b label rank_a + d, except
+            // contracted axes of b that take the label of their partner in a.
+            labelled<T> la{a, {}}, lb{b, {}};
+            label_extents extents;
+            for (size_t d = 0; d < rank_a; d++)
+            {
+                la.labels.push_back(static_cast<int>(d));
+                extents[static_cast<int>(d)] = a.shape()[d];
+            }
+            for (size_t d = 0; d < rank_b; d++)
+            {
+                lb.labels.push_back(static_cast<int>(rank_a + d));
+                extents[static_cast<int>(rank_a + d)] = b.shape()[d];
+            }
+
+            std::vector<bool> used_a(rank_a, false), used_b(rank_b, false);
+            for (size_t i = 0; i < axes_a.size(); i++)
+            {
+                if (axes_a[i] >= rank_a || axes_b[i] >= rank_b || used_a[axes_a[i]] || used_b[axes_b[i]])
+                    throw std::invalid_argument("Invalid axis for tensordot.");
+                if (a.shape()[axes_a[i]] != b.shape()[axes_b[i]])
+                    throw std::invalid_argument("Mismatched extents for a contracted index.");
+                used_a[axes_a[i]] = used_b[axes_b[i]] = true;
+                lb.labels[axes_b[i]] = la.labels[axes_a[i]];
+            }
+
+            std::vector<int> output;
+            for (size_t d = 0; d < rank_a; d++)
+                if (!used_a[d])
+                    output.push_back(la.labels[d]);
+            for (size_t d = 0; d < rank_b; d++)
+                if (!used_b[d])
+                    output.push_back(lb.labels[d]);
+
+            return contract_all(std::vector<labelled<T>>{la, lb}, output, extents);
+        }
+
+        template <typename T>
+        basic_cx_tensor<T> tensordot_impl(const basic_cx_tensor_const_view<T>& a, const basic_cx_tensor_const_view<T>& b, size_t n)
+        {
+            const size_t rank_a = a.shape().size();
+            if (n > rank_a || n > b.shape().size())
+                throw std::invalid_argument("Invalid axis for tensordot.");
+
+            std::vector<size_t> axes_a(n), axes_b(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                axes_a[i] = rank_a - n + i;
+                axes_b[i] = i;
+            }
+            return tensordot_impl(a, b, axes_a, axes_b);
+        }
+    }
+
+    cx_tensor einsum(const std::string& subscripts, const std::vector<cx_tensor_const_view>& operands)
+    {
+        return einsum_impl(subscripts, operands);
+    }
+
+    cx_tensor einsum(const std::string& subscripts, const cx_tensor_const_view& a)
+    {
+        return einsum_impl(subscripts, std::vector<cx_tensor_const_view>{a});
+    }
+
+    cx_tensor einsum(const std::string& subscripts, const cx_tensor_const_view& a, const cx_tensor_const_view& b)
+    {
+        return einsum_impl(subscripts, std::vector<cx_tensor_const_view>{a, b});
+    }
+
+    cx_tensor tensordot(const cx_tensor_const_view& a, const cx_tensor_const_view& b,
+                         const std::vector<size_t>& axes_a, const std::vector<size_t>& axes_b)
+    {
+        return tensordot_impl(a, b, axes_a, axes_b);
+    }
+
+    cx_tensor tensordot(const cx_tensor_const_view& a, const cx_tensor_const_view& b, size_t n)
+    {
+        return tensordot_impl(a, b, n);
+    }
+
+    cxd_tensor einsum(const std::string& subscripts, const std::vector<cxd_tensor_const_view>& operands)
+    {
+        return einsum_impl(subscripts, operands);
+    }
+
+    cxd_tensor einsum(const std::string& subscripts, const cxd_tensor_const_view& a)
+    {
+        return einsum_impl(subscripts, std::vector<cxd_tensor_const_view>{a});
+    }
+
+    cxd_tensor einsum(const std::string& subscripts, const cxd_tensor_const_view& a, const cxd_tensor_const_view& b)
+    {
+        return einsum_impl(subscripts, std::vector<cxd_tensor_const_view>{a, b});
+    }
+
+    cxd_tensor tensordot(const cxd_tensor_const_view& a, const cxd_tensor_const_view& b,
+                          const std::vector<size_t>& axes_a, const std::vector<size_t>& axes_b)
+    {
+        return tensordot_impl(a, b, axes_a, axes_b);
+    }
+
+    cxd_tensor tensordot(const cxd_tensor_const_view& a, const cxd_tensor_const_view& b, size_t n)
+    {
+        return tensordot_impl(a, b, n);
+    }
+}
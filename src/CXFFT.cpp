@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include "CXFFT.h"
+#include "CXKernels.h"
+#include "CXThreadPool.h"
+
+namespace cx_lib
+{
+    namespace
+    {
+        // Largest prime handled by a generic O(p^2) butterfly; sizes with a
+        // larger prime factor go through Bluestein.
+        constexpr size_t max_generic_radix = 13;
+        // Butterfly outputs per chunk when a pass is split across threads.
+        constexpr size_t parallel_grain = size_t(1) << 14;
+        constexpr double pi = 3.14159265358979323846;
+        // Elements of the per-thread tile of lines transposed out of a
+        // non-contiguous axis (bounded to stay in the L2 cache).
+        constexpr size_t tile_elements = size_t(1) << 13;
+        // Largest scratch kept by a thread between execute(in, out) calls;
+        // larger transforms allocate theirs for the call only.
+        constexpr size_t cached_work_elements = size_t(1) << 16;
+
+        // Radices of n: generic primes first (they are scalar and cheapest
+        // while the stride is small), then at most one 2, then the 4s.
+        std::vector<size_t> factorize(size_t n)
+        {
+            std::vector<size_t> fours, radices;
+            while (n % 4 == 0)
+            {
+                fours.push_back(4);
+                n /= 4;
+            }
+            const bool two = (n % 2 == 0);
+            if (two)
+                n /= 2;
+            for (size_t p = 3; p * p <= n; p += 2)
+                while (n % p == 0)
+                {
+                    radices.push_back(p);
+                    n /= p;
+                }
+            if (n > 1)
+                radices.push_back(n);
+            if (two)
+                radices.push_back(2);
+            radices.insert(radices.end(), fours.begin(), fours.end());
+            return radices;
+        }
+
+        // e^{sign * 2 pi i k / n}, computed in double precision.
+        template <typename C>
+        C root_of_unity(size_t k, size_t n, double sign)
+        {
+            const double angle = sign * 2.0 * pi * static_cast<double>(k % n) / static_cast<double>(n);
+            return C(cxd(std::cos(angle), std::sin(angle)));
+        }
+
+        template <typename T>
+        struct plan_cache
+        {
+            std::mutex mutex;
+            std::map<std::pair<size_t, int>, std::shared_ptr<const basic_cx_fft_plan<T>>> plans;
+
+            static plan_cache& instance()
+            {
+                static plan_cache cache;
+                return cache;
+            }
+
+            void clear()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                plans.clear();
+            }
+        };
+    }
+
+    template <typename T>
+    basic_cx_fft_plan<T>::basic_cx_fft_plan(size_t n, __cx_fft_direction__ direction)
+        : __size__(n), __direction__(direction)
+    {
+        if (n == 0)
+            throw std::invalid_argument("FFT length must be positive.");
+
+        const double sign = (direction == FFT_FORWARD) ? -1.0 : 1.0;
+        const std::vector<size_t> radices = (n > 1) ? factorize(n) : std::vector<size_t>();
+        const bool small_primes = std::all_of(radices.begin(), radices.end(),
+                                              [](size_t p) { return p == 4 || p <= max_generic_radix; });
+
+        if (small_primes)
+        {
+            size_t len = n, stride = 1;
+            for (size_t p : radices)
+            {
+                pass ps{p, len, stride, {}, {}};
+                const size_t m = len / p;
+                ps.twiddles.resize(m * (p - 1));
+                for (size_t j = 0; j < m; j++)
+                    for (size_t t = 1; t < p; t++)
+                        ps.twiddles[j * (p - 1) + t - 1] = root_of_unity<cx>(j * t, len, sign);
+                if (p != 2 && p != 4)
+                    for (size_t k = 0; k < p; k++)
+                        ps.roots.push_back(root_of_unity<cx>(k, p, sign));
+
+                passes.push_back(std::move(ps));
+                len = m;
+                stride *= p;
+            }
+            return;
+        }
+
+        // Bluestein: jk = (j^2 + k^2 - (k - j)^2) / 2 turns the transform into
+        // the circular convolution of x[j] * c[j] with conj(c), c[k] = e^{-+pi i k^2 / n}.
+        size_t m = 1;
+        while (m < 2 * n - 1)
+            m <<= 1;
+        convolution = fft_plan<T>(m, FFT_FORWARD);
+
+        chirp.resize(n);
+        for (size_t k = 0, k2 = 0; k < n; k++)
+        {
+            // k2 = k^2 mod 2n, updated incrementally to avoid overflow
+            chirp[k] = root_of_unity<cx>(k2, 2 * n, sign);
+            k2 = (k2 + 2 * k + 1) % (2 * n);
+        }
+
+        chirp_spectrum.assign(m, cx(0, 0));
+        chirp_spectrum[0] = chirp[0].conjugate();
+        for (size_t k = 1; k < n; k++)
+            chirp_spectrum[k] = chirp_spectrum[m - k] = chirp[k].conjugate();
+        std::vector<cx> work(convolution->work_size());
+        convolution->execute(chirp_spectrum.data(), chirp_spectrum.data(), work.data());
+        // The inverse transform of the convolution is unnormalized: fold the 1 / m in here.
+        kernels::scale(m, cx(T(1) / static_cast<T>(m), 0), chirp_spectrum.data(), chirp_spectrum.data());
+    }
+
+    template <typename T>
+    size_t basic_cx_fft_plan<T>::work_size() const noexcept
+    {
+        if (convolution)
+            return convolution->size() + convolution->work_size();
+        return __size__;
+    }
+
+    template <typename T>
+    void basic_cx_fft_plan<T>::run_pass(const pass& ps, const cx* src, cx* dst) const
+    {
+        const size_t p = ps.radix, s = ps.stride, m = ps.len / p;
+        const bool inverse = (__direction__ == FFT_BACKWARD);
+
+        // Sub-transform j of length len reads src[q + s * (j + r * m)] and
+        // writes dst[q + s * (p * j + t)], for q in [q0, q1).
+        auto butterflies = [&](size_t j0, size_t j1, size_t q0, size_t q1) {
+            const size_t n = q1 - q0;
+            for (size_t j = j0; j < j1; j++)
+            {
+                const cx* x = src + s * j + q0;
+                cx* y = dst + s * p * j + q0;
+                const cx* w = ps.twiddles.data() + j * (p - 1);
+                if (p == 4)
+                    kernels::fft_radix4(n, x, s * m, w, inverse, y, s);
+                else if (p == 2)
+                    kernels::fft_radix2(n, x, s * m, w[0], y, s);
+                else
+                {
+                    cx a[max_generic_radix];
+                    for (size_t q = 0; q < n; q++)
+                    {
+                        for (size_t r = 0; r < p; r++)
+                            a[r] = x[q + s * m * r];
+                        for (size_t t = 0; t < p; t++)
+                        {
+                            cx acc = a[0];
+                            for (size_t r = 1, k = t; r < p; r++, k = (k + t) % p)
+                                acc += a[r] * ps.roots[k];
+                            y[q + s * t] = (t == 0) ? acc : acc * w[t - 1];
+                        }
+                    }
+                }
+            }
+        };
+
+        if (__size__ < 4 * parallel_grain)
+        {
+            butterflies(0, m, 0, s);
+            return;
+        }
+
+        // Early passes have many short sub-transforms, late ones few long
+        // spans: split whichever dimension is larger.
+        if (m >= s)
+            parallel_for(0, m, std::max<size_t>(1, parallel_grain / (s * p)),
+                         [&](size_t j0, size_t j1) { butterflies(j0, j1, 0, s); });
+        else
+            parallel_for(0, s, std::max<size_t>(1, parallel_grain / (m * p)),
+                         [&](size_t q0, size_t q1) { butterflies(0, m, q0, q1); });
+    }
+
+    template <typename T>
+    void basic_cx_fft_plan<T>::stockham(const cx* in, cx* out, cx* work) const
+    {
+        const size_t k = passes.size();
+        if (k == 0)
+        {
+            if (in != out)
+                std::copy(in, in + __size__, out);
+            return;
+        }
+
+        // Passes alternate between out and work, ending in out; the first
+        // pass must not write the buffer it reads.
+        const cx* src = in;
+        if (k % 2 == 1 && in == out)
+        {
+            std::copy(in, in + __size__, work);
+            src = work;
+        }
+        for (size_t i = 0; i < k; i++)
+        {
+            cx* dst = ((k - 1 - i) % 2 == 0) ? out : work;
+            run_pass(passes[i], src, dst);
+            src = dst;
+        }
+    }
+
+    template <typename T>
+    void basic_cx_fft_plan<T>::bluestein(const cx* in, cx* out, cx* work) const
+    {
+        const size_t n = __size__, m = convolution->size();
+        cx* a = work;
+        cx* inner = work + m;
+
+        kernels::mul(n, in, chirp.data(), a);
+        std::fill(a + n, a + m, cx(0, 0));
+        convolution->execute(a, a, inner);
+        kernels::mul(m, a, chirp_spectrum.data(), a);
+
+        // Inverse transform as conj(FFT(conj(.))), reusing the forward plan.
+        for (size_t k = 0; k < m; k++)
+            a[k].imag = -a[k].imag;
+        convolution->execute(a, a, inner);
+        kernels::conj_mul(n, a, chirp.data(), out);
+    }
+
+    template <typename T>
+    void basic_cx_fft_plan<T>::execute(const cx* in, cx* out, cx* work) const
+    {
+        if (convolution)
+            bluestein(in, out, work);
+        else
+            stockham(in, out, work);
+    }
+
+    template <typename T>
+    void basic_cx_fft_plan<T>::execute(const cx* in, cx* out) const
+    {
+        const size_t size = work_size();
+        if (size > cached_work_elements)
+        {
+            std::vector<cx> work(size);
+            execute(in, out, work.data());
+            return;
+        }
+
+        thread_local std::vector<cx> scratch;
+        if (scratch.size() < size)
+            scratch.resize(size);
+        execute(in, out, scratch.data());
+    }
+
+    template <typename T>
+    std::shared_ptr<const basic_cx_fft_plan<T>> fft_plan(size_t n, __cx_fft_direction__ direction)
+    {
+        auto& cache = plan_cache<T>::instance();
+        const auto key = std::make_pair(n, static_cast<int>(direction));
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            auto it = cache.plans.find(key);
+            if (it != cache.plans.end())
+                return it->second;
+        }
+
+        // Built outside the lock: a Bluestein plan asks the cache for its inner plan.
+        auto plan = std::make_shared<const basic_cx_fft_plan<T>>(n, direction);
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        return cache.plans.emplace(key, plan).first->second;
+    }
+
+    void clear_fft_plans()
+    {
+        plan_cache<float>::instance().clear();
+        plan_cache<double>::instance().clear();
+    }
+
+    namespace
+    {
+        template <typename T>
+        basic_cx_vector<T> transform(const basic_cx_vector<T>& x, __cx_fft_direction__ direction)
+        {
+            auto plan = fft_plan<T>(x.dim(), direction);
+            basic_cx_vector<T> out(x.dim(), basic_cx<T>(0, 0));
+            plan->execute(&x[0], &out[0]);
+            if (direction == FFT_BACKWARD)
+                out *= T(1) / static_cast<T>(x.dim());
+            return out;
+        }
+
+        template <typename T>
+        void transform_inplace(basic_cx_vector<T>& x, __cx_fft_direction__ direction)
+        {
+            fft_plan<T>(x.dim(), direction)->execute(&x[0]);
+            if (direction == FFT_BACKWARD)
+                x *= T(1) / static_cast<T>(x.dim());
+        }
+    }
+
+    cx_vector fft(const cx_vector& x) { return transform(x, FFT_FORWARD); }
+    cxd_vector fft(const cxd_vector& x) { return transform(x, FFT_FORWARD); }
+    cx_vector ifft(const cx_vector& x) { return transform(x, FFT_BACKWARD); }
+    cxd_vector ifft(const cxd_vector& x) { return transform(x, FFT_BACKWARD); }
+    void fft_inplace(cx_vector& x) { transform_inplace(x, FFT_FORWARD); }
+    void fft_inplace(cxd_vector& x) { transform_inplace(x, FFT_FORWARD); }
+    void ifft_inplace(cx_vector& x) { transform_inplace(x, FFT_BACKWARD); }
+    void ifft_inplace(cxd_vector& x) { transform_inplace(x, FFT_BACKWARD); }
+
+    namespace
+    {
+        // 1-D transforms of every line along axis of the dense row-major
+        // buffer data, in place.
+        template <typename T>
+        void transform_axis(basic_cx<T>* data, const std::vector<size_t>& shape, size_t axis,
+                            const basic_cx_fft_plan<T>& plan)
+        {
+            using C = basic_cx<T>;
+            const size_t n = shape[axis];
+            size_t outer = 1, inner = 1;
+            for (size_t i = 0; i < axis; i++)
+                outer *= shape[i];
+            for (size_t i = axis + 1; i < shape.size(); i++)
+                inner *= shape[i];
+            if (n == 1)
+                return;
+
+            if (inner == 1)
+            {
+                parallel_for(0, outer, std::max<size_t>(1, parallel_grain / n), [&](size_t l0, size_t l1) {
+                    for (size_t l = l0; l < l1; l++)
+                        plan.execute(data + l * n, data + l * n);
+                });
+                return;
+            }
+
+            // Lines are inner elements apart: each task moves a tile of
+            // `batch` adjacent lines (contiguous runs of every row) into
+            // a buffer where they are contiguous, and back. The tile holds
+            // at most tile_elements, or a single line when n is larger.
+            const size_t batch = std::min(inner, std::max<size_t>(1, tile_elements / n));
+            const size_t tiles = (inner + batch - 1) / batch;
+            parallel_for(0, outer * tiles, std::max<size_t>(1, parallel_grain / (n * batch)), [&](size_t t0, size_t t1) {
+                std::vector<C> tile(batch * n), work(plan.work_size());
+                for (size_t t = t0; t < t1; t++)
+                {
+                    C* block = data + (t / tiles) * n * inner;
+                    const size_t q0 = (t % tiles) * batch, width = std::min(batch, inner - q0);
+                    for (size_t i = 0; i < n; i++)
+                        for (size_t b = 0; b < width; b++)
+                            tile[b * n + i] = block[i * inner + q0 + b];
+                    for (size_t b = 0; b < width; b++)
+                        plan.execute(tile.data() + b * n, tile.data() + b * n, work.data());
+                    for (size_t i = 0; i < n; i++)
+                        for (size_t b = 0; b < width; b++)
+                            block[i * inner + q0 + b] = tile[b * n + i];
+                }
+            });
+        }
+
+        template <typename T>
+        void transform_inplace(basic_cx_tensor<T>& x, std::vector<size_t> axes, __cx_fft_direction__ direction)
+        {
+            const std::vector<size_t>& shape = x.shape();
+            for (size_t axis : axes)
+                if (axis >= shape.size())
+                    throw std::invalid_argument("Invalid axis for fft.");
+            if (x.size() == 0)
+                return;
+            if (axes.empty())
+            {
+                axes.resize(shape.size());
+                std::iota(axes.begin(), axes.end(), size_t(0));
+            }
+
+            size_t points = 1;
+            for (size_t axis : axes)
+            {
+                transform_axis(&x[0], shape, axis, *fft_plan<T>(shape[axis], direction));
+                points *= shape[axis];
+            }
+            if (direction == FFT_BACKWARD)
+                x *= basic_cx<T>(T(1) / static_cast<T>(points), 0);
+        }
+
+        template <typename T>
+        basic_cx_tensor<T> transform(const basic_cx_tensor_const_view<T>& x, const std::vector<size_t>& axes,
+                                     __cx_fft_direction__ direction)
+        {
+            basic_cx_tensor<T> out(x);
+            transform_inplace(out, axes, direction);
+            return out;
+        }
+    }
+
+    cx_tensor fft(const cx_tensor_const_view& x, const std::vector<size_t>& axes) { return transform(x, axes, FFT_FORWARD); }
+    cxd_tensor fft(const cxd_tensor_const_view& x, const std::vector<size_t>& axes) { return transform(x, axes, FFT_FORWARD); }
+    cx_tensor ifft(const cx_tensor_const_view& x, const std::vector<size_t>& axes) { return transform(x, axes, FFT_BACKWARD); }
+    cxd_tensor ifft(const cxd_tensor_const_view& x, const std::vector<size_t>& axes) { return transform(x, axes, FFT_BACKWARD); }
+    void fft_inplace(cx_tensor& x, const std::vector<size_t>& axes) { transform_inplace(x, axes, FFT_FORWARD); }
+    void fft_inplace(cxd_tensor& x, const std::vector<size_t>& axes) { transform_inplace(x, axes, FFT_FORWARD); }
+    void ifft_inplace(cx_tensor& x, const std::vector<size_t>& axes) { transform_inplace(x, axes, FFT_BACKWARD); }
+    void ifft_inplace(cxd_tensor& x, const std::vector<size_t>& axes) { transform_inplace(x, axes, FFT_BACKWARD); }
+
+    template class basic_cx_fft_plan<float>;
+    template class basic_cx_fft_plan<double>;
+    template std::shared_ptr<const basic_cx_fft_plan<float>> fft_plan<float>(size_t, __cx_fft_direction__);
+    template std::shared_ptr<const basic_cx_fft_plan<double>> fft_plan<double>(size_t, __cx_fft_direction__);
+}
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <vector>
+#include "CXGemm.h"
+#include "CXThreadPool.h"
+#include "CXMemory.h"
+
+namespace cx_lib
+{
+    namespace
+    {
+        // Register tile: MR rows of op(A) times NR columns of op(B).
+        constexpr size_t MR = 4;
+        constexpr size_t NR = 8;
+        // Cache blocks: a KC x NR sliver of B stays in L1, an MC x KC block
+        // of A in L2 and a KC x NC panel of B in L3.
+        constexpr size_t KC = 256;
+        constexpr size_t MC = 128;
+        constexpr size_t NC = 2048;
+
+        template <typename T>
+        using packed_buffer = std::vector<T, cx_aligned_allocator<T>>;
+
+        template <typename C>
+        inline C fetch(const C* p, size_t ld, size_t i, size_t j, __cx_gemm_op__ op) noexcept
+        {
+            switch (op)
+            {
+                case TRANS:
+                    return p[j * ld + i];
+                case CONJ_TRANS:
+                    return p[j * ld + i].conjugate();
+                default:
+                    return p[i * ld + j];
+            }
+        }
+
+        /*
+         * Pack alpha * op(A)[ic:ic+mc, pc:pc+kc] into MR-row slivers. Each
+         * sliver stores, for every p, MR real parts followed by MR imaginary
+         * parts; rows past mc are zero padded.
+         */
+        template <typename C>
+        void pack_a(const C* a, size_t lda, __cx_gemm_op__ op, const C& alpha,
+                    size_t ic, size_t pc, size_t mc, size_t kc, typename C::value_type* dst) noexcept
+        {
+            for (size_t ir = 0; ir < mc; ir += MR)
+            {
+                size_t mr = std::min(MR, mc - ir);
+                for (size_t p = 0; p < kc; p++)
+                {
+                    for (size_t i = 0; i < MR; i++)
+                    {
+                        C v(0, 0);
+                        if (i < mr)
+                            v = alpha * fetch(a, lda, ic + ir + i, pc + p, op);
+                        dst[i] = v.real;
+                        dst[MR + i] = v.imag;
+                    }
+                    dst += 2 * MR;
+                }
+            }
+        }
+
+        /*
+         * Pack op(B)[pc:pc+kc, jc:jc+nc] into NR-column slivers, laid out
+         * like pack_a (NR real parts then NR imaginary parts per p).
+         */
+        template <typename C>
+        void pack_b(const C* b, size_t ldb, __cx_gemm_op__ op,
+                    size_t pc, size_t jc, size_t kc, size_t nc, typename C::value_type* dst) noexcept
+        {
+            for (size_t jr = 0; jr < nc; jr += NR)
+            {
+                size_t nr = std::min(NR, nc - jr);
+                for (size_t p = 0; p < kc; p++)
+                {
+                    if (op == NO_TRANS && nr == NR)
+                    {
+                        const C* src = b + (pc + p) * ldb + jc + jr;
+                        for (size_t j = 0; j < NR; j++)
+                        {
+                            dst[j] = src[j].real;
+                            dst[NR + j] = src[j].imag;
+                        }
+                    }
+                    else
+                    {
+                        for (size_t j = 0; j < NR; j++)
+                        {
+                            C v(0, 0);
+                            if (j < nr)
+                                v = fetch(b, ldb, pc + p, jc + jr + j, op);
+                            dst[j] = v.real;
+                            dst[NR + j] = v.imag;
+                        }
+                    }
+                    dst += 2 * NR;
+                }
+            }
+        }
+
+        /*
+         * C[0:mr, 0:nr] += A_sliver * B_sliver. The accumulators are kept as
+         * separate real/imaginary MR x NR blocks so the inner loop over j is
+         * a plain fused multiply-add over NR reals.
+         */
+        template <typename T>
+        void micro_kernel(size_t kc, const T* __restrict ap, const T* __restrict bp,
+                          basic_cx<T>* c, size_t ldc, size_t mr, size_t nr) noexcept
+        {
+            T cr[MR][NR] = {};
+            T ci[MR][NR] = {};
+
+            for (size_t p = 0; p < kc; p++)
+            {
+                const T* br = bp + p * 2 * NR;
+                const T* bi = br + NR;
+                const T* ar = ap + p * 2 * MR;
+                const T* ai = ar + MR;
+#pragma GCC unroll 8
+                for (size_t i = 0; i < MR; i++)
+                {
+#pragma GCC unroll 16
+                    for (size_t j = 0; j < NR; j++)
+                    {
+                        cr[i][j] += ar[i] * br[j] - ai[i] * bi[j];
+                        ci[i][j] += ar[i] * bi[j] + ai[i] * br[j];
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < mr; i++)
+            {
+                basic_cx<T>* row = c + i * ldc;
+                for (size_t j = 0; j < nr; j++)
+                {
+                    row[j].real += cr[i][j];
+                    row[j].imag += ci[i][j];
+                }
+            }
+        }
+
+        template <typename C>
+        void scale(size_t m, size_t n, const C& beta, C* c, size_t ldc) noexcept
+        {
+            if (beta == C(1, 0))
+                return;
+
+            for (size_t i = 0; i < m; i++)
+            {
+                C* row = c + i * ldc;
+                if (beta == C(0, 0))
+                    std::fill(row, row + n, C(0, 0));
+                else
+                    for (size_t j = 0; j < n; j++)
+                        row[j] *= beta;
+            }
+        }
+
+        /*
+         * Single-threaded blocked product on one tile of C. The loop order
+         * (jc, pc, ic, jr, ir) keeps a packed KC x NC panel of op(B) resident
+         * while MC x KC blocks of op(A) stream through it.
+         */
+        template <typename C>
+        void gemm_tile(__cx_gemm_op__ op_a, __cx_gemm_op__ op_b,
+                       size_t m, size_t n, size_t k,
+                       const C& alpha, const C* a, size_t lda,
+                       const C* b, size_t ldb,
+                       const C& beta, C* c, size_t ldc)
+        {
+            using T = typename C::value_type;
+            scale(m, n, beta, c, ldc);
+            if (k == 0 || alpha == C(0, 0))
+                return;
+
+            packed_buffer<T> a_pack(2 * (std::min(MC, m) + MR) * std::min(KC, k));
+            packed_buffer<T> b_pack(2 * (std::min(NC, n) + NR) * std::min(KC, k));
+
+            for (size_t jc = 0; jc < n; jc += NC)
+            {
+                size_t nc = std::min(NC, n - jc);
+                for (size_t pc = 0; pc < k; pc += KC)
+                {
+                    size_t kc = std::min(KC, k - pc);
+                    pack_b(b, ldb, op_b, pc, jc, kc, nc, b_pack.data());
+
+                    for (size_t ic = 0; ic < m; ic += MC)
+                    {
+                        size_t mc = std::min(MC, m - ic);
+                        pack_a(a, lda, op_a, alpha, ic, pc, mc, kc, a_pack.data());
+
+                        for (size_t jr = 0; jr < nc; jr += NR)
+                        {
+                            size_t nr = std::min(NR, nc - jr);
+                            const T* bp = b_pack.data() + jr * 2 * kc;
+                            for (size_t ir = 0; ir < mc; ir += MR)
+                            {
+                                size_t mr = std::min(MR, mc - ir);
+                                const T* ap = a_pack.data() + ir * 2 * kc;
+                                micro_kernel(kc, ap, bp, c + (ic + ir) * ldc + jc + jr, ldc, mr, nr);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        /*
+         * Split num_threads into a tiles_m x tiles_n grid whose tiles are as
+         * close to square as possible, so every thread packs a comparable
+         * share of op(A) and op(B).
+         */
+        std::pair<size_t, size_t> tile_grid(size_t m, size_t n, size_t num_threads) noexcept
+        {
+            std::pair<size_t, size_t> best(num_threads, 1);
+            double best_ratio = -1.0;
+            for (size_t tm = 1; tm <= num_threads; tm++)
+            {
+                if (num_threads % tm != 0)
+                    continue;
+                size_t tn = num_threads / tm;
+                if (tm > (m + MR - 1) / MR || tn > (n + NR - 1) / NR)
+                    continue;
+                double h = static_cast<double>(m) / tm;
+                double w = static_cast<double>(n) / tn;
+                double ratio = std::min(h, w) / std::max(h, w);
+                if (ratio > best_ratio)
+                {
+                    best_ratio = ratio;
+                    best = std::make_pair(tm, tn);
+                }
+            }
+            return best;
+        }
+
+        // Split [0, len) into parts pieces whose boundaries are multiples of unit.
+        size_t tile_bound(size_t len, size_t parts, size_t index, size_t unit) noexcept
+        {
+            size_t units = (len + unit - 1) / unit;
+            return std::min(len, (units * index / parts) * unit);
+        }
+
+        template <typename C>
+        void gemm_impl(__cx_gemm_op__ op_a, __cx_gemm_op__ op_b,
+                       size_t m, size_t n, size_t k,
+                       const C& alpha, const C* a, size_t lda,
+                       const C* b, size_t ldb,
+                       const C& beta, C* c, size_t ldc)
+        {
+            if (m == 0 || n == 0)
+                return;
+
+            size_t num_threads = 1;
+            if (__cx_multithread_enabled__ && !cx_thread_pool::in_parallel_region())
+            {
+                // Below __cx_gemm_thread_work__ complex multiply-adds per
+                // thread, waking workers costs more than it saves.
+                num_threads = std::min(get_num_threads(), std::max<size_t>(1, (m * n * std::max<size_t>(k, 1)) / __cx_gemm_thread_work__));
+            }
+
+            std::pair<size_t, size_t> grid = tile_grid(m, n, num_threads);
+            size_t num_tiles = grid.first * grid.second;
+            if (num_tiles <= 1)
+            {
+                gemm_tile(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+                return;
+            }
+
+            parallel_for(0, num_tiles, 1, [&](size_t start, size_t end) {
+                for (size_t t = start; t < end; t++)
+                {
+                    size_t tm = t / grid.second;
+                    size_t tn = t % grid.second;
+                    size_t i0 = tile_bound(m, grid.first, tm, MR);
+                    size_t i1 = tile_bound(m, grid.first, tm + 1, MR);
+                    size_t j0 = tile_bound(n, grid.second, tn, NR);
+                    size_t j1 = tile_bound(n, grid.second, tn + 1, NR);
+                    if (i0 == i1 || j0 == j1)
+                        continue;
+
+                    const C* a_tile = (op_a == NO_TRANS) ? a + i0 * lda : a + i0;
+                    const C* b_tile = (op_b == NO_TRANS) ? b + j0 : b + j0 * ldb;
+                    gemm_tile(op_a, op_b, i1 - i0, j1 - j0, k, alpha, a_tile, lda, b_tile, ldb, beta, c + i0 * ldc + j0, ldc);
+                }
+            });
+        }
+    }
+
+    void gemm(__cx_gemm_op__ op_a, __cx_gemm_op__ op_b,
+              size_t m, size_t n, size_t k,
+              const cx& alpha, const cx* a, size_t lda,
+              const cx* b, size_t ldb,
+              const cx& beta, cx* c, size_t ldc)
+    {
+        gemm_impl(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    }
+
+    void gemm(__cx_gemm_op__ op_a, __cx_gemm_op__ op_b,
+              size_t m, size_t n, size_t k,
+              const cxd& alpha, const cxd* a, size_t lda,
+              const cxd* b, size_t ldb,
+              const cxd& beta, cxd* c, size_t ldc)
+    {
+        gemm_impl(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    }
+}
@@ -0,0 +1,1067 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include "CXKernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CX_KERNELS_X86 1
+#include <immintrin.h>
+#define CX_TARGET_SSE2 __attribute__((target("sse2")))
+#define CX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define CX_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#endif
+
+namespace cx_lib
+{
+    namespace
+    {
+        /*
+         * Scalar kernels: the SIMD_SCALAR variant, and the tails of the
+         * vector variants. Each element is read completely before its output
+         * is written, so exact aliasing of input and output is fine.
+         */
+        namespace scalar
+        {
+            template <typename C>
+            void add(size_t n, const C* a, const C* b, C* out) noexcept
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    const auto re = a[i].real + b[i].real, im = a[i].imag + b[i].imag;
+                    out[i].real = re;
+                    out[i].imag = im;
+                }
+            }
+
+            template <typename C>
+            void sub(size_t n, const C* a, const C* b, C* out) noexcept
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    const auto re = a[i].real - b[i].real, im = a[i].imag - b[i].imag;
+                    out[i].real = re;
+                    out[i].imag = im;
+                }
+            }
+
+            template <typename C>
+            void mul(size_t n, const C* a, const C* b, C* out) noexcept
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    const auto re = a[i].real * b[i].real - a[i].imag * b[i].imag;
+                    const auto im = a[i].real * b[i].imag + a[i].imag * b[i].real;
+                    out[i].real = re;
+                    out[i].imag = im;
+                }
+            }
+
+            template <typename C>
+            void conj_mul(size_t n, const C* a, const C* b, C* out) noexcept
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    const auto re = a[i].real * b[i].real + a[i].imag * b[i].imag;
+                    const auto im = a[i].real * b[i].imag - a[i].imag * b[i].real;
+                    out[i].real = re;
+                    out[i].imag = im;
+                }
+            }
+
+            template <typename C>
+            void scale(size_t n, const C& alpha, const C* x, C* out) noexcept
+            {
+                const auto ar = alpha.real, ai = alpha.imag;
+                for (size_t i = 0; i < n; i++)
+                {
+                    const auto re = ar * x[i].real - ai * x[i].imag;
+                    const auto im = ar * x[i].imag + ai * x[i].real;
+                    out[i].real = re;
+                    out[i].imag = im;
+                }
+            }
+
+            template <typename C>
+            void axpy(size_t n, const C& alpha, const C* x, C* y) noexcept
+            {
+                const auto ar = alpha.real, ai = alpha.imag;
+                for (size_t i = 0; i < n; i++)
+                {
+                    const auto re = ar * x[i].real - ai * x[i].imag;
+                    const auto im = ar * x[i].imag + ai * x[i].real;
+                    y[i].real += re;
+                    y[i].imag += im;
+                }
+            }
+
+            // Sum of a[i] * b[i] (conj(a[i]) * b[i] when Conj), accumulated in precision A.
+            template <typename A, bool Conj, typename C>
+            basic_cx<A> dot_acc(size_t n, const C* a, const C* b) noexcept
+            {
+                const A sign = Conj ? A(-1) : A(1);
+                A re = 0, im = 0;
+                for (size_t i = 0; i < n; i++)
+                {
+                    const A ar = a[i].real, ai = sign * a[i].imag, br = b[i].real, bi = b[i].imag;
+                    re += ar * br - ai * bi;
+                    im += ar * bi + ai * br;
+                }
+                return basic_cx<A>(re, im);
+            }
+
+            template <typename C>
+            C dot(size_t n, const C* a, const C* b) noexcept
+            {
+                return dot_acc<typename C::value_type, false>(n, a, b);
+            }
+
+            template <typename C>
+            C dotc(size_t n, const C* a, const C* b) noexcept
+            {
+                return dot_acc<typename C::value_type, true>(n, a, b);
+            }
+
+            cxd dot_wide(size_t n, const cx* a, const cx* b) noexcept
+            {
+                return dot_acc<double, false>(n, a, b);
+            }
+
+            cxd dotc_wide(size_t n, const cx* a, const cx* b) noexcept
+            {
+                return dot_acc<double, true>(n, a, b);
+            }
+
+            template <typename C>
+            void abs2(size_t n, const C* x, typename C::value_type* out) noexcept
+            {
+                for (size_t i = 0; i < n; i++)
+                    out[i] = x[i].real * x[i].real + x[i].imag * x[i].imag;
+            }
+
+            template <typename C>
+            void abs(size_t n, const C* x, typename C::value_type* out) noexcept
+            {
+                for (size_t i = 0; i < n; i++)
+                    out[i] = std::sqrt(x[i].real * x[i].real + x[i].imag * x[i].imag);
+            }
+
+            template <typename C>
+            void fft_radix2(size_t n, const C* x, size_t xs, const C& w, C* y, size_t ys) noexcept
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    const C a = x[i], b = x[xs + i];
+                    y[i] = a + b;
+                    y[ys + i] = (a - b) * w;
+                }
+            }
+
+            template <typename C>
+            void fft_radix4(size_t n, const C* x, size_t xs, const C* w, bool inverse, C* y, size_t ys) noexcept
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    const C a0 = x[i], a1 = x[xs + i], a2 = x[2 * xs + i], a3 = x[3 * xs + i];
+                    const C b0 = a0 + a2, b1 = a0 - a2, b2 = a1 + a3, d = a1 - a3;
+                    // d * -i (forward) or d * i (inverse)
+                    const C b3 = inverse ? C(-d.imag, d.real) : C(d.imag, -d.real);
+                    y[i] = b0 + b2;
+                    y[ys + i] = (b1 + b3) * w[0];
+                    y[2 * ys + i] = (b0 - b2) * w[1];
+                    y[3 * ys + i] = (b1 - b3) * w[2];
+                }
+            }
+        }
+
+        inline const float* fp(const cx* p) noexcept { return reinterpret_cast<const float*>(p); }
+        inline float* fp(cx* p) noexcept { return reinterpret_cast<float*>(p); }
+
+#ifdef CX_KERNELS_X86
+        /*
+         * SSE2: 2 complex numbers per register. Without SSE3 the real and
+         * imaginary parts are broadcast with shuffles, and the sign of the
+         * cross terms is flipped with a xor.
+         */
+        namespace sse2
+        {
+            // [a.r * b.r - a.i * b.i, a.r * b.i + a.i * b.r] (sign = -0, 0),
+            // or the same with conj(a) (sign = 0, -0).
+            CX_TARGET_SSE2 inline __m128 cmul(__m128 a, __m128 b, __m128 sign) noexcept
+            {
+                const __m128 ar = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 0, 0));
+                const __m128 ai = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 1, 1));
+                const __m128 bs = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1));
+                return _mm_add_ps(_mm_mul_ps(ar, b), _mm_xor_ps(_mm_mul_ps(ai, bs), sign));
+            }
+
+            CX_TARGET_SSE2 inline __m128 mul_sign() noexcept { return _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f); }
+            CX_TARGET_SSE2 inline __m128 conj_sign() noexcept { return _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f); }
+
+            CX_TARGET_SSE2 inline cx hsum(__m128 v) noexcept
+            {
+                float t[4];
+                _mm_storeu_ps(t, v);
+                return cx(t[0] + t[2], t[1] + t[3]);
+            }
+
+            CX_TARGET_SSE2 void add(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                    _mm_storeu_ps(fp(out + i), _mm_add_ps(_mm_loadu_ps(fp(a + i)), _mm_loadu_ps(fp(b + i))));
+                scalar::add(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_SSE2 void sub(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                    _mm_storeu_ps(fp(out + i), _mm_sub_ps(_mm_loadu_ps(fp(a + i)), _mm_loadu_ps(fp(b + i))));
+                scalar::sub(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_SSE2 void mul(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                const __m128 sign = mul_sign();
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                    _mm_storeu_ps(fp(out + i), cmul(_mm_loadu_ps(fp(a + i)), _mm_loadu_ps(fp(b + i)), sign));
+                scalar::mul(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_SSE2 void conj_mul(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                const __m128 sign = conj_sign();
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                    _mm_storeu_ps(fp(out + i), cmul(_mm_loadu_ps(fp(a + i)), _mm_loadu_ps(fp(b + i)), sign));
+                scalar::conj_mul(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_SSE2 void scale(size_t n, const cx& alpha, const cx* x, cx* out) noexcept
+            {
+                const __m128 va = _mm_setr_ps(alpha.real, alpha.imag, alpha.real, alpha.imag);
+                const __m128 sign = mul_sign();
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                    _mm_storeu_ps(fp(out + i), cmul(va, _mm_loadu_ps(fp(x + i)), sign));
+                scalar::scale(n - i, alpha, x + i, out + i);
+            }
+
+            CX_TARGET_SSE2 void axpy(size_t n, const cx& alpha, const cx* x, cx* y) noexcept
+            {
+                const __m128 va = _mm_setr_ps(alpha.real, alpha.imag, alpha.real, alpha.imag);
+                const __m128 sign = mul_sign();
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    const __m128 vy = _mm_loadu_ps(fp(y + i));
+                    _mm_storeu_ps(fp(y + i), _mm_add_ps(vy, cmul(va, _mm_loadu_ps(fp(x + i)), sign)));
+                }
+                scalar::axpy(n - i, alpha, x + i, y + i);
+            }
+
+            CX_TARGET_SSE2 cx dot_impl(size_t n, const cx* a, const cx* b, __m128 sign, bool conj) noexcept
+            {
+                __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    acc0 = _mm_add_ps(acc0, cmul(_mm_loadu_ps(fp(a + i)), _mm_loadu_ps(fp(b + i)), sign));
+                    acc1 = _mm_add_ps(acc1, cmul(_mm_loadu_ps(fp(a + i + 2)), _mm_loadu_ps(fp(b + i + 2)), sign));
+                }
+                const cx head = hsum(_mm_add_ps(acc0, acc1));
+                const cx tail = conj ? scalar::dotc(n - i, a + i, b + i) : scalar::dot(n - i, a + i, b + i);
+                return cx(head.real + tail.real, head.imag + tail.imag);
+            }
+
+            CX_TARGET_SSE2 cx dot(size_t n, const cx* a, const cx* b) noexcept
+            {
+                return dot_impl(n, a, b, mul_sign(), false);
+            }
+
+            CX_TARGET_SSE2 cx dotc(size_t n, const cx* a, const cx* b) noexcept
+            {
+                return dot_impl(n, a, b, conj_sign(), true);
+            }
+
+            // Double precision products of the 2 complex numbers in the low
+            // and high halves of a float register.
+            CX_TARGET_SSE2 inline __m128d cmul_pd(__m128d a, __m128d b, __m128d sign) noexcept
+            {
+                const __m128d ar = _mm_unpacklo_pd(a, a), ai = _mm_unpackhi_pd(a, a);
+                return _mm_add_pd(_mm_mul_pd(ar, b), _mm_xor_pd(_mm_mul_pd(ai, _mm_shuffle_pd(b, b, 1)), sign));
+            }
+
+            CX_TARGET_SSE2 cxd dot_wide_impl(size_t n, const cx* a, const cx* b, __m128d sign, bool conj) noexcept
+            {
+                __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    const __m128 va = _mm_loadu_ps(fp(a + i)), vb = _mm_loadu_ps(fp(b + i));
+                    acc0 = _mm_add_pd(acc0, cmul_pd(_mm_cvtps_pd(va), _mm_cvtps_pd(vb), sign));
+                    acc1 = _mm_add_pd(acc1, cmul_pd(_mm_cvtps_pd(_mm_movehl_ps(va, va)), _mm_cvtps_pd(_mm_movehl_ps(vb, vb)), sign));
+                }
+                double t[2];
+                _mm_storeu_pd(t, _mm_add_pd(acc0, acc1));
+                const cxd tail = conj ? scalar::dotc_wide(n - i, a + i, b + i) : scalar::dot_wide(n - i, a + i, b + i);
+                return cxd(t[0] + tail.real, t[1] + tail.imag);
+            }
+
+            CX_TARGET_SSE2 cxd dot_wide(size_t n, const cx* a, const cx* b) noexcept
+            {
+                return dot_wide_impl(n, a, b, _mm_setr_pd(-0.0, 0.0), false);
+            }
+
+            CX_TARGET_SSE2 cxd dotc_wide(size_t n, const cx* a, const cx* b) noexcept
+            {
+                return dot_wide_impl(n, a, b, _mm_setr_pd(0.0, -0.0), true);
+            }
+
+            // |x|^2 of 4 complex numbers.
+            CX_TARGET_SSE2 inline __m128 norm4(const cx* x) noexcept
+            {
+                const __m128 s0 = _mm_loadu_ps(fp(x)), s1 = _mm_loadu_ps(fp(x + 2));
+                const __m128 q0 = _mm_mul_ps(s0, s0), q1 = _mm_mul_ps(s1, s1);
+                return _mm_add_ps(_mm_shuffle_ps(q0, q1, _MM_SHUFFLE(2, 0, 2, 0)),
+                                  _mm_shuffle_ps(q0, q1, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+
+            CX_TARGET_SSE2 void abs2(size_t n, const cx* x, float* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    _mm_storeu_ps(out + i, norm4(x + i));
+                scalar::abs2(n - i, x + i, out + i);
+            }
+
+            CX_TARGET_SSE2 void abs(size_t n, const cx* x, float* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    _mm_storeu_ps(out + i, _mm_sqrt_ps(norm4(x + i)));
+                scalar::abs(n - i, x + i, out + i);
+            }
+
+            CX_TARGET_SSE2 void fft_radix2(size_t n, const cx* x, size_t xs, const cx& w, cx* y, size_t ys) noexcept
+            {
+                const __m128 vw = _mm_setr_ps(w.real, w.imag, w.real, w.imag);
+                const __m128 sign = mul_sign();
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    const __m128 a = _mm_loadu_ps(fp(x + i)), b = _mm_loadu_ps(fp(x + xs + i));
+                    _mm_storeu_ps(fp(y + i), _mm_add_ps(a, b));
+                    _mm_storeu_ps(fp(y + ys + i), cmul(vw, _mm_sub_ps(a, b), sign));
+                }
+                scalar::fft_radix2(n - i, x + i, xs, w, y + i, ys);
+            }
+
+            CX_TARGET_SSE2 void fft_radix4(size_t n, const cx* x, size_t xs, const cx* w, bool inverse, cx* y, size_t ys) noexcept
+            {
+                const __m128 w1 = _mm_setr_ps(w[0].real, w[0].imag, w[0].real, w[0].imag);
+                const __m128 w2 = _mm_setr_ps(w[1].real, w[1].imag, w[1].real, w[1].imag);
+                const __m128 w3 = _mm_setr_ps(w[2].real, w[2].imag, w[2].real, w[2].imag);
+                const __m128 sign = mul_sign();
+                // Multiplying by -i (i) swaps the parts and negates the imaginary (real) one.
+                const __m128 rot = inverse ? _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f) : _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    const __m128 a0 = _mm_loadu_ps(fp(x + i)), a1 = _mm_loadu_ps(fp(x + xs + i));
+                    const __m128 a2 = _mm_loadu_ps(fp(x + 2 * xs + i)), a3 = _mm_loadu_ps(fp(x + 3 * xs + i));
+                    const __m128 b0 = _mm_add_ps(a0, a2), b1 = _mm_sub_ps(a0, a2), b2 = _mm_add_ps(a1, a3);
+                    const __m128 d = _mm_sub_ps(a1, a3);
+                    const __m128 b3 = _mm_xor_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1)), rot);
+                    _mm_storeu_ps(fp(y + i), _mm_add_ps(b0, b2));
+                    _mm_storeu_ps(fp(y + ys + i), cmul(w1, _mm_add_ps(b1, b3), sign));
+                    _mm_storeu_ps(fp(y + 2 * ys + i), cmul(w2, _mm_sub_ps(b0, b2), sign));
+                    _mm_storeu_ps(fp(y + 3 * ys + i), cmul(w3, _mm_sub_ps(b1, b3), sign));
+                }
+                scalar::fft_radix4(n - i, x + i, xs, w, inverse, y + i, ys);
+            }
+        }
+
+        /*
+         * AVX2 + FMA: 4 complex numbers per register. A product is one
+         * moveldup/movehdup pair, a swap of b and a fused multiply-add/sub.
+         */
+        namespace avx2
+        {
+            CX_TARGET_AVX2 inline __m256 cmul(__m256 a, __m256 b) noexcept
+            {
+                const __m256 ai_bs = _mm256_mul_ps(_mm256_movehdup_ps(a), _mm256_permute_ps(b, 0xB1));
+                return _mm256_fmaddsub_ps(_mm256_moveldup_ps(a), b, ai_bs);
+            }
+
+            CX_TARGET_AVX2 inline __m256 cmulc(__m256 a, __m256 b) noexcept
+            {
+                const __m256 ai_bs = _mm256_mul_ps(_mm256_movehdup_ps(a), _mm256_permute_ps(b, 0xB1));
+                return _mm256_fmsubadd_ps(_mm256_moveldup_ps(a), b, ai_bs);
+            }
+
+            CX_TARGET_AVX2 inline __m256 broadcast(const cx& alpha) noexcept
+            {
+                return _mm256_setr_ps(alpha.real, alpha.imag, alpha.real, alpha.imag,
+                                      alpha.real, alpha.imag, alpha.real, alpha.imag);
+            }
+
+            CX_TARGET_AVX2 inline cx hsum(__m256 v) noexcept
+            {
+                __m128 h = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+                h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+                float t[4];
+                _mm_storeu_ps(t, h);
+                return cx(t[0], t[1]);
+            }
+
+            CX_TARGET_AVX2 void add(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    _mm256_storeu_ps(fp(out + i), _mm256_add_ps(_mm256_loadu_ps(fp(a + i)), _mm256_loadu_ps(fp(b + i))));
+                scalar::add(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_AVX2 void sub(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    _mm256_storeu_ps(fp(out + i), _mm256_sub_ps(_mm256_loadu_ps(fp(a + i)), _mm256_loadu_ps(fp(b + i))));
+                scalar::sub(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_AVX2 void mul(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    _mm256_storeu_ps(fp(out + i), cmul(_mm256_loadu_ps(fp(a + i)), _mm256_loadu_ps(fp(b + i))));
+                scalar::mul(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_AVX2 void conj_mul(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    _mm256_storeu_ps(fp(out + i), cmulc(_mm256_loadu_ps(fp(a + i)), _mm256_loadu_ps(fp(b + i))));
+                scalar::conj_mul(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_AVX2 void scale(size_t n, const cx& alpha, const cx* x, cx* out) noexcept
+            {
+                const __m256 va = broadcast(alpha);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                    _mm256_storeu_ps(fp(out + i), cmul(va, _mm256_loadu_ps(fp(x + i))));
+                scalar::scale(n - i, alpha, x + i, out + i);
+            }
+
+            CX_TARGET_AVX2 void axpy(size_t n, const cx& alpha, const cx* x, cx* y) noexcept
+            {
+                const __m256 va = broadcast(alpha);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    const __m256 vy = _mm256_loadu_ps(fp(y + i));
+                    _mm256_storeu_ps(fp(y + i), _mm256_add_ps(vy, cmul(va, _mm256_loadu_ps(fp(x + i)))));
+                }
+                scalar::axpy(n - i, alpha, x + i, y + i);
+            }
+
+            CX_TARGET_AVX2 cx dot(size_t n, const cx* a, const cx* b) noexcept
+            {
+                __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    acc0 = _mm256_add_ps(acc0, cmul(_mm256_loadu_ps(fp(a + i)), _mm256_loadu_ps(fp(b + i))));
+                    acc1 = _mm256_add_ps(acc1, cmul(_mm256_loadu_ps(fp(a + i + 4)), _mm256_loadu_ps(fp(b + i + 4))));
+                }
+                const cx head = hsum(_mm256_add_ps(acc0, acc1));
+                const cx tail = scalar::dot(n - i, a + i, b + i);
+                return cx(head.real + tail.real, head.imag + tail.imag);
+            }
+
+            CX_TARGET_AVX2 cx dotc(size_t n, const cx* a, const cx* b) noexcept
+            {
+                __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    acc0 = _mm256_add_ps(acc0, cmulc(_mm256_loadu_ps(fp(a + i)), _mm256_loadu_ps(fp(b + i))));
+                    acc1 = _mm256_add_ps(acc1, cmulc(_mm256_loadu_ps(fp(a + i + 4)), _mm256_loadu_ps(fp(b + i + 4))));
+                }
+                const cx head = hsum(_mm256_add_ps(acc0, acc1));
+                const cx tail = scalar::dotc(n - i, a + i, b + i);
+                return cx(head.real + tail.real, head.imag + tail.imag);
+            }
+
+            CX_TARGET_AVX2 inline __m256d cmul_pd(__m256d a, __m256d b) noexcept
+            {
+                const __m256d ai_bs = _mm256_mul_pd(_mm256_permute_pd(a, 0xF), _mm256_permute_pd(b, 0x5));
+                return _mm256_fmaddsub_pd(_mm256_movedup_pd(a), b, ai_bs);
+            }
+
+            CX_TARGET_AVX2 inline __m256d cmulc_pd(__m256d a, __m256d b) noexcept
+            {
+                const __m256d ai_bs = _mm256_mul_pd(_mm256_permute_pd(a, 0xF), _mm256_permute_pd(b, 0x5));
+                return _mm256_fmsubadd_pd(_mm256_movedup_pd(a), b, ai_bs);
+            }
+
+            // 4 complex numbers are widened to two registers of 2 doubles each.
+            template <bool Conj>
+            CX_TARGET_AVX2 cxd dot_wide_impl(size_t n, const cx* a, const cx* b) noexcept
+            {
+                __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    const __m256 va = _mm256_loadu_ps(fp(a + i)), vb = _mm256_loadu_ps(fp(b + i));
+                    const __m256d a0 = _mm256_cvtps_pd(_mm256_castps256_ps128(va));
+                    const __m256d a1 = _mm256_cvtps_pd(_mm256_extractf128_ps(va, 1));
+                    const __m256d b0 = _mm256_cvtps_pd(_mm256_castps256_ps128(vb));
+                    const __m256d b1 = _mm256_cvtps_pd(_mm256_extractf128_ps(vb, 1));
+                    acc0 = _mm256_add_pd(acc0, Conj ? cmulc_pd(a0, b0) : cmul_pd(a0, b0));
+                    acc1 = _mm256_add_pd(acc1, Conj ? cmulc_pd(a1, b1) : cmul_pd(a1, b1));
+                }
+                const __m256d acc = _mm256_add_pd(acc0, acc1);
+                double t[2];
+                _mm_storeu_pd(t, _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1)));
+                const cxd tail = Conj ? scalar::dotc_wide(n - i, a + i, b + i) : scalar::dot_wide(n - i, a + i, b + i);
+                return cxd(t[0] + tail.real, t[1] + tail.imag);
+            }
+
+            CX_TARGET_AVX2 cxd dot_wide(size_t n, const cx* a, const cx* b) noexcept
+            {
+                return dot_wide_impl<false>(n, a, b);
+            }
+
+            CX_TARGET_AVX2 cxd dotc_wide(size_t n, const cx* a, const cx* b) noexcept
+            {
+                return dot_wide_impl<true>(n, a, b);
+            }
+
+            // |x|^2 of 8 complex numbers: hadd works within 128-bit lanes, so
+            // the 64-bit quarters are put back in order afterwards.
+            CX_TARGET_AVX2 inline __m256 norm8(const cx* x) noexcept
+            {
+                const __m256 s0 = _mm256_loadu_ps(fp(x)), s1 = _mm256_loadu_ps(fp(x + 4));
+                const __m256 h = _mm256_hadd_ps(_mm256_mul_ps(s0, s0), _mm256_mul_ps(s1, s1));
+                return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(h), _MM_SHUFFLE(3, 1, 2, 0)));
+            }
+
+            CX_TARGET_AVX2 void abs2(size_t n, const cx* x, float* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                    _mm256_storeu_ps(out + i, norm8(x + i));
+                scalar::abs2(n - i, x + i, out + i);
+            }
+
+            CX_TARGET_AVX2 void abs(size_t n, const cx* x, float* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                    _mm256_storeu_ps(out + i, _mm256_sqrt_ps(norm8(x + i)));
+                scalar::abs(n - i, x + i, out + i);
+            }
+
+            CX_TARGET_AVX2 void fft_radix2(size_t n, const cx* x, size_t xs, const cx& w, cx* y, size_t ys) noexcept
+            {
+                const __m256 vw = broadcast(w);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    const __m256 a = _mm256_loadu_ps(fp(x + i)), b = _mm256_loadu_ps(fp(x + xs + i));
+                    _mm256_storeu_ps(fp(y + i), _mm256_add_ps(a, b));
+                    _mm256_storeu_ps(fp(y + ys + i), cmul(vw, _mm256_sub_ps(a, b)));
+                }
+                scalar::fft_radix2(n - i, x + i, xs, w, y + i, ys);
+            }
+
+            CX_TARGET_AVX2 void fft_radix4(size_t n, const cx* x, size_t xs, const cx* w, bool inverse, cx* y, size_t ys) noexcept
+            {
+                const __m256 w1 = broadcast(w[0]), w2 = broadcast(w[1]), w3 = broadcast(w[2]);
+                // Multiplying by -i (i) swaps the parts and negates the imaginary (real) one.
+                const __m256 rot = inverse ? _mm256_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f)
+                                           : _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    const __m256 a0 = _mm256_loadu_ps(fp(x + i)), a1 = _mm256_loadu_ps(fp(x + xs + i));
+                    const __m256 a2 = _mm256_loadu_ps(fp(x + 2 * xs + i)), a3 = _mm256_loadu_ps(fp(x + 3 * xs + i));
+                    const __m256 b0 = _mm256_add_ps(a0, a2), b1 = _mm256_sub_ps(a0, a2), b2 = _mm256_add_ps(a1, a3);
+                    const __m256 b3 = _mm256_xor_ps(_mm256_permute_ps(_mm256_sub_ps(a1, a3), 0xB1), rot);
+                    _mm256_storeu_ps(fp(y + i), _mm256_add_ps(b0, b2));
+                    _mm256_storeu_ps(fp(y + ys + i), cmul(w1, _mm256_add_ps(b1, b3)));
+                    _mm256_storeu_ps(fp(y + 2 * ys + i), cmul(w2, _mm256_sub_ps(b0, b2)));
+                    _mm256_storeu_ps(fp(y + 3 * ys + i), cmul(w3, _mm256_sub_ps(b1, b3)));
+                }
+                scalar::fft_radix4(n - i, x + i, xs, w, inverse, y + i, ys);
+            }
+        }
+
+#if defined(__GNUC__) && !defined(__clang__)
+        // GCC 12 warns about the _mm512_undefined_* placeholders used inside
+        // the AVX-512 intrinsic headers (GCC bug 105593).
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+        /*
+         * AVX-512F: 8 complex numbers per register, same scheme as AVX2.
+         * Moduli are gathered from the even lanes with a 64 -> 32 bit
+         * narrowing instead of horizontal adds.
+         */
+        namespace avx512
+        {
+            CX_TARGET_AVX512 inline __m512 cmul(__m512 a, __m512 b) noexcept
+            {
+                const __m512 ai_bs = _mm512_mul_ps(_mm512_movehdup_ps(a), _mm512_permute_ps(b, 0xB1));
+                return _mm512_fmaddsub_ps(_mm512_moveldup_ps(a), b, ai_bs);
+            }
+
+            CX_TARGET_AVX512 inline __m512 cmulc(__m512 a, __m512 b) noexcept
+            {
+                const __m512 ai_bs = _mm512_mul_ps(_mm512_movehdup_ps(a), _mm512_permute_ps(b, 0xB1));
+                return _mm512_fmsubadd_ps(_mm512_moveldup_ps(a), b, ai_bs);
+            }
+
+            CX_TARGET_AVX512 inline __m512 broadcast(const cx& alpha) noexcept
+            {
+                const __m128 pair = _mm_setr_ps(alpha.real, alpha.imag, alpha.real, alpha.imag);
+                return _mm512_broadcast_f32x4(pair);
+            }
+
+            CX_TARGET_AVX512 inline cx hsum(__m512 v) noexcept
+            {
+                return cx(_mm512_mask_reduce_add_ps(0x5555, v), _mm512_mask_reduce_add_ps(0xAAAA, v));
+            }
+
+            CX_TARGET_AVX512 void add(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                    _mm512_storeu_ps(fp(out + i), _mm512_add_ps(_mm512_loadu_ps(fp(a + i)), _mm512_loadu_ps(fp(b + i))));
+                avx2::add(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_AVX512 void sub(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                    _mm512_storeu_ps(fp(out + i), _mm512_sub_ps(_mm512_loadu_ps(fp(a + i)), _mm512_loadu_ps(fp(b + i))));
+                avx2::sub(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_AVX512 void mul(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                    _mm512_storeu_ps(fp(out + i), cmul(_mm512_loadu_ps(fp(a + i)), _mm512_loadu_ps(fp(b + i))));
+                avx2::mul(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_AVX512 void conj_mul(size_t n, const cx* a, const cx* b, cx* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                    _mm512_storeu_ps(fp(out + i), cmulc(_mm512_loadu_ps(fp(a + i)), _mm512_loadu_ps(fp(b + i))));
+                avx2::conj_mul(n - i, a + i, b + i, out + i);
+            }
+
+            CX_TARGET_AVX512 void scale(size_t n, const cx& alpha, const cx* x, cx* out) noexcept
+            {
+                const __m512 va = broadcast(alpha);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                    _mm512_storeu_ps(fp(out + i), cmul(va, _mm512_loadu_ps(fp(x + i))));
+                avx2::scale(n - i, alpha, x + i, out + i);
+            }
+
+            CX_TARGET_AVX512 void axpy(size_t n, const cx& alpha, const cx* x, cx* y) noexcept
+            {
+                const __m512 va = broadcast(alpha);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    const __m512 vy = _mm512_loadu_ps(fp(y + i));
+                    _mm512_storeu_ps(fp(y + i), _mm512_add_ps(vy, cmul(va, _mm512_loadu_ps(fp(x + i)))));
+                }
+                avx2::axpy(n - i, alpha, x + i, y + i);
+            }
+
+            CX_TARGET_AVX512 cx dot(size_t n, const cx* a, const cx* b) noexcept
+            {
+                __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+                size_t i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    acc0 = _mm512_add_ps(acc0, cmul(_mm512_loadu_ps(fp(a + i)), _mm512_loadu_ps(fp(b + i))));
+                    acc1 = _mm512_add_ps(acc1, cmul(_mm512_loadu_ps(fp(a + i + 8)), _mm512_loadu_ps(fp(b + i + 8))));
+                }
+                const cx head = hsum(_mm512_add_ps(acc0, acc1));
+                const cx tail = avx2::dot(n - i, a + i, b + i);
+                return cx(head.real + tail.real, head.imag + tail.imag);
+            }
+
+            CX_TARGET_AVX512 cx dotc(size_t n, const cx* a, const cx* b) noexcept
+            {
+                __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+                size_t i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    acc0 = _mm512_add_ps(acc0, cmulc(_mm512_loadu_ps(fp(a + i)), _mm512_loadu_ps(fp(b + i))));
+                    acc1 = _mm512_add_ps(acc1, cmulc(_mm512_loadu_ps(fp(a + i + 8)), _mm512_loadu_ps(fp(b + i + 8))));
+                }
+                const cx head = hsum(_mm512_add_ps(acc0, acc1));
+                const cx tail = avx2::dotc(n - i, a + i, b + i);
+                return cx(head.real + tail.real, head.imag + tail.imag);
+            }
+
+            CX_TARGET_AVX512 inline __m512d cmul_pd(__m512d a, __m512d b) noexcept
+            {
+                const __m512d ai_bs = _mm512_mul_pd(_mm512_permute_pd(a, 0xFF), _mm512_permute_pd(b, 0x55));
+                return _mm512_fmaddsub_pd(_mm512_movedup_pd(a), b, ai_bs);
+            }
+
+            CX_TARGET_AVX512 inline __m512d cmulc_pd(__m512d a, __m512d b) noexcept
+            {
+                const __m512d ai_bs = _mm512_mul_pd(_mm512_permute_pd(a, 0xFF), _mm512_permute_pd(b, 0x55));
+                return _mm512_fmsubadd_pd(_mm512_movedup_pd(a), b, ai_bs);
+            }
+
+            // 8 complex numbers are widened to two registers of 4 doubles each.
+            template <bool Conj>
+            CX_TARGET_AVX512 cxd dot_wide_impl(size_t n, const cx* a, const cx* b) noexcept
+            {
+                __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    const __m512 va = _mm512_loadu_ps(fp(a + i)), vb = _mm512_loadu_ps(fp(b + i));
+                    const __m512d a0 = _mm512_cvtps_pd(_mm512_castps512_ps256(va));
+                    const __m512d a1 = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(va), 1)));
+                    const __m512d b0 = _mm512_cvtps_pd(_mm512_castps512_ps256(vb));
+                    const __m512d b1 = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(vb), 1)));
+                    acc0 = _mm512_add_pd(acc0, Conj ? cmulc_pd(a0, b0) : cmul_pd(a0, b0));
+                    acc1 = _mm512_add_pd(acc1, Conj ? cmulc_pd(a1, b1) : cmul_pd(a1, b1));
+                }
+                const __m512d acc = _mm512_add_pd(acc0, acc1);
+                const cxd head(_mm512_mask_reduce_add_pd(0x55, acc), _mm512_mask_reduce_add_pd(0xAA, acc));
+                const cxd tail = Conj ? avx2::dotc_wide(n - i, a + i, b + i) : avx2::dot_wide(n - i, a + i, b + i);
+                return cxd(head.real + tail.real, head.imag + tail.imag);
+            }
+
+            CX_TARGET_AVX512 cxd dot_wide(size_t n, const cx* a, const cx* b) noexcept
+            {
+                return dot_wide_impl<false>(n, a, b);
+            }
+
+            CX_TARGET_AVX512 cxd dotc_wide(size_t n, const cx* a, const cx* b) noexcept
+            {
+                return dot_wide_impl<true>(n, a, b);
+            }
+
+            CX_TARGET_AVX512 inline __m256 norm8(const cx* x) noexcept
+            {
+                const __m512 s = _mm512_loadu_ps(fp(x));
+                const __m512 q = _mm512_mul_ps(s, s);
+                const __m512 t = _mm512_add_ps(q, _mm512_permute_ps(q, 0xB1));
+                return _mm256_castsi256_ps(_mm512_cvtepi64_epi32(_mm512_castps_si512(t)));
+            }
+
+            CX_TARGET_AVX512 void abs2(size_t n, const cx* x, float* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                    _mm256_storeu_ps(out + i, norm8(x + i));
+                scalar::abs2(n - i, x + i, out + i);
+            }
+
+            CX_TARGET_AVX512 void abs(size_t n, const cx* x, float* out) noexcept
+            {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                    _mm256_storeu_ps(out + i, _mm256_sqrt_ps(norm8(x + i)));
+                scalar::abs(n - i, x + i, out + i);
+            }
+
+            CX_TARGET_AVX512 void fft_radix2(size_t n, const cx* x, size_t xs, const cx& w, cx* y, size_t ys) noexcept
+            {
+                const __m512 vw = broadcast(w);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    const __m512 a = _mm512_loadu_ps(fp(x + i)), b = _mm512_loadu_ps(fp(x + xs + i));
+                    _mm512_storeu_ps(fp(y + i), _mm512_add_ps(a, b));
+                    _mm512_storeu_ps(fp(y + ys + i), cmul(vw, _mm512_sub_ps(a, b)));
+                }
+                avx2::fft_radix2(n - i, x + i, xs, w, y + i, ys);
+            }
+
+            CX_TARGET_AVX512 void fft_radix4(size_t n, const cx* x, size_t xs, const cx* w, bool inverse, cx* y, size_t ys) noexcept
+            {
+                const __m512 w1 = broadcast(w[0]), w2 = broadcast(w[1]), w3 = broadcast(w[2]);
+                // Multiplying by -i (i) swaps the parts and negates the imaginary (real) one;
+                // AVX-512F has no float xor, so the sign is flipped with a product.
+                const __m512 rot = broadcast(inverse ? cx(-1, 1) : cx(1, -1));
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    const __m512 a0 = _mm512_loadu_ps(fp(x + i)), a1 = _mm512_loadu_ps(fp(x + xs + i));
+                    const __m512 a2 = _mm512_loadu_ps(fp(x + 2 * xs + i)), a3 = _mm512_loadu_ps(fp(x + 3 * xs + i));
+                    const __m512 b0 = _mm512_add_ps(a0, a2), b1 = _mm512_sub_ps(a0, a2), b2 = _mm512_add_ps(a1, a3);
+                    const __m512 b3 = _mm512_mul_ps(_mm512_permute_ps(_mm512_sub_ps(a1, a3), 0xB1), rot);
+                    _mm512_storeu_ps(fp(y + i), _mm512_add_ps(b0, b2));
+                    _mm512_storeu_ps(fp(y + ys + i), cmul(w1, _mm512_add_ps(b1, b3)));
+                    _mm512_storeu_ps(fp(y + 2 * ys + i), cmul(w2, _mm512_sub_ps(b0, b2)));
+                    _mm512_storeu_ps(fp(y + 3 * ys + i), cmul(w3, _mm512_sub_ps(b1, b3)));
+                }
+                avx2::fft_radix4(n - i, x + i, xs, w, inverse, y + i, ys);
+            }
+        }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+        struct kernel_table
+        {
+            void (*add)(size_t, const cx*, const cx*, cx*) noexcept;
+            void (*sub)(size_t, const cx*, const cx*, cx*) noexcept;
+            void (*mul)(size_t, const cx*, const cx*, cx*) noexcept;
+            void (*conj_mul)(size_t, const cx*, const cx*, cx*) noexcept;
+            void (*scale)(size_t, const cx&, const cx*, cx*) noexcept;
+            void (*axpy)(size_t, const cx&, const cx*, cx*) noexcept;
+            cx (*dot)(size_t, const cx*, const cx*) noexcept;
+            cx (*dotc)(size_t, const cx*, const cx*) noexcept;
+            void (*abs)(size_t, const cx*, float*) noexcept;
+            void (*abs2)(size_t, const cx*, float*) noexcept;
+            cxd (*dot_wide)(size_t, const cx*, const cx*) noexcept;
+            cxd (*dotc_wide)(size_t, const cx*, const cx*) noexcept;
+            void (*fft_radix2)(size_t, const cx*, size_t, const cx&, cx*, size_t) noexcept;
+            void (*fft_radix4)(size_t, const cx*, size_t, const cx*, bool, cx*, size_t) noexcept;
+        };
+
+#define CX_KERNEL_TABLE(ns) \
+        { ns::add, ns::sub, ns::mul, ns::conj_mul, ns::scale, ns::axpy, ns::dot, ns::dotc, ns::abs, ns::abs2, \
+          ns::dot_wide, ns::dotc_wide, ns::fft_radix2, ns::fft_radix4 }
+
+        const kernel_table scalar_table = CX_KERNEL_TABLE(scalar);
+#ifdef CX_KERNELS_X86
+        const kernel_table sse2_table = CX_KERNEL_TABLE(sse2);
+        const kernel_table avx2_table = CX_KERNEL_TABLE(avx2);
+        const kernel_table avx512_table = CX_KERNEL_TABLE(avx512);
+#endif
+#undef CX_KERNEL_TABLE
+
+        const kernel_table* table_for(__cx_simd_level__ level) noexcept
+        {
+            switch (level)
+            {
+#ifdef CX_KERNELS_X86
+                case SIMD_AVX512:
+                    return &avx512_table;
+                case SIMD_AVX2:
+                    return &avx2_table;
+                case SIMD_SSE2:
+                    return &sse2_table;
+#endif
+                default:
+                    return &scalar_table;
+            }
+        }
+
+        std::atomic<int> active_level{-1};  ///< Selected level, -1 until first use
+        std::atomic<const kernel_table*> active_table{nullptr};
+
+        const kernel_table& active() noexcept
+        {
+            const kernel_table* table = active_table.load(std::memory_order_acquire);
+            if (!table)
+            {
+                set_simd_level(simd_detect());
+                table = active_table.load(std::memory_order_acquire);
+            }
+            return *table;
+        }
+    }
+
+    std::atomic<bool> __cx_double_accumulation__ = false;
+
+    void enable_double_accumulation(bool enable) noexcept
+    {
+        __cx_double_accumulation__ = enable;
+    }
+
+    __cx_simd_level__ simd_detect() noexcept
+    {
+#ifdef CX_KERNELS_X86
+        // __builtin_cpu_supports also checks (through XGETBV) that the OS
+        // saves the wide registers.
+        static const __cx_simd_level__ level = [] {
+            __builtin_cpu_init();
+            const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            if (avx2 && __builtin_cpu_supports("avx512f"))
+                return SIMD_AVX512;
+            if (avx2)
+                return SIMD_AVX2;
+            if (__builtin_cpu_supports("sse2"))
+                return SIMD_SSE2;
+            return SIMD_SCALAR;
+        }();
+        return level;
+#else
+        return SIMD_SCALAR;
+#endif
+    }
+
+    __cx_simd_level__ get_simd_level() noexcept
+    {
+        if (active_level.load(std::memory_order_acquire) < 0)
+            active();
+        return static_cast<__cx_simd_level__>(active_level.load(std::memory_order_acquire));
+    }
+
+    void set_simd_level(__cx_simd_level__ level) noexcept
+    {
+        level = std::min(level, simd_detect());
+        active_level.store(level, std::memory_order_release);
+        active_table.store(table_for(level), std::memory_order_release);
+    }
+
+    namespace kernels
+    {
+        void add(size_t n, const cx* a, const cx* b, cx* out) noexcept
+        {
+            active().add(n, a, b, out);
+        }
+
+        void sub(size_t n, const cx* a, const cx* b, cx* out) noexcept
+        {
+            active().sub(n, a, b, out);
+        }
+
+        void mul(size_t n, const cx* a, const cx* b, cx* out) noexcept
+        {
+            active().mul(n, a, b, out);
+        }
+
+        void conj_mul(size_t n, const cx* a, const cx* b, cx* out) noexcept
+        {
+            active().conj_mul(n, a, b, out);
+        }
+
+        void scale(size_t n, const cx& alpha, const cx* x, cx* out) noexcept
+        {
+            active().scale(n, alpha, x, out);
+        }
+
+        void axpy(size_t n, const cx& alpha, const cx* x, cx* y) noexcept
+        {
+            active().axpy(n, alpha, x, y);
+        }
+
+        cx dot(size_t n, const cx* a, const cx* b) noexcept
+        {
+            return active().dot(n, a, b);
+        }
+
+        cx dotc(size_t n, const cx* a, const cx* b) noexcept
+        {
+            return active().dotc(n, a, b);
+        }
+
+        void abs(size_t n, const cx* x, float* out) noexcept
+        {
+            active().abs(n, x, out);
+        }
+
+        void abs2(size_t n, const cx* x, float* out) noexcept
+        {
+            active().abs2(n, x, out);
+        }
+
+        cxd dot_wide(size_t n, const cx* a, const cx* b) noexcept
+        {
+            return active().dot_wide(n, a, b);
+        }
+
+        cxd dotc_wide(size_t n, const cx* a, const cx* b) noexcept
+        {
+            return active().dotc_wide(n, a, b);
+        }
+
+        void fft_radix2(size_t n, const cx* x, size_t xs, const cx& w, cx* y, size_t ys) noexcept
+        {
+            active().fft_radix2(n, x, xs, w, y, ys);
+        }
+
+        void fft_radix4(size_t n, const cx* x, size_t xs, const cx* w, bool inverse, cx* y, size_t ys) noexcept
+        {
+            active().fft_radix4(n, x, xs, w, inverse, y, ys);
+        }
+
+        void add(size_t n, const cxd* a, const cxd* b, cxd* out) noexcept
+        {
+            scalar::add(n, a, b, out);
+        }
+
+        void sub(size_t n, const cxd* a, const cxd* b, cxd* out) noexcept
+        {
+            scalar::sub(n, a, b, out);
+        }
+
+        void mul(size_t n, const cxd* a, const cxd* b, cxd* out) noexcept
+        {
+            scalar::mul(n, a, b, out);
+        }
+
+        void conj_mul(size_t n, const cxd* a, const cxd* b, cxd* out) noexcept
+        {
+            scalar::conj_mul(n, a, b, out);
+        }
+
+        void scale(size_t n, const cxd& alpha, const cxd* x, cxd* out) noexcept
+        {
+            scalar::scale(n, alpha, x, out);
+        }
+
+        void axpy(size_t n, const cxd& alpha, const cxd* x, cxd* y) noexcept
+        {
+            scalar::axpy(n, alpha, x, y);
+        }
+
+        cxd dot(size_t n, const cxd* a, const cxd* b) noexcept
+        {
+            return scalar::dot(n, a, b);
+        }
+
+        cxd dotc(size_t n, const cxd* a, const cxd* b) noexcept
+        {
+            return scalar::dotc(n, a, b);
+        }
+
+        void abs(size_t n, const cxd* x, double* out) noexcept
+        {
+            scalar::abs(n, x, out);
+        }
+
+        void abs2(size_t n, const cxd* x, double* out) noexcept
+        {
+            scalar::abs2(n, x, out);
+        }
+
+        void fft_radix2(size_t n, const cxd* x, size_t xs, const cxd& w, cxd* y, size_t ys) noexcept
+        {
+            scalar::fft_radix2(n, x, xs, w, y, ys);
+        }
+
+        void fft_radix4(size_t n, const cxd* x, size_t xs, const cxd* w, bool inverse, cxd* y, size_t ys) noexcept
+        {
+            scalar::fft_radix4(n, x, xs, w, inverse, y, ys);
+        }
+    }
+}
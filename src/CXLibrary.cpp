@@ -1,151 +1,316 @@
 #include "CXLibrary.h"
 #include "ComplexMatrix.h"
 #include "ComplexVector.h"
+#include "CXGemm.h"
+#include "CXKernels.h"
 
 namespace cx_lib
 {
-    std::atomic<bool> __cx_multithread_enabled__ = false;
-
-    void enable_multithreading(bool enable) noexcept
+    namespace
     {
-        __cx_multithread_enabled__ = enable;
-    }
+        // Minimum number of complex multiply-adds handed to a single chunk;
+        // below this waking a worker costs more than it saves.
+        constexpr size_t MIN_WORK_PER_CHUNK = size_t(1) << 15;
 
-    cx_matrix matmul(const cx_matrix& a, const cx_matrix& b)
-    {
-        if (a.cols() != b.rows())
-            throw std::runtime_error("Can't perform cx_lib::matmul -> dimensions mismatch.");
+        /*
+         * Split [0, count) into contiguous blocks and run fn(begin, end) on
+         * each block through the thread pool. work_per_item is the cost of
+         * one item and sets how many items a block holds at least, so small
+         * inputs run inline on the calling thread.
+         */
+        template <typename F>
+        void parallel_blocks(size_t count, size_t work_per_item, F&& fn)
+        {
+            size_t grain = std::max<size_t>(1, MIN_WORK_PER_CHUNK / std::max<size_t>(work_per_item, 1));
+            parallel_for(0, count, grain, fn);
+        }
+
+        // The matmul overloads conjugate the right operand (they used to go
+        // through cx_vector::dot); the matprod ones compute the plain product.
+
+        template <typename T>
+        basic_cx_matrix<T> matmul_impl(const basic_cx_matrix<T>& a, const basic_cx_matrix<T>& b, bool conj)
+        {
+            if (a.cols() != b.rows())
+                throw std::runtime_error(conj ? "Can't perform cx_lib::matmul -> dimensions mismatch."
+                                              : "Can't perform cx_lib::matprod -> dimensions mismatch.");
+
+            basic_cx_matrix<T> new_(a.rows(), b.cols(), basic_cx<T>(0, 0));
+            if (!conj)
+            {
+                gemm(NO_TRANS, NO_TRANS, a.rows(), b.cols(), a.cols(),
+                     basic_cx<T>(1, 0), a.data(), a.row_stride(),
+                     b.data(), b.row_stride(),
+                     basic_cx<T>(0, 0), new_.data(), new_.row_stride());
+                return new_;
+            }
+
+            // conj(b), packed densely: O(k n) extra work against the O(m k n) product.
+            std::vector<basic_cx<T>> b_conj(b.rows() * b.cols());
+            for (size_t k = 0; k < b.rows(); k++)
+                for (size_t j = 0; j < b.cols(); j++)
+                    b_conj[k * b.cols() + j] = b(k, j).conjugate();
+
+            gemm(NO_TRANS, NO_TRANS, a.rows(), b.cols(), a.cols(),
+                 basic_cx<T>(1, 0), a.data(), a.row_stride(),
+                 b_conj.data(), b.cols(),
+                 basic_cx<T>(0, 0), new_.data(), new_.row_stride());
 
-        cx_matrix new_(a.rows(), b.cols(), cx(0, 0));
-        for (size_t j = 0; j < b.cols(); j++)
+            return new_;
+        }
+
+        template <typename T>
+        basic_cx_vector<T> matmul_impl(const basic_cx_matrix<T>& a, const basic_cx_vector<T>& b, bool conj)
+        {
+            if (a.cols() != b.dim())
+                throw std::runtime_error(conj ? "Can't perform cx_lib::matmul -> dimensions mismatch."
+                                              : "Can't perform cx_lib::matprod -> dimensions mismatch.");
+        
+            // sum a[i][k] * conj(b[k]) is dotc(b, a[i]).
+            std::vector<basic_cx<T>> acc_(a.rows(), basic_cx<T>(0, 0));
+            parallel_blocks(a.rows(), a.cols(), [&](size_t start, size_t end) {
+                for (size_t i = start; i < end; i++)
+                    acc_[i] = conj ? kernels::accumulate_dotc(a.cols(), &b[0], a[i].data())
+                                   : kernels::accumulate_dot(a.cols(), a[i].data(), &b[0]);
+            });
+
+            return basic_cx_vector<T>(acc_);
+        }
+
+        template <typename T>
+        basic_cx_vector<T> matmul_impl(const basic_cx_vector<T>& a, const basic_cx_matrix<T>& b, bool conj)
         {
-            cx_vector elem = b.get_col(j);
-            for (size_t i = 0; i < a.rows(); i++)
-                new_(i, j) = a[i].dot(elem);
+            if (a.dim() != b.rows())
+                throw std::runtime_error(conj ? "Can't perform cx_lib::matmul -> dimensions mismatch."
+                                              : "Can't perform cx_lib::matprod -> dimensions mismatch.");
+            
+            // Each block owns a range of output columns and sweeps all rows of b
+            // over it, so reads stay contiguous and no two threads share outputs.
+            // The conjugating product is accumulated as conj(sum conj(a[k]) * b[k]).
+            std::vector<basic_cx<T>> acc_(b.cols(), basic_cx<T>(0, 0));
+            parallel_blocks(b.cols(), b.rows(), [&](size_t start, size_t end) {
+                for (size_t k = 0; k < b.rows(); k++)
+                    kernels::axpy(end - start, conj ? a[k].conjugate() : a[k], b[k].data() + start, acc_.data() + start);
+                if (conj)
+                    for (size_t j = start; j < end; j++)
+                        acc_[j] = acc_[j].conjugate();
+            });
+
+            basic_cx_vector<T> new_(acc_);
+
+            return new_;
         }
 
-        return new_;
+        template <typename T>
+        basic_cx_vector<T> hadamard_vprod_impl(const basic_cx_vector<T>& a, const basic_cx_vector<T>& b)
+        {
+            if (a.dim() != b.dim())
+                throw std::runtime_error("Can't perform cx_lib::hadamard_vprod -> dimensions mismatch.");
+
+            basic_cx_vector<T> prod_(a.dim(), basic_cx<T>(0, 0));
+            kernels::mul(a.dim(), &a[0], &b[0], &prod_[0]);
+
+            return prod_;
+        }
+
+        template <typename T>
+        basic_cx_matrix<T> hadamard_prod_impl(const basic_cx_matrix<T>& a, const basic_cx_matrix<T>& b)
+        {
+            if (a.dim() != b.dim())
+                throw std::runtime_error("Can't perform cx_lib::hadamard_prod -> dimensions mismatch.");
+
+            basic_cx_matrix<T> prod_(a.rows(), a.cols(), basic_cx<T>(0, 0));
+            parallel_blocks(a.rows(), a.cols(), [&](size_t start, size_t end) {
+                for (size_t i = start; i < end; i++)
+                    kernels::mul(a.cols(), a[i].data(), b[i].data(), prod_[i].data());
+            });
+
+            return prod_;
+        }
+
+        template <typename T>
+        basic_cx_tensor<T> hadamard_prod_impl(const basic_cx_tensor_const_view<T>& a, const basic_cx_tensor_const_view<T>& b)
+        {
+            return a.broadcast_mul(b);
+        }
+
+        template <typename T>
+        basic_cx_vector<T> tensor_prod_impl(const basic_cx_vector<T>& a, const basic_cx_vector<T>& b) noexcept
+        {
+            std::vector<basic_cx<T>> prod_(a.dim() * b.dim(), basic_cx<T>(0, 0));
+            parallel_blocks(a.dim(), b.dim(), [&](size_t start, size_t end) {
+                for (size_t i = start; i < end; i++) 
+                {
+                    for (size_t j = 0; j < b.dim(); j++) 
+                    {
+                        size_t index = i * b.dim() + j;
+                        prod_[index] = a[i] * b[j];
+                    }
+                }
+            });
+
+            return basic_cx_vector<T>(prod_);
+        }
+
+        template <typename T>
+        basic_cx_tensor<T> tensor_prod_impl(const basic_cx_tensor_const_view<T>& a, const basic_cx_tensor_const_view<T>& b) noexcept
+        {
+            // The result is a outer b in row-major order: loop over the
+            // concatenated shape, with each operand broadcast (stride 0) along
+            // the axes of the other one. The element-wise engine collapses this
+            // to new_[i * b.size() + j] = a[i] * b[j], parallel over i.
+            std::vector<size_t> shape_(a.shape());
+            shape_.insert(shape_.end(), b.shape().begin(), b.shape().end());
+
+            std::vector<ptrdiff_t> strides_a(a.strides());
+            strides_a.resize(shape_.size(), 0);
+            std::vector<ptrdiff_t> strides_b(a.shape().size(), 0);
+            strides_b.insert(strides_b.end(), b.strides().begin(), b.strides().end());
+
+            basic_cx_tensor<T> new_(shape_, basic_cx<T>(0, 0));
+            nd_binary_map(shape_, new_.view().data(), contiguous_strides(shape_),
+                          a.data(), strides_a, b.data(), strides_b, cx_mul_op());
+
+            return new_;
+        }
+
+        template <typename T>
+        basic_cx_matrix<T> kron_impl(const basic_cx_matrix<T>& a, const basic_cx_matrix<T>& b)
+        {
+            // Same kernel as tensor_prod, on the axes (i, k, j, l) of
+            // new_(i * b.rows() + k, j * b.cols() + l) = a(i, j) * b(k, l).
+            basic_cx_matrix<T> new_(a.rows() * b.rows(), a.cols() * b.cols(), basic_cx<T>(0, 0));
+            const std::vector<size_t> shape_ = {a.rows(), b.rows(), a.cols(), b.cols()};
+            const ptrdiff_t ldc = static_cast<ptrdiff_t>(new_.row_stride());
+            const ptrdiff_t ncols = static_cast<ptrdiff_t>(b.cols());
+
+            nd_binary_map(shape_, new_.data(),
+                          {static_cast<ptrdiff_t>(b.rows()) * ldc, ldc, ncols, 1},
+                          a.data(), {static_cast<ptrdiff_t>(a.row_stride()), 0, static_cast<ptrdiff_t>(a.col_stride()), 0},
+                          b.data(), {0, static_cast<ptrdiff_t>(b.row_stride()), 0, static_cast<ptrdiff_t>(b.col_stride())},
+                          cx_mul_op());
+
+            return new_;
+        }
+    }
+
+    cx_matrix matmul(const cx_matrix& a, const cx_matrix& b)
+    {
+        return matmul_impl(a, b, true);
+    }
+
+    cxd_matrix matmul(const cxd_matrix& a, const cxd_matrix& b)
+    {
+        return matmul_impl(a, b, true);
     }
 
     cx_vector matmul(const cx_matrix& a, const cx_vector& b)
     {
-        if (a.cols() != b.dim())
-            throw std::runtime_error("Can't perform cx_lib::matmul -> dimensions mismatch.");
-        
-        cx_vector new_(a.rows(), cx(0, 0));
-        for (size_t i = 0; i < a.rows(); i++)
-            new_[i] = a[i].dot(b);
+        return matmul_impl(a, b, true);
+    }
 
-        return new_;
+    cxd_vector matmul(const cxd_matrix& a, const cxd_vector& b)
+    {
+        return matmul_impl(a, b, true);
     }
 
     cx_vector matmul(const cx_vector& a, const cx_matrix& b)
     {
-        if (a.dim() != b.rows())
-            throw std::runtime_error("Can't perform cx_lib::matmul -> dimensions mismatch.");
-            
-        cx_vector new_(b.cols(), cx(0, 0));
-        for (size_t j = 0; j < b.cols(); j++)
-        {
-            cx_vector elem = b.get_col(j);
-            new_[j] = a.dot(elem);
-        }
-
-        return new_;
+        return matmul_impl(a, b, true);
     }
 
-    cx_vector hadamard_vprod(const cx_vector& a, const cx_vector& b)
+    cxd_vector matmul(const cxd_vector& a, const cxd_matrix& b)
     {
-        if (a.dim() != b.dim())
-            throw std::runtime_error("Can't perform cx_lib::hadamard_vprod -> dimensions mismatch.");
+        return matmul_impl(a, b, true);
+    }
 
-        cx_vector prod_(a.dim(), cx(0, 0));
-        for (size_t i = 0; i < a.dim(); i++)
-            prod_[i] = a[i] * b[i];
+    cx_matrix matprod(const cx_matrix& a, const cx_matrix& b)
+    {
+        return matmul_impl(a, b, false);
+    }
 
-        return prod_;
+    cxd_matrix matprod(const cxd_matrix& a, const cxd_matrix& b)
+    {
+        return matmul_impl(a, b, false);
     }
 
-    cx_matrix hadamard_prod(const cx_matrix& a, const cx_matrix& b)
+    cx_vector matprod(const cx_matrix& a, const cx_vector& b)
     {
-        if (a.dim() != b.dim())
-            throw std::runtime_error("Can't perform cx_lib::hadamard_prod -> dimensions mismatch.");
+        return matmul_impl(a, b, false);
+    }
 
-        cx_matrix prod_(a.rows(), a.cols(), cx(0, 0));
-        for (size_t i = 0; i < a.rows(); i++)
-            prod_[i] = hadamard_vprod(a[i], b[i]);
+    cxd_vector matprod(const cxd_matrix& a, const cxd_vector& b)
+    {
+        return matmul_impl(a, b, false);
+    }
 
-        return prod_;
+    cx_vector matprod(const cx_vector& a, const cx_matrix& b)
+    {
+        return matmul_impl(a, b, false);
     }
 
-    cx_tensor hadamard_prod(const cx_tensor& a, const cx_tensor& b)
+    cxd_vector matprod(const cxd_vector& a, const cxd_matrix& b)
     {
-        if (a.shape() != b.shape())
-            throw std::invalid_argument("Shapes do not match for Hadamard product.");
+        return matmul_impl(a, b, false);
+    }
 
-        cx_tensor result(a.shape(), cx(0, 0));
+    cx_vector hadamard_vprod(const cx_vector& a, const cx_vector& b)
+    {
+        return hadamard_vprod_impl(a, b);
+    }
 
-        if (cx_lib::__cx_multithread_enabled__)
-        {
-            size_t num_threads = std::thread::hardware_concurrency();
-            size_t chunk_size = a.size() / num_threads;
-            std::vector<std::thread> threads;
+    cxd_vector hadamard_vprod(const cxd_vector& a, const cxd_vector& b)
+    {
+        return hadamard_vprod_impl(a, b);
+    }
 
-            for (size_t t = 0; t < num_threads; t++)
-            {
-                threads.emplace_back([&, t]() {
-                    size_t start = t * chunk_size;
-                    size_t end = (t == num_threads - 1)? a.size() : (t + 1) * chunk_size;
-                    for (size_t i = start; i < end; i++)
-                        result[i] = a[i] * b[i];
-                });
-            }
+    cx_matrix hadamard_prod(const cx_matrix& a, const cx_matrix& b)
+    {
+        return hadamard_prod_impl(a, b);
+    }
 
-            for (auto& thread : threads)
-                thread.join();
-        }
-        else
-            for (size_t i = 0; i < a.size(); i++)
-                result[i] = a[i] * b[i];
+    cxd_matrix hadamard_prod(const cxd_matrix& a, const cxd_matrix& b)
+    {
+        return hadamard_prod_impl(a, b);
+    }
 
-        return result;
+    cx_tensor hadamard_prod(const cx_tensor_const_view& a, const cx_tensor_const_view& b)
+    {
+        return hadamard_prod_impl(a, b);
     }
 
+    cxd_tensor hadamard_prod(const cxd_tensor_const_view& a, const cxd_tensor_const_view& b)
+    {
+        return hadamard_prod_impl(a, b);
+    }
 
     cx_vector tensor_prod(const cx_vector& a, const cx_vector& b) noexcept
     {
-        cx_vector prod_(a.dim() * b.dim(), cx(0, 0));
-        for (size_t i = 0; i < a.dim(); i++) 
-        {
-            for (size_t j = 0; j < b.dim(); j++) 
-            {
-                size_t index = i * b.dim() + j;
-                prod_[index] = a[i] * b[j];
-            }
-        }
+        return tensor_prod_impl(a, b);
+    }
 
-        return prod_;
+    cxd_vector tensor_prod(const cxd_vector& a, const cxd_vector& b) noexcept
+    {
+        return tensor_prod_impl(a, b);
     }
 
-    cx_tensor tensor_prod(const cx_tensor& a, const cx_tensor& b) noexcept
+    cx_tensor tensor_prod(const cx_tensor_const_view& a, const cx_tensor_const_view& b) noexcept
     {
-        std::vector<size_t> shape_a(a.shape());
-        std::vector<size_t> shape_b(b.shape());
-        shape_a.insert(shape_a.end(), shape_b.begin(), shape_b.end());
-        cx_tensor new_(shape_a, cx(0, 0));
+        return tensor_prod_impl(a, b);
+    }
 
-        for (size_t i = 0; i < a.size(); i++)
-        {
-            std::vector<size_t> idx_a = a.unravel_index(i);
-            for (size_t j = 0; j < b.size(); j++)
-            {
-                std::vector<size_t> idx_b = b.unravel_index(j);
-                std::vector<size_t> idx_new = idx_a;
-                idx_new.insert(idx_new.end(), idx_b.begin(), idx_b.end());
-                new_.at(idx_new) = a[i] * b[j];
-            }
-        }
+    cxd_tensor tensor_prod(const cxd_tensor_const_view& a, const cxd_tensor_const_view& b) noexcept
+    {
+        return tensor_prod_impl(a, b);
+    }
+
+    cx_matrix kron(const cx_matrix& a, const cx_matrix& b)
+    {
+        return kron_impl(a, b);
+    }
 
-        return new_;
+    cxd_matrix kron(const cxd_matrix& a, const cxd_matrix& b)
+    {
+        return kron_impl(a, b);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,2530 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include "CXLinalg.h"
+#include "CXGemm.h"
+#include "CXKernels.h"
+#include "CXThreadPool.h"
+
+namespace cx_lib
+{
+    namespace
+    {
+        // Width of the panels: the trailing updates are gemm calls with an
+        // inner dimension of panel_width.
+        constexpr size_t panel_width = 64;
+        // Minimum number of complex multiply-adds handed to a single chunk.
+        constexpr size_t MIN_WORK_PER_CHUNK = size_t(1) << 15;
+
+        template <typename F>
+        void parallel_blocks(size_t count, size_t work_per_item, F&& fn)
+        {
+            size_t grain = std::max<size_t>(1, MIN_WORK_PER_CHUNK / std::max<size_t>(work_per_item, 1));
+            parallel_for(0, count, grain, fn);
+        }
+
+        // |re| + |im|, the pivoting norm of LAPACK's icamax.
+        template <typename T>
+        inline T abs1(const basic_cx<T>& z) noexcept
+        {
+            return std::abs(z.real) + std::abs(z.imag);
+        }
+
+        template <typename T>
+        void require_square(const basic_cx_matrix<T>& a, const char* what)
+        {
+            if (a.rows() != a.cols())
+                throw std::invalid_argument(std::string(what) + " needs a square matrix.");
+        }
+
+        /*
+         * Unblocked LU of columns [k, k + nb) of a, rows [k, n). Pivot rows
+         * are swapped over the whole width, which also applies the
+         * interchanges to L on the left and to the trailing columns.
+         * Returns false if a pivot was zero.
+         */
+        template <typename C>
+        bool factor_panel(C* a, size_t lda, size_t n, size_t k, size_t nb, size_t* pivots)
+        {
+            bool regular = true;
+            for (size_t j = k; j < k + nb; j++)
+            {
+                size_t p = j;
+                auto best = abs1(a[j * lda + j]);
+                for (size_t i = j + 1; i < n; i++)
+                    if (abs1(a[i * lda + j]) > best)
+                    {
+                        best = abs1(a[i * lda + j]);
+                        p = i;
+                    }
+                pivots[j] = p;
+                if (p != j)
+                    std::swap_ranges(a + j * lda, a + j * lda + n, a + p * lda);
+
+                const C pivot = a[j * lda + j];
+                if (pivot == C(0, 0))
+                {
+                    regular = false;
+                    continue;
+                }
+
+                // Scale the column of L and update the rest of the panel, one row at a time.
+                const C inv = C(1, 0) / pivot;
+                const size_t width = k + nb - j - 1;
+                const C* u = a + j * lda + j + 1;
+                parallel_blocks(n - j - 1, width + 1, [&](size_t start, size_t end) {
+                    for (size_t i = j + 1 + start; i < j + 1 + end; i++)
+                    {
+                        C* row = a + i * lda + j;
+                        row[0] *= inv;
+                        kernels::axpy(width, -row[0], u, row + 1);
+                    }
+                });
+            }
+            return regular;
+        }
+
+        /*
+         * x[k:k+nb, :] = L[k:k+nb, k:k+nb]^-1 x[k:k+nb, :] for the unit lower
+         * triangular diagonal block of l, column chunks of x in parallel.
+         */
+        template <typename C>
+        void solve_lower_block(const C* l, size_t ldl, size_t k, size_t nb, C* x, size_t ldx, size_t cols)
+        {
+            parallel_blocks(cols, nb * nb / 2, [&](size_t start, size_t end) {
+                for (size_t i = k + 1; i < k + nb; i++)
+                    for (size_t j = k; j < i; j++)
+                        kernels::axpy(end - start, -l[i * ldl + j], x + j * ldx + start, x + i * ldx + start);
+            });
+        }
+
+        /*
+         * x[k:k+nb, :] = U[k:k+nb, k:k+nb]^-1 x[k:k+nb, :] for the upper
+         * triangular diagonal block of u, column chunks of x in parallel.
+         */
+        template <typename C>
+        void solve_upper_block(const C* u, size_t ldu, size_t k, size_t nb, C* x, size_t ldx, size_t cols)
+        {
+            parallel_blocks(cols, nb * nb / 2, [&](size_t start, size_t end) {
+                for (size_t i = k + nb; i-- > k;)
+                {
+                    C* row = x + i * ldx + start;
+                    for (size_t j = i + 1; j < k + nb; j++)
+                        kernels::axpy(end - start, -u[i * ldu + j], x + j * ldx + start, row);
+                    kernels::scale(end - start, C(1, 0) / u[i * ldu + i], row, row);
+                }
+            });
+        }
+
+        // x = L^-1 x for the unit lower triangle of a and the n x cols row-major block x.
+        template <typename C>
+        void solve_unit_lower(const C* a, size_t lda, size_t n, C* x, size_t ldx, size_t cols)
+        {
+            for (size_t k = 0; k < n; k += panel_width)
+            {
+                const size_t nb = std::min(panel_width, n - k);
+                solve_lower_block(a, lda, k, nb, x, ldx, cols);
+                gemm(NO_TRANS, NO_TRANS, n - k - nb, cols, nb, C(-1, 0), a + (k + nb) * lda + k, lda,
+                     x + k * ldx, ldx, C(1, 0), x + (k + nb) * ldx, ldx);
+            }
+        }
+
+        // x = U^-1 x for the upper triangle of a and the n x cols row-major block x.
+        template <typename C>
+        void solve_upper(const C* a, size_t lda, size_t n, C* x, size_t ldx, size_t cols)
+        {
+            for (size_t end = n; end > 0;)
+            {
+                const size_t nb = std::min(panel_width, end), k = end - nb;
+                solve_upper_block(a, lda, k, nb, x, ldx, cols);
+                gemm(NO_TRANS, NO_TRANS, k, cols, nb, C(-1, 0), a + k, lda,
+                     x + k * ldx, ldx, C(1, 0), x, ldx);
+                end = k;
+            }
+        }
+
+        // Columns factored without further recursion inside a QR panel.
+        constexpr size_t qr_base_width = 8;
+        // Elements (rows x columns) of a TSQR leaf block, sized to stay in cache.
+        constexpr size_t tsqr_leaf_elements = size_t(1) << 17;
+
+        // Euclidean norm of n elements ld apart, scaled to avoid overflow.
+        template <typename T>
+        T column_norm(const basic_cx<T>* x, size_t ld, size_t n) noexcept
+        {
+            T scale = 0;
+            for (size_t i = 0; i < n; i++)
+                scale = std::max(scale, std::max(std::abs(x[i * ld].real), std::abs(x[i * ld].imag)));
+            if (scale == 0)
+                return 0;
+            double sum = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                const double re = x[i * ld].real / scale, im = x[i * ld].imag / scale;
+                sum += re * re + im * im;
+            }
+            return scale * static_cast<T>(std::sqrt(sum));
+        }
+
+        /*
+         * Householder reflection H = I - tau v v^H with H^H (alpha, x) =
+         * (beta, 0) and beta real (LAPACK's larfg). alpha becomes beta, x
+         * becomes v without its leading 1; returns tau.
+         */
+        template <typename C>
+        C householder(C& alpha, C* x, size_t ldx, size_t n)
+        {
+            using T = typename C::value_type;
+            const T xnorm = column_norm(x, ldx, n);
+            if (xnorm == 0 && alpha.imag == 0)
+                return C(0, 0);
+
+            T beta = std::hypot(std::hypot(alpha.real, alpha.imag), xnorm);
+            if (alpha.real >= 0)
+                beta = -beta;
+            const C tau((beta - alpha.real) / beta, -alpha.imag / beta);
+            const C s = C(1, 0) / (alpha - C(beta, 0));
+            for (size_t i = 0; i < n; i++)
+                x[i * ldx] *= s;
+            alpha = C(beta, 0);
+            return tau;
+        }
+
+        /*
+         * c = (I - V op(T) V^H) c, where V holds the Householder vectors of
+         * columns [c0, c0 + w) of a (rows [c0, m), unit diagonal implied),
+         * op(T) is T^H when adjoint (applying Q^H) and T otherwise, and c
+         * points at row c0 of a row-major block of cols columns.
+         */
+        template <typename C>
+        void apply_reflector(const C* a, size_t lda, size_t m, size_t c0, size_t w,
+                             const C* t, size_t ldt, bool adjoint, C* c, size_t ldc, size_t cols)
+        {
+            if (cols == 0 || w == 0)
+                return;
+            const size_t mv = m - c0;
+            const C* v = a + c0 * lda + c0;
+            const C one(1, 0), zero(0, 0), minus_one(-1, 0);
+
+            // The top w x w block of V is unit lower triangular and shares
+            // its storage with R, so it is copied; the rest is used in place.
+            std::vector<C> top(w * w, zero), work(2 * w * cols);
+            for (size_t i = 0; i < w; i++)
+            {
+                std::copy(v + i * lda, v + i * lda + i, top.data() + i * w);
+                top[i * w + i] = one;
+            }
+            C* vhc = work.data();
+            C* tvhc = vhc + w * cols;
+
+            gemm(CONJ_TRANS, NO_TRANS, w, cols, w, one, top.data(), w, c, ldc, zero, vhc, cols);
+            gemm(CONJ_TRANS, NO_TRANS, w, cols, mv - w, one, v + w * lda, lda, c + w * ldc, ldc, one, vhc, cols);
+            gemm(adjoint ? CONJ_TRANS : NO_TRANS, NO_TRANS, w, cols, w, one, t, ldt, vhc, cols, zero, tvhc, cols);
+            gemm(NO_TRANS, NO_TRANS, w, cols, w, minus_one, top.data(), w, tvhc, cols, one, c, ldc);
+            gemm(NO_TRANS, NO_TRANS, mv - w, cols, w, minus_one, v + w * lda, lda, tvhc, cols, one, c + w * ldc, ldc);
+        }
+
+        /*
+         * Unblocked QR of columns [c0, c1) of a, rows [c0, m), with the
+         * triangular factor T of the block written to t (LAPACK's geqr2
+         * followed by larft).
+         */
+        template <typename C>
+        void factor_columns_unblocked(C* a, size_t lda, size_t m, size_t c0, size_t c1, C* tau, C* t, size_t ldt)
+        {
+            const size_t w = c1 - c0;
+            C work[qr_base_width];
+            for (size_t j = c0; j < c1; j++)
+            {
+                C* col = a + j * lda + j;
+                const C tj = householder(col[0], col + lda, lda, m - j - 1);
+                tau[j - c0] = tj;
+                const size_t width = c1 - j - 1;
+                if (tj == C(0, 0) || width == 0)
+                    continue;
+
+                // Columns (j, c1) -= conj(tau) v (v^H columns), v_j = 1.
+                for (size_t c = 0; c < width; c++)
+                    work[c] = col[1 + c];
+                for (size_t r = j + 1; r < m; r++)
+                {
+                    const C* row = a + r * lda + j;
+                    const C vr = row[0].conjugate();
+                    for (size_t c = 0; c < width; c++)
+                        work[c] += vr * row[1 + c];
+                }
+                const C ct = tj.conjugate();
+                for (size_t c = 0; c < width; c++)
+                {
+                    work[c] *= ct;
+                    col[1 + c] -= work[c];
+                }
+                for (size_t r = j + 1; r < m; r++)
+                {
+                    C* row = a + r * lda + j;
+                    const C vr = row[0];
+                    for (size_t c = 0; c < width; c++)
+                        row[1 + c] -= vr * work[c];
+                }
+            }
+
+            // T(0:i, i) = -tau_i T(0:i, 0:i) V(:, 0:i)^H v_i, with V^H V accumulated row by row.
+            C gram[qr_base_width][qr_base_width] = {};
+            for (size_t r = c0; r < m; r++)
+            {
+                const C* row = a + r * lda + c0;
+                const size_t last = std::min(w, r - c0 + 1);
+                for (size_t i = 0; i < last; i++)
+                {
+                    const C vi = (r - c0 == i) ? C(1, 0) : row[i];
+                    for (size_t p = 0; p < i; p++)
+                        gram[p][i] += row[p].conjugate() * vi;
+                }
+            }
+            for (size_t i = 0; i < w; i++)
+            {
+                t[i * ldt + i] = tau[i];
+                for (size_t p = 0; p < i; p++)
+                {
+                    C sum(0, 0);
+                    for (size_t q = p; q < i; q++)
+                        sum += t[p * ldt + q] * gram[q][i];
+                    t[p * ldt + i] = -tau[i] * sum;
+                }
+            }
+        }
+
+        /*
+         * QR of columns [c0, c1) of a, rows [c0, m): the left half is
+         * factored, applied to the right half with gemm, the right half is
+         * factored, and the two triangular factors are merged into
+         * T = [T1, -T1 (V1^H V2) T2; 0, T2]. t must be zero below the diagonal.
+         */
+        template <typename C>
+        void factor_columns(C* a, size_t lda, size_t m, size_t c0, size_t c1, C* tau, C* t, size_t ldt)
+        {
+            const size_t w = c1 - c0;
+            if (w <= qr_base_width)
+            {
+                factor_columns_unblocked(a, lda, m, c0, c1, tau, t, ldt);
+                return;
+            }
+
+            const size_t h = w / 2, w2 = w - h;
+            const C one(1, 0), zero(0, 0);
+            factor_columns(a, lda, m, c0, c0 + h, tau, t, ldt);
+            apply_reflector(a, lda, m, c0, h, t, ldt, true, a + c0 * lda + c0 + h, lda, w2);
+            factor_columns(a, lda, m, c0 + h, c1, tau + h, t + h * ldt + h, ldt);
+
+            // V1^H V2 over the rows where V2 is not zero; the top of V2 is unit lower triangular.
+            std::vector<C> top(w2 * w2, zero), gram(h * w2), tmp(h * w2);
+            for (size_t i = 0; i < w2; i++)
+            {
+                const C* row = a + (c0 + h + i) * lda + c0 + h;
+                std::copy(row, row + i, top.data() + i * w2);
+                top[i * w2 + i] = one;
+            }
+            gemm(CONJ_TRANS, NO_TRANS, h, w2, w2, one, a + (c0 + h) * lda + c0, lda, top.data(), w2, zero, gram.data(), w2);
+            gemm(CONJ_TRANS, NO_TRANS, h, w2, m - c0 - w, one, a + (c0 + w) * lda + c0, lda,
+                 a + (c0 + w) * lda + c0 + h, lda, one, gram.data(), w2);
+            gemm(NO_TRANS, NO_TRANS, h, w2, h, one, t, ldt, gram.data(), w2, zero, tmp.data(), w2);
+            gemm(NO_TRANS, NO_TRANS, h, w2, w2, C(-1, 0), tmp.data(), w2, t + h * ldt + h, ldt, zero, t + h, ldt);
+        }
+
+        /*
+         * Blocked QR of the m x n row-major block a: panels of panel_width
+         * columns, each factored by factor_columns and applied to the
+         * trailing columns with gemm. tau receives min(m, n) scalars and t
+         * one panel_width x panel_width zero-initialized block per panel.
+         */
+        template <typename C>
+        void qr_factor(C* a, size_t lda, size_t m, size_t n, C* tau, C* t)
+        {
+            const size_t k = std::min(m, n);
+            for (size_t k0 = 0; k0 < k; k0 += panel_width)
+            {
+                const size_t w = std::min(panel_width, k - k0);
+                C* tk = t + (k0 / panel_width) * panel_width * panel_width;
+                factor_columns(a, lda, m, k0, k0 + w, tau + k0, tk, panel_width);
+                apply_reflector(a, lda, m, k0, w, tk, panel_width, true, a + k0 * lda + k0 + w, lda, n - k0 - w);
+            }
+        }
+
+        // b = Q^H b (adjoint) or Q b for the Q of qr_factor and the m x cols block b.
+        template <typename C>
+        void qr_apply(const C* a, size_t lda, size_t m, size_t k, const C* t, bool adjoint, C* b, size_t ldb, size_t cols)
+        {
+            const size_t panels = (k + panel_width - 1) / panel_width;
+            for (size_t p = 0; p < panels; p++)
+            {
+                const size_t index = adjoint ? p : panels - 1 - p, k0 = index * panel_width;
+                const size_t w = std::min(panel_width, k - k0);
+                apply_reflector(a, lda, m, k0, w, t + index * panel_width * panel_width, panel_width,
+                                adjoint, b + k0 * ldb, ldb, cols);
+            }
+        }
+
+        // Zero-initialized storage for the panel factors of qr_factor.
+        template <typename C>
+        std::vector<C> panel_factors(size_t k)
+        {
+            return std::vector<C>(((k + panel_width - 1) / panel_width) * panel_width * panel_width, C(0, 0));
+        }
+
+        // Rows of a TSQR leaf block for n columns.
+        size_t tsqr_leaf_rows(size_t n) noexcept
+        {
+            return std::max(4 * n, tsqr_leaf_elements / n);
+        }
+
+        /*
+         * TSQR reduction of min |A X - B| for the m x n block a and the m x r
+         * block b: on return r_out (n x n, upper triangular) and b_out
+         * (n x r) hold R and the first n rows of Q^H B. Blocks of rows are
+         * reduced independently and their results stacked and reduced again.
+         */
+        template <typename C>
+        void tsqr(const C* a, size_t lda, const C* b, size_t ldb, size_t m, size_t n, size_t r, C* r_out, C* b_out)
+        {
+            const size_t leaf = tsqr_leaf_rows(n);
+            if (m <= leaf)
+            {
+                std::vector<C> block(m * n), rhs(m * r), tau(n), t = panel_factors<C>(n);
+                for (size_t i = 0; i < m; i++)
+                {
+                    std::copy(a + i * lda, a + i * lda + n, block.data() + i * n);
+                    std::copy(b + i * ldb, b + i * ldb + r, rhs.data() + i * r);
+                }
+                qr_factor(block.data(), n, m, n, tau.data(), t.data());
+                qr_apply(block.data(), n, m, n, t.data(), true, rhs.data(), r, r);
+                for (size_t i = 0; i < n; i++)
+                {
+                    std::fill(r_out + i * n, r_out + i * n + i, C(0, 0));
+                    std::copy(block.data() + i * n + i, block.data() + i * n + n, r_out + i * n + i);
+                }
+                std::copy(rhs.data(), rhs.data() + n * r, b_out);
+                return;
+            }
+
+            const size_t blocks = (m + leaf - 1) / leaf;
+            std::vector<C> stacked_r(blocks * n * n), stacked_b(blocks * n * r);
+            parallel_for(0, blocks, 1, [&](size_t start, size_t end) {
+                for (size_t i = start; i < end; i++)
+                {
+                    const size_t r0 = m * i / blocks, r1 = m * (i + 1) / blocks;
+                    tsqr(a + r0 * lda, lda, b + r0 * ldb, ldb, r1 - r0, n, r,
+                         stacked_r.data() + i * n * n, stacked_b.data() + i * n * r);
+                }
+            });
+            tsqr(stacked_r.data(), n, stacked_b.data(), r, blocks * n, n, r, r_out, b_out);
+        }
+
+        // Throws if the n x n upper triangle of r has a zero on the diagonal.
+        template <typename C>
+        void require_full_rank(const C* r, size_t ldr, size_t n)
+        {
+            for (size_t i = 0; i < n; i++)
+                if (r[i * ldr + i] == C(0, 0))
+                    throw std::runtime_error("Can't solve the least-squares problem -> the matrix is rank deficient.");
+        }
+
+        // Whether lstsq goes through TSQR for an m x n matrix.
+        bool use_tsqr(size_t m, size_t n) noexcept
+        {
+            return m >= 2 * tsqr_leaf_rows(n);
+        }
+
+        // Least-squares solution (n x r, row-major) of a X = b for the m x r block b, with TSQR.
+        template <typename T>
+        std::vector<basic_cx<T>> tsqr_solve(const basic_cx_matrix<T>& a, const basic_cx<T>* b, size_t ldb, size_t r)
+        {
+            const size_t n = a.cols();
+            std::vector<basic_cx<T>> rf(n * n), x(n * r);
+            tsqr(a.data(), a.row_stride(), b, ldb, a.rows(), n, r, rf.data(), x.data());
+            require_full_rank(rf.data(), n, n);
+            solve_upper(rf.data(), n, n, x.data(), r, r);
+            return x;
+        }
+    }
+
+    template <typename T>
+    basic_cx_lu<T>::basic_cx_lu(const basic_cx_matrix<T>& a)
+        : __factors__(a)
+    {
+        factor();
+    }
+
+    template <typename T>
+    basic_cx_lu<T>::basic_cx_lu(basic_cx_matrix<T>&& a)
+        : __factors__(std::move(a))
+    {
+        factor();
+    }
+
+    template <typename T>
+    void basic_cx_lu<T>::factor()
+    {
+        require_square(__factors__, "LU decomposition");
+
+        const size_t n = __factors__.rows(), lda = __factors__.row_stride();
+        cx* a = __factors__.data();
+        const cx one(1, 0), minus_one(-1, 0);
+        __pivots__.assign(n, 0);
+
+        for (size_t k = 0; k < n; k += panel_width)
+        {
+            const size_t nb = std::min(panel_width, n - k), rest = n - k - nb;
+            if (!factor_panel(a, lda, n, k, nb, __pivots__.data()))
+                __singular__ = true;
+            if (rest == 0)
+                break;
+
+            // U12 = L11^-1 A12, then A22 -= L21 U12.
+            solve_lower_block(a, lda, k, nb, a + k + nb, lda, rest);
+            gemm(NO_TRANS, NO_TRANS, rest, rest, nb, minus_one, a + (k + nb) * lda + k, lda,
+                 a + k * lda + k + nb, lda, one, a + (k + nb) * lda + k + nb, lda);
+        }
+    }
+
+    template <typename T>
+    std::vector<size_t> basic_cx_lu<T>::permutation() const
+    {
+        std::vector<size_t> perm(size());
+        std::iota(perm.begin(), perm.end(), 0);
+        for (size_t i = 0; i < size(); i++)
+            std::swap(perm[i], perm[__pivots__[i]]);
+        return perm;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_lu<T>::lower() const
+    {
+        const size_t n = size();
+        basic_cx_matrix<T> l(n, n, cx(0, 0));
+        for (size_t i = 0; i < n; i++)
+        {
+            std::copy(&__factors__(i, 0), &__factors__(i, 0) + i, &l(i, 0));
+            l(i, i) = cx(1, 0);
+        }
+        return l;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_lu<T>::upper() const
+    {
+        const size_t n = size();
+        basic_cx_matrix<T> u(n, n, cx(0, 0));
+        for (size_t i = 0; i < n; i++)
+            std::copy(&__factors__(i, i), &__factors__(i, 0) + n, &u(i, i));
+        return u;
+    }
+
+    template <typename T>
+    typename basic_cx_lu<T>::cx basic_cx_lu<T>::det() const noexcept
+    {
+        if (__singular__)
+            return cx(0, 0);
+
+        cx d(1, 0);
+        for (size_t i = 0; i < size(); i++)
+        {
+            d *= __factors__(i, i);
+            if (__pivots__[i] != i)
+                d = -d;
+        }
+        return d;
+    }
+
+    template <typename T>
+    basic_cx_vector<T> basic_cx_lu<T>::solve(const basic_cx_vector<T>& b) const
+    {
+        const size_t n = size();
+        if (b.dim() != n)
+            throw std::invalid_argument("Can't solve the linear system -> dimensions mismatch.");
+        if (__singular__)
+            throw std::runtime_error("Can't solve the linear system -> the matrix is singular.");
+
+        std::vector<cx> x(n);
+        for (size_t i = 0; i < n; i++)
+            x[i] = b[i];
+        for (size_t i = 0; i < n; i++)
+            std::swap(x[i], x[__pivots__[i]]);
+
+        // Substitutions with the rows of L and U, which are contiguous.
+        for (size_t i = 1; i < n; i++)
+            x[i] -= kernels::accumulate_dot(i, &__factors__(i, 0), x.data());
+        for (size_t i = n; i-- > 0;)
+            x[i] = (x[i] - kernels::accumulate_dot(n - i - 1, &__factors__(i, i + 1), x.data() + i + 1)) / __factors__(i, i);
+
+        return basic_cx_vector<T>(x);
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_lu<T>::solve(const basic_cx_matrix<T>& b) const
+    {
+        const size_t n = size();
+        if (b.rows() != n)
+            throw std::invalid_argument("Can't solve the linear system -> dimensions mismatch.");
+        if (__singular__)
+            throw std::runtime_error("Can't solve the linear system -> the matrix is singular.");
+
+        basic_cx_matrix<T> x(b);
+        for (size_t i = 0; i < n; i++)
+            if (__pivots__[i] != i)
+                std::swap_ranges(&x(i, 0), &x(i, 0) + x.cols(), &x(__pivots__[i], 0));
+
+        solve_unit_lower(__factors__.data(), __factors__.row_stride(), n, x.data(), x.row_stride(), x.cols());
+        solve_upper(__factors__.data(), __factors__.row_stride(), n, x.data(), x.row_stride(), x.cols());
+        return x;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_lu<T>::inverse() const
+    {
+        return solve(basic_cx_matrix<T>::get_identity(size()));
+    }
+
+    template class basic_cx_lu<float>;
+    template class basic_cx_lu<double>;
+
+    cx_lu lu(const cx_matrix& a)
+    {
+        return cx_lu(a);
+    }
+
+    cxd_lu lu(const cxd_matrix& a)
+    {
+        return cxd_lu(a);
+    }
+
+    cx_lu lu(cx_matrix&& a)
+    {
+        return cx_lu(std::move(a));
+    }
+
+    cxd_lu lu(cxd_matrix&& a)
+    {
+        return cxd_lu(std::move(a));
+    }
+
+    cx_vector solve(const cx_matrix& a, const cx_vector& b)
+    {
+        return cx_lu(a).solve(b);
+    }
+
+    cxd_vector solve(const cxd_matrix& a, const cxd_vector& b)
+    {
+        return cxd_lu(a).solve(b);
+    }
+
+    cx_matrix solve(const cx_matrix& a, const cx_matrix& b)
+    {
+        return cx_lu(a).solve(b);
+    }
+
+    cxd_matrix solve(const cxd_matrix& a, const cxd_matrix& b)
+    {
+        return cxd_lu(a).solve(b);
+    }
+
+    cx det(const cx_matrix& a)
+    {
+        return cx_lu(a).det();
+    }
+
+    cxd det(const cxd_matrix& a)
+    {
+        return cxd_lu(a).det();
+    }
+
+    cx_matrix inverse(const cx_matrix& a)
+    {
+        return cx_lu(a).inverse();
+    }
+
+    cxd_matrix inverse(const cxd_matrix& a)
+    {
+        return cxd_lu(a).inverse();
+    }
+
+    namespace
+    {
+        /*
+         * L of the nb x nb diagonal block at (k, k) of a, in place, reading
+         * its lower triangle (already updated by the previous panels).
+         */
+        template <typename C>
+        void cholesky_block(C* a, size_t lda, size_t k, size_t nb)
+        {
+            using T = typename C::value_type;
+            for (size_t j = 0; j < nb; j++)
+            {
+                C* row = a + (k + j) * lda + k;
+                T d = row[j].real;
+                for (size_t p = 0; p < j; p++)
+                    d -= row[p].mod2();
+                if (!(d > 0))
+                    throw std::runtime_error("Can't compute the Cholesky decomposition -> the matrix is not positive definite.");
+                d = std::sqrt(d);
+                row[j] = C(d, 0);
+
+                const C inv(T(1) / d, 0);
+                for (size_t i = j + 1; i < nb; i++)
+                {
+                    C* below = a + (k + i) * lda + k;
+                    C sum = below[j];
+                    for (size_t p = 0; p < j; p++)
+                        sum -= below[p] * row[p].conjugate();
+                    below[j] = sum * inv;
+                }
+            }
+        }
+
+        /*
+         * x = L^-1 x for the nb x nb lower triangular block l (real
+         * diagonal) and the nb x cols row-major block x, column chunks of x
+         * in parallel.
+         */
+        template <typename C>
+        void solve_cholesky_block(const C* l, size_t ldl, size_t nb, C* x, size_t ldx, size_t cols)
+        {
+            using T = typename C::value_type;
+            parallel_blocks(cols, nb * nb / 2, [&](size_t start, size_t end) {
+                for (size_t i = 0; i < nb; i++)
+                {
+                    C* row = x + i * ldx + start;
+                    for (size_t j = 0; j < i; j++)
+                        kernels::axpy(end - start, -l[i * ldl + j], x + j * ldx + start, row);
+                    kernels::scale(end - start, C(T(1) / l[i * ldl + i].real, 0), row, row);
+                }
+            });
+        }
+
+        // x = (L L^H)^-1 x for the lower triangle of l and the n x cols row-major block x.
+        template <typename C>
+        void cholesky_solve(const C* l, size_t ldl, size_t n, C* x, size_t ldx, size_t cols)
+        {
+            using T = typename C::value_type;
+            const C one(1, 0), minus_one(-1, 0);
+            for (size_t k = 0; k < n; k += panel_width)
+            {
+                const size_t nb = std::min(panel_width, n - k);
+                solve_cholesky_block(l + k * ldl + k, ldl, nb, x + k * ldx, ldx, cols);
+                gemm(NO_TRANS, NO_TRANS, n - k - nb, cols, nb, minus_one, l + (k + nb) * ldl + k, ldl,
+                     x + k * ldx, ldx, one, x + (k + nb) * ldx, ldx);
+            }
+            for (size_t end = n; end > 0;)
+            {
+                const size_t nb = std::min(panel_width, end), k = end - nb;
+                parallel_blocks(cols, nb * nb / 2, [&](size_t start, size_t stop) {
+                    for (size_t i = k + nb; i-- > k;)
+                    {
+                        C* row = x + i * ldx + start;
+                        for (size_t j = i + 1; j < k + nb; j++)
+                            kernels::axpy(stop - start, -l[j * ldl + i].conjugate(), x + j * ldx + start, row);
+                        kernels::scale(stop - start, C(T(1) / l[i * ldl + i].real, 0), row, row);
+                    }
+                });
+                gemm(CONJ_TRANS, NO_TRANS, k, cols, nb, minus_one, l + k * ldl, ldl,
+                     x + k * ldx, ldx, one, x, ldx);
+                end = k;
+            }
+        }
+    }
+
+    template <typename T>
+    basic_cx_cholesky<T>::basic_cx_cholesky(const basic_cx_matrix<T>& a)
+        : __factors__(a)
+    {
+        factor();
+    }
+
+    template <typename T>
+    basic_cx_cholesky<T>::basic_cx_cholesky(basic_cx_matrix<T>&& a)
+        : __factors__(std::move(a))
+    {
+        factor();
+    }
+
+    template <typename T>
+    void basic_cx_cholesky<T>::factor()
+    {
+        require_square(__factors__, "Cholesky decomposition");
+
+        const size_t n = __factors__.rows(), lda = __factors__.row_stride();
+        cx* a = __factors__.data();
+        const cx one(1, 0), minus_one(-1, 0);
+        std::vector<cx> z;
+
+        for (size_t k = 0; k < n; k += panel_width)
+        {
+            const size_t nb = std::min(panel_width, n - k), s0 = k + nb, rest = n - s0;
+            cholesky_block(a, lda, k, nb);
+            if (rest == 0)
+                break;
+
+            // Z = L21^H = L11^-1 A21^H, solved on the adjoint so that every step is an axpy of length rest.
+            z.resize(nb * rest);
+            for (size_t r = 0; r < rest; r++)
+                for (size_t j = 0; j < nb; j++)
+                    z[j * rest + r] = a[(s0 + r) * lda + k + j].conjugate();
+            solve_cholesky_block(a + k * lda + k, lda, nb, z.data(), rest, rest);
+            for (size_t r = 0; r < rest; r++)
+                for (size_t j = 0; j < nb; j++)
+                    a[(s0 + r) * lda + k + j] = z[j * rest + r].conjugate();
+
+            // A22 -= Z^H Z, block column by block column, on and below the diagonal only.
+            for (size_t c = 0; c < rest; c += panel_width)
+            {
+                const size_t w = std::min(panel_width, rest - c);
+                gemm(CONJ_TRANS, NO_TRANS, rest - c, w, nb, minus_one, z.data() + c, rest,
+                     z.data() + c, rest, one, a + (s0 + c) * lda + s0 + c, lda);
+            }
+        }
+
+        for (size_t i = 0; i + 1 < n; i++)
+            std::fill(a + i * lda + i + 1, a + i * lda + n, cx(0, 0));
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_cholesky<T>::upper() const
+    {
+        const size_t n = size();
+        basic_cx_matrix<T> u(n, n, cx(0, 0));
+        for (size_t i = 0; i < n; i++)
+            for (size_t j = 0; j <= i; j++)
+                u(j, i) = __factors__(i, j).conjugate();
+        return u;
+    }
+
+    template <typename T>
+    basic_cx_vector<T> basic_cx_cholesky<T>::solve(const basic_cx_vector<T>& b) const
+    {
+        const size_t n = size();
+        if (b.dim() != n)
+            throw std::invalid_argument("Can't solve the linear system -> dimensions mismatch.");
+
+        std::vector<cx> x(n);
+        for (size_t i = 0; i < n; i++)
+            x[i] = b[i];
+
+        // L y = b with the rows of L, then L^H x = y with them again, as columns of L^H.
+        for (size_t i = 0; i < n; i++)
+            x[i] = (x[i] - kernels::accumulate_dot(i, &__factors__(i, 0), x.data())) * cx(T(1) / __factors__(i, i).real, 0);
+        for (size_t i = n; i-- > 0;)
+        {
+            x[i] *= cx(T(1) / __factors__(i, i).real, 0);
+            const cx* row = &__factors__(i, 0);
+            for (size_t j = 0; j < i; j++)
+                x[j] -= row[j].conjugate() * x[i];
+        }
+
+        return basic_cx_vector<T>(x);
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_cholesky<T>::solve(const basic_cx_matrix<T>& b) const
+    {
+        const size_t n = size();
+        if (b.rows() != n)
+            throw std::invalid_argument("Can't solve the linear system -> dimensions mismatch.");
+
+        basic_cx_matrix<T> x(b);
+        cholesky_solve(__factors__.data(), __factors__.row_stride(), n, x.data(), x.row_stride(), x.cols());
+        return x;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_cholesky<T>::inverse() const
+    {
+        return solve(basic_cx_matrix<T>::get_identity(size()));
+    }
+
+    template <typename T>
+    T basic_cx_cholesky<T>::det() const noexcept
+    {
+        T d = 1;
+        for (size_t i = 0; i < size(); i++)
+            d *= __factors__(i, i).real * __factors__(i, i).real;
+        return d;
+    }
+
+    template <typename T>
+    void basic_cx_cholesky<T>::update(const basic_cx_vector<T>& x)
+    {
+        const size_t n = size();
+        if (x.dim() != n)
+            throw std::invalid_argument("Can't update the Cholesky factor -> dimensions mismatch.");
+
+        // Rotation i mixes column i of L with x so that x_i vanishes. Row i
+        // only needs the rotations of the previous rows, so a single sweep
+        // applies them and finds the next one.
+        std::vector<T> c(n);
+        std::vector<cx> s(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            cx* row = &__factors__(i, 0);
+            cx xi = x[i];
+            for (size_t k = 0; k < i; k++)
+            {
+                const cx l = row[k];
+                row[k] = l * cx(c[k], 0) + s[k].conjugate() * xi;
+                xi = xi * cx(c[k], 0) - s[k] * l;
+            }
+            const T d = row[i].real, r = std::hypot(d, std::hypot(xi.real, xi.imag));
+            c[i] = d / r;
+            s[i] = cx(xi.real / r, xi.imag / r);
+            row[i] = cx(r, 0);
+        }
+    }
+
+    template <typename T>
+    void basic_cx_cholesky<T>::downdate(const basic_cx_vector<T>& x)
+    {
+        const size_t n = size();
+        if (x.dim() != n)
+            throw std::invalid_argument("Can't downdate the Cholesky factor -> dimensions mismatch.");
+
+        // A - x x^H = L (I - p p^H) L^H with L p = x, positive definite if and only if |p| < 1.
+        std::vector<cx> p(n);
+        double norm = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            p[i] = (x[i] - kernels::accumulate_dot(i, &__factors__(i, 0), p.data())) * cx(T(1) / __factors__(i, i).real, 0);
+            norm += static_cast<double>(p[i].real) * p[i].real + static_cast<double>(p[i].imag) * p[i].imag;
+        }
+        if (!(norm < 1))
+            throw std::runtime_error("Can't downdate the Cholesky factor -> the result is not positive definite.");
+
+        // Rotations taking (p, sqrt(1 - |p|^2)) to the last unit vector
+        // (LINPACK's chdd); applied to (L^H; 0) they leave the factor of
+        // A - x x^H on top. They are known in advance, so rows of L are
+        // independent.
+        std::vector<T> c(n);
+        std::vector<cx> s(n);
+        double alpha = std::sqrt(1 - norm);
+        for (size_t i = n; i-- > 0;)
+        {
+            const double next = std::hypot(alpha, std::hypot(static_cast<double>(p[i].real), static_cast<double>(p[i].imag)));
+            c[i] = static_cast<T>(alpha / next);
+            s[i] = cx(static_cast<T>(p[i].real / next), static_cast<T>(p[i].imag / next));
+            alpha = next;
+        }
+        parallel_blocks(n, n / 2, [&](size_t start, size_t end) {
+            for (size_t j = start; j < end; j++)
+            {
+                cx* row = &__factors__(j, 0);
+                cx y(0, 0);
+                for (size_t i = j + 1; i-- > 0;)
+                {
+                    const cx l = row[i];
+                    row[i] = l * cx(c[i], 0) - s[i].conjugate() * y;
+                    y = s[i] * l + cx(c[i], 0) * y;
+                }
+            }
+        });
+    }
+
+    template class basic_cx_cholesky<float>;
+    template class basic_cx_cholesky<double>;
+
+    cx_cholesky cholesky(const cx_matrix& a)
+    {
+        return cx_cholesky(a);
+    }
+
+    cxd_cholesky cholesky(const cxd_matrix& a)
+    {
+        return cxd_cholesky(a);
+    }
+
+    cx_cholesky cholesky(cx_matrix&& a)
+    {
+        return cx_cholesky(std::move(a));
+    }
+
+    cxd_cholesky cholesky(cxd_matrix&& a)
+    {
+        return cxd_cholesky(std::move(a));
+    }
+
+    cx_vector cho_solve(const cx_cholesky& c, const cx_vector& b)
+    {
+        return c.solve(b);
+    }
+
+    cxd_vector cho_solve(const cxd_cholesky& c, const cxd_vector& b)
+    {
+        return c.solve(b);
+    }
+
+    cx_matrix cho_solve(const cx_cholesky& c, const cx_matrix& b)
+    {
+        return c.solve(b);
+    }
+
+    cxd_matrix cho_solve(const cxd_cholesky& c, const cxd_matrix& b)
+    {
+        return c.solve(b);
+    }
+
+    template <typename T>
+    basic_cx_qr<T>::basic_cx_qr(const basic_cx_matrix<T>& a)
+        : __factors__(a)
+    {
+        factor();
+    }
+
+    template <typename T>
+    basic_cx_qr<T>::basic_cx_qr(basic_cx_matrix<T>&& a)
+        : __factors__(std::move(a))
+    {
+        factor();
+    }
+
+    template <typename T>
+    void basic_cx_qr<T>::factor()
+    {
+        const size_t k = std::min(rows(), cols());
+        __tau__.assign(k, cx(0, 0));
+        __t__ = panel_factors<cx>(k);
+        qr_factor(__factors__.data(), __factors__.row_stride(), rows(), cols(), __tau__.data(), __t__.data());
+    }
+
+    template <typename T>
+    void basic_cx_qr<T>::apply(bool adjoint, cx* b, size_t ldb, size_t n) const
+    {
+        qr_apply(__factors__.data(), __factors__.row_stride(), rows(), __tau__.size(), __t__.data(), adjoint, b, ldb, n);
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_qr<T>::q() const
+    {
+        const size_t k = __tau__.size();
+        basic_cx_matrix<T> q(rows(), k, cx(0, 0));
+        for (size_t i = 0; i < k; i++)
+            q(i, i) = cx(1, 0);
+        apply(false, q.data(), q.row_stride(), k);
+        return q;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_qr<T>::r() const
+    {
+        const size_t k = __tau__.size();
+        basic_cx_matrix<T> r(k, cols(), cx(0, 0));
+        for (size_t i = 0; i < k; i++)
+            std::copy(&__factors__(i, i), &__factors__(i, 0) + cols(), &r(i, i));
+        return r;
+    }
+
+    template <typename T>
+    basic_cx_vector<T> basic_cx_qr<T>::apply_qh(const basic_cx_vector<T>& b) const
+    {
+        if (b.dim() != rows())
+            throw std::invalid_argument("Can't apply Q -> dimensions mismatch.");
+        std::vector<cx> x(b.dim());
+        for (size_t i = 0; i < b.dim(); i++)
+            x[i] = b[i];
+        apply(true, x.data(), 1, 1);
+        return basic_cx_vector<T>(x);
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_qr<T>::apply_qh(const basic_cx_matrix<T>& b) const
+    {
+        if (b.rows() != rows())
+            throw std::invalid_argument("Can't apply Q -> dimensions mismatch.");
+        basic_cx_matrix<T> x(b);
+        apply(true, x.data(), x.row_stride(), x.cols());
+        return x;
+    }
+
+    template <typename T>
+    basic_cx_vector<T> basic_cx_qr<T>::apply_q(const basic_cx_vector<T>& b) const
+    {
+        if (b.dim() != rows())
+            throw std::invalid_argument("Can't apply Q -> dimensions mismatch.");
+        std::vector<cx> x(b.dim());
+        for (size_t i = 0; i < b.dim(); i++)
+            x[i] = b[i];
+        apply(false, x.data(), 1, 1);
+        return basic_cx_vector<T>(x);
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_qr<T>::apply_q(const basic_cx_matrix<T>& b) const
+    {
+        if (b.rows() != rows())
+            throw std::invalid_argument("Can't apply Q -> dimensions mismatch.");
+        basic_cx_matrix<T> x(b);
+        apply(false, x.data(), x.row_stride(), x.cols());
+        return x;
+    }
+
+    template <typename T>
+    basic_cx_vector<T> basic_cx_qr<T>::solve(const basic_cx_vector<T>& b) const
+    {
+        if (rows() < cols())
+            throw std::invalid_argument("Can't solve the least-squares problem -> more columns than rows.");
+        if (b.dim() != rows())
+            throw std::invalid_argument("Can't solve the least-squares problem -> dimensions mismatch.");
+        require_full_rank(__factors__.data(), __factors__.row_stride(), cols());
+
+        std::vector<cx> x(b.dim());
+        for (size_t i = 0; i < b.dim(); i++)
+            x[i] = b[i];
+        apply(true, x.data(), 1, 1);
+        solve_upper(__factors__.data(), __factors__.row_stride(), cols(), x.data(), 1, 1);
+        x.resize(cols());
+        return basic_cx_vector<T>(x);
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_qr<T>::solve(const basic_cx_matrix<T>& b) const
+    {
+        if (rows() < cols())
+            throw std::invalid_argument("Can't solve the least-squares problem -> more columns than rows.");
+        if (b.rows() != rows())
+            throw std::invalid_argument("Can't solve the least-squares problem -> dimensions mismatch.");
+        require_full_rank(__factors__.data(), __factors__.row_stride(), cols());
+
+        basic_cx_matrix<T> y(b);
+        apply(true, y.data(), y.row_stride(), y.cols());
+        solve_upper(__factors__.data(), __factors__.row_stride(), cols(), y.data(), y.row_stride(), y.cols());
+        basic_cx_matrix<T> x(cols(), b.cols(), cx(0, 0));
+        std::copy(y.data(), y.data() + cols() * y.row_stride(), x.data());
+        return x;
+    }
+
+    template class basic_cx_qr<float>;
+    template class basic_cx_qr<double>;
+
+    namespace
+    {
+        template <typename T>
+        basic_cx_vector<T> lstsq_vector(const basic_cx_matrix<T>& a, const basic_cx_vector<T>& b)
+        {
+            if (a.rows() < a.cols() || !use_tsqr(a.rows(), a.cols()))
+                return basic_cx_qr<T>(a).solve(b);
+            if (b.dim() != a.rows())
+                throw std::invalid_argument("Can't solve the least-squares problem -> dimensions mismatch.");
+            return basic_cx_vector<T>(tsqr_solve(a, &b[0], 1, 1));
+        }
+
+        template <typename T>
+        basic_cx_matrix<T> lstsq_matrix(const basic_cx_matrix<T>& a, const basic_cx_matrix<T>& b)
+        {
+            if (a.rows() < a.cols() || !use_tsqr(a.rows(), a.cols()))
+                return basic_cx_qr<T>(a).solve(b);
+            if (b.rows() != a.rows())
+                throw std::invalid_argument("Can't solve the least-squares problem -> dimensions mismatch.");
+            const std::vector<basic_cx<T>> x = tsqr_solve(a, b.data(), b.row_stride(), b.cols());
+            basic_cx_matrix<T> out(a.cols(), b.cols(), basic_cx<T>(0, 0));
+            std::copy(x.begin(), x.end(), out.data());
+            return out;
+        }
+
+        template <typename T>
+        std::vector<basic_cx_vector<T>> orthonormalize_impl(const std::vector<basic_cx_vector<T>>& vectors)
+        {
+            using C = basic_cx<T>;
+            const size_t k = vectors.size();
+            if (k == 0)
+                throw std::invalid_argument("Can't orthonormalize an empty set of vectors.");
+            const size_t d = vectors[0].dim();
+            if (k > d)
+                throw std::invalid_argument("Can't orthonormalize more vectors than dimensions.");
+
+            // One vector per column; a single vector gets a zero companion column.
+            basic_cx_matrix<T> a(d, std::max<size_t>(k, 2), C(0, 0));
+            for (size_t j = 0; j < k; j++)
+            {
+                if (vectors[j].dim() != d)
+                    throw std::invalid_argument("Can't orthonormalize vectors of different dimensions.");
+                for (size_t i = 0; i < d; i++)
+                    a(i, j) = vectors[j][i];
+            }
+
+            const basic_cx_qr<T> f(std::move(a));
+            const basic_cx_matrix<T> q = f.q();
+            std::vector<basic_cx_vector<T>> out;
+            out.reserve(k);
+            for (size_t j = 0; j < k; j++)
+            {
+                const T sign = (f.factors()(j, j).real < 0) ? T(-1) : T(1);
+                std::vector<C> column(d);
+                for (size_t i = 0; i < d; i++)
+                    column[i] = q(i, j) * C(sign, 0);
+                out.emplace_back(column);
+            }
+            return out;
+        }
+    }
+
+    cx_qr qr(const cx_matrix& a)
+    {
+        return cx_qr(a);
+    }
+
+    cxd_qr qr(const cxd_matrix& a)
+    {
+        return cxd_qr(a);
+    }
+
+    cx_qr qr(cx_matrix&& a)
+    {
+        return cx_qr(std::move(a));
+    }
+
+    cxd_qr qr(cxd_matrix&& a)
+    {
+        return cxd_qr(std::move(a));
+    }
+
+    cx_vector lstsq(const cx_matrix& a, const cx_vector& b)
+    {
+        return lstsq_vector(a, b);
+    }
+
+    cxd_vector lstsq(const cxd_matrix& a, const cxd_vector& b)
+    {
+        return lstsq_vector(a, b);
+    }
+
+    cx_matrix lstsq(const cx_matrix& a, const cx_matrix& b)
+    {
+        return lstsq_matrix(a, b);
+    }
+
+    cxd_matrix lstsq(const cxd_matrix& a, const cxd_matrix& b)
+    {
+        return lstsq_matrix(a, b);
+    }
+
+    std::vector<cx_vector> orthonormalize(const std::vector<cx_vector>& vectors)
+    {
+        return orthonormalize_impl(vectors);
+    }
+
+    std::vector<cxd_vector> orthonormalize(const std::vector<cxd_vector>& vectors)
+    {
+        return orthonormalize_impl(vectors);
+    }
+
+    namespace
+    {
+        // Largest tridiagonal block solved by QL iteration inside divide and conquer.
+        constexpr size_t dc_leaf_size = 32;
+        // Order from which the two halves of a divide and conquer step run in parallel.
+        constexpr size_t dc_parallel_size = 256;
+
+        /*
+         * Blocked reduction of the Hermitian n x n block a (both triangles
+         * stored) to the real tridiagonal T = Q^H A Q (LAPACK's hetrd with
+         * latrd panels, lower variant). Within a panel the reflections are
+         * only accumulated in V and W, and applied to the trailing matrix
+         * at the end as the rank-2k update A -= V W^H + W V^H with gemm.
+         * d and e receive the diagonal and subdiagonal of T, tau the n - 1
+         * scalars of Q = H_0 ... H_{n-2}; v_j is left in column j of a,
+         * below the subdiagonal.
+         */
+        template <typename C>
+        void tridiagonalize(C* a, size_t lda, size_t n, typename C::value_type* d, typename C::value_type* e, C* tau)
+        {
+            const C one(1, 0), zero(0, 0), minus_one(-1, 0);
+            const size_t ld = panel_width;
+            std::vector<C> vb(n * ld), wb(n * ld), v(n), y(2 * ld);
+            for (size_t k = 0; k + 1 < n; k += panel_width)
+            {
+                const size_t nb = std::min(panel_width, n - 1 - k);
+                std::fill(vb.begin() + k * ld, vb.end(), zero);
+                std::fill(wb.begin() + k * ld, wb.end(), zero);
+                for (size_t i = 0; i < nb; i++)
+                {
+                    const size_t j = k + i, len = n - j - 1;
+
+                    // Column j with the updates of the previous reflectors of the panel.
+                    const C* vj = vb.data() + j * ld;
+                    const C* wj = wb.data() + j * ld;
+                    for (size_t r = j; r < n; r++)
+                    {
+                        const C* vr = vb.data() + r * ld;
+                        const C* wr = wb.data() + r * ld;
+                        C sum(0, 0);
+                        for (size_t p = 0; p < i; p++)
+                            sum += vr[p] * wj[p].conjugate() + wr[p] * vj[p].conjugate();
+                        a[r * lda + j] -= sum;
+                    }
+                    d[j] = a[j * lda + j].real;
+
+                    // Reflector annihilating column j below the subdiagonal.
+                    C* col = a + (j + 1) * lda + j;
+                    tau[j] = householder(col[0], len > 1 ? col + lda : col, lda, len - 1);
+                    e[j] = col[0].real;
+                    v[0] = one;
+                    for (size_t r = 1; r < len; r++)
+                        v[r] = col[r * lda];
+                    for (size_t r = 0; r < len; r++)
+                        vb[(j + 1 + r) * ld + i] = v[r];
+
+                    // w = tau (A v - V W^H v - W V^H v), the matrix-vector product split by rows.
+                    C* y1 = y.data();
+                    C* y2 = y1 + ld;
+                    std::fill(y.begin(), y.end(), zero);
+                    for (size_t r = 0; r < len; r++)
+                    {
+                        const C* vr = vb.data() + (j + 1 + r) * ld;
+                        const C* wr = wb.data() + (j + 1 + r) * ld;
+                        for (size_t p = 0; p < i; p++)
+                        {
+                            y1[p] += wr[p].conjugate() * v[r];
+                            y2[p] += vr[p].conjugate() * v[r];
+                        }
+                    }
+                    const C tj = tau[j];
+                    parallel_blocks(len, len, [&](size_t start, size_t end) {
+                        for (size_t r = j + 1 + start; r < j + 1 + end; r++)
+                        {
+                            C s = kernels::accumulate_dot(len, a + r * lda + j + 1, v.data());
+                            const C* vr = vb.data() + r * ld;
+                            const C* wr = wb.data() + r * ld;
+                            for (size_t p = 0; p < i; p++)
+                                s -= vr[p] * y1[p] + wr[p] * y2[p];
+                            wb[r * ld + i] = tj * s;
+                        }
+                    });
+
+                    // w -= tau / 2 (w^H v) v
+                    C wv(0, 0);
+                    for (size_t r = 0; r < len; r++)
+                        wv += wb[(j + 1 + r) * ld + i].conjugate() * v[r];
+                    const C alpha = C(-0.5, 0) * tj * wv;
+                    for (size_t r = 0; r < len; r++)
+                        wb[(j + 1 + r) * ld + i] += alpha * v[r];
+                }
+
+                const size_t s = k + nb, rest = n - s;
+                gemm(NO_TRANS, CONJ_TRANS, rest, rest, nb, minus_one, vb.data() + s * ld, ld,
+                     wb.data() + s * ld, ld, one, a + s * lda + s, lda);
+                gemm(NO_TRANS, CONJ_TRANS, rest, rest, nb, minus_one, wb.data() + s * ld, ld,
+                     vb.data() + s * ld, ld, one, a + s * lda + s, lda);
+            }
+            d[n - 1] = a[(n - 1) * lda + n - 1].real;
+        }
+
+        /*
+         * Panel factors, as qr_apply expects them, of k reflectors stored
+         * like qr_factor leaves them in the m-row block v: reflector j in
+         * column j, unit element on the diagonal (LAPACK's larft, with
+         * V^H V through gemm).
+         */
+        template <typename C>
+        std::vector<C> reflector_factors(const C* v, size_t lda, size_t m, size_t k, const C* tau)
+        {
+            const C one(1, 0), zero(0, 0);
+            std::vector<C> t = panel_factors<C>(k), top(panel_width * panel_width), gram(panel_width * panel_width);
+            for (size_t k0 = 0; k0 < k; k0 += panel_width)
+            {
+                const size_t w = std::min(panel_width, k - k0);
+                C* tk = t.data() + (k0 / panel_width) * panel_width * panel_width;
+                std::fill(top.begin(), top.end(), zero);
+                for (size_t i = 0; i < w; i++)
+                {
+                    const C* row = v + (k0 + i) * lda + k0;
+                    std::copy(row, row + i, top.data() + i * w);
+                    top[i * w + i] = one;
+                }
+                gemm(CONJ_TRANS, NO_TRANS, w, w, w, one, top.data(), w, top.data(), w, zero, gram.data(), w);
+                gemm(CONJ_TRANS, NO_TRANS, w, w, m - k0 - w, one, v + (k0 + w) * lda + k0, lda,
+                     v + (k0 + w) * lda + k0, lda, one, gram.data(), w);
+                for (size_t i = 0; i < w; i++)
+                {
+                    tk[i * panel_width + i] = tau[k0 + i];
+                    for (size_t p = 0; p < i; p++)
+                    {
+                        C sum(0, 0);
+                        for (size_t q = p; q < i; q++)
+                            sum += tk[p * panel_width + q] * gram[q * w + i];
+                        tk[p * panel_width + i] = -tau[k0 + i] * sum;
+                    }
+                }
+            }
+            return t;
+        }
+
+        // Sorts the eigenvalues d ascending, permuting the columns of the rows x n block z (if any) alike.
+        void sort_eigenpairs(size_t n, double* d, double* z, size_t ldz, size_t rows)
+        {
+            std::vector<size_t> order(n);
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) { return d[x] < d[y]; });
+            std::vector<double> tmp(n);
+            for (size_t i = 0; i < n; i++)
+                tmp[i] = d[order[i]];
+            std::copy(tmp.begin(), tmp.end(), d);
+            if (z == nullptr)
+                return;
+            for (size_t r = 0; r < rows; r++)
+            {
+                double* row = z + r * ldz;
+                for (size_t i = 0; i < n; i++)
+                    tmp[i] = row[order[i]];
+                std::copy(tmp.begin(), tmp.end(), row);
+            }
+        }
+
+        /*
+         * Eigenvalues (ascending, in d) of the symmetric tridiagonal matrix
+         * with diagonal d and off-diagonal e[0, n - 1) by implicit QL with
+         * Wilkinson shifts; e[n - 1] is scratch. If z is not null, the
+         * rotations are accumulated into its n x n block, which turns the
+         * identity into the eigenvectors (as columns).
+         */
+        void tridiagonal_ql(size_t n, double* d, double* e, double* z, size_t ldz)
+        {
+            const double eps = std::numeric_limits<double>::epsilon();
+            e[n - 1] = 0;
+            for (size_t l = 0; l < n; l++)
+            {
+                size_t iter = 0, m;
+                do
+                {
+                    for (m = l; m + 1 < n; m++)
+                        if (std::abs(e[m]) <= eps * (std::abs(d[m]) + std::abs(d[m + 1])))
+                            break;
+                    if (m == l)
+                        break;
+                    if (iter++ == 60)
+                        throw std::runtime_error("Can't compute the eigenvalues -> the QL iteration did not converge.");
+
+                    double g = (d[l + 1] - d[l]) / (2 * e[l]);
+                    double r = std::hypot(g, 1.0);
+                    g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+                    double s = 1, c = 1, p = 0;
+                    bool split = false;
+                    for (size_t i = m; i-- > l;)
+                    {
+                        double f = s * e[i];
+                        const double b = c * e[i];
+                        e[i + 1] = r = std::hypot(f, g);
+                        if (r == 0)
+                        {
+                            // Underflow: the matrix splits, start again.
+                            d[i + 1] -= p;
+                            e[m] = 0;
+                            split = true;
+                            break;
+                        }
+                        s = f / r;
+                        c = g / r;
+                        g = d[i + 1] - p;
+                        r = (d[i] - g) * s + 2 * c * b;
+                        p = s * r;
+                        d[i + 1] = g + p;
+                        g = c * r - b;
+                        if (z != nullptr)
+                            for (size_t k = 0; k < n; k++)
+                            {
+                                double* row = z + k * ldz;
+                                f = row[i + 1];
+                                row[i + 1] = s * row[i] + c * f;
+                                row[i] = c * row[i] - s * f;
+                            }
+                    }
+                    if (split)
+                        continue;
+                    d[l] -= p;
+                    e[l] = g;
+                    e[m] = 0;
+                } while (m != l);
+            }
+            sort_eigenpairs(n, d, z, ldz, n);
+        }
+
+        /*
+         * c = a b for row-major real matrices (m x k and k x n). Pairs of
+         * columns of b are packed into one complex column, so the complex
+         * gemm does the work with half of its products wasted instead of three
+         * quarters.
+         */
+        void real_gemm(size_t m, size_t n, size_t k, const double* a, size_t lda,
+                       const double* b, size_t ldb, double* c, size_t ldc)
+        {
+            const size_t np = (n + 1) / 2;
+            std::vector<cxd> ac(m * k), bc(k * np), cc(m * np);
+            for (size_t i = 0; i < m; i++)
+                for (size_t p = 0; p < k; p++)
+                    ac[i * k + p] = cxd(a[i * lda + p], 0);
+            for (size_t p = 0; p < k; p++)
+                for (size_t q = 0; q < np; q++)
+                    bc[p * np + q] = cxd(b[p * ldb + 2 * q], 2 * q + 1 < n ? b[p * ldb + 2 * q + 1] : 0.0);
+            gemm(NO_TRANS, NO_TRANS, m, np, k, cxd(1, 0), ac.data(), k, bc.data(), np, cxd(0, 0), cc.data(), np);
+            for (size_t i = 0; i < m; i++)
+                for (size_t q = 0; q < np; q++)
+                {
+                    c[i * ldc + 2 * q] = cc[i * np + q].real;
+                    if (2 * q + 1 < n)
+                        c[i * ldc + 2 * q + 1] = cc[i * np + q].imag;
+                }
+        }
+
+        /*
+         * Roots of the secular equation 1/rho + sum z_i^2 / (d_i - x) = 0 for
+         * ascending d, nonzero z and rho > 0 (LAPACK's laed4). Root j lies
+         * in (d_j, d_j+1), the last one above d_k-1; each is a rational
+         * Newton iteration with two poles, safeguarded by bisection, and is
+         * returned as d[origin[j]] + tau[j] with the origin at the nearer
+         * pole so that the differences d_i - x stay accurate.
+         */
+        void secular_roots(size_t k, const double* d, const double* z, double rho, size_t* origin, double* tau)
+        {
+            const double eps = std::numeric_limits<double>::epsilon();
+            double zsq = 0;
+            for (size_t i = 0; i < k; i++)
+                zsq += z[i] * z[i];
+
+            parallel_blocks(k, 16 * k, [&](size_t start, size_t end) {
+                for (size_t j = start; j < end; j++)
+                {
+                    const bool last = j + 1 == k;
+                    size_t org = j;
+                    double lo = 0, hi = rho * zsq;
+                    if (!last)
+                    {
+                        const double gap = d[j + 1] - d[j], mid = gap / 2;
+                        double f = 1 / rho;
+                        for (size_t i = 0; i < k; i++)
+                            f += z[i] * z[i] / ((d[i] - d[j]) - mid);
+                        if (f >= 0)
+                            hi = mid;
+                        else
+                        {
+                            org = j + 1;
+                            lo = mid - gap;
+                            hi = 0;
+                        }
+                    }
+
+                    const double p1 = d[j] - d[org], p2 = last ? 0 : d[j + 1] - d[org];
+                    double t = (lo + hi) / 2;
+                    for (int iter = 0; iter < 100; iter++)
+                    {
+                        double psi = 0, dpsi = 0, phi = 0, dphi = 0;
+                        for (size_t i = 0; i <= j; i++)
+                        {
+                            const double q = z[i] / ((d[i] - d[org]) - t);
+                            psi += z[i] * q;
+                            dpsi += q * q;
+                        }
+                        for (size_t i = j + 1; i < k; i++)
+                        {
+                            const double q = z[i] / ((d[i] - d[org]) - t);
+                            phi += z[i] * q;
+                            dphi += q * q;
+                        }
+                        const double f = 1 / rho + psi + phi;
+                        if (std::abs(f) <= 8 * eps * (1 / rho + std::abs(psi) + std::abs(phi)))
+                            break;
+                        if (f > 0)
+                            hi = t;
+                        else
+                            lo = t;
+                        if (hi - lo <= 2 * eps * std::max(std::abs(lo), std::abs(hi)))
+                            break;
+
+                        // Zero of a + b1 / (p1 - x) + b2 / (p2 - x), matching psi and phi to first order.
+                        const double b1 = dpsi * (p1 - t) * (p1 - t), a1 = psi - dpsi * (p1 - t);
+                        double next = lo;
+                        if (last)
+                        {
+                            const double c = 1 / rho + a1;
+                            if (c > 0)
+                                next = p1 + b1 / c;
+                        }
+                        else
+                        {
+                            const double b2 = dphi * (p2 - t) * (p2 - t), a2 = phi - dphi * (p2 - t);
+                            const double c = 1 / rho + a1 + a2;
+                            const double qb = -(c * (p1 + p2) + b1 + b2), qc = c * p1 * p2 + b1 * p2 + b2 * p1;
+                            if (c == 0)
+                                next = qb != 0 ? -qc / qb : lo;
+                            else
+                            {
+                                const double disc = qb * qb - 4 * c * qc;
+                                if (disc >= 0)
+                                {
+                                    const double s = -0.5 * (qb + std::copysign(std::sqrt(disc), qb));
+                                    const double r1 = s / c, r2 = s != 0 ? qc / s : r1;
+                                    next = (r1 > lo && r1 < hi) ? r1 : r2;
+                                }
+                            }
+                        }
+                        t = (next > lo && next < hi) ? next : (lo + hi) / 2;
+                    }
+                    origin[j] = org;
+                    tau[j] = t;
+                }
+            });
+        }
+
+        /*
+         * Merge step of divide and conquer (LAPACK's laed1, laed2 and laed3).
+         * On entry d holds the eigenvalues of the two halves [0, m) and
+         * [m, n), and the n x n block z their eigenvectors as diag(Q1, Q2);
+         * the full matrix is then diag(Q1, Q2) (D + rho u u^T) diag(Q1, Q2)^T
+         * with u built from the last row of Q1 and the first of Q2. Small
+         * components of u and close pairs of eigenvalues are deflated, the
+         * rest of the eigenvalues are the roots of the secular equation, and
+         * the eigenvectors use the Gu-Eisenstat recomputed u, which keeps them
+         * orthogonal. On return d and z hold the eigenpairs of the full block.
+         */
+        void dc_merge(size_t n, size_t m, double beta, double* d, double* z, size_t ldz)
+        {
+            const double eps = std::numeric_limits<double>::epsilon();
+            const double sign = beta < 0 ? -1.0 : 1.0, norm = 1 / std::sqrt(2.0), rho = 2 * std::abs(beta);
+
+            std::vector<size_t> order(n);
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) { return d[x] < d[y]; });
+            std::vector<double> dd(n), zz(n), q(n * n);
+            double dmax = 0, zmax = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                const size_t c = order[i];
+                dd[i] = d[c];
+                zz[i] = (c < m ? z[(m - 1) * ldz + c] : sign * z[m * ldz + c]) * norm;
+                dmax = std::max(dmax, std::abs(dd[i]));
+                zmax = std::max(zmax, std::abs(zz[i]));
+            }
+            for (size_t r = 0; r < n; r++)
+                for (size_t i = 0; i < n; i++)
+                    q[r * n + i] = z[r * ldz + order[i]];
+
+            // Deflation: negligible components of u, then eigenvalues closer than tol by a Givens rotation.
+            const double tol = 8 * eps * std::max(dmax, zmax);
+            std::vector<size_t> kept, deflated;
+            size_t prev = n;
+            for (size_t j = 0; j < n; j++)
+            {
+                if (rho * std::abs(zz[j]) <= tol)
+                {
+                    deflated.push_back(j);
+                    continue;
+                }
+                if (prev == n)
+                {
+                    prev = j;
+                    continue;
+                }
+                const double r = std::hypot(zz[j], zz[prev]), t = dd[j] - dd[prev];
+                const double c = zz[j] / r, s = -zz[prev] / r;
+                if (std::abs(t * c * s) <= tol)
+                {
+                    zz[j] = r;
+                    zz[prev] = 0;
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        double* row = q.data() + i * n;
+                        const double x = row[prev], y = row[j];
+                        row[prev] = c * x + s * y;
+                        row[j] = c * y - s * x;
+                    }
+                    const double dp = dd[prev] * c * c + dd[j] * s * s;
+                    dd[j] = dd[prev] * s * s + dd[j] * c * c;
+                    dd[prev] = dp;
+                    deflated.push_back(prev);
+                }
+                else
+                    kept.push_back(prev);
+                prev = j;
+            }
+            if (prev != n)
+                kept.push_back(prev);
+            std::stable_sort(kept.begin(), kept.end(), [&](size_t x, size_t y) { return dd[x] < dd[y]; });
+
+            const size_t k = kept.size();
+            std::vector<double> values(n), out(n * n);
+            if (k > 0)
+            {
+                std::vector<double> dk(k), zk(k), tau(k), zhat(k), u(k * k), qk(n * k);
+                std::vector<size_t> origin(k);
+                for (size_t i = 0; i < k; i++)
+                {
+                    dk[i] = dd[kept[i]];
+                    zk[i] = zz[kept[i]];
+                }
+                secular_roots(k, dk.data(), zk.data(), rho, origin.data(), tau.data());
+                auto delta = [&](size_t i, size_t j) { return (dk[i] - dk[origin[j]]) - tau[j]; };
+
+                // Gu-Eisenstat: the u for which the computed roots are exact.
+                for (size_t i = 0; i < k; i++)
+                {
+                    double p = -delta(i, i) / rho;
+                    for (size_t j = 0; j < k; j++)
+                        if (j != i)
+                            p *= -delta(i, j) / (dk[j] - dk[i]);
+                    zhat[i] = std::copysign(std::sqrt(p), zk[i]);
+                }
+                for (size_t j = 0; j < k; j++)
+                {
+                    double sum = 0;
+                    for (size_t i = 0; i < k; i++)
+                    {
+                        u[i * k + j] = zhat[i] / delta(i, j);
+                        sum += u[i * k + j] * u[i * k + j];
+                    }
+                    const double inv = 1 / std::sqrt(sum);
+                    for (size_t i = 0; i < k; i++)
+                        u[i * k + j] *= inv;
+                    values[j] = dk[origin[j]] + tau[j];
+                }
+
+                for (size_t r = 0; r < n; r++)
+                    for (size_t i = 0; i < k; i++)
+                        qk[r * k + i] = q[r * n + kept[i]];
+                real_gemm(n, k, k, qk.data(), k, u.data(), k, out.data(), n);
+            }
+            for (size_t i = 0; i < deflated.size(); i++)
+            {
+                values[k + i] = dd[deflated[i]];
+                for (size_t r = 0; r < n; r++)
+                    out[r * n + k + i] = q[r * n + deflated[i]];
+            }
+
+            sort_eigenpairs(n, values.data(), out.data(), n, n);
+            std::copy(values.begin(), values.end(), d);
+            for (size_t r = 0; r < n; r++)
+                std::copy(out.data() + r * n, out.data() + (r + 1) * n, z + r * ldz);
+        }
+
+        /*
+         * Eigenvalues (ascending, in d) and eigenvectors (columns of the
+         * n x n block z) of the tridiagonal matrix (d, e) by divide and
+         * conquer: the matrix is split in two halves coupled by a rank-one
+         * term, the halves are solved recursively (in parallel when large)
+         * and merged by dc_merge. e needs n elements, the last one scratch.
+         */
+        void tridiagonal_dc(size_t n, double* d, double* e, double* z, size_t ldz)
+        {
+            if (n <= dc_leaf_size)
+            {
+                for (size_t i = 0; i < n; i++)
+                {
+                    std::fill(z + i * ldz, z + i * ldz + n, 0.0);
+                    z[i * ldz + i] = 1;
+                }
+                tridiagonal_ql(n, d, e, z, ldz);
+                return;
+            }
+
+            const size_t m = n / 2;
+            const double beta = e[m - 1];
+            d[m - 1] -= std::abs(beta);
+            d[m] -= std::abs(beta);
+            for (size_t i = 0; i < n; i++)
+            {
+                if (i < m)
+                    std::fill(z + i * ldz + m, z + i * ldz + n, 0.0);
+                else
+                    std::fill(z + i * ldz, z + i * ldz + m, 0.0);
+            }
+            auto half = [&](size_t h) {
+                if (h == 0)
+                    tridiagonal_dc(m, d, e, z, ldz);
+                else
+                    tridiagonal_dc(n - m, d + m, e + m, z + m * ldz + m, ldz);
+            };
+            if (n >= dc_parallel_size)
+                parallel_for(0, 2, 1, [&](size_t start, size_t end) {
+                    for (size_t h = start; h < end; h++)
+                        half(h);
+                });
+            else
+            {
+                half(0);
+                half(1);
+            }
+            dc_merge(n, m, beta, d, z, ldz);
+        }
+
+        // Number of eigenvalues of the tridiagonal (d, e) below x, e2 holding the squares of e (Sturm count).
+        size_t sturm_count(size_t n, const double* d, const double* e2, double x, double pivmin) noexcept
+        {
+            size_t count = 0;
+            double q = 1;
+            for (size_t i = 0; i < n; i++)
+            {
+                q = d[i] - x - (i > 0 ? e2[i - 1] / q : 0.0);
+                if (std::abs(q) < pivmin)
+                    q = -pivmin;
+                if (q < 0)
+                    count++;
+            }
+            return count;
+        }
+
+        // Eigenvalues [first, first + count) of the tridiagonal (d, e) by bisection, in parallel.
+        std::vector<double> tridiagonal_bisect(size_t n, const double* d, const double* e, size_t first, size_t count)
+        {
+            const double eps = std::numeric_limits<double>::epsilon();
+            std::vector<double> e2(n, 0.0);
+            double lo = d[0], hi = d[0], emax = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                const double left = i > 0 ? std::abs(e[i - 1]) : 0.0, right = i + 1 < n ? std::abs(e[i]) : 0.0;
+                lo = std::min(lo, d[i] - left - right);
+                hi = std::max(hi, d[i] + left + right);
+                if (i + 1 < n)
+                {
+                    e2[i] = e[i] * e[i];
+                    emax = std::max(emax, e2[i]);
+                }
+            }
+            const double pivmin = std::numeric_limits<double>::min() * std::max(1.0, emax);
+            const double atol = 2 * eps * std::max(std::abs(lo), std::abs(hi)) + pivmin;
+            lo -= n * atol;
+            hi += n * atol;
+
+            std::vector<double> values(count);
+            parallel_blocks(count, 64 * n, [&](size_t start, size_t end) {
+                for (size_t c = start; c < end; c++)
+                {
+                    double a = lo, b = hi;
+                    while (b - a > atol)
+                    {
+                        const double mid = a + (b - a) / 2;
+                        if (sturm_count(n, d, e2.data(), mid, pivmin) > first + c)
+                            b = mid;
+                        else
+                            a = mid;
+                    }
+                    values[c] = a + (b - a) / 2;
+                }
+            });
+            return values;
+        }
+
+        /*
+         * Eigenvectors of the tridiagonal (d, e) for the ascending
+         * eigenvalues w by inverse iteration (LAPACK's stein), as the columns
+         * of the n x count block z. Eigenvalues closer than 1e-3 |T| form a
+         * cluster whose vectors are orthogonalized against each other at
+         * every step; clusters run in parallel.
+         */
+        void tridiagonal_inverse_iteration(size_t n, const double* d, const double* e, const double* w, size_t count, double* z)
+        {
+            const double eps = std::numeric_limits<double>::epsilon();
+            double tnorm = 0;
+            for (size_t i = 0; i < n; i++)
+                tnorm = std::max(tnorm, std::abs(d[i]) + (i > 0 ? std::abs(e[i - 1]) : 0.0) + (i + 1 < n ? std::abs(e[i]) : 0.0));
+            const double ortol = 1e-3 * tnorm, pertol = 10 * eps * tnorm;
+            const double tiny = tnorm > 0 ? eps * tnorm : std::numeric_limits<double>::min();
+
+            std::vector<size_t> clusters{0};
+            for (size_t c = 1; c < count; c++)
+                if (w[c] - w[c - 1] > ortol)
+                    clusters.push_back(c);
+            clusters.push_back(count);
+
+            parallel_for(0, clusters.size() - 1, 1, [&](size_t start, size_t end) {
+                std::vector<double> u0(n), u1(n), u2(n), l(n), x(n);
+                std::vector<char> swapped(n);
+                for (size_t s = start; s < end; s++)
+                {
+                    double prev = 0;
+                    for (size_t c = clusters[s]; c < clusters[s + 1]; c++)
+                    {
+                        // Close eigenvalues are pulled apart so that their vectors differ.
+                        double lambda = w[c];
+                        if (c > clusters[s] && lambda - prev < pertol)
+                            lambda = prev + pertol;
+                        prev = lambda;
+
+                        // T - lambda I = P L U with partial pivoting; U has two superdiagonals.
+                        double p = d[0] - lambda, q = n > 1 ? e[0] : 0.0;
+                        for (size_t i = 0; i + 1 < n; i++)
+                        {
+                            const double sub = e[i], next = d[i + 1] - lambda, far = i + 2 < n ? e[i + 1] : 0.0;
+                            if (std::abs(p) >= std::abs(sub))
+                            {
+                                if (p == 0)
+                                    p = tiny;
+                                swapped[i] = 0;
+                                l[i] = sub / p;
+                                u0[i] = p;
+                                u1[i] = q;
+                                u2[i] = 0;
+                                p = next - l[i] * q;
+                                q = far;
+                            }
+                            else
+                            {
+                                swapped[i] = 1;
+                                l[i] = p / sub;
+                                u0[i] = sub;
+                                u1[i] = next;
+                                u2[i] = far;
+                                p = q - l[i] * next;
+                                q = -l[i] * far;
+                            }
+                        }
+                        u0[n - 1] = p != 0 ? p : tiny;
+
+                        uint64_t state = 0x9E3779B97F4A7C15ull * (c + 1);
+                        for (size_t i = 0; i < n; i++)
+                        {
+                            state = state * 6364136223846793005ull + 1442695040888963407ull;
+                            x[i] = static_cast<double>(state >> 11) / 9007199254740992.0 - 0.5;
+                        }
+                        for (int iter = 0; iter < 4; iter++)
+                        {
+                            for (size_t i = 0; i + 1 < n; i++)
+                            {
+                                if (swapped[i])
+                                    std::swap(x[i], x[i + 1]);
+                                x[i + 1] -= l[i] * x[i];
+                            }
+                            for (size_t i = n; i-- > 0;)
+                            {
+                                double v = x[i];
+                                if (i + 1 < n)
+                                    v -= u1[i] * x[i + 1];
+                                if (i + 2 < n)
+                                    v -= u2[i] * x[i + 2];
+                                x[i] = v / u0[i];
+                            }
+
+                            for (size_t o = clusters[s]; o < c; o++)
+                            {
+                                double dot = 0;
+                                for (size_t i = 0; i < n; i++)
+                                    dot += z[i * count + o] * x[i];
+                                for (size_t i = 0; i < n; i++)
+                                    x[i] -= dot * z[i * count + o];
+                            }
+                            double scale = 0;
+                            for (size_t i = 0; i < n; i++)
+                                scale = std::max(scale, std::abs(x[i]));
+                            double sum = 0;
+                            for (size_t i = 0; i < n; i++)
+                            {
+                                x[i] /= scale;
+                                sum += x[i] * x[i];
+                            }
+                            const double inv = 1 / std::sqrt(sum);
+                            for (size_t i = 0; i < n; i++)
+                                x[i] *= inv;
+                        }
+                        for (size_t i = 0; i < n; i++)
+                            z[i * count + c] = x[i];
+                    }
+                }
+            });
+        }
+    }
+
+    template <typename T>
+    basic_cx_eigh<T>::basic_cx_eigh(const basic_cx_matrix<T>& a, __cx_eig_range__ range, size_t count, bool vectors)
+    {
+        using C = basic_cx<T>;
+        require_square(a, "Hermitian eigendecomposition");
+        const size_t n = a.rows();
+        if (range == EIG_ALL)
+            count = n;
+        else if (count == 0 || count > n)
+            throw std::invalid_argument("Can't compute the eigenvalues -> count must be between 1 and the order of the matrix.");
+        const size_t first = (range == EIG_LARGEST) ? n - count : 0;
+
+        // Hermitian copy of the lower triangle, reduced to tridiagonal form.
+        std::vector<C> h(n * n);
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t j = 0; j < i; j++)
+            {
+                h[i * n + j] = a(i, j);
+                h[j * n + i] = a(i, j).conjugate();
+            }
+            h[i * n + i] = C(a(i, i).real, 0);
+        }
+        std::vector<T> dt(n), et(n);
+        std::vector<C> tau(n - 1);
+        tridiagonalize(h.data(), n, n, dt.data(), et.data(), tau.data());
+        std::vector<double> d(dt.begin(), dt.end()), e(et.begin(), et.end());
+
+        // Past half of the spectrum, the whole of it is cheaper than bisection.
+        const bool whole = 2 * count > n;
+        std::vector<double> values, z;
+        if (!vectors && whole)
+        {
+            tridiagonal_ql(n, d.data(), e.data(), nullptr, 0);
+            values.assign(d.begin() + first, d.begin() + first + count);
+        }
+        else if (whole)
+        {
+            std::vector<double> all(n * n);
+            tridiagonal_dc(n, d.data(), e.data(), all.data(), n);
+            values.assign(d.begin() + first, d.begin() + first + count);
+            z.resize(n * count);
+            for (size_t i = 0; i < n; i++)
+                std::copy(all.data() + i * n + first, all.data() + i * n + first + count, z.data() + i * count);
+        }
+        else
+        {
+            values = tridiagonal_bisect(n, d.data(), e.data(), first, count);
+            if (vectors)
+            {
+                z.resize(n * count);
+                tridiagonal_inverse_iteration(n, d.data(), e.data(), values.data(), count, z.data());
+            }
+        }
+        __values__.assign(values.begin(), values.end());
+        if (!vectors)
+            return;
+
+        // Eigenvectors of A = Q T Q^H are Q times those of T.
+        std::vector<C> x(n * count);
+        for (size_t i = 0; i < n * count; i++)
+            x[i] = C(static_cast<T>(z[i]), 0);
+        // Seen one row down, reflector j has its unit element on the diagonal.
+        const std::vector<C> t = reflector_factors(h.data() + n, n, n - 1, n - 1, tau.data());
+        qr_apply(h.data() + n, n, n - 1, n - 1, t.data(), false, x.data() + count, count, count);
+        __vectors__.reserve(count);
+        for (size_t j = 0; j < count; j++)
+        {
+            std::vector<C> column(n);
+            for (size_t i = 0; i < n; i++)
+                column[i] = x[i * count + j];
+            __vectors__.emplace_back(column);
+        }
+    }
+
+    template class basic_cx_eigh<float>;
+    template class basic_cx_eigh<double>;
+
+    cx_eigh eigh(const cx_matrix& a, __cx_eig_range__ range, size_t count)
+    {
+        return cx_eigh(a, range, count);
+    }
+
+    cxd_eigh eigh(const cxd_matrix& a, __cx_eig_range__ range, size_t count)
+    {
+        return cxd_eigh(a, range, count);
+    }
+
+    std::vector<float> eigvalsh(const cx_matrix& a, __cx_eig_range__ range, size_t count)
+    {
+        return cx_eigh(a, range, count, false).values();
+    }
+
+    std::vector<double> eigvalsh(const cxd_matrix& a, __cx_eig_range__ range, size_t count)
+    {
+        return cxd_eigh(a, range, count, false).values();
+    }
+
+    namespace
+    {
+        /*
+         * Blocked reduction of the n x n block a to the real upper
+         * bidiagonal B = Q^H A P (LAPACK's gebrd with labrd panels). Within
+         * a panel the reflections are only accumulated, the left ones as
+         * A -= U Y^H and the right ones as A -= X V^H, and applied to the
+         * trailing matrix at the end with gemm. d and e receive the diagonal
+         * and superdiagonal of B; Q = H_0 ... H_{n-1} is stored like
+         * qr_factor leaves it (u_j below the diagonal of column j) and
+         * P = G_0 ... G_{n-2} with v_j right of the superdiagonal of row j.
+         */
+        template <typename C>
+        void bidiagonalize(C* a, size_t lda, size_t n, typename C::value_type* d, typename C::value_type* e,
+                           C* tauq, C* taup)
+        {
+            const C one(1, 0), zero(0, 0), minus_one(-1, 0);
+            const size_t ld = panel_width;
+            std::vector<C> ub(n * ld), yb(n * ld), xb(n * ld), vb(n * ld), u(n), v(n), g(n), s(4 * ld);
+            for (size_t k = 0; k < n; k += panel_width)
+            {
+                const size_t nb = std::min(panel_width, n - k);
+                for (auto* buffer : {&ub, &yb, &xb, &vb})
+                    std::fill(buffer->begin() + k * ld, buffer->end(), zero);
+                for (size_t i = 0; i < nb; i++)
+                {
+                    const size_t j = k + i, len = n - j, rlen = len - 1;
+
+                    // Column j with the updates of the previous reflections of the panel.
+                    for (size_t r = j; r < n; r++)
+                    {
+                        const C* ur = ub.data() + r * ld;
+                        const C* xr = xb.data() + r * ld;
+                        const C* yj = yb.data() + j * ld;
+                        const C* vj = vb.data() + j * ld;
+                        C sum(0, 0);
+                        for (size_t p = 0; p < i; p++)
+                            sum += ur[p] * yj[p].conjugate() + xr[p] * vj[p].conjugate();
+                        a[r * lda + j] -= sum;
+                    }
+
+                    // Left reflector annihilating column j below the diagonal.
+                    C* col = a + j * lda + j;
+                    tauq[j] = householder(col[0], rlen > 0 ? col + lda : col, lda, rlen);
+                    d[j] = col[0].real;
+                    u[0] = one;
+                    for (size_t r = 1; r < len; r++)
+                        u[r] = col[r * lda];
+                    for (size_t r = 0; r < len; r++)
+                        ub[(j + r) * ld + i] = u[r];
+                    if (rlen == 0)
+                        break;
+
+                    // y = tauq (A^H u - Y U^H u - V X^H u) over columns (j, n), by column chunks.
+                    C* t1 = s.data();
+                    C* t2 = t1 + ld;
+                    std::fill(s.begin(), s.end(), zero);
+                    for (size_t r = 0; r < len; r++)
+                        for (size_t p = 0; p < i; p++)
+                        {
+                            t1[p] += ub[(j + r) * ld + p].conjugate() * u[r];
+                            t2[p] += xb[(j + r) * ld + p].conjugate() * u[r];
+                        }
+                    const C tq = tauq[j];
+                    parallel_blocks(rlen, len, [&](size_t start, size_t end) {
+                        std::fill(g.begin() + start, g.begin() + end, zero);
+                        for (size_t r = 0; r < len; r++)
+                            kernels::axpy(end - start, u[r].conjugate(), a + (j + r) * lda + j + 1 + start, g.data() + start);
+                        for (size_t c = start; c < end; c++)
+                        {
+                            const C* yc = yb.data() + (j + 1 + c) * ld;
+                            const C* vc = vb.data() + (j + 1 + c) * ld;
+                            C value = g[c].conjugate();
+                            for (size_t p = 0; p < i; p++)
+                                value -= yc[p] * t1[p] + vc[p] * t2[p];
+                            yb[(j + 1 + c) * ld + i] = tq * value;
+                        }
+                    });
+
+                    // Row j with the left reflection and the previous right ones.
+                    C* row = a + j * lda + j + 1;
+                    const C* uj = ub.data() + j * ld;
+                    const C* xj = xb.data() + j * ld;
+                    for (size_t c = 0; c < rlen; c++)
+                    {
+                        const C* yc = yb.data() + (j + 1 + c) * ld;
+                        const C* vc = vb.data() + (j + 1 + c) * ld;
+                        C sum = uj[i] * yc[i].conjugate();
+                        for (size_t p = 0; p < i; p++)
+                            sum += uj[p] * yc[p].conjugate() + xj[p] * vc[p].conjugate();
+                        row[c] -= sum;
+                    }
+
+                    // Right reflector annihilating row j past the superdiagonal: the
+                    // reflector of the conjugated row, A G = A - (A v) taup v^H.
+                    for (size_t c = 0; c < rlen; c++)
+                        row[c] = row[c].conjugate();
+                    taup[j] = householder(row[0], rlen > 1 ? row + 1 : row, 1, rlen - 1);
+                    e[j] = row[0].real;
+                    v[0] = one;
+                    for (size_t c = 1; c < rlen; c++)
+                        v[c] = row[c];
+                    for (size_t c = 0; c < rlen; c++)
+                        vb[(j + 1 + c) * ld + i] = v[c];
+
+                    // x = taup (A v - U Y^H v - X V^H v) over rows (j, n), by row chunks.
+                    C* s1 = t2 + ld;
+                    C* s2 = s1 + ld;
+                    for (size_t c = 0; c < rlen; c++)
+                    {
+                        const C* yc = yb.data() + (j + 1 + c) * ld;
+                        const C* vc = vb.data() + (j + 1 + c) * ld;
+                        for (size_t p = 0; p <= i; p++)
+                            s1[p] += yc[p].conjugate() * v[c];
+                        for (size_t p = 0; p < i; p++)
+                            s2[p] += vc[p].conjugate() * v[c];
+                    }
+                    const C tp = taup[j];
+                    parallel_blocks(rlen, rlen, [&](size_t start, size_t end) {
+                        for (size_t r = j + 1 + start; r < j + 1 + end; r++)
+                        {
+                            C value = kernels::accumulate_dot(rlen, a + r * lda + j + 1, v.data());
+                            const C* ur = ub.data() + r * ld;
+                            const C* xr = xb.data() + r * ld;
+                            for (size_t p = 0; p <= i; p++)
+                                value -= ur[p] * s1[p];
+                            for (size_t p = 0; p < i; p++)
+                                value -= xr[p] * s2[p];
+                            xb[r * ld + i] = tp * value;
+                        }
+                    });
+                }
+
+                const size_t s0 = k + nb, rest = n - s0;
+                if (rest == 0)
+                    break;
+                gemm(NO_TRANS, CONJ_TRANS, rest, rest, nb, minus_one, ub.data() + s0 * ld, ld,
+                     yb.data() + s0 * ld, ld, one, a + s0 * lda + s0, lda);
+                gemm(NO_TRANS, CONJ_TRANS, rest, rest, nb, minus_one, xb.data() + s0 * ld, ld,
+                     vb.data() + s0 * ld, ld, one, a + s0 * lda + s0, lda);
+            }
+        }
+
+        /*
+         * Singular values of the upper bidiagonal matrix (d, e) by the
+         * implicit shifted QR iteration of Golub and Kahan (Golub-Reinsch).
+         * If ut and vt are not null, the rotations are accumulated into
+         * their n x n blocks, which turns the identity into U^T and V^T
+         * (one singular vector per row, so that rotations touch contiguous
+         * rows). On return d holds the singular values in descending order.
+         */
+        void bidiagonal_svd(size_t n, double* d, const double* e, double* ut, double* vt)
+        {
+            const double eps = std::numeric_limits<double>::epsilon();
+            // f[i] couples columns i - 1 and i, f[0] = 0.
+            std::vector<double> f(n, 0.0);
+            double norm = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                if (i > 0)
+                    f[i] = e[i - 1];
+                norm = std::max(norm, std::abs(d[i]) + std::abs(f[i]));
+            }
+            const double tol = eps * norm;
+            auto rotate = [n](double* z, size_t p, size_t q, double c, double s) {
+                if (z == nullptr)
+                    return;
+                double* zp = z + p * n;
+                double* zq = z + q * n;
+                for (size_t i = 0; i < n; i++)
+                {
+                    const double x = zp[i], y = zq[i];
+                    zp[i] = x * c + y * s;
+                    zq[i] = y * c - x * s;
+                }
+            };
+
+            for (size_t k = n; k-- > 0;)
+            {
+                for (size_t iter = 0;; iter++)
+                {
+                    // Split: a negligible f[l] ends the block, a negligible d[l - 1] is chased away first.
+                    size_t l = k;
+                    bool cancel = false;
+                    for (;; l--)
+                    {
+                        if (std::abs(f[l]) <= tol)
+                            break;
+                        if (std::abs(d[l - 1]) <= tol)
+                        {
+                            cancel = true;
+                            break;
+                        }
+                    }
+                    if (cancel)
+                    {
+                        double c = 0, s = 1;
+                        for (size_t i = l; i <= k; i++)
+                        {
+                            const double g = s * f[i];
+                            f[i] *= c;
+                            if (std::abs(g) <= tol)
+                                break;
+                            const double h = std::hypot(g, d[i]);
+                            c = d[i] / h;
+                            s = -g / h;
+                            d[i] = h;
+                            rotate(ut, l - 1, i, c, s);
+                        }
+                    }
+                    if (l == k)
+                    {
+                        if (d[k] < 0)
+                        {
+                            d[k] = -d[k];
+                            if (vt != nullptr)
+                                for (size_t i = 0; i < n; i++)
+                                    vt[k * n + i] = -vt[k * n + i];
+                        }
+                        break;
+                    }
+                    if (iter == 75)
+                        throw std::runtime_error("Can't compute the singular values -> the QR iteration did not converge.");
+
+                    // Shift from the trailing 2 x 2 block, then one chase of the bulge from l to k.
+                    double x = d[l], y = d[k - 1], z = d[k], g = f[k - 1], h = f[k];
+                    double shift = ((y - z) * (y + z) + (g - h) * (g + h)) / (2 * h * y);
+                    g = std::hypot(shift, 1.0);
+                    shift = ((x - z) * (x + z) + h * ((y / (shift + std::copysign(g, shift))) - h)) / x;
+                    double c = 1, s = 1;
+                    for (size_t j = l; j < k; j++)
+                    {
+                        const size_t i = j + 1;
+                        g = f[i];
+                        y = d[i];
+                        h = s * g;
+                        g = c * g;
+                        z = std::hypot(shift, h);
+                        f[j] = z;
+                        c = shift / z;
+                        s = h / z;
+                        shift = x * c + g * s;
+                        g = g * c - x * s;
+                        h = y * s;
+                        y *= c;
+                        rotate(vt, j, i, c, s);
+                        z = std::hypot(shift, h);
+                        d[j] = z;
+                        if (z != 0)
+                        {
+                            c = shift / z;
+                            s = h / z;
+                        }
+                        shift = c * g + s * y;
+                        x = c * y - s * g;
+                        rotate(ut, j, i, c, s);
+                    }
+                    f[l] = 0;
+                    f[k] = shift;
+                    d[k] = x;
+                }
+            }
+
+            // Descending order, rows of ut and vt alike.
+            std::vector<size_t> order(n);
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::stable_sort(order.begin(), order.end(), [&](size_t p, size_t q) { return d[p] > d[q]; });
+            std::vector<double> tmp(n), rows(ut != nullptr ? n * n : 0);
+            for (size_t i = 0; i < n; i++)
+                tmp[i] = d[order[i]];
+            std::copy(tmp.begin(), tmp.end(), d);
+            for (double* z : {ut, vt})
+                if (z != nullptr)
+                {
+                    for (size_t i = 0; i < n; i++)
+                        std::copy(z + order[i] * n, z + (order[i] + 1) * n, rows.data() + i * n);
+                    std::copy(rows.begin(), rows.end(), z);
+                }
+        }
+
+        /*
+         * Thin SVD of the m x n row-major block a: s receives the min(m, n)
+         * singular values in descending order, u (m x min(m, n)) and v
+         * (n x min(m, n)) the singular vectors as columns, unless u is null.
+         * Tall blocks are reduced to their R factor first, wide ones go
+         * through their adjoint.
+         */
+        template <typename C>
+        void thin_svd(const C* a, size_t lda, size_t m, size_t n, typename C::value_type* s, C* u, C* v)
+        {
+            using T = typename C::value_type;
+            if (m < n)
+            {
+                std::vector<C> t(n * m);
+                for (size_t i = 0; i < m; i++)
+                    for (size_t j = 0; j < n; j++)
+                        t[j * m + i] = a[i * lda + j].conjugate();
+                thin_svd(t.data(), m, n, m, s, v, u);
+                return;
+            }
+
+            // The square matrix to bidiagonalize: a itself, or R of a = Q R.
+            std::vector<C> r(n * n, C(0, 0)), qa, qtau, qt;
+            if (m > n)
+            {
+                qa.resize(m * n);
+                qtau.resize(n);
+                qt = panel_factors<C>(n);
+                for (size_t i = 0; i < m; i++)
+                    std::copy(a + i * lda, a + i * lda + n, qa.data() + i * n);
+                qr_factor(qa.data(), n, m, n, qtau.data(), qt.data());
+                for (size_t i = 0; i < n; i++)
+                    std::copy(qa.data() + i * n + i, qa.data() + (i + 1) * n, r.data() + i * n + i);
+            }
+            else
+                for (size_t i = 0; i < n; i++)
+                    std::copy(a + i * lda, a + i * lda + n, r.data() + i * n);
+
+            std::vector<T> dt(n), et(n);
+            std::vector<C> tauq(n), taup(n);
+            bidiagonalize(r.data(), n, n, dt.data(), et.data(), tauq.data(), taup.data());
+            std::vector<double> d(dt.begin(), dt.end()), e(et.begin(), et.end());
+            std::vector<double> ut(u != nullptr ? n * n : 0), vt(u != nullptr ? n * n : 0);
+            for (size_t i = 0; u != nullptr && i < n; i++)
+                ut[i * n + i] = vt[i * n + i] = 1;
+            bidiagonal_svd(n, d.data(), e.data(), u != nullptr ? ut.data() : nullptr, u != nullptr ? vt.data() : nullptr);
+            for (size_t i = 0; i < n; i++)
+                s[i] = static_cast<T>(d[i]);
+            if (u == nullptr)
+                return;
+
+            // U = Q_qr Q_bd U_B, V = P V_B.
+            std::fill(u, u + m * n, C(0, 0));
+            for (size_t i = 0; i < n; i++)
+                for (size_t j = 0; j < n; j++)
+                {
+                    u[i * n + j] = C(static_cast<T>(ut[j * n + i]), 0);
+                    v[i * n + j] = C(static_cast<T>(vt[j * n + i]), 0);
+                }
+            const std::vector<C> tq = reflector_factors(r.data(), n, n, n, tauq.data());
+            qr_apply(r.data(), n, n, n, tq.data(), false, u, n, n);
+            if (m > n)
+                qr_apply(qa.data(), n, m, n, qt.data(), false, u, n, n);
+
+            // The right reflectors as columns, seen one row down with their unit element on the diagonal.
+            std::vector<C> pv(n * n, C(0, 0));
+            for (size_t i = 0; i < n; i++)
+                for (size_t c = i + 1; c < n; c++)
+                    pv[c * n + i] = r[i * n + c];
+            const std::vector<C> tp = reflector_factors(pv.data() + n, n, n - 1, n - 1, taup.data());
+            qr_apply(pv.data() + n, n, n - 1, n - 1, tp.data(), false, v + n, n, n);
+        }
+
+        // One vector per column of the rows x cols row-major block z.
+        template <typename T>
+        std::vector<basic_cx_vector<T>> column_vectors(const basic_cx<T>* z, size_t rows, size_t cols, size_t count)
+        {
+            std::vector<basic_cx_vector<T>> out;
+            out.reserve(count);
+            for (size_t j = 0; j < count; j++)
+            {
+                std::vector<basic_cx<T>> column(rows);
+                for (size_t i = 0; i < rows; i++)
+                    column[i] = z[i * cols + j];
+                out.emplace_back(column);
+            }
+            return out;
+        }
+
+        // Orthonormal basis (m x l, in place) of the columns of the m x l block y, by QR.
+        template <typename C>
+        void orthonormal_basis(C* y, size_t m, size_t l)
+        {
+            std::vector<C> tau(l), t = panel_factors<C>(l), q(m * l, C(0, 0));
+            qr_factor(y, l, m, l, tau.data(), t.data());
+            for (size_t i = 0; i < l; i++)
+                q[i * l + i] = C(1, 0);
+            qr_apply(y, l, m, l, t.data(), false, q.data(), l, l);
+            std::copy(q.begin(), q.end(), y);
+        }
+    }
+
+    template <typename T>
+    basic_cx_svd<T>::basic_cx_svd(const basic_cx_matrix<T>& a, bool vectors)
+        : __rows__(a.rows()), __cols__(a.cols())
+    {
+        const size_t m = a.rows(), n = a.cols(), k = std::min(m, n);
+        __values__.resize(k);
+        if (!vectors)
+        {
+            thin_svd<cx>(a.data(), a.row_stride(), m, n, __values__.data(), nullptr, nullptr);
+            return;
+        }
+        std::vector<cx> u(m * k), v(n * k);
+        thin_svd(a.data(), a.row_stride(), m, n, __values__.data(), u.data(), v.data());
+        __u__ = column_vectors(u.data(), m, k, k);
+        __v__ = column_vectors(v.data(), n, k, k);
+    }
+
+    template <typename T>
+    basic_cx_svd<T> basic_cx_svd<T>::truncated(const basic_cx_matrix<T>& a, size_t rank,
+                                               size_t oversampling, size_t power_iterations)
+    {
+        const size_t m = a.rows(), n = a.cols();
+        if (rank == 0 || rank > std::min(m, n))
+            throw std::invalid_argument("Can't compute the truncated SVD -> rank must be between 1 and the smallest dimension.");
+        const size_t l = std::min(rank + oversampling, std::min(m, n));
+        const cx one(1, 0), zero(0, 0);
+
+        // Random test block, real and imaginary parts uniform in [-1, 1).
+        std::vector<cx> omega(n * l), y(m * l), z(n * l);
+        uint64_t state = 0x2545F4914F6CDD1Dull;
+        auto next = [&]() {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<T>(static_cast<double>(state >> 11) / 4503599627370496.0 - 1.0);
+        };
+        for (cx& w : omega)
+        {
+            const T re = next();
+            w = cx(re, next());
+        }
+
+        // Range of A: Y = A Omega, then Y = A (A^H Y) with re-orthonormalization in between.
+        gemm(NO_TRANS, NO_TRANS, m, l, n, one, a.data(), a.row_stride(), omega.data(), l, zero, y.data(), l);
+        for (size_t q = 0; q < power_iterations; q++)
+        {
+            orthonormal_basis(y.data(), m, l);
+            gemm(CONJ_TRANS, NO_TRANS, n, l, m, one, a.data(), a.row_stride(), y.data(), l, zero, z.data(), l);
+            orthonormal_basis(z.data(), n, l);
+            gemm(NO_TRANS, NO_TRANS, m, l, n, one, a.data(), a.row_stride(), z.data(), l, zero, y.data(), l);
+        }
+        orthonormal_basis(y.data(), m, l);
+
+        // B = Q^H A is l x n; A ~ Q B = (Q U_B) S V_B^H.
+        std::vector<cx> b(l * n), ub(l * l), vb(n * l), u(m * l);
+        std::vector<T> values(l);
+        gemm(CONJ_TRANS, NO_TRANS, l, n, m, one, y.data(), l, a.data(), a.row_stride(), zero, b.data(), n);
+        thin_svd(b.data(), n, l, n, values.data(), ub.data(), vb.data());
+        gemm(NO_TRANS, NO_TRANS, m, l, l, one, y.data(), l, ub.data(), l, zero, u.data(), l);
+
+        basic_cx_svd out;
+        out.__rows__ = m;
+        out.__cols__ = n;
+        out.__values__.assign(values.begin(), values.begin() + rank);
+        out.__u__ = column_vectors(u.data(), m, l, rank);
+        out.__v__ = column_vectors(vb.data(), n, l, rank);
+        return out;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_svd<T>::reconstruct() const
+    {
+        if (__u__.empty())
+            throw std::runtime_error("Can't reconstruct the matrix -> the singular vectors were not computed.");
+        const size_t k = size();
+        std::vector<cx> us(__rows__ * k), v(__cols__ * k);
+        for (size_t j = 0; j < k; j++)
+        {
+            for (size_t i = 0; i < __rows__; i++)
+                us[i * k + j] = __u__[j][i] * cx(__values__[j], 0);
+            for (size_t i = 0; i < __cols__; i++)
+                v[i * k + j] = __v__[j][i];
+        }
+        basic_cx_matrix<T> out(__rows__, __cols__, cx(0, 0));
+        gemm(NO_TRANS, CONJ_TRANS, __rows__, __cols__, k, cx(1, 0), us.data(), k, v.data(), k,
+             cx(0, 0), out.data(), out.row_stride());
+        return out;
+    }
+
+    template class basic_cx_svd<float>;
+    template class basic_cx_svd<double>;
+
+    cx_svd svd(const cx_matrix& a)
+    {
+        return cx_svd(a);
+    }
+
+    cxd_svd svd(const cxd_matrix& a)
+    {
+        return cxd_svd(a);
+    }
+
+    std::vector<float> svdvals(const cx_matrix& a)
+    {
+        return cx_svd(a, false).values();
+    }
+
+    std::vector<double> svdvals(const cxd_matrix& a)
+    {
+        return cxd_svd(a, false).values();
+    }
+
+    cx_svd svd_truncated(const cx_matrix& a, size_t rank, size_t oversampling, size_t power_iterations)
+    {
+        return cx_svd::truncated(a, rank, oversampling, power_iterations);
+    }
+
+    cxd_svd svd_truncated(const cxd_matrix& a, size_t rank, size_t oversampling, size_t power_iterations)
+    {
+        return cxd_svd::truncated(a, rank, oversampling, power_iterations);
+    }
+}
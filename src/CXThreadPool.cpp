@@ -0,0 +1,249 @@
+#include "CXThreadPool.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace cx_lib
+{
+    std::atomic<bool> __cx_multithread_enabled__ = false;
+
+    void enable_multithreading(bool enable) noexcept
+    {
+        __cx_multithread_enabled__ = enable;
+    }
+
+    namespace
+    {
+        thread_local bool __is_pool_worker__ = false;
+        // Set while the thread runs tasks of a job, as a worker or as the submitter.
+        thread_local bool __in_parallel_region__ = false;
+    }
+
+    cx_thread_pool& cx_thread_pool::instance()
+    {
+        static cx_thread_pool pool;
+        return pool;
+    }
+
+    cx_thread_pool::~cx_thread_pool()
+    {
+        this->shutdown();
+    }
+
+    size_t cx_thread_pool::size() const noexcept
+    {
+        // Written under submit_mutex by resize(), read here without it.
+        const size_t requested = this->__size__;
+        if (requested != 0)
+            return requested;
+
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    bool cx_thread_pool::affinity() const noexcept
+    {
+        return this->__pinned__;
+    }
+
+    bool cx_thread_pool::in_worker() noexcept
+    {
+        return __is_pool_worker__;
+    }
+
+    bool cx_thread_pool::in_parallel_region() noexcept
+    {
+        return __in_parallel_region__;
+    }
+
+    void cx_thread_pool::resize(size_t __size)
+    {
+        std::lock_guard<std::mutex> submit(this->submit_mutex);
+        this->shutdown_locked();
+        this->__size__ = __size;
+    }
+
+    void cx_thread_pool::set_affinity(bool __pin)
+    {
+        std::lock_guard<std::mutex> submit(this->submit_mutex);
+        this->__pinned__ = __pin;
+        if (!__pin)
+        {
+            // Undo the pinning by restarting the workers unpinned.
+            this->shutdown_locked();
+            return;
+        }
+
+        for (size_t i = 0; i < this->workers.size(); i++)
+            this->pin(this->workers[i], i + 1);
+    }
+
+    void cx_thread_pool::shutdown()
+    {
+        std::lock_guard<std::mutex> submit(this->submit_mutex);
+        this->shutdown_locked();
+    }
+
+    void cx_thread_pool::shutdown_locked()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->state_mutex);
+            this->stopping = true;
+        }
+        this->work_cv.notify_all();
+
+        for (auto& thr : this->workers)
+            thr.join();
+
+        this->workers.clear();
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        this->stopping = false;
+    }
+
+    void cx_thread_pool::start()
+    {
+        if (!this->workers.empty())
+            return;
+
+        // Workers join only the jobs submitted after they start: the
+        // generation keeps counting across restarts of the pool.
+        uint64_t current;
+        {
+            std::lock_guard<std::mutex> lock(this->state_mutex);
+            current = this->generation;
+        }
+
+        size_t num_workers = this->size() - 1;
+        this->workers.reserve(num_workers);
+        for (size_t i = 0; i < num_workers; i++)
+        {
+            this->workers.emplace_back(&cx_thread_pool::worker_loop, this, current);
+            if (this->__pinned__)
+                this->pin(this->workers.back(), i + 1);
+        }
+    }
+
+    void cx_thread_pool::pin(std::thread& thr, size_t core) noexcept
+    {
+#ifdef __linux__
+        size_t num_cores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core % num_cores, &set);
+        pthread_setaffinity_np(thr.native_handle(), sizeof(cpu_set_t), &set);
+#else
+        (void)thr;
+        (void)core;
+#endif
+    }
+
+    void cx_thread_pool::drain() noexcept
+    {
+        size_t task;
+        while ((task = this->next_task.fetch_add(1)) < this->job_tasks)
+        {
+            try
+            {
+                (*this->job)(task);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(this->state_mutex);
+                if (!this->error)
+                    this->error = std::current_exception();
+            }
+        }
+    }
+
+    void cx_thread_pool::worker_loop(uint64_t seen)
+    {
+        __is_pool_worker__ = true;
+        __in_parallel_region__ = true;
+
+        std::unique_lock<std::mutex> lock(this->state_mutex);
+        while (true)
+        {
+            this->work_cv.wait(lock, [&]() { return this->stopping || this->generation != seen; });
+            if (this->stopping)
+                return;
+
+            seen = this->generation;
+            lock.unlock();
+            this->drain();
+            lock.lock();
+
+            if (--this->active_workers == 0)
+                this->done_cv.notify_one();
+        }
+    }
+
+    void cx_thread_pool::run(size_t num_tasks, const std::function<void(size_t)>& task)
+    {
+        if (num_tasks == 0)
+            return;
+
+        // Nested or concurrent parallel regions run inline: a worker waiting
+        // on its own pool would deadlock, and the submitter running tasks
+        // still holds submit_mutex, so it must not even try to lock it.
+        std::unique_lock<std::mutex> submit;
+        if (num_tasks > 1 && !__in_parallel_region__)
+            submit = std::unique_lock<std::mutex>(this->submit_mutex, std::try_to_lock);
+        if (!submit.owns_lock())
+        {
+            for (size_t t = 0; t < num_tasks; t++)
+                task(t);
+            return;
+        }
+
+        this->start();
+
+        {
+            std::lock_guard<std::mutex> lock(this->state_mutex);
+            this->job = &task;
+            this->job_tasks = num_tasks;
+            this->next_task = 0;
+            this->active_workers = this->workers.size();
+            this->error = nullptr;
+            this->generation++;
+        }
+        this->work_cv.notify_all();
+
+        __in_parallel_region__ = true;
+        this->drain();
+        __in_parallel_region__ = false;
+
+        std::exception_ptr error_;
+        {
+            std::unique_lock<std::mutex> lock(this->state_mutex);
+            this->done_cv.wait(lock, [&]() { return this->active_workers == 0; });
+            this->job = nullptr;
+            this->job_tasks = 0;
+            error_ = this->error;
+            this->error = nullptr;
+        }
+
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+    void set_num_threads(size_t num_threads)
+    {
+        cx_thread_pool::instance().resize(num_threads);
+    }
+
+    size_t get_num_threads() noexcept
+    {
+        return cx_thread_pool::instance().size();
+    }
+
+    void set_thread_affinity(bool pin)
+    {
+        cx_thread_pool::instance().set_affinity(pin);
+    }
+
+    void shutdown_thread_pool()
+    {
+        cx_thread_pool::instance().shutdown();
+    }
+}
@@ -1,18 +1,24 @@
+#include <utility>
 #include "ComplexMatrix.h"
+#include "CXKernels.h"
 
 namespace cx_lib
 {
-    cx_matrix::cx_matrix(size_t __rows, size_t __cols, const cx& val)
+    template <typename T>
+    basic_cx_matrix<T>::basic_cx_matrix(size_t __rows, size_t __cols, const cx& val)
     {
         if (__rows < 2 || __cols < 2)
             throw std::invalid_argument("cx_matrix must have at least 2 rows and columns");
 
-        this->mat = std::vector<cx_vector>(__rows);
-        for (size_t i = 0; i < __rows; i++)
-            this->mat[i] = cx_vector(__cols, val);
+        this->buf.assign(__rows * __cols, val);
+        this->__rows__ = __rows;
+        this->__cols__ = __cols;
+        this->__row_stride__ = __cols;
+        this->__col_stride__ = 1;
     }
 
-    cx_matrix::cx_matrix(const std::vector<std::vector<cx>>& vec)
+    template <typename T>
+    basic_cx_matrix<T>::basic_cx_matrix(const std::vector<std::vector<cx>>& vec)
     {
         size_t __rows = vec.size();
         if (__rows < 2)
@@ -30,12 +36,17 @@ namespace cx_lib
         if (__cols < 2)
             throw std::invalid_argument("cx_matrix must have at least 2 rows and columns.");
 
-        this->mat = std::vector<cx_vector>(__rows);
+        this->buf.resize(__rows * __cols);
+        this->__rows__ = __rows;
+        this->__cols__ = __cols;
+        this->__row_stride__ = __cols;
+        this->__col_stride__ = 1;
         for (size_t i = 0; i < __rows; i++)
-            this->mat[i] = cx_vector(vec[i]);
+            std::copy(vec[i].begin(), vec[i].end(), this->buf.begin() + i * __cols);
     }
 
-    cx_matrix::cx_matrix(const std::vector<cx_vector> &vec)
+    template <typename T>
+    basic_cx_matrix<T>::basic_cx_matrix(const std::vector<basic_cx_vector<T>> &vec)
     {
         size_t __rows = vec.size();
         if (__rows < 2)
@@ -53,112 +64,274 @@ namespace cx_lib
         if (__cols < 2)
             throw std::invalid_argument("cx_matrix must have at least 2 rows and columns.");
 
-        this->mat = std::vector<cx_vector>(__rows);
+        this->buf.resize(__rows * __cols);
+        this->__rows__ = __rows;
+        this->__cols__ = __cols;
+        this->__row_stride__ = __cols;
+        this->__col_stride__ = 1;
         for (size_t i = 0; i < __rows; i++)
-            this->mat[i] = vec[i];
+            for (size_t j = 0; j < __cols; j++)
+                (*this)(i, j) = vec[i][j];
+    }
+
+    template <typename T>
+    basic_cx_matrix<T>::basic_cx_matrix(const basic_cx_matrix& obj) noexcept
+        : buf(obj.buf),
+          __rows__(obj.__rows__),
+          __cols__(obj.__cols__),
+          __row_stride__(obj.__row_stride__),
+          __col_stride__(obj.__col_stride__)
+    {
     }
 
-    cx_matrix::cx_matrix(const cx_matrix& obj) noexcept
+    template <typename T>
+    basic_cx_matrix<T>::basic_cx_matrix(basic_cx_matrix&& obj) noexcept
+        : buf(std::move(obj.buf)),
+          __rows__(std::exchange(obj.__rows__, 0)),
+          __cols__(std::exchange(obj.__cols__, 0)),
+          __row_stride__(std::exchange(obj.__row_stride__, 0)),
+          __col_stride__(std::exchange(obj.__col_stride__, 1))
     {
-        this->mat = obj.mat;
     }
 
-    cx& cx_matrix::operator()(size_t __row, size_t __col) noexcept
+    template <typename T>
+    basic_cx<T>& basic_cx_matrix<T>::operator()(size_t __row, size_t __col) noexcept
     {
-        return this->mat[__row][__col];
+        return this->buf[__row * this->__row_stride__ + __col * this->__col_stride__];
     }
 
-    const cx& cx_matrix::operator()(size_t __row, size_t __col) const noexcept
+    template <typename T>
+    const basic_cx<T>& basic_cx_matrix<T>::operator()(size_t __row, size_t __col) const noexcept
     {
-        return this->mat[__row][__col];
+        return this->buf[__row * this->__row_stride__ + __col * this->__col_stride__];
     }
 
-    cx_vector& cx_matrix::operator[](size_t __index) noexcept
+    template <typename T>
+    typename basic_cx_matrix<T>::row_view basic_cx_matrix<T>::operator[](size_t __index) noexcept
     {
-        return this->mat[__index];
+        return row_view(this->buf.data() + __index * this->__row_stride__, this->__cols__, this->__col_stride__);
     }
 
-    const cx_vector& cx_matrix::operator[](size_t __index) const noexcept
+    template <typename T>
+    typename basic_cx_matrix<T>::const_row_view basic_cx_matrix<T>::operator[](size_t __index) const noexcept
     {
-        return this->mat[__index];
+        return const_row_view(this->buf.data() + __index * this->__row_stride__, this->__cols__, this->__col_stride__);
     }
 
-    cx& cx_matrix::at(size_t __row, size_t __col)
+    template <typename T>
+    basic_cx<T>& basic_cx_matrix<T>::at(size_t __row, size_t __col)
     {
         if (( __row >= this->rows()) || (__col >= this->cols()))
             throw std::runtime_error("Index out of range.");
 
-        return this->mat[__row][__col];
+        return (*this)(__row, __col);
     }
 
-    const cx& cx_matrix::at(size_t __row, size_t __col) const
+    template <typename T>
+    const basic_cx<T>& basic_cx_matrix<T>::at(size_t __row, size_t __col) const
     {
         if (( __row >= this->rows()) || (__col >= this->cols()))
             throw std::runtime_error("Index out of range.");
 
-        return this->mat[__row][__col];
+        return (*this)(__row, __col);
     }
 
-    size_t cx_matrix::rows() const noexcept
+    template <typename T>
+    size_t basic_cx_matrix<T>::rows() const noexcept
     {
-        return this->mat.size();
+        return this->__rows__;
     }
 
-    size_t cx_matrix::cols() const noexcept
+    template <typename T>
+    size_t basic_cx_matrix<T>::cols() const noexcept
     {
-        return this->mat[0].dim();
+        return this->__cols__;
     }
 
-    std::pair<size_t, size_t> cx_matrix::dim() const noexcept
+    template <typename T>
+    std::pair<size_t, size_t> basic_cx_matrix<T>::dim() const noexcept
     {
         return std::make_pair(this->rows(), this->cols());
     }
 
-    cx_vector cx_matrix::get_col(size_t __index) const
+    template <typename T>
+    size_t basic_cx_matrix<T>::row_stride() const noexcept
+    {
+        return this->__row_stride__;
+    }
+
+    template <typename T>
+    size_t basic_cx_matrix<T>::col_stride() const noexcept
+    {
+        return this->__col_stride__;
+    }
+
+    template <typename T>
+    basic_cx<T>* basic_cx_matrix<T>::data() noexcept
+    {
+        return this->buf.data();
+    }
+
+    template <typename T>
+    const basic_cx<T>* basic_cx_matrix<T>::data() const noexcept
+    {
+        return this->buf.data();
+    }
+
+    template <typename T>
+    basic_cx_vector<T> basic_cx_matrix<T>::get_col(size_t __index) const
+    {
+        return this->col_view(__index).to_vector();
+    }
+
+    template <typename T>
+    typename basic_cx_matrix<T>::const_row_view basic_cx_matrix<T>::col_view(size_t __index) const
     {
         if (__index >= this->cols())
             throw std::runtime_error("Index out of range.");
 
-        cx_vector col_(this->rows(), cx(0, 0));
-        for (size_t i = 0; i < this->rows(); i++)
-            col_[i] = this->at(i, __index);
-
-        return col_;
+        return const_row_view(this->buf.data() + __index * this->__col_stride__, this->__rows__, this->__row_stride__);
     }
 
-    cx_matrix& cx_matrix::operator =(const cx_matrix& obj) noexcept
+    template <typename T>
+    basic_cx_matrix<T>& basic_cx_matrix<T>::operator =(const basic_cx_matrix& obj) noexcept
     {
         if (this != &obj)
-            this->mat = obj.mat;
+        {
+            this->buf = obj.buf;
+            this->__rows__ = obj.__rows__;
+            this->__cols__ = obj.__cols__;
+            this->__row_stride__ = obj.__row_stride__;
+            this->__col_stride__ = obj.__col_stride__;
+        }
             
         return *this;
     }
 
-    cx_matrix cx_matrix::operator +(const cx_matrix& obj) const
+    template <typename T>
+    basic_cx_matrix<T>& basic_cx_matrix<T>::operator =(basic_cx_matrix&& obj) noexcept
+    {
+        if (this != &obj)
+        {
+            this->buf = std::move(obj.buf);
+            this->__rows__ = std::exchange(obj.__rows__, 0);
+            this->__cols__ = std::exchange(obj.__cols__, 0);
+            this->__row_stride__ = std::exchange(obj.__row_stride__, 0);
+            this->__col_stride__ = std::exchange(obj.__col_stride__, 1);
+        }
+
+        return *this;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_matrix<T>::operator +(const basic_cx_matrix& obj) const&
     {
         if (this->dim() != obj.dim())
             throw std::invalid_argument("Dimensions don\'t match.");
 
-        cx_matrix new_(this->rows(), this->cols(), cx(0, 0));
+        basic_cx_matrix new_(this->rows(), this->cols(), cx(0, 0));
         for (size_t i = 0; i < this->rows(); i++)
-            new_.mat[i] = this->mat[i] + obj.mat[i];
+            kernels::add(this->cols(), (*this)[i].data(), obj[i].data(), new_[i].data());
 
         return new_;
     }
 
-    cx_matrix cx_matrix::operator -(const cx_matrix& obj) const
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_matrix<T>::operator +(const basic_cx_matrix& obj) &&
+    {
+        (*this) += obj;
+        return std::move(*this);
+    }
+
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_matrix<T>::operator -(const basic_cx_matrix& obj) const&
     {
         if (this->dim() != obj.dim())
             throw std::invalid_argument("Dimensions don\'t match.");
 
-        cx_matrix new_(this->rows(), this->cols(), cx(0, 0));
+        basic_cx_matrix new_(this->rows(), this->cols(), cx(0, 0));
         for (size_t i = 0; i < this->rows(); i++)
-            new_.mat[i] = this->mat[i] - obj.mat[i];
+            kernels::sub(this->cols(), (*this)[i].data(), obj[i].data(), new_[i].data());
 
         return new_;
     }
 
-    bool cx_matrix::operator ==(const cx_matrix& obj) const noexcept
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_matrix<T>::operator -(const basic_cx_matrix& obj) &&
+    {
+        (*this) -= obj;
+        return std::move(*this);
+    }
+
+    template <typename T>
+    basic_cx_matrix<T>& basic_cx_matrix<T>::operator +=(const basic_cx_matrix& obj)
+    {
+        if (this->dim() != obj.dim())
+            throw std::invalid_argument("Dimensions don\'t match.");
+
+        for (size_t i = 0; i < this->rows(); i++)
+            kernels::add(this->cols(), (*this)[i].data(), obj[i].data(), (*this)[i].data());
+
+        return *this;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T>& basic_cx_matrix<T>::operator -=(const basic_cx_matrix& obj)
+    {
+        if (this->dim() != obj.dim())
+            throw std::invalid_argument("Dimensions don\'t match.");
+
+        for (size_t i = 0; i < this->rows(); i++)
+            kernels::sub(this->cols(), (*this)[i].data(), obj[i].data(), (*this)[i].data());
+
+        return *this;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T>& basic_cx_matrix<T>::operator *=(const cx& val) noexcept
+    {
+        for (size_t i = 0; i < this->rows(); i++)
+            kernels::scale(this->cols(), val, (*this)[i].data(), (*this)[i].data());
+
+        return *this;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T>& basic_cx_matrix<T>::operator *=(T val) noexcept
+    {
+        return (*this) *= cx(val, 0);
+    }
+
+    template <typename T>
+    basic_cx_matrix<T>& basic_cx_matrix<T>::axpy(const cx& alpha, const basic_cx_matrix& x)
+    {
+        if (this->dim() != x.dim())
+            throw std::invalid_argument("Dimensions don\'t match.");
+
+        for (size_t i = 0; i < this->rows(); i++)
+            kernels::axpy(this->cols(), alpha, x[i].data(), (*this)[i].data());
+
+        return *this;
+    }
+
+    template <typename T>
+    basic_cx_matrix<T>& basic_cx_matrix<T>::axpby(const cx& alpha, const basic_cx_matrix& x, const cx& beta)
+    {
+        if (this->dim() != x.dim())
+            throw std::invalid_argument("Dimensions don\'t match.");
+
+        // One pass per row: the row of this is scaled while it is in cache.
+        for (size_t i = 0; i < this->rows(); i++)
+        {
+            kernels::scale(this->cols(), beta, (*this)[i].data(), (*this)[i].data());
+            kernels::axpy(this->cols(), alpha, x[i].data(), (*this)[i].data());
+        }
+
+        return *this;
+    }
+
+    template <typename T>
+    bool basic_cx_matrix<T>::operator ==(const basic_cx_matrix& obj) const noexcept
     {
         if (this->rows() != obj.rows() || this->cols() != obj.cols()) return false;
         for (size_t i = 0; i < this->rows(); i++)
@@ -168,29 +341,38 @@ namespace cx_lib
         return true;
     }
 
-    bool cx_matrix::operator !=(const cx_matrix& obj) const noexcept
+    template <typename T>
+    bool basic_cx_matrix<T>::operator !=(const basic_cx_matrix& obj) const noexcept
     {
-        return !((*this) == obj.mat);
+        return !((*this) == obj);
     }
 
-    cx_matrix cx_matrix::get_identity(size_t __size)
+    template <typename T>
+    basic_cx_matrix<T> basic_cx_matrix<T>::get_identity(size_t __size)
     {
         if (__size < 2)
             throw std::invalid_argument("Identity matrix accepts size greater or equal than 2.");
 
-        cx_matrix identity_(__size, __size, cx(0, 0));
+        basic_cx_matrix identity_(__size, __size, cx(0, 0));
         for (size_t i = 0; i < __size; i++)
             identity_(i, i) = cx(1, 0);
 
         return identity_;
     }
 
-    std::vector<cx_vector> cx_matrix::get() noexcept
+    template <typename T>
+    std::vector<basic_cx_vector<T>> basic_cx_matrix<T>::get() noexcept
     {
-        return this->mat;
+        std::vector<basic_cx_vector<T>> rows_;
+        rows_.reserve(this->rows());
+        for (size_t i = 0; i < this->rows(); i++)
+            rows_.push_back((*this)[i].to_vector());
+
+        return rows_;
     }
 
-    std::ostream& operator <<(std::ostream& os, const cx_matrix& obj)
+    template <typename T>
+    std::ostream& operator <<(std::ostream& os, const basic_cx_matrix<T>& obj)
     {
         bool print_all = (obj.rows() <= 10);
         os << "[";
@@ -205,4 +387,9 @@ namespace cx_lib
         os << "]";
         return os;
     }
+
+    template class basic_cx_matrix<float>;
+    template class basic_cx_matrix<double>;
+    template std::ostream& operator << <float>(std::ostream&, const basic_cx_matrix<float>&);
+    template std::ostream& operator << <double>(std::ostream&, const basic_cx_matrix<double>&);
 }
\ No newline at end of file
@@ -3,79 +3,13 @@
 
 namespace cx_lib
 {
-    cx::cx(const cx& obj) noexcept : real(obj.real), imag(obj.imag) {}
-
-    cx::operator std::pair<float, float>() const noexcept
-    {
-        return {real, imag};
-    }
-
-    cx cx::operator+(const cx& obj) const noexcept
-    {
-        return cx(real + obj.real, imag + obj.imag);
-    }
-
-    cx cx::operator-(const cx& obj) const noexcept
-    {
-        return cx(real - obj.real, imag - obj.imag);
-    }
-
-    cx cx::operator*(const cx& obj) const noexcept
-    {
-        return cx(
-            (real * obj.real) - (imag * obj.imag),
-            (real * obj.imag) + (imag * obj.real));
-    }
-
-    cx cx::operator/(const cx& obj) const
-    {
-        if (obj.real == 0 && obj.imag == 0)
-            throw std::runtime_error("Division by zero.");
-
-        float denominator = std::pow(obj.real, 2) + std::pow(obj.imag, 2);
-        return cx(
-            (float)((real * obj.real) + (imag * obj.imag)) / denominator,
-            (float)((imag * obj.real) - (real * obj.imag)) / denominator);
-    }
-
-    cx& cx::operator+=(const cx& obj) noexcept
-    {
-        real += obj.real;
-        imag += obj.imag;
-        return *this;
-    }
-
-    cx& cx::operator-=(const cx& obj) noexcept
-    {
-        real -= obj.real;
-        imag -= obj.imag;
-        return *this;
-    }
-
-    cx& cx::operator*=(const cx& obj) noexcept
-    {
-        float temp_real = (real * obj.real) - (imag * obj.imag);
-        float temp_imag = (real * obj.imag) + (imag * obj.real);
-        real = temp_real;
-        imag = temp_imag;
-        return *this;
-    }
-
-    cx& cx::operator/=(const cx& obj)
+    void __cx_division_by_zero__()
     {
-        if (obj.real == 0 && obj.imag == 0)
-            throw std::runtime_error("Division by zero.");
-
-        float denominator = std::pow(obj.real, 2) + std::pow(obj.imag, 2);
-        float temp_real = ((real * obj.real) + (imag * obj.imag)) / denominator;
-        float temp_imag = ((imag * obj.real) - (real * obj.imag)) / denominator;
-
-        real = temp_real;
-        imag = temp_imag;
-        return *this;
+        throw std::runtime_error("Division by zero.");
     }
 
-    std::ostream &operator<<(std::ostream &os, const cx& obj)
+    template <typename T>
+    std::ostream &operator<<(std::ostream &os, const basic_cx<T>& obj)
     {
         os << obj.real;
 
@@ -91,64 +25,32 @@ namespace cx_lib
         return os;
     }
 
-    float cx::mod() const noexcept
-    {
-        return std::sqrt(std::pow(real, 2) + std::pow(imag, 2));
-    }
-
-    float cx::mod2() const noexcept
-    {
-        return std::pow(real, 2) + std::pow(imag, 2);
-    }
-
-    float cx::phase() const noexcept
+    template <typename T>
+    T basic_cx<T>::phase() const noexcept
     {
         return std::atan2(imag, real);
     }
 
-    cx cx::conjugate() const noexcept
-    {
-        return cx(real, -imag);
-    }
-
-    bool cx::operator==(const cx& obj) const noexcept
+    template <typename T>
+    basic_cx<T> basic_cx<T>::pow(int n) const noexcept
     {
-        return real == obj.real && imag == obj.imag;
-    }
-
-    bool cx::operator!=(const cx& obj) const noexcept
-    {
-        return real != obj.real || imag != obj.imag;
-    }
-
-    cx cx::operator-() const noexcept
-    {
-        return cx(-real, -imag);
-    }
-
-    cx cx::pow(int n) const noexcept
-    {
-        float mag = std::pow(mod(), n);
-        float ph = n * phase();
+        T mag = static_cast<T>(std::pow(mod(), n));
+        T ph = n * phase();
         return cx(
             mag * std::cos(ph),
             mag * std::sin(ph));
     }
 
-    cx cx::sqrt() const noexcept
+    template <typename T>
+    basic_cx<T> basic_cx<T>::sqrt() const noexcept
     {
-        float mag = std::sqrt(mod());
-        float ph = (float)phase() / 2;
+        T mag = std::sqrt(mod());
+        T ph = phase() / 2;
         return cx(
             mag * std::cos(ph),
             mag * std::sin(ph));
     }
 
-    cx cx::from_pair(const std::pair<float, float> &p) noexcept
-    {
-        return cx(p.first, p.second);
-    }
-
     static std::string trim(const std::string &s)
     {
         auto start = s.find_first_not_of(" \t\n\r\f\v");
@@ -159,7 +61,8 @@ namespace cx_lib
         return s.substr(start, (end - start + 1));
     }
 
-    cx cx::from_string(const std::string &input)
+    template <typename T>
+    basic_cx<T> basic_cx<T>::from_string(const std::string &input)
     {
         std::string str = trim(input);
         if (str.empty())
@@ -175,8 +78,8 @@ namespace cx_lib
             }
         }
 
-        float r = 0.0;
-        float im = 0.0;
+        T r = 0.0;
+        T im = 0.0;
 
         if (splitPos == std::string::npos)
         {
@@ -220,8 +123,14 @@ namespace cx_lib
         return cx(r, im);
     }
 
-    std::pair<float, float> cx::to_polar() const noexcept
+    template <typename T>
+    std::pair<T, T> basic_cx<T>::to_polar() const noexcept
     {
         return {mod(), phase()};
     }
+
+    template struct basic_cx<float>;
+    template struct basic_cx<double>;
+    template std::ostream& operator << <float>(std::ostream&, const basic_cx<float>&);
+    template std::ostream& operator << <double>(std::ostream&, const basic_cx<double>&);
 }
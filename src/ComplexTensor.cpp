@@ -1,20 +1,661 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <utility>
 #include "ComplexTensor.h"
 
 namespace cx_lib
 {
-    cx_tensor::cx_tensor(const std::vector<size_t>& __shape, const cx& val)
-        : data(__shape.size() ? std::vector<cx>(std::accumulate(__shape.begin(), __shape.end(), 1, std::multiplies<size_t>()), val) : std::vector<cx>()),
+    namespace
+    {
+        size_t shape_size(const std::vector<size_t>& shape) noexcept
+        {
+            return shape.empty() ? 0 : std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>());
+        }
+
+        // Buffer shared by every empty tensor, so that default construction
+        // and moves don't allocate. It is never written: it has no elements,
+        // and operations reusing a buffer in place skip shared ones.
+        template <typename C>
+        const std::shared_ptr<std::vector<C>>& empty_buffer()
+        {
+            static const std::shared_ptr<std::vector<C>> buffer = std::make_shared<std::vector<C>>();
+            return buffer;
+        }
+
+        void check_slice(const std::vector<size_t>& shape, const std::vector<size_t>& start, const std::vector<size_t>& end)
+        {
+            if (start.size() != end.size() || start.size() != shape.size())
+                throw std::invalid_argument("Start and end dimensions must match tensor shape.");
+
+            for (size_t i = 0; i < start.size(); i++)
+                if (start[i] >= end[i] || end[i] > shape[i])
+                    throw std::invalid_argument("Invalid slicing range.");
+        }
+
+        void check_axes(const std::vector<size_t>& shape, const std::vector<size_t>& axes)
+        {
+            if (axes.size() != shape.size())
+                throw std::invalid_argument("Axes size must match tensor dimensions.");
+
+            std::vector<bool> seen(axes.size(), false);
+            for (size_t axis : axes)
+            {
+                if (axis >= shape.size() || seen[axis])
+                    throw std::invalid_argument("Invalid axis for transpose.");
+                seen[axis] = true;
+            }
+        }
+
+        // Side of the square tiles used when the two fastest axes of source
+        // and destination differ: a tile of each stays in L1.
+        constexpr size_t TILE = 32;
+        // Minimum number of elements handed to a chunk of a parallel copy.
+        constexpr size_t COPY_GRAIN = size_t(1) << 16;
+
+        /*
+         * Copy a strided view into a dense row-major buffer. Extent-1 axes are
+         * dropped and axes contiguous in both layouts are merged first. If the
+         * source is then fastest along the destination rows, rows are copied
+         * one after the other with an odometer walk over the outer axes;
+         * otherwise the destination's fastest axis and the source's fastest
+         * axis are copied in TILE x TILE blocks, so that both sides are
+         * accessed a cache line at a time. No allocation happens per element.
+         */
+        template <typename C>
+        void strided_copy(const std::vector<size_t>& shape, const C* src,
+                          const std::vector<ptrdiff_t>& strides, C* dst)
+        {
+            const std::vector<ptrdiff_t> dense = contiguous_strides(shape);
+            std::vector<size_t> n;
+            std::vector<ptrdiff_t> ss, ds;
+            for (size_t d = 0; d < shape.size(); d++)
+            {
+                if (shape[d] == 1)
+                    continue;
+                ptrdiff_t extent = static_cast<ptrdiff_t>(shape[d]);
+                if (!n.empty() && ss.back() == strides[d] * extent && ds.back() == dense[d] * extent)
+                {
+                    n.back() *= shape[d];
+                    ss.back() = strides[d];
+                    ds.back() = dense[d];
+                    continue;
+                }
+                n.push_back(shape[d]);
+                ss.push_back(strides[d]);
+                ds.push_back(dense[d]);
+            }
+
+            if (n.empty())
+            {
+                dst[0] = src[0];
+                return;
+            }
+
+            const size_t total = shape_size(n);
+            const size_t a = n.size() - 1;
+            size_t b = a;
+            for (size_t d = 0; d < a; d++)
+                if (std::abs(ss[d]) < std::abs(ss[b]))
+                    b = d;
+
+            if (b == a)
+            {
+                const size_t len = n[a];
+                const ptrdiff_t step = ss[a];
+                parallel_for(0, total / len, std::max<size_t>(1, COPY_GRAIN / len), [&](size_t start, size_t end) {
+                    std::vector<size_t> idx(a, 0);
+                    ptrdiff_t off = 0;
+                    size_t rem = start;
+                    for (size_t d = a; d-- > 0;)
+                    {
+                        idx[d] = rem % n[d];
+                        rem /= n[d];
+                        off += static_cast<ptrdiff_t>(idx[d]) * ss[d];
+                    }
+
+                    for (size_t r = start; r < end; r++)
+                    {
+                        const C* s = src + off;
+                        C* o = dst + r * len;
+                        if (step == 1)
+                            std::copy(s, s + len, o);
+                        else
+                            for (size_t j = 0; j < len; j++)
+                                o[j] = s[static_cast<ptrdiff_t>(j) * step];
+
+                        for (size_t d = a; d-- > 0;)
+                        {
+                            off += ss[d];
+                            if (++idx[d] < n[d])
+                                break;
+                            off -= static_cast<ptrdiff_t>(n[d]) * ss[d];
+                            idx[d] = 0;
+                        }
+                    }
+                });
+                return;
+            }
+
+            const size_t tiles_a = (n[a] + TILE - 1) / TILE;
+            const size_t tiles_b = (n[b] + TILE - 1) / TILE;
+            const size_t units = (total / (n[a] * n[b])) * tiles_a * tiles_b;
+            parallel_for(0, units, std::max<size_t>(1, COPY_GRAIN / (TILE * TILE)), [&](size_t start, size_t end) {
+                for (size_t u = start; u < end; u++)
+                {
+                    size_t rem = u;
+                    const size_t a0 = (rem % tiles_a) * TILE;
+                    rem /= tiles_a;
+                    const size_t b0 = (rem % tiles_b) * TILE;
+                    rem /= tiles_b;
+
+                    ptrdiff_t s_off = 0, d_off = 0;
+                    for (size_t d = n.size(); d-- > 0;)
+                    {
+                        if (d == a || d == b)
+                            continue;
+                        ptrdiff_t i = static_cast<ptrdiff_t>(rem % n[d]);
+                        rem /= n[d];
+                        s_off += i * ss[d];
+                        d_off += i * ds[d];
+                    }
+
+                    const size_t a1 = std::min(n[a], a0 + TILE);
+                    const size_t b1 = std::min(n[b], b0 + TILE);
+                    for (size_t ib = b0; ib < b1; ib++)
+                    {
+                        const C* s = src + s_off + static_cast<ptrdiff_t>(ib) * ss[b];
+                        C* o = dst + d_off + static_cast<ptrdiff_t>(ib) * ds[b];
+                        for (size_t ia = a0; ia < a1; ia++)
+                            o[ia] = s[static_cast<ptrdiff_t>(ia) * ss[a]];
+                    }
+                }
+            });
+        }
+
+        // Reduction ranges up to this length are accumulated linearly, over
+        // REDUCE_LANES interleaved accumulators; longer ranges are halved and
+        // the partial results combined, so rounding errors grow as O(log n).
+        constexpr size_t REDUCE_BLOCK = 256;
+        constexpr size_t REDUCE_LANES = 4;
+        // Minimum number of elements read by a chunk of a parallel reduction.
+        constexpr size_t REDUCE_GRAIN = size_t(1) << 15;
+        // Minimum extent of the fastest kept axis for reducing whole rows of results at once.
+        constexpr size_t REDUCE_ROW = 16;
+
+        /*
+         * A reduction seen as `outputs` independent reductions of `length`
+         * elements. Kept and reduced axes are collapsed separately (extent-1
+         * axes dropped, contiguous neighbours merged); both keep row-major
+         * order, so result m is element m of the output and position k is the
+         * row-major index within the reduced axes.
+         */
+        struct reduce_plan
+        {
+            std::vector<size_t> out_shape;          // Shape of the result
+            std::vector<size_t> outer;              // Kept axes
+            std::vector<ptrdiff_t> outer_strides;
+            std::vector<size_t> inner;              // Reduced axes
+            std::vector<ptrdiff_t> inner_strides;
+            size_t outputs = 1;
+            size_t length = 1;
+        };
+
+        void collapse_axes(const std::vector<size_t>& shape, const std::vector<ptrdiff_t>& strides,
+                           const std::vector<bool>& reduced, bool which,
+                           std::vector<size_t>& n, std::vector<ptrdiff_t>& s)
+        {
+            for (size_t d = 0; d < shape.size(); d++)
+            {
+                if (reduced[d] != which || shape[d] == 1)
+                    continue;
+                if (!n.empty() && s.back() == strides[d] * static_cast<ptrdiff_t>(shape[d]))
+                {
+                    n.back() *= shape[d];
+                    s.back() = strides[d];
+                    continue;
+                }
+                n.push_back(shape[d]);
+                s.push_back(strides[d]);
+            }
+
+            if (n.empty())
+            {
+                n.push_back(1);
+                s.push_back(0);
+            }
+        }
+
+        reduce_plan make_reduce_plan(const std::vector<size_t>& shape, const std::vector<ptrdiff_t>& strides,
+                                     const std::vector<size_t>& axes, bool keepdims)
+        {
+            if (shape_size(shape) == 0)
+                throw std::invalid_argument("Cannot reduce an empty tensor.");
+
+            std::vector<bool> reduced(shape.size(), axes.empty());
+            for (size_t axis : axes)
+            {
+                if (axis >= shape.size() || reduced[axis])
+                    throw std::invalid_argument("Invalid axis for reduction.");
+                reduced[axis] = true;
+            }
+
+            reduce_plan p;
+            for (size_t d = 0; d < shape.size(); d++)
+            {
+                if (reduced[d])
+                {
+                    p.length *= shape[d];
+                    if (keepdims)
+                        p.out_shape.push_back(1);
+                }
+                else
+                {
+                    p.outputs *= shape[d];
+                    p.out_shape.push_back(shape[d]);
+                }
+            }
+            if (p.out_shape.empty())
+                p.out_shape.push_back(1);
+
+            collapse_axes(shape, strides, reduced, false, p.outer, p.outer_strides);
+            collapse_axes(shape, strides, reduced, true, p.inner, p.inner_strides);
+            return p;
+        }
+
+        // Odometer over the first `rank` axes of a collapsed shape, tracking the offset.
+        struct axis_walker
+        {
+            const std::vector<size_t>& n;
+            const std::vector<ptrdiff_t>& s;
+            std::vector<size_t> idx;
+            ptrdiff_t off = 0;
+
+            axis_walker(const std::vector<size_t>& __n, const std::vector<ptrdiff_t>& __s, size_t rank)
+                : n(__n), s(__s), idx(rank, 0)
+            {
+            }
+
+            void seek(size_t pos) noexcept
+            {
+                off = 0;
+                for (size_t d = idx.size(); d-- > 0;)
+                {
+                    idx[d] = pos % n[d];
+                    pos /= n[d];
+                    off += static_cast<ptrdiff_t>(idx[d]) * s[d];
+                }
+            }
+
+            void next() noexcept
+            {
+                for (size_t d = idx.size(); d-- > 0;)
+                {
+                    off += s[d];
+                    if (++idx[d] < n[d])
+                        return;
+                    off -= static_cast<ptrdiff_t>(n[d]) * s[d];
+                    idx[d] = 0;
+                }
+            }
+        };
+
+        /*
+         * Reduce positions [k0, k1) of one result. rows walks all reduced
+         * axes but the last one, which is read in runs; inside a block the
+         * runs are spread over REDUCE_LANES accumulators so that the loop
+         * carries no dependency from one element to the next.
+         */
+        template <typename R, typename C>
+        typename R::acc_t reduce_range(const R& r, const C* base, const reduce_plan& p,
+                                       size_t k0, size_t k1, axis_walker& rows)
+        {
+            if (k1 - k0 > REDUCE_BLOCK)
+            {
+                const size_t mid = k0 + (k1 - k0) / 2;
+                typename R::acc_t lo = reduce_range(r, base, p, k0, mid, rows);
+                return r.combine(lo, reduce_range(r, base, p, mid, k1, rows));
+            }
+
+            const size_t len = p.inner.back();
+            const ptrdiff_t step = p.inner_strides.back();
+            rows.seek(k0 / len);
+            size_t col = k0 % len;
+
+            typename R::acc_t lanes[REDUCE_LANES];
+            for (auto& lane : lanes)
+                lane = r.init();
+
+            for (size_t k = k0; k < k1; rows.next(), col = 0)
+            {
+                const size_t run = std::min(len - col, k1 - k);
+                const C* src = base + rows.off + static_cast<ptrdiff_t>(col) * step;
+                size_t j = 0;
+                for (; j + REDUCE_LANES <= run; j += REDUCE_LANES)
+                    for (size_t l = 0; l < REDUCE_LANES; l++)
+                        r.push(lanes[l], src[static_cast<ptrdiff_t>(j + l) * step], k + j + l);
+                for (; j < run; j++)
+                    r.push(lanes[j % REDUCE_LANES], src[static_cast<ptrdiff_t>(j) * step], k + j);
+                k += run;
+            }
+
+            for (size_t w = 1; w < REDUCE_LANES; w *= 2)
+                for (size_t l = 0; l + w < REDUCE_LANES; l += 2 * w)
+                    lanes[l] = r.combine(lanes[l], lanes[l + w]);
+            return lanes[0];
+        }
+
+        /*
+         * Reduce `width` neighbouring results at once, used when the fastest
+         * kept axis is faster than the reduced ones: every reduced position
+         * then reads a (usually contiguous) row. Blocks of REDUCE_BLOCK
+         * positions are accumulated linearly and merged like a binary
+         * counter, which builds the same pairwise tree as reduce_range. The
+         * result is left in stack[0].
+         */
+        template <typename R, typename C>
+        void reduce_row(const R& r, const C* base, const reduce_plan& p, size_t width, ptrdiff_t step,
+                        std::vector<std::vector<typename R::acc_t>>& stack, std::vector<size_t>& levels,
+                        axis_walker& rows)
+        {
+            const size_t len = p.inner.back();
+            const ptrdiff_t inner_step = p.inner_strides.back();
+            size_t depth = 0;
+
+            for (size_t k0 = 0; k0 < p.length; k0 += REDUCE_BLOCK)
+            {
+                if (stack.size() <= depth)
+                {
+                    stack.emplace_back(width);
+                    levels.push_back(0);
+                }
+                std::vector<typename R::acc_t>& cur = stack[depth];
+                std::fill(cur.begin(), cur.end(), r.init());
+
+                const size_t k1 = std::min(p.length, k0 + REDUCE_BLOCK);
+                rows.seek(k0 / len);
+                size_t col = k0 % len;
+                for (size_t k = k0; k < k1; k++)
+                {
+                    const C* src = base + rows.off + static_cast<ptrdiff_t>(col) * inner_step;
+                    if (step == 1)
+                        for (size_t j = 0; j < width; j++)
+                            r.push(cur[j], src[j], k);
+                    else
+                        for (size_t j = 0; j < width; j++)
+                            r.push(cur[j], src[static_cast<ptrdiff_t>(j) * step], k);
+
+                    if (++col == len)
+                    {
+                        col = 0;
+                        rows.next();
+                    }
+                }
+
+                size_t level = 0;
+                for (; depth > 0 && levels[depth - 1] == level; depth--, level++)
+                    for (size_t j = 0; j < width; j++)
+                        stack[depth - 1][j] = r.combine(stack[depth - 1][j], stack[depth][j]);
+                levels[depth++] = level;
+            }
+
+            for (; depth > 1; depth--)
+                for (size_t j = 0; j < width; j++)
+                    stack[depth - 2][j] = r.combine(stack[depth - 2][j], stack[depth - 1][j]);
+        }
+
+        /*
+         * Run a reduction and hand every result to store(m, acc). Work is
+         * spread over the thread pool by rows or by results; when there are
+         * fewer results than threads, each reduction is itself split into
+         * segments whose partial results are combined pairwise.
+         */
+        template <typename R, typename C, typename Store>
+        void run_reduction(const R& r, const C* base, const reduce_plan& p, Store&& store)
+        {
+            using acc_t = typename R::acc_t;
+            const size_t width = p.outer.back();
+            const ptrdiff_t step = p.outer_strides.back();
+
+            if (width >= REDUCE_ROW && std::abs(step) < std::abs(p.inner_strides.back()))
+            {
+                const size_t grain = std::max<size_t>(1, REDUCE_GRAIN / (width * p.length));
+                parallel_for(0, p.outputs / width, grain, [&](size_t start, size_t end) {
+                    axis_walker outer(p.outer, p.outer_strides, p.outer.size() - 1);
+                    axis_walker rows(p.inner, p.inner_strides, p.inner.size() - 1);
+                    std::vector<std::vector<acc_t>> stack;
+                    std::vector<size_t> levels;
+                    outer.seek(start);
+                    for (size_t row = start; row < end; row++, outer.next())
+                    {
+                        reduce_row(r, base + outer.off, p, width, step, stack, levels, rows);
+                        for (size_t j = 0; j < width; j++)
+                            store(row * width + j, stack[0][j]);
+                    }
+                });
+                return;
+            }
+
+            size_t threads = 1;
+            if (__cx_multithread_enabled__ && !cx_thread_pool::in_parallel_region())
+                threads = cx_thread_pool::instance().size();
+
+            if (p.outputs >= threads || p.length < 2 * REDUCE_GRAIN)
+            {
+                parallel_for(0, p.outputs, std::max<size_t>(1, REDUCE_GRAIN / p.length), [&](size_t start, size_t end) {
+                    axis_walker outer(p.outer, p.outer_strides, p.outer.size());
+                    axis_walker rows(p.inner, p.inner_strides, p.inner.size() - 1);
+                    outer.seek(start);
+                    for (size_t m = start; m < end; m++, outer.next())
+                        store(m, reduce_range(r, base + outer.off, p, 0, p.length, rows));
+                });
+                return;
+            }
+
+            const size_t parts = std::min(4 * threads, p.length / REDUCE_GRAIN);
+            std::vector<acc_t> partial(parts);
+            axis_walker outer(p.outer, p.outer_strides, p.outer.size());
+            for (size_t m = 0; m < p.outputs; m++, outer.next())
+            {
+                const C* src = base + outer.off;
+                parallel_for(0, parts, 1, [&](size_t start, size_t end) {
+                    axis_walker rows(p.inner, p.inner_strides, p.inner.size() - 1);
+                    for (size_t q = start; q < end; q++)
+                        partial[q] = reduce_range(r, src, p, (p.length * q) / parts, (p.length * (q + 1)) / parts, rows);
+                });
+
+                for (size_t w = 1; w < parts; w *= 2)
+                    for (size_t q = 0; q + w < parts; q += 2 * w)
+                        partial[q] = r.combine(partial[q], partial[q + w]);
+                store(m, partial[0]);
+            }
+        }
+
+        /*
+         * Reducers: init() is the identity, push(acc, x, k) adds the element
+         * at reduced position k, combine(a, b) merges the results of two
+         * ranges (a covering the earlier one) and finalize(acc, n) turns the
+         * result of n elements into the output value. C is the element type
+         * and A the precision of the accumulator.
+         */
+        template <typename C, typename A>
+        struct cx_sum_reducer
+        {
+            using acc_t = basic_cx<A>;
+            acc_t init() const noexcept { return acc_t(0, 0); }
+            void push(acc_t& a, const C& x, size_t) const noexcept { a.real += x.real; a.imag += x.imag; }
+            acc_t combine(const acc_t& a, const acc_t& b) const noexcept { return acc_t(a.real + b.real, a.imag + b.imag); }
+            C finalize(const acc_t& a, size_t) const noexcept { return C(a); }
+        };
+
+        template <typename C, typename A>
+        struct cx_mean_reducer : cx_sum_reducer<C, A>
+        {
+            using typename cx_sum_reducer<C, A>::acc_t;
+            C finalize(const acc_t& a, size_t n) const noexcept
+            {
+                const A scale = A(1) / static_cast<A>(n);
+                return C(acc_t(a.real * scale, a.imag * scale));
+            }
+        };
+
+        template <typename C, typename A>
+        struct cx_prod_reducer
+        {
+            using acc_t = basic_cx<A>;
+            acc_t init() const noexcept { return acc_t(1, 0); }
+            void push(acc_t& a, const C& x, size_t) const noexcept { a = combine(a, acc_t(x)); }
+            acc_t combine(const acc_t& a, const acc_t& b) const noexcept { return cx_mul_op()(a, b); }
+            C finalize(const acc_t& a, size_t) const noexcept { return C(a); }
+        };
+
+        template <typename C, typename A>
+        struct cx_norm_reducer
+        {
+            using acc_t = A;
+            acc_t init() const noexcept { return A(0); }
+            void push(acc_t& a, const C& x, size_t) const noexcept { a += A(x.real) * A(x.real) + A(x.imag) * A(x.imag); }
+            acc_t combine(const acc_t& a, const acc_t& b) const noexcept { return a + b; }
+            C finalize(const acc_t& a, size_t) const noexcept { return C(static_cast<typename C::value_type>(std::sqrt(a)), 0); }
+        };
+
+        struct cx_real_key { template <typename C> auto operator ()(const C& x) const noexcept { return x.real; } };
+        struct cx_imag_key { template <typename C> auto operator ()(const C& x) const noexcept { return x.imag; } };
+        struct cx_mod_key { template <typename C> auto operator ()(const C& x) const noexcept { return x.mod(); } };
+        struct cx_phase_key { template <typename C> auto operator ()(const C& x) const noexcept { return x.phase(); } };
+
+        // Maximum (sign = 1) or minimum (sign = -1) of Key. Ties go to the
+        // lowest position whatever the order of combination; NaN keys win,
+        // like in numpy.
+        template <typename C, typename Key>
+        struct cx_extreme_reducer
+        {
+            using value_type = typename C::value_type;
+
+            struct acc_t
+            {
+                value_type key;
+                size_t index;
+                C value;
+            };
+
+            value_type sign;
+
+            static bool better(value_type key, size_t index, const acc_t& a) noexcept
+            {
+                if (std::isnan(key) || std::isnan(a.key))
+                    return std::isnan(key) && (!std::isnan(a.key) || index < a.index);
+                return key > a.key || (key == a.key && index < a.index);
+            }
+
+            acc_t init() const noexcept { return {-std::numeric_limits<value_type>::infinity(), SIZE_MAX, C(0, 0)}; }
+            void push(acc_t& a, const C& x, size_t k) const noexcept
+            {
+                const value_type key = sign * Key()(x);
+                if (better(key, k, a))
+                    a = {key, k, x};
+            }
+            acc_t combine(const acc_t& a, const acc_t& b) const noexcept { return better(b.key, b.index, a) ? b : a; }
+            C finalize(const acc_t& a, size_t) const noexcept { return a.value; }
+        };
+
+        template <typename C, typename Visit>
+        auto with_extreme_reducer(__cx_comparison_criteria__ criteria, float sign, Visit&& visit)
+        {
+            switch (criteria)
+            {
+                case BY_REAL:
+                    return visit(cx_extreme_reducer<C, cx_real_key>{sign});
+                case BY_IMAG:
+                    return visit(cx_extreme_reducer<C, cx_imag_key>{sign});
+                case BY_MOD:
+                    return visit(cx_extreme_reducer<C, cx_mod_key>{sign});
+                case BY_PHASE:
+                    return visit(cx_extreme_reducer<C, cx_phase_key>{sign});
+                default:
+                    throw std::invalid_argument("Invalid comparison criteria.");
+            }
+        }
+
+        template <typename T, typename R>
+        basic_cx_tensor<T> reduce(const basic_cx_tensor_const_view<T>& v, const R& r, const std::vector<size_t>& axes, bool keepdims)
+        {
+            const reduce_plan p = make_reduce_plan(v.shape(), v.strides(), axes, keepdims);
+            basic_cx_tensor<T> new_(p.out_shape, basic_cx<T>(0, 0));
+            run_reduction(r, v.data(), p, [&](size_t m, const typename R::acc_t& acc) {
+                new_[m] = r.finalize(acc, p.length);
+            });
+            return new_;
+        }
+
+        // Reduce with R in double precision when double_accumulation<T>(), in T otherwise.
+        template <template <typename, typename> class R, typename T>
+        basic_cx_tensor<T> reduce_acc(const basic_cx_tensor_const_view<T>& v, const std::vector<size_t>& axes, bool keepdims)
+        {
+            if (double_accumulation<T>())
+                return reduce(v, R<basic_cx<T>, double>(), axes, keepdims);
+            return reduce(v, R<basic_cx<T>, T>(), axes, keepdims);
+        }
+
+        template <typename T, typename R>
+        std::vector<size_t> arg_reduce(const basic_cx_tensor_const_view<T>& v, const R& r, const std::vector<size_t>& axes)
+        {
+            const reduce_plan p = make_reduce_plan(v.shape(), v.strides(), axes, false);
+            std::vector<size_t> indices(p.outputs, 0);
+            run_reduction(r, v.data(), p, [&](size_t m, const typename R::acc_t& acc) {
+                indices[m] = acc.index;
+            });
+            return indices;
+        }
+    }
+
+    template <typename T>
+    basic_cx_tensor<T>::basic_cx_tensor()
+        : data(empty_buffer<cx>())
+    {
+    }
+
+    template <typename T>
+    basic_cx_tensor<T>::basic_cx_tensor(const basic_cx_tensor& obj)
+        : data(std::make_shared<std::vector<cx>>(obj.data ? *obj.data : std::vector<cx>())),
+          __shape__(obj.__shape__),
+          __size__(obj.__size__)
+    {
+    }
+
+    template <typename T>
+    basic_cx_tensor<T>::basic_cx_tensor(basic_cx_tensor&& obj) noexcept
+        : data(std::move(obj.data)),
+          __shape__(std::move(obj.__shape__)),
+          __size__(std::exchange(obj.__size__, 0))
+    {
+        // The source is left as a default-constructed (empty) tensor.
+        obj.data = empty_buffer<cx>();
+        obj.__shape__.clear();
+    }
+
+    template <typename T>
+    basic_cx_tensor<T>::basic_cx_tensor(const const_view_type& obj)
+        : basic_cx_tensor(obj.contiguous())
+    {
+    }
+
+    template <typename T>
+    basic_cx_tensor<T>::basic_cx_tensor(const std::vector<size_t>& __shape, const cx& val)
+        : data(std::make_shared<std::vector<cx>>(shape_size(__shape), val)),
           __shape__(__shape),
-          __size__(std::accumulate(__shape.begin(), __shape.end(), 1, std::multiplies<size_t>()))
+          __size__(shape_size(__shape))
     {
         if (__shape.empty())
             throw std::invalid_argument("Shape cannot be empty.");
     }
 
-    cx_tensor::cx_tensor(const std::vector<size_t>& __shape, const std::vector<cx> &data)
-        : data(data),
+    template <typename T>
+    basic_cx_tensor<T>::basic_cx_tensor(const std::vector<size_t>& __shape, const std::vector<cx> &data)
+        : data(std::make_shared<std::vector<cx>>(data)),
           __shape__(__shape),
-          __size__(std::accumulate(__shape.begin(), __shape.end(), 1, std::multiplies<size_t>()))
+          __size__(shape_size(__shape))
     {
         if (__shape.empty())
             throw std::invalid_argument("Shape cannot be empty.");
@@ -22,17 +663,50 @@ namespace cx_lib
             throw std::invalid_argument("Data size does not match shape dimensions.");
     }
 
-    size_t cx_tensor::size() const noexcept
+    template <typename T>
+    basic_cx_tensor<T>& basic_cx_tensor<T>::operator =(const basic_cx_tensor& obj)
+    {
+        if (this != &obj)
+        {
+            // Views must keep seeing the old elements, so a shared buffer is replaced.
+            if (this->data && obj.data && this->data.use_count() == 1 && this->__size__ == obj.__size__)
+                std::copy(obj.data->begin(), obj.data->end(), this->data->begin());
+            else
+                this->data = std::make_shared<std::vector<cx>>(obj.data ? *obj.data : std::vector<cx>());
+            this->__shape__ = obj.__shape__;
+            this->__size__ = obj.__size__;
+        }
+        return *this;
+    }
+
+    template <typename T>
+    basic_cx_tensor<T>& basic_cx_tensor<T>::operator =(basic_cx_tensor&& obj) noexcept
+    {
+        if (this != &obj)
+        {
+            this->data = std::move(obj.data);
+            this->__shape__ = std::move(obj.__shape__);
+            this->__size__ = std::exchange(obj.__size__, 0);
+            obj.data = empty_buffer<cx>();
+            obj.__shape__.clear();
+        }
+        return *this;
+    }
+
+    template <typename T>
+    size_t basic_cx_tensor<T>::size() const noexcept
     {
         return this->__size__;
     }
 
-    const std::vector<size_t> &cx_tensor::shape() const noexcept
+    template <typename T>
+    const std::vector<size_t> &basic_cx_tensor<T>::shape() const noexcept
     {
         return this->__shape__;
     }
 
-    size_t cx_tensor::lindex(const std::vector<size_t>& __indices) const
+    template <typename T>
+    size_t basic_cx_tensor<T>::lindex(const std::vector<size_t>& __indices) const
     {
         if (__indices.size() != this->__shape__.size())
             throw std::invalid_argument("Index dimensionality mismatch.");
@@ -48,129 +722,125 @@ namespace cx_lib
         return idx;
     }
 
-    cx &cx_tensor::operator[](size_t __indices) noexcept
+    template <typename T>
+    basic_cx<T> &basic_cx_tensor<T>::operator[](size_t __indices) noexcept
     {
-        return this->data[__indices];
+        return (*this->data)[__indices];
     }
 
-    const cx &cx_tensor::operator[](size_t __indices) const noexcept
+    template <typename T>
+    const basic_cx<T> &basic_cx_tensor<T>::operator[](size_t __indices) const noexcept
     {
-        return this->data[__indices];
+        return (*this->data)[__indices];
     }
 
-    cx &cx_tensor::at(const std::vector<size_t>& __indices)
+    template <typename T>
+    basic_cx<T> &basic_cx_tensor<T>::at(const std::vector<size_t>& __indices)
     {
-        return this->data[lindex(__indices)];
+        return (*this->data)[lindex(__indices)];
     }
 
-    const cx &cx_tensor::at(const std::vector<size_t> &__indices) const
+    template <typename T>
+    const basic_cx<T> &basic_cx_tensor<T>::at(const std::vector<size_t> &__indices) const
     {
-        return this->data[lindex(__indices)];
+        return (*this->data)[lindex(__indices)];
     }
 
-    cx_tensor cx_tensor::operator+(const cx_tensor& obj) const
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::operator+(const const_view_type& obj) const&
     {
-        if (this->shape() != obj.shape())
-            throw std::invalid_argument("Dimensions mismatch between tensors.");
-
-        cx_tensor new_(this->shape(), cx(0, 0));
-
-        if (cx_lib::__cx_multithread_enabled__)
-        {
-            if (this->size() == 0)
-                return new_;
-
-            const size_t min_chunk_size = 1000;
-            size_t max_threads = std::thread::hardware_concurrency();
-            size_t needed_threads = (this->size() + min_chunk_size - 1) / min_chunk_size;
-            size_t num_threads = std::min(max_threads, needed_threads);
-
-            if (num_threads <= 1)
-            {
-                for (size_t i = 0; i < this->size(); i++)
-                    new_[i] = (*this)[i] + obj[i];
-                return new_;
-            }
-
-            size_t chunk_size = this->size() / num_threads;
-            std::vector<std::thread> threads;
-            threads.reserve(num_threads);
-
-            for (size_t t = 0; t < num_threads; ++t)
-            {
-                threads.emplace_back([&, t]()
-                                     {
-                                        size_t start = t * chunk_size;
-                                        size_t end = (t == num_threads - 1) ? this->size() : (t + 1) * chunk_size;
-                                        for (size_t i = start; i < end; ++i)
-                                            new_[i] = (*this)[i] + obj[i]; 
-                                     });
-            }
-
-            for (auto &thr : threads)
-                thr.join();
-        }
-        else
-        {
-            for (size_t i = 0; i < this->size(); i++)
-                new_[i] = (*this)[i] + obj[i];
-        }
+        return this->apply(obj, cx_add_op());
+    }
 
-        return new_;
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::operator+(const const_view_type& obj) &&
+    {
+        // In place only if no view shares the buffer and the shape is kept.
+        if (this->data.use_count() != 1 || broadcast_shape(this->__shape__, obj.shape()) != this->__shape__)
+            return this->apply(obj, cx_add_op());
+        return std::move(this->update(obj, cx_add_op()));
     }
 
-    cx_tensor cx_tensor::operator-(const cx_tensor& obj) const
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::operator-(const const_view_type& obj) const&
     {
-        if (this->shape() != obj.shape())
-            throw std::invalid_argument("Dimensions mismatch between tensors.");
+        return this->apply(obj, cx_sub_op());
+    }
 
-        cx_tensor new_(this->shape(), cx(0, 0));
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::operator-(const const_view_type& obj) &&
+    {
+        // In place only if no view shares the buffer and the shape is kept.
+        if (this->data.use_count() != 1 || broadcast_shape(this->__shape__, obj.shape()) != this->__shape__)
+            return this->apply(obj, cx_sub_op());
+        return std::move(this->update(obj, cx_sub_op()));
+    }
 
-        if (cx_lib::__cx_multithread_enabled__)
-        {
-            if (this->size() == 0)
-                return new_;
+    template <typename T>
+    template <typename Op>
+    basic_cx_tensor<T>& basic_cx_tensor<T>::update(const const_view_type& obj, Op op)
+    {
+        if (broadcast_shape(this->__shape__, obj.shape()) != this->__shape__)
+            throw std::invalid_argument("Cannot broadcast operand to the shape of the tensor.");
+        if (this->__size__ == 0)
+            return *this;
+
+        // An operand sharing our buffer with another layout would be read
+        // after being overwritten: work on a copy of it.
+        const cx* begin = this->data->data();
+        if (obj.data() >= begin && obj.data() < begin + this->__size__ &&
+            !(obj.data() == begin && obj.shape() == this->__shape__ && obj.is_contiguous()))
+            return this->update(const_view_type(obj.contiguous()), op);
+
+        const std::vector<ptrdiff_t> strides = contiguous_strides(this->__shape__);
+        nd_binary_map(this->__shape__, this->data->data(), strides, begin, strides,
+                      obj.data(), broadcast_strides(obj.shape(), obj.strides(), this->__shape__), op);
+        return *this;
+    }
 
-            const size_t min_chunk_size = 1000;
-            size_t max_threads = std::thread::hardware_concurrency();
-            size_t needed_threads = (this->size() + min_chunk_size - 1) / min_chunk_size;
-            size_t num_threads = std::min(max_threads, needed_threads);
+    template <typename T>
+    basic_cx_tensor<T>& basic_cx_tensor<T>::operator+=(const const_view_type& obj)
+    {
+        return this->update(obj, cx_add_op());
+    }
 
-            if (num_threads <= 1)
-            {
-                for (size_t i = 0; i < this->size(); i++)
-                    new_[i] = (*this)[i] + obj[i];
-                return new_;
-            }
+    template <typename T>
+    basic_cx_tensor<T>& basic_cx_tensor<T>::operator-=(const const_view_type& obj)
+    {
+        return this->update(obj, cx_sub_op());
+    }
 
-            size_t chunk_size = this->size() / num_threads;
-            std::vector<std::thread> threads;
-            threads.reserve(num_threads);
+    template <typename T>
+    basic_cx_tensor<T>& basic_cx_tensor<T>::operator*=(const const_view_type& obj)
+    {
+        return this->update(obj, cx_mul_op());
+    }
 
-            for (size_t t = 0; t < num_threads; ++t)
-            {
-                threads.emplace_back([&, t]()
-                                     {
-                                        size_t start = t * chunk_size;
-                                        size_t end = (t == num_threads - 1) ? this->size() : (t + 1) * chunk_size;
-                                        for (size_t i = start; i < end; ++i)
-                                            new_[i] = (*this)[i] - obj[i]; 
-                                     });
-            }
+    template <typename T>
+    basic_cx_tensor<T>& basic_cx_tensor<T>::operator*=(const cx& val)
+    {
+        if (this->__size__ == 0)
+            return *this;
+        const std::vector<ptrdiff_t> strides = contiguous_strides(this->__shape__);
+        nd_unary_map(this->__shape__, this->data->data(), strides, this->data->data(), strides,
+                     [val](const cx& a) { return a * val; });
+        return *this;
+    }
 
-            for (auto &thr : threads)
-                thr.join();
-        }
-        else
-        {
-            for (size_t i = 0; i < this->size(); i++)
-                new_[i] = (*this)[i] - obj[i];
-        }
+    template <typename T>
+    basic_cx_tensor<T>& basic_cx_tensor<T>::axpy(const cx& alpha, const const_view_type& x)
+    {
+        return this->update(x, [alpha](const cx& y, const cx& v) { return y + alpha * v; });
+    }
 
-        return new_;
+    template <typename T>
+    basic_cx_tensor<T>& basic_cx_tensor<T>::axpby(const cx& alpha, const const_view_type& x, const cx& beta)
+    {
+        return this->update(x, [alpha, beta](const cx& y, const cx& v) { return beta * y + alpha * v; });
     }
 
-    cx_tensor &cx_tensor::reshape(const std::vector<size_t>& __shape)
+    template <typename T>
+    basic_cx_tensor<T> &basic_cx_tensor<T>::reshape(const std::vector<size_t>& __shape)
     {
         size_t new_size = 1;
         for (size_t dim : __shape)
@@ -187,151 +857,134 @@ namespace cx_lib
         return *this;
     }
 
-    cx_tensor cx_tensor::broadcast_add(const cx_tensor& obj) const
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::broadcast_add(const const_view_type& obj) const
     {
-        if (this->__shape__.size() < obj.__shape__.size())
-            throw std::invalid_argument("Cannot broadcast: dimensions mismatch.");
-
-        cx_tensor new_ = *this;
-
-        if (cx_lib::__cx_multithread_enabled__)
-        {
-            size_t num_threads = std::thread::hardware_concurrency();
-            std::vector<std::mutex> mutexes(this->__size__);
-            std::vector<std::thread> threads;
-            threads.reserve(num_threads);
-
-            size_t chunk_size = obj.size() / num_threads;
-
-            for (size_t t = 0; t < num_threads; ++t)
-            {
-                threads.emplace_back([&, t]()
-                                     {
-                size_t start = t * chunk_size;
-                size_t end = (t == num_threads - 1) ? obj.size() : (t + 1) * chunk_size;
-
-                for (size_t i = start; i < end; ++i)
-                {
-                    size_t target_idx = i % this->__size__;
-                    std::lock_guard<std::mutex> lock(mutexes[target_idx]);
-                    new_[target_idx] = new_[target_idx] + obj[i];
-                } });
-            }
-
-            for (auto &thr : threads)
-                thr.join();
-        }
-        else
-        {
-            for (size_t i = 0; i < obj.size(); i++)
-                new_[i % this->__size__] = new_[i % this->__size__] + obj[i];
-        }
+        return this->apply(obj, cx_add_op());
+    }
 
-        return new_;
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::broadcast_sub(const const_view_type& obj) const
+    {
+        return this->apply(obj, cx_sub_op());
     }
 
-    cx_tensor cx_tensor::slice(const std::vector<size_t>& start, const std::vector<size_t>& end) const
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::broadcast_mul(const const_view_type& obj) const
     {
-        if (start.size() != end.size() || start.size() != this->__shape__.size())
-            throw std::invalid_argument("Start and end dimensions must match tensor shape.");
+        return this->apply(obj, cx_mul_op());
+    }
 
-        for (size_t i = 0; i < start.size(); i++)
-            if (start[i] >= end[i] || end[i] > this->__shape__[i])
-                throw std::invalid_argument("Invalid slicing range.");
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::broadcast_div(const const_view_type& obj) const
+    {
+        return this->apply(obj, cx_div_op());
+    }
 
-        std::vector<size_t> new_shape;
-        for (size_t i = 0; i < start.size(); i++)
-            new_shape.push_back(end[i] - start[i]);
+    template <typename T>
+    basic_cx_tensor_view<T> basic_cx_tensor<T>::view()
+    {
+        return view_type(*this);
+    }
 
-        std::vector<cx> sliced_data;
-        for (size_t i = start[0]; i < end[0]; i++)
-            sliced_data.push_back(this->data[i]);
+    template <typename T>
+    basic_cx_tensor_const_view<T> basic_cx_tensor<T>::view() const
+    {
+        return const_view_type(*this);
+    }
 
-        return cx_tensor(new_shape, sliced_data);
+    template <typename T>
+    basic_cx_tensor_view<T> basic_cx_tensor<T>::slice(const std::vector<size_t>& start, const std::vector<size_t>& end)
+    {
+        return this->view().slice(start, end);
     }
 
-    cx_tensor cx_tensor::transpose(const std::vector<size_t>& axes) const
+    template <typename T>
+    basic_cx_tensor_const_view<T> basic_cx_tensor<T>::slice(const std::vector<size_t>& start, const std::vector<size_t>& end) const
     {
-        if (axes.size() != this->__shape__.size())
-            throw std::invalid_argument("Axes size must match tensor dimensions.");
+        return this->view().slice(start, end);
+    }
 
-        std::vector<size_t> new_shape(this->__shape__.size());
-        for (size_t i = 0; i < axes.size(); ++i)
-        {
-            if (axes[i] >= this->__shape__.size())
-                throw std::invalid_argument("Invalid axis for transpose.");
-            new_shape[i] = this->__shape__[axes[i]];
-        }
+    template <typename T>
+    basic_cx_tensor_view<T> basic_cx_tensor<T>::transpose(const std::vector<size_t>& axes)
+    {
+        return this->view().transpose(axes);
+    }
 
-        cx_tensor result(new_shape, cx(0, 0));
+    template <typename T>
+    basic_cx_tensor_const_view<T> basic_cx_tensor<T>::transpose(const std::vector<size_t>& axes) const
+    {
+        return this->view().transpose(axes);
+    }
 
-        std::vector<size_t> old_strides(this->__shape__.size(), 1);
-        for (int i = this->__shape__.size() - 2; i >= 0; --i)
-            old_strides[i] = old_strides[i + 1] * this->__shape__[i + 1];
+    template <typename T>
+    basic_cx_tensor_view<T> basic_cx_tensor<T>::diagonal(size_t axis1, size_t axis2)
+    {
+        return this->view().diagonal(axis1, axis2);
+    }
 
-        std::vector<size_t> new_strides(new_shape.size(), 1);
-        for (int i = new_shape.size() - 2; i >= 0; --i)
-            new_strides[i] = new_strides[i + 1] * new_shape[i + 1];
+    template <typename T>
+    basic_cx_tensor_const_view<T> basic_cx_tensor<T>::diagonal(size_t axis1, size_t axis2) const
+    {
+        return this->view().diagonal(axis1, axis2);
+    }
 
-        if (cx_lib::__cx_multithread_enabled__)
-        {
-            size_t num_threads = std::thread::hardware_concurrency();
-            size_t chunk_size = this->__size__ / num_threads;
-            std::vector<std::thread> threads;
-            threads.reserve(num_threads);
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::reduce_sum(size_t axis) const
+    {
+        return this->view().sum({axis});
+    }
 
-            for (size_t t = 0; t < num_threads; ++t)
-            {
-                threads.emplace_back([&, t]()
-                                     {
-                size_t start = t * chunk_size;
-                size_t end = (t == num_threads - 1)? this->__size__ : (t + 1) * chunk_size;
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::sum(const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return this->view().sum(axes, keepdims);
+    }
 
-                for (size_t i = start; i < end; ++i)
-                {
-                    std::vector<size_t> old_indices(this->__shape__.size(), 0);
-                    size_t temp = i;
-                    for (size_t j = 0; j < this->__shape__.size(); ++j)
-                    {
-                        old_indices[j] = temp / old_strides[j];
-                        temp %= old_strides[j];
-                    }
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::mean(const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return this->view().mean(axes, keepdims);
+    }
 
-                    size_t new_index = 0;
-                    for (size_t j = 0; j < axes.size(); ++j)
-                        new_index += old_indices[axes[j]] * new_strides[j];
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::prod(const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return this->view().prod(axes, keepdims);
+    }
 
-                    result[new_index] = this->data[i];
-                } });
-            }
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::norm(const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return this->view().norm(axes, keepdims);
+    }
 
-            for (auto &thr : threads)
-                thr.join();
-        }
-        else
-        {
-            for (size_t i = 0; i < this->__size__; ++i)
-            {
-                std::vector<size_t> old_indices(this->__shape__.size(), 0);
-                size_t temp = i;
-                for (size_t j = 0; j < this->__shape__.size(); ++j)
-                {
-                    old_indices[j] = temp / old_strides[j];
-                    temp %= old_strides[j];
-                }
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::max(__cx_comparison_criteria__ criteria, const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return this->view().max(criteria, axes, keepdims);
+    }
 
-                size_t new_index = 0;
-                for (size_t j = 0; j < axes.size(); ++j)
-                    new_index += old_indices[axes[j]] * new_strides[j];
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor<T>::min(__cx_comparison_criteria__ criteria, const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return this->view().min(criteria, axes, keepdims);
+    }
 
-                result[new_index] = this->data[i];
-            }
-        }
+    template <typename T>
+    std::vector<size_t> basic_cx_tensor<T>::argmax(__cx_comparison_criteria__ criteria, const std::vector<size_t>& axes) const
+    {
+        return this->view().argmax(criteria, axes);
+    }
 
-        return result;
+    template <typename T>
+    std::vector<size_t> basic_cx_tensor<T>::argmin(__cx_comparison_criteria__ criteria, const std::vector<size_t>& axes) const
+    {
+        return this->view().argmin(criteria, axes);
     }
 
-    std::vector<size_t> cx_tensor::unravel_index(size_t index) const
+    template <typename T>
+    std::vector<size_t> basic_cx_tensor<T>::unravel_index(size_t index) const
     {
         std::vector<size_t> multi_index(this->__shape__.size());
         size_t remainder = index;
@@ -349,40 +1002,41 @@ namespace cx_lib
         return multi_index;
     }
 
-    void cx_tensor::normalize(__cx_comparison_criteria__ criteria)
+    template <typename T>
+    void basic_cx_tensor<T>::normalize(__cx_comparison_criteria__ criteria)
     {        
         cx min_, max_;
         switch (criteria)
         {
             case BY_REAL:
             {
-                min_ = *std::min_element(this->data.begin(), this->data.end(), 
+                min_ = *std::min_element(this->data->begin(), this->data->end(), 
                                               [](const cx& a, const cx& b) { return a.real < b.real; });      
-                max_ = *std::max_element(this->data.begin(), this->data.end(), 
+                max_ = *std::max_element(this->data->begin(), this->data->end(), 
                                               [](const cx& a, const cx& b) { return a.real > b.real; });      
                 break;
             }
             case BY_IMAG:
             {
-                min_ = *std::min_element(this->data.begin(), this->data.end(), 
+                min_ = *std::min_element(this->data->begin(), this->data->end(), 
                                               [](const cx& a, const cx& b) { return a.imag < b.imag; });      
-                max_ = *std::max_element(this->data.begin(), this->data.end(), 
+                max_ = *std::max_element(this->data->begin(), this->data->end(), 
                                               [](const cx& a, const cx& b) { return a.imag > b.imag; });      
                 break;
             }
             case BY_MOD:
             {
-                min_ = *std::min_element(this->data.begin(), this->data.end(), 
+                min_ = *std::min_element(this->data->begin(), this->data->end(), 
                                               [](const cx& a, const cx& b) { return a.mod() < b.mod(); });      
-                max_ = *std::max_element(this->data.begin(), this->data.end(), 
+                max_ = *std::max_element(this->data->begin(), this->data->end(), 
                                               [](const cx& a, const cx& b) { return a.mod() > b.mod(); });      
                 break;
             }
             case BY_PHASE:
             {
-                min_ = *std::min_element(this->data.begin(), this->data.end(), 
+                min_ = *std::min_element(this->data->begin(), this->data->end(), 
                                               [](const cx& a, const cx& b) { return a.phase() < b.phase(); });      
-                max_ = *std::max_element(this->data.begin(), this->data.end(), 
+                max_ = *std::max_element(this->data->begin(), this->data->end(), 
                                               [](const cx& a, const cx& b) { return a.phase() > b.phase(); });      
                 break;
             }
@@ -390,13 +1044,416 @@ namespace cx_lib
                 throw std::invalid_argument("Invalid comparison criteria.");
         }
 
+        const cx range = max_ - min_;
+        if (range.real == 0 && range.imag == 0)
+            __cx_division_by_zero__();
         for (size_t i = 0; i < this->size(); i++)
-            (*this)[i] = ((*this)[i] - min_) / (max_ - min_);
+            (*this)[i] = ((*this)[i] - min_).div(range);
     }
 
-    void cx_tensor::flatten() noexcept
+    template <typename T>
+    void basic_cx_tensor<T>::flatten() noexcept
     {
         this->__shape__ = {this->size()};
     }
 
-}
\ No newline at end of file
+    template <typename T>
+    basic_cx_tensor_const_view<T>::basic_cx_tensor_const_view(std::shared_ptr<std::vector<cx>> __storage, size_t __offset,
+                                   std::vector<size_t> __shape, std::vector<ptrdiff_t> __strides)
+        : storage(std::move(__storage)),
+          __offset__(__offset),
+          __shape__(std::move(__shape)),
+          __strides__(std::move(__strides)),
+          __size__(shape_size(this->__shape__))
+    {
+    }
+
+    template <typename T>
+    basic_cx_tensor_const_view<T>::basic_cx_tensor_const_view(const tensor_type& obj)
+        : basic_cx_tensor_const_view(obj.data, 0, obj.__shape__, contiguous_strides(obj.__shape__))
+    {
+    }
+
+    template <typename T>
+    size_t basic_cx_tensor_const_view<T>::offset_of(size_t index) const noexcept
+    {
+        ptrdiff_t off = static_cast<ptrdiff_t>(this->__offset__);
+        for (size_t d = this->__shape__.size(); d-- > 0;)
+        {
+            off += static_cast<ptrdiff_t>(index % this->__shape__[d]) * this->__strides__[d];
+            index /= this->__shape__[d];
+        }
+        return static_cast<size_t>(off);
+    }
+
+    template <typename T>
+    const basic_cx<T>& basic_cx_tensor_const_view<T>::operator [](size_t index) const noexcept
+    {
+        return (*this->storage)[this->offset_of(index)];
+    }
+
+    template <typename T>
+    size_t basic_cx_tensor_const_view<T>::offset_of(const std::vector<size_t>& __indices) const
+    {
+        if (__indices.size() != this->__shape__.size())
+            throw std::invalid_argument("Index dimensionality mismatch.");
+
+        ptrdiff_t off = static_cast<ptrdiff_t>(this->__offset__);
+        for (size_t d = 0; d < __indices.size(); d++)
+        {
+            if (__indices[d] >= this->__shape__[d])
+                throw std::invalid_argument("Index out of range.");
+            off += static_cast<ptrdiff_t>(__indices[d]) * this->__strides__[d];
+        }
+        return static_cast<size_t>(off);
+    }
+
+    template <typename T>
+    const basic_cx<T>& basic_cx_tensor_const_view<T>::at(const std::vector<size_t>& __indices) const
+    {
+        return (*this->storage)[this->offset_of(__indices)];
+    }
+
+    template <typename T>
+    size_t basic_cx_tensor_const_view<T>::size() const noexcept
+    {
+        return this->__size__;
+    }
+
+    template <typename T>
+    const std::vector<size_t>& basic_cx_tensor_const_view<T>::shape() const noexcept
+    {
+        return this->__shape__;
+    }
+
+    template <typename T>
+    const std::vector<ptrdiff_t>& basic_cx_tensor_const_view<T>::strides() const noexcept
+    {
+        return this->__strides__;
+    }
+
+    template <typename T>
+    size_t basic_cx_tensor_const_view<T>::offset() const noexcept
+    {
+        return this->__offset__;
+    }
+
+    template <typename T>
+    const basic_cx<T>* basic_cx_tensor_const_view<T>::data() const noexcept
+    {
+        return this->storage->data() + this->__offset__;
+    }
+
+    template <typename T>
+    bool basic_cx_tensor_const_view<T>::is_contiguous() const noexcept
+    {
+        ptrdiff_t expected = 1;
+        for (size_t d = this->__shape__.size(); d-- > 0;)
+        {
+            if (this->__shape__[d] != 1 && this->__strides__[d] != expected)
+                return false;
+            expected *= static_cast<ptrdiff_t>(this->__shape__[d]);
+        }
+        return true;
+    }
+
+    template <typename T>
+    std::vector<size_t> basic_cx_tensor_const_view<T>::unravel_index(size_t index) const
+    {
+        std::vector<size_t> multi_index(this->__shape__.size());
+        for (size_t d = this->__shape__.size(); d-- > 0;)
+        {
+            multi_index[d] = index % this->__shape__[d];
+            index /= this->__shape__[d];
+        }
+        return multi_index;
+    }
+
+    template <typename T>
+    basic_cx_tensor_const_view<T> basic_cx_tensor_const_view<T>::slice(const std::vector<size_t>& start, const std::vector<size_t>& end) const
+    {
+        check_slice(this->__shape__, start, end);
+
+        ptrdiff_t off = static_cast<ptrdiff_t>(this->__offset__);
+        std::vector<size_t> new_shape(start.size());
+        for (size_t d = 0; d < start.size(); d++)
+        {
+            off += static_cast<ptrdiff_t>(start[d]) * this->__strides__[d];
+            new_shape[d] = end[d] - start[d];
+        }
+
+        return basic_cx_tensor_const_view(this->storage, static_cast<size_t>(off), new_shape, this->__strides__);
+    }
+
+    template <typename T>
+    basic_cx_tensor_const_view<T> basic_cx_tensor_const_view<T>::transpose(const std::vector<size_t>& axes) const
+    {
+        check_axes(this->__shape__, axes);
+
+        std::vector<size_t> new_shape(axes.size());
+        std::vector<ptrdiff_t> new_strides(axes.size());
+        for (size_t i = 0; i < axes.size(); i++)
+        {
+            new_shape[i] = this->__shape__[axes[i]];
+            new_strides[i] = this->__strides__[axes[i]];
+        }
+
+        return basic_cx_tensor_const_view(this->storage, this->__offset__, new_shape, new_strides);
+    }
+
+    template <typename T>
+    basic_cx_tensor_const_view<T> basic_cx_tensor_const_view<T>::diagonal(size_t axis1, size_t axis2) const
+    {
+        if (axis1 == axis2 || axis1 >= this->__shape__.size() || axis2 >= this->__shape__.size())
+            throw std::invalid_argument("Invalid axes for diagonal.");
+        if (this->__shape__[axis1] != this->__shape__[axis2])
+            throw std::invalid_argument("Diagonal axes must have the same extent.");
+
+        std::vector<size_t> new_shape(this->__shape__);
+        std::vector<ptrdiff_t> new_strides(this->__strides__);
+        new_strides[axis1] += new_strides[axis2];
+        new_shape.erase(new_shape.begin() + axis2);
+        new_strides.erase(new_strides.begin() + axis2);
+
+        return basic_cx_tensor_const_view(this->storage, this->__offset__, new_shape, new_strides);
+    }
+
+    template <typename T>
+    basic_cx_tensor_const_view<T> basic_cx_tensor_const_view<T>::reshape(const std::vector<size_t>& __shape) const
+    {
+        if (__shape.empty())
+            throw std::invalid_argument("Shape cannot be empty.");
+        for (size_t dim : __shape)
+            if (dim == 0)
+                throw std::invalid_argument("Invalid shape: dimensions must be greater than zero.");
+        if (shape_size(__shape) != this->__size__)
+            throw std::invalid_argument("Invalid shape: total number of elements does not match.");
+
+        // Try to express the new shape on the current strides: walk both
+        // shapes from the left, matching groups of axes with the same number
+        // of elements. A group of old axes can be re-split only if it is
+        // contiguous with itself (numpy's no-copy reshape rule).
+        std::vector<size_t> old_shape, new_shape = __shape;
+        std::vector<ptrdiff_t> old_strides;
+        for (size_t d = 0; d < this->__shape__.size(); d++)
+        {
+            if (this->__shape__[d] == 1)
+                continue;
+            old_shape.push_back(this->__shape__[d]);
+            old_strides.push_back(this->__strides__[d]);
+        }
+
+        std::vector<ptrdiff_t> new_strides(new_shape.size(), 0);
+        bool viewable = true;
+        size_t oi = 0, oj = 1, ni = 0, nj = 1;
+        while (ni < new_shape.size() && oi < old_shape.size())
+        {
+            size_t np = new_shape[ni], op = old_shape[oi];
+            while (np != op)
+            {
+                if (np < op)
+                    np *= new_shape[nj++];
+                else
+                    op *= old_shape[oj++];
+            }
+
+            for (size_t k = oi; k + 1 < oj; k++)
+                if (old_strides[k] != old_strides[k + 1] * static_cast<ptrdiff_t>(old_shape[k + 1]))
+                    viewable = false;
+            if (!viewable)
+                break;
+
+            new_strides[nj - 1] = old_strides[oj - 1];
+            for (size_t k = nj - 1; k > ni; k--)
+                new_strides[k - 1] = new_strides[k] * static_cast<ptrdiff_t>(new_shape[k]);
+
+            ni = nj++;
+            oi = oj++;
+        }
+
+        if (!viewable)
+        {
+            tensor_type copy_ = this->contiguous();
+            return basic_cx_tensor_const_view(copy_.data, 0, new_shape, contiguous_strides(new_shape));
+        }
+
+        // Trailing axes of extent 1 are not covered by the walk above.
+        for (size_t k = ni; k < new_shape.size(); k++)
+            new_strides[k] = 1;
+
+        return basic_cx_tensor_const_view(this->storage, this->__offset__, new_shape, new_strides);
+    }
+
+    template <typename T>
+    basic_cx_tensor_const_view<T> basic_cx_tensor_const_view<T>::flatten() const
+    {
+        return this->reshape({this->__size__});
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::contiguous() const
+    {
+        tensor_type new_(this->__shape__, cx(0, 0));
+        strided_copy(this->__shape__, this->data(), this->__strides__, new_.data->data());
+        return new_;
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::sum(const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return reduce_acc<cx_sum_reducer>(*this, axes, keepdims);
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::mean(const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return reduce_acc<cx_mean_reducer>(*this, axes, keepdims);
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::prod(const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return reduce_acc<cx_prod_reducer>(*this, axes, keepdims);
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::norm(const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return reduce_acc<cx_norm_reducer>(*this, axes, keepdims);
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::max(__cx_comparison_criteria__ criteria, const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return with_extreme_reducer<cx>(criteria, 1.0f, [&](const auto& r) {
+            return reduce(*this, r, axes, keepdims);
+        });
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::min(__cx_comparison_criteria__ criteria, const std::vector<size_t>& axes, bool keepdims) const
+    {
+        return with_extreme_reducer<cx>(criteria, -1.0f, [&](const auto& r) {
+            return reduce(*this, r, axes, keepdims);
+        });
+    }
+
+    template <typename T>
+    std::vector<size_t> basic_cx_tensor_const_view<T>::argmax(__cx_comparison_criteria__ criteria, const std::vector<size_t>& axes) const
+    {
+        return with_extreme_reducer<cx>(criteria, 1.0f, [&](const auto& r) {
+            return arg_reduce(*this, r, axes);
+        });
+    }
+
+    template <typename T>
+    std::vector<size_t> basic_cx_tensor_const_view<T>::argmin(__cx_comparison_criteria__ criteria, const std::vector<size_t>& axes) const
+    {
+        return with_extreme_reducer<cx>(criteria, -1.0f, [&](const auto& r) {
+            return arg_reduce(*this, r, axes);
+        });
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::operator +(const basic_cx_tensor_const_view& obj) const
+    {
+        return this->apply(obj, cx_add_op());
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::operator -(const basic_cx_tensor_const_view& obj) const
+    {
+        return this->apply(obj, cx_sub_op());
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::broadcast_add(const basic_cx_tensor_const_view& obj) const
+    {
+        return this->apply(obj, cx_add_op());
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::broadcast_sub(const basic_cx_tensor_const_view& obj) const
+    {
+        return this->apply(obj, cx_sub_op());
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::broadcast_mul(const basic_cx_tensor_const_view& obj) const
+    {
+        return this->apply(obj, cx_mul_op());
+    }
+
+    template <typename T>
+    basic_cx_tensor<T> basic_cx_tensor_const_view<T>::broadcast_div(const basic_cx_tensor_const_view& obj) const
+    {
+        return this->apply(obj, cx_div_op());
+    }
+
+    template <typename T>
+    basic_cx_tensor_view<T>::basic_cx_tensor_view(const_view_type&& obj) noexcept
+        : const_view_type(std::move(obj))
+    {
+    }
+
+    template <typename T>
+    basic_cx_tensor_view<T>::basic_cx_tensor_view(tensor_type& obj)
+        : const_view_type(obj)
+    {
+    }
+
+    template <typename T>
+    basic_cx<T>& basic_cx_tensor_view<T>::operator [](size_t index) noexcept
+    {
+        return (*this->storage)[this->offset_of(index)];
+    }
+
+    template <typename T>
+    basic_cx<T>& basic_cx_tensor_view<T>::at(const std::vector<size_t>& __indices)
+    {
+        return (*this->storage)[this->offset_of(__indices)];
+    }
+
+    template <typename T>
+    basic_cx<T>* basic_cx_tensor_view<T>::data() noexcept
+    {
+        return this->storage->data() + this->__offset__;
+    }
+
+    template <typename T>
+    basic_cx_tensor_view<T> basic_cx_tensor_view<T>::slice(const std::vector<size_t>& start, const std::vector<size_t>& end)
+    {
+        return basic_cx_tensor_view(const_view_type::slice(start, end));
+    }
+
+    template <typename T>
+    basic_cx_tensor_view<T> basic_cx_tensor_view<T>::transpose(const std::vector<size_t>& axes)
+    {
+        return basic_cx_tensor_view(const_view_type::transpose(axes));
+    }
+
+    template <typename T>
+    basic_cx_tensor_view<T> basic_cx_tensor_view<T>::diagonal(size_t axis1, size_t axis2)
+    {
+        return basic_cx_tensor_view(const_view_type::diagonal(axis1, axis2));
+    }
+
+    template <typename T>
+    basic_cx_tensor_view<T> basic_cx_tensor_view<T>::reshape(const std::vector<size_t>& __shape)
+    {
+        return basic_cx_tensor_view(const_view_type::reshape(__shape));
+    }
+
+    template <typename T>
+    basic_cx_tensor_view<T> basic_cx_tensor_view<T>::flatten()
+    {
+        return basic_cx_tensor_view(const_view_type::flatten());
+    }
+
+    template class basic_cx_tensor<float>;
+    template class basic_cx_tensor<double>;
+    template class basic_cx_tensor_const_view<float>;
+    template class basic_cx_tensor_const_view<double>;
+    template class basic_cx_tensor_view<float>;
+    template class basic_cx_tensor_view<double>;
+}
@@ -1,45 +1,160 @@
+#include <functional>
+#include <utility>
 #include "ComplexVector.h"
+#include "CXKernels.h"
 
 namespace cx_lib
 {
-    void cx_vector::reset_values()
+    namespace
+    {
+        // Sum of the elements, accumulated in precision A.
+        template <typename A, typename C>
+        basic_cx<A> sum_as(const std::vector<C>& v) noexcept
+        {
+            basic_cx<A> sum_(0, 0);
+            for (const auto& val : v)
+                sum_ += basic_cx<A>(val);
+            return sum_;
+        }
+
+        // Index of the element with the larger (Better = std::greater) or
+        // smaller (std::less) modulus, the lower index on ties.
+        template <typename Better, typename C>
+        size_t pick(const std::vector<C>& v, size_t a, size_t b) noexcept
+        {
+            if (a > b)
+                std::swap(a, b);
+            return Better()(v[b].mod2(), v[a].mod2()) ? b : a;
+        }
+
+        // Tournament tree over the indices of v: leaves in [n, 2n), node p
+        // holds the winner of 2p and 2p + 1, the root (node 1) the winner
+        // of all elements.
+        template <typename Better, typename C>
+        void build_tree(std::vector<size_t>& tree, const std::vector<C>& v)
+        {
+            const size_t n = v.size();
+            tree.resize(2 * n);
+            for (size_t i = 0; i < n; i++)
+                tree[n + i] = i;
+            for (size_t p = n - 1; p > 0; p--)
+                tree[p] = pick<Better>(v, tree[2 * p], tree[2 * p + 1]);
+        }
+
+        // Replay the matches on the path from leaf i to the root.
+        template <typename Better, typename C>
+        void update_tree(std::vector<size_t>& tree, const std::vector<C>& v, size_t i) noexcept
+        {
+            for (size_t p = (v.size() + i) / 2; p > 0; p /= 2)
+                tree[p] = pick<Better>(v, tree[2 * p], tree[2 * p + 1]);
+        }
+    }
+
+    template <typename T>
+    void basic_cx_vector<T>::reset_values()
     {
         if (arr.empty()) {
             __sum__ = cx(0, 0);
             __mean__ = cx(0, 0);
             __max__ = cx(0, 0);
             __min__ = cx(0, 0);
+            if (__incremental__)
+                *__incremental__ = incremental_stats();
             cache_valid = true;
             return;
         }
 
-        __sum__ = cx(0, 0);
+        if (stats_mode == STATS_INCREMENTAL)
+        {
+            if (!__incremental__)
+                __incremental__ = std::make_unique<incremental_stats>();
+            build_tree<std::greater<T>>(__incremental__->max_tree, arr);
+            build_tree<std::less<T>>(__incremental__->min_tree, arr);
+            __incremental__->running_sum = sum_as<double>(arr);
+            read_incremental();
+            return;
+        }
+
+        // One squared modulus per element, compared with the current extremes.
+        T max_key = arr[0].mod2(), min_key = max_key;
         __max__ = arr[0];
         __min__ = arr[0];
 
         for (const auto& val : arr)
         {
-            __sum__ = __sum__ + val;
-            if (val.mod() > __max__.mod())
+            const T key = val.mod2();
+            if (key > max_key)
+            {
+                max_key = key;
                 __max__ = val;
-            if (val.mod() < __min__.mod())
+            }
+            if (key < min_key)
+            {
+                min_key = key;
                 __min__ = val;
+            }
         }
 
-        __mean__ = __sum__ / cx(arr.size(), 0);
+        if (double_accumulation<T>())
+        {
+            const cxd sum_ = sum_as<double>(arr);
+            __sum__ = cx(sum_);
+            __mean__ = cx(sum_ / cxd(arr.size(), 0));
+        }
+        else
+        {
+            __sum__ = sum_as<T>(arr);
+            __mean__ = __sum__ / cx(arr.size(), 0);
+        }
+        cache_valid = true;
+    }
+
+    template <typename T>
+    void basic_cx_vector<T>::read_incremental() noexcept
+    {
+        __sum__ = cx(__incremental__->running_sum);
+        __mean__ = cx(__incremental__->running_sum / cxd(arr.size(), 0));
+        __max__ = arr[__incremental__->max_tree[1]];
+        __min__ = arr[__incremental__->min_tree[1]];
         cache_valid = true;
     }
 
-    cx_vector::cx_vector(const std::vector<cx>& vec)
+    template <typename T>
+    void basic_cx_vector<T>::set(size_t index, const cx& val) noexcept
+    {
+        if (stats_mode != STATS_INCREMENTAL || !cache_valid || !__incremental__)
+        {
+            arr[index] = val;
+            cache_valid = false;
+            return;
+        }
+
+        __incremental__->running_sum += cxd(val) - cxd(arr[index]);
+        arr[index] = val;
+        update_tree<std::greater<T>>(__incremental__->max_tree, arr, index);
+        update_tree<std::less<T>>(__incremental__->min_tree, arr, index);
+        read_incremental();
+    }
+
+    template <typename T>
+    void basic_cx_vector<T>::set_stats_mode(__cx_stats_mode__ mode) noexcept
+    {
+        stats_mode = mode;
+        cache_valid = false;
+        if (mode == STATS_LAZY)
+            __incremental__.reset();
+    }
+
+    template <typename T>
+    basic_cx_vector<T>::basic_cx_vector(const std::vector<cx>& vec)
         : arr(vec)
     {
         if (vec.size() < 2)
             throw std::invalid_argument("cx_vector constructor accepts vector with size greater or equal than 2.");
-        
-        this->reset_values();
     }
 
-    cx_vector::cx_vector(const cx_vector& obj) noexcept
+    template <typename T>
+    basic_cx_vector<T>::basic_cx_vector(const basic_cx_vector& obj) noexcept
         : arr(obj.arr)
     {
         this->__sum__ = obj.__sum__;
@@ -47,18 +162,36 @@ namespace cx_lib
         this->__max__ = obj.__max__;
         this->__min__ = obj.__min__;
         this->cache_valid = obj.cache_valid;
+        this->stats_mode = obj.stats_mode;
+        if (obj.__incremental__)
+            this->__incremental__ = std::make_unique<incremental_stats>(*obj.__incremental__);
+    }
+
+    template <typename T>
+    basic_cx_vector<T>::basic_cx_vector(basic_cx_vector&& obj) noexcept
+        : arr(std::move(obj.arr)),
+          __sum__(obj.__sum__),
+          __mean__(obj.__mean__),
+          __max__(obj.__max__),
+          __min__(obj.__min__),
+          cache_valid(std::exchange(obj.cache_valid, false)),
+          stats_mode(obj.stats_mode),
+          __incremental__(std::move(obj.__incremental__))
+    {
+        // The source is left empty; its statistics are recomputed (as zeros) when queried.
+        obj.arr.clear();
     }
 
-    cx_vector::cx_vector(size_t __size, const cx& val)
+    template <typename T>
+    basic_cx_vector<T>::basic_cx_vector(size_t __size, const cx& val)
         : arr(__size, val)
     {
         if (__size < 2)
             throw std::invalid_argument("cx_vector constructor accepts vector with size greater or equal than 2.");
-        
-        this->reset_values();
     }
 
-    cx_vector& cx_vector::operator =(const cx_vector& obj) noexcept
+    template <typename T>
+    basic_cx_vector<T>& basic_cx_vector<T>::operator =(const basic_cx_vector& obj) noexcept
     {
         if (this != &obj)
         {
@@ -68,22 +201,35 @@ namespace cx_lib
             this->__max__ = obj.__max__;
             this->__min__ = obj.__min__;
             this->cache_valid = obj.cache_valid;
+            this->stats_mode = obj.stats_mode;
+            if (obj.__incremental__)
+                this->__incremental__ = std::make_unique<incremental_stats>(*obj.__incremental__);
+            else
+                this->__incremental__.reset();
         }
         return *this;
     }
 
-    cx& cx_vector::operator [](size_t index) noexcept
-    {
-        this->cache_valid = false;
-        return this->arr[index];
-    }
-
-    const cx& cx_vector::operator [](size_t index) const noexcept
+    template <typename T>
+    basic_cx_vector<T>& basic_cx_vector<T>::operator =(basic_cx_vector&& obj) noexcept
     {
-        return this->arr[index];
+        if (this != &obj)
+        {
+            this->arr = std::move(obj.arr);
+            obj.arr.clear();
+            this->__sum__ = obj.__sum__;
+            this->__mean__ = obj.__mean__;
+            this->__max__ = obj.__max__;
+            this->__min__ = obj.__min__;
+            this->cache_valid = std::exchange(obj.cache_valid, false);
+            this->stats_mode = obj.stats_mode;
+            this->__incremental__ = std::move(obj.__incremental__);
+        }
+        return *this;
     }
 
-    const cx& cx_vector::at(size_t index) const
+    template <typename T>
+    const basic_cx<T>& basic_cx_vector<T>::at(size_t index) const
     {
         if (index >= this->arr.size())
             throw std::runtime_error("Index out of range.");
@@ -91,53 +237,39 @@ namespace cx_lib
         return (*this)[index];
     }
 
-    cx_vector cx_vector::operator +(const cx_vector& obj) const
+    template <typename T>
+    basic_cx_vector<T>& basic_cx_vector<T>::operator *=(const cx& val) noexcept
     {
-        if (this->arr.size() != obj.arr.size())
-            throw std::runtime_error("Dimensions don't match.");
-
-        cx_vector sum_(this->arr.size(), cx(0, 0));
-        for (size_t i = 0; i < this->arr.size(); i++)
-            sum_[i] = (*this)[i] + obj[i];
-
-        sum_.reset_values();
-        return sum_;
+        kernels::scale(this->dim(), val, this->arr.data(), this->arr.data());
+        this->cache_valid = false;
+        return *this;
     }
 
-    cx_vector cx_vector::operator -(const cx_vector& obj) const
+    template <typename T>
+    basic_cx_vector<T>& basic_cx_vector<T>::operator *=(T val) noexcept
     {
-        if (this->arr.size() != obj.arr.size())
-            throw std::runtime_error("Dimensions don't match.");
-
-        cx_vector sub_(this->arr.size(), cx(0, 0));
-        for (size_t i = 0; i < this->arr.size(); i++)
-            sub_[i] = (*this)[i] - obj[i];
-
-        sub_.reset_values();
-        return sub_;
+        return (*this) *= cx(val, 0);
     }
 
-    cx_vector cx_vector::operator *(const cx& val) const noexcept
+    template <typename T>
+    basic_cx_vector<T>& basic_cx_vector<T>::axpy(const cx& alpha, const basic_cx_vector& x)
     {
-        cx_vector prod_ = *this;
-        for (size_t i = 0; i < prod_.dim(); i++)
-            prod_[i] = prod_[i] * val;
-
-        prod_.reset_values();
-        return prod_;
-    }
+        if (this->dim() != x.dim())
+            throw std::runtime_error("Dimensions don't match.");
 
-    cx_vector cx_vector::operator *(float val) const noexcept
-    {
-        return (*this) * cx(val, 0);
+        kernels::axpy(this->dim(), alpha, x.arr.data(), this->arr.data());
+        this->cache_valid = false;
+        return *this;
     }
 
-    size_t cx_vector::dim() const noexcept
+    template <typename T>
+    basic_cx_vector<T>& basic_cx_vector<T>::axpby(const cx& alpha, const basic_cx_vector& x, const cx& beta)
     {
-        return this->arr.size();
+        return *this = x * alpha + (*this) * beta;
     }
 
-    bool cx_vector::operator ==(const cx_vector& obj) const noexcept
+    template <typename T>
+    bool basic_cx_vector<T>::operator ==(const basic_cx_vector& obj) const noexcept
     {
         if (this->dim() != obj.dim())
             return false;
@@ -149,84 +281,85 @@ namespace cx_lib
         return true;
     }
 
-    bool cx_vector::operator !=(const cx_vector& obj) const noexcept
+    template <typename T>
+    bool basic_cx_vector<T>::operator !=(const basic_cx_vector& obj) const noexcept
     {
         return !((*this) == obj);
     }
 
-    float cx_vector::mod() const noexcept
+    template <typename T>
+    T basic_cx_vector<T>::mod() const noexcept
     {
-        float sum_ = 0.0f;
-        for (const auto& val : this->arr)
-            sum_ += val.mod() * val.mod();
-
-        return std::sqrt(sum_);
+        return std::sqrt(kernels::accumulate_dotc(this->arr.size(), this->arr.data(), this->arr.data()).real);
     }
 
-    void cx_vector::normalize()
+    template <typename T>
+    void basic_cx_vector<T>::normalize()
     {
-        float mag = this->mod();
-        if (mag == 0.0f)
+        T mag = this->mod();
+        if (mag == 0)
             throw std::runtime_error("Cannot normalize a zero vector.");
 
-        for (size_t i = 0; i < this->dim(); i++)
-            (*this)[i] = (*this)[i] / cx(mag, 0);
-
-        this->reset_values();
+        kernels::scale(this->dim(), cx(1 / mag, 0), this->arr.data(), this->arr.data());
+        this->cache_valid = false;
     }
 
-    cx_vector cx_vector::cumulative_sum() const noexcept
+    template <typename T>
+    basic_cx_vector<T> basic_cx_vector<T>::cumulative_sum() const noexcept
     {
-        cx_vector cum_(this->dim(), cx(0, 0));
-        cx sum_(0, 0);
-        for (size_t i = 0; i < this->dim(); i++)
-        {
-            sum_ = sum_ + (*this)[i];
-            cum_[i] = sum_;
-        }
+        basic_cx_vector cum_(this->dim(), cx(0, 0));
+        auto scan = [&](auto sum_) {
+            for (size_t i = 0; i < this->dim(); i++)
+            {
+                sum_ += decltype(sum_)((*this)[i]);
+                cum_[i] = cx(sum_);
+            }
+        };
+        if (double_accumulation<T>())
+            scan(cxd(0, 0));
+        else
+            scan(cx(0, 0));
 
-        cum_.reset_values();
         return cum_;
     }
 
-    cx_vector cx_vector::conjugate() const noexcept
+    template <typename T>
+    basic_cx_vector<T> basic_cx_vector<T>::conjugate() const noexcept
     {
-        cx_vector conj_(this->arr);
+        basic_cx_vector conj_(this->arr);
         for (size_t i = 0; i < conj_.dim(); i++)
             conj_[i] = conj_[i].conjugate();
 
-        conj_.reset_values();
         return conj_;
     }
 
-    cx cx_vector::dot(const cx_vector& obj) const
+    template <typename T>
+    basic_cx<T> basic_cx_vector<T>::dot(const basic_cx_vector& obj) const
     {
         if (this->dim() != obj.dim())
             throw std::runtime_error("Dimensions don't match.");
 
-        cx prod_(0, 0);
-        for (size_t i = 0; i < this->dim(); i++)
-            prod_ = prod_ + ((*this)[i] * obj[i].conjugate());
-
-        return prod_;
+        // sum a[i] * conj(b[i]) is sum conj(b[i]) * a[i]
+        return kernels::accumulate_dotc(this->dim(), obj.arr.data(), this->arr.data());
     }
 
-    cx_vector cx_vector::cross(const cx_vector& obj) const
+    template <typename T>
+    basic_cx_vector<T> basic_cx_vector<T>::cross(const basic_cx_vector& obj) const
     {
         if (this->dim() != 3 || obj.dim() != 3)
             throw std::runtime_error("Cross product is only defined in 3-Dimensional space.");
 
-        cx_vector cross_ = std::vector<cx>({
+        basic_cx_vector cross_ = std::vector<cx>({
             (*this)[1] * obj[2] - (*this)[2] * obj[1],
             (*this)[2] * obj[0] - (*this)[0] * obj[2],
             (*this)[0] * obj[1] - (*this)[1] * obj[0]
         });
 
-        cross_.reset_values();
         return cross_;
     }
 
-    cx_vector cx_vector::projection(const cx_vector& obj) const
+    template <typename T>
+    basic_cx_vector<T> basic_cx_vector<T>::projection(const basic_cx_vector& obj) const
     {
         if (this->dim() != obj.dim())
             throw std::runtime_error("Dimensions don't match.");
@@ -237,56 +370,61 @@ namespace cx_lib
             throw std::runtime_error("Can't project onto a zero vector.");
 
         cx scalar = dot_product / mod_squared;
-        cx_vector proj_(obj.dim(), cx(0, 0));
-        for (size_t i = 0; i < obj.dim(); i++)
-            proj_[i] = obj[i] * scalar;
-            
-        proj_.reset_values();
+        basic_cx_vector proj_(obj.dim(), cx(0, 0));
+        kernels::scale(obj.dim(), scalar, obj.arr.data(), proj_.arr.data());
+
         return proj_;
     }
 
-    cx cx_vector::sum() const noexcept
+    template <typename T>
+    basic_cx<T> basic_cx_vector<T>::sum() const noexcept
     {
         if (!this->cache_valid)
-            const_cast<cx_vector*>(this)->reset_values();
+            const_cast<basic_cx_vector*>(this)->reset_values();
         return this->__sum__;
     }
 
-    cx cx_vector::mean() const noexcept
+    template <typename T>
+    basic_cx<T> basic_cx_vector<T>::mean() const noexcept
     {
         if (!this->cache_valid)
-            const_cast<cx_vector*>(this)->reset_values();
+            const_cast<basic_cx_vector*>(this)->reset_values();
         return this->__mean__;
     }
 
-    cx cx_vector::max() const noexcept
+    template <typename T>
+    basic_cx<T> basic_cx_vector<T>::max() const noexcept
     {
         if (!this->cache_valid)
-            const_cast<cx_vector*>(this)->reset_values();
+            const_cast<basic_cx_vector*>(this)->reset_values();
         return this->__max__;
     }
 
-    cx cx_vector::min() const noexcept
+    template <typename T>
+    basic_cx<T> basic_cx_vector<T>::min() const noexcept
     {
         if (!this->cache_valid)
-            const_cast<cx_vector*>(this)->reset_values();
+            const_cast<basic_cx_vector*>(this)->reset_values();
         return this->__min__;
     }
 
-    cx_vector cx_vector::null_vector(size_t __size)
+    template <typename T>
+    basic_cx_vector<T> basic_cx_vector<T>::null_vector(size_t __size)
     {
         if (__size < 2)
             throw std::invalid_argument("cx_vector constructor accepts vector with size greater or equal than 2.");
         
-        return cx_vector(__size, cx(0, 0));
+        return basic_cx_vector(__size, cx(0, 0));
     }
 
-    std::vector<cx> cx_vector::get() noexcept
+    template <typename T>
+    std::vector<basic_cx<T>> basic_cx_vector<T>::get() noexcept
     {
         return this->arr;
     }
 
-    std::ostream& operator <<(std::ostream& os, const cx_vector& obj)
+    template <typename T>
+    std::ostream& operator <<(std::ostream& os, const basic_cx_vector<T>& obj)
     {
         bool print_all = (obj.dim() <= 10);
         os << "[";
@@ -301,4 +439,9 @@ namespace cx_lib
         os << "]";
         return os;
     }
+
+    template class basic_cx_vector<float>;
+    template class basic_cx_vector<double>;
+    template std::ostream& operator << <float>(std::ostream&, const basic_cx_vector<float>&);
+    template std::ostream& operator << <double>(std::ostream&, const basic_cx_vector<double>&);
 }
\ No newline at end of file
@@ -0,0 +1,197 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "CXLibrary.h"
+#include "test_helpers.h"
+
+using namespace cx_lib;
+using namespace cx_test;
+
+namespace
+{
+    // Full convolution by definition, in double precision.
+    std::vector<cxd> naive_convolve(const std::vector<cx>& a, const std::vector<cx>& v)
+    {
+        std::vector<cxd> out(a.size() + v.size() - 1, cxd(0, 0));
+        for (size_t i = 0; i < a.size(); ++i)
+            for (size_t j = 0; j < v.size(); ++j)
+                out[i + j] += cxd(a[i]) * cxd(v[j]);
+        return out;
+    }
+
+    void require_close(const cx_vector& a, const std::vector<cxd>& b, size_t start, double margin)
+    {
+        for (size_t i = 0; i < a.dim(); ++i)
+        {
+            REQUIRE(a[i].real == Approx(b[start + i].real).margin(margin));
+            REQUIRE(a[i].imag == Approx(b[start + i].imag).margin(margin));
+        }
+    }
+}
+
+TEST_CASE("Vector convolution...", "[convolve]") {
+    SECTION("Direct and FFT methods match the definition in every mode") {
+        for (size_t n : {2, 7, 64, 1000})
+            for (size_t m : {2, 5, 33})
+            {
+                if (m > n)
+                    continue;
+                const auto a = sample(n, 0.3f), v = sample(m, 1.1f);
+                const auto expected = naive_convolve(a, v);
+                for (auto method : {CONV_AUTO, CONV_DIRECT, CONV_FFT})
+                {
+                    cx_vector full = convolve(cx_vector(a), cx_vector(v), CONV_FULL, method);
+                    REQUIRE(full.dim() == n + m - 1);
+                    require_close(full, expected, 0, 1e-3);
+
+                    cx_vector same = convolve(cx_vector(a), cx_vector(v), CONV_SAME, method);
+                    REQUIRE(same.dim() == n);
+                    require_close(same, expected, (m - 1) / 2, 1e-3);
+
+                    if (n - m + 1 >= 2)
+                    {
+                        cx_vector valid = convolve(cx_vector(a), cx_vector(v), CONV_VALID, method);
+                        REQUIRE(valid.dim() == n - m + 1);
+                        require_close(valid, expected, m - 1, 1e-3);
+                    }
+                }
+            }
+    }
+
+    SECTION("Overlap-add for long signals") {
+        const auto a = sample(20000, 0.05f), v = sample(17, 0.9f);
+        const auto expected = naive_convolve(a, v);
+        require_close(fftconvolve(cx_vector(a), cx_vector(v)), expected, 0, 2e-3);
+
+        enable_multithreading(true);
+        cx_vector parallel = fftconvolve(cx_vector(a), cx_vector(v));
+        enable_multithreading(false);
+        require_close(parallel, expected, 0, 2e-3);
+    }
+
+    SECTION("Correlation") {
+        const auto a = sample(50, 0.4f), v = sample(6, 1.7f);
+        cx_vector c = correlate(cx_vector(a), cx_vector(v), CONV_VALID);
+        for (size_t k = 0; k < c.dim(); ++k)
+        {
+            cxd expected(0, 0);
+            for (size_t j = 0; j < v.size(); ++j)
+                expected += cxd(a[j + k]) * cxd(v[j].conjugate());
+            REQUIRE(c[k].real == Approx(expected.real).margin(1e-3));
+            REQUIRE(c[k].imag == Approx(expected.imag).margin(1e-3));
+        }
+        cx_vector f = correlate(cx_vector(a), cx_vector(v), CONV_FULL, CONV_FFT);
+        REQUIRE(f[v.size() - 1].real == Approx(c[0].real).margin(1e-3));
+    }
+
+    SECTION("Double precision") {
+        cxd_vector a(std::vector<cxd>{cxd(1, 0), cxd(2, 0), cxd(3, 0)});
+        cxd_vector v(std::vector<cxd>{cxd(0, 1), cxd(1, 0)});
+        cxd_vector c = fftconvolve(a, v);
+        REQUIRE(c.dim() == 4);
+        REQUIRE(c[0].imag == Approx(1));
+        REQUIRE(c[1].real == Approx(1));
+        REQUIRE(c[1].imag == Approx(2));
+        REQUIRE(c[3].real == Approx(3));
+        REQUIRE(convolve(a, v, CONV_FULL, CONV_DIRECT) == cxd_vector(std::vector<cxd>{cxd(0, 1), cxd(1, 2), cxd(2, 3), cxd(3, 0)}));
+    }
+
+    SECTION("Kernel longer than the signal in valid mode throws") {
+        REQUIRE_THROWS_AS(convolve(cx_vector(sample(3, 0.1f)), cx_vector(sample(5, 0.2f)), CONV_VALID), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Tensor convolution...", "[convolve]") {
+    const cx_tensor a({9, 7, 5}, sample(315, 0.2f));
+    const cx_tensor v({3, 2, 4}, sample(24, 0.8f));
+
+    // Full convolution by definition.
+    cx_tensor expected({11, 8, 8}, cx(0, 0));
+    for (size_t i = 0; i < a.size(); ++i)
+        for (size_t j = 0; j < v.size(); ++j)
+        {
+            auto ai = a.unravel_index(i), vj = v.unravel_index(j);
+            expected.at({ai[0] + vj[0], ai[1] + vj[1], ai[2] + vj[2]}) += a[i] * v[j];
+        }
+
+    SECTION("Direct and FFT methods in every mode") {
+        for (auto method : {CONV_DIRECT, CONV_FFT, CONV_AUTO})
+        {
+            require_close(convolve(a, v, CONV_FULL, method), expected, 1e-3);
+            require_close(convolve(a, v, CONV_SAME, method), cx_tensor(expected.slice({1, 0, 1}, {10, 7, 6})), 1e-3);
+            require_close(convolve(a, v, CONV_VALID, method), cx_tensor(expected.slice({2, 1, 3}, {9, 7, 5})), 1e-3);
+        }
+        require_close(fftconvolve(a, v), expected, 1e-3);
+    }
+
+    SECTION("Views and multithreading") {
+        const cx_tensor at(a.transpose({2, 1, 0}));
+        const cx_tensor vt(v.transpose({2, 1, 0}));
+        cx_tensor seq = convolve(a.transpose({2, 1, 0}), v.transpose({2, 1, 0}), CONV_FULL, CONV_DIRECT);
+        require_close(seq, cx_tensor(expected.transpose({2, 1, 0})), 1e-3);
+
+        enable_multithreading(true);
+        cx_tensor par = convolve(at, vt, CONV_FULL, CONV_DIRECT);
+        enable_multithreading(false);
+        require_close(par, seq, 0);
+    }
+
+    SECTION("Correlation flips and conjugates the kernel") {
+        const cx_tensor img({6, 6}, sample(36, 0.6f));
+        const cx_tensor k({2, 3}, sample(6, 1.2f));
+        cx_tensor c = correlate(img, k, CONV_VALID, CONV_DIRECT);
+        REQUIRE(c.shape() == std::vector<size_t>{5, 4});
+        for (size_t y = 0; y < 5; ++y)
+            for (size_t x = 0; x < 4; ++x)
+            {
+                cxd expected_(0, 0);
+                for (size_t i = 0; i < 2; ++i)
+                    for (size_t j = 0; j < 3; ++j)
+                        expected_ += cxd(img.at({y + i, x + j})) * cxd(k.at({i, j}).conjugate());
+                REQUIRE(c.at({y, x}).real == Approx(expected_.real).margin(1e-3));
+                REQUIRE(c.at({y, x}).imag == Approx(expected_.imag).margin(1e-3));
+            }
+        require_close(correlate(img, k, CONV_VALID, CONV_FFT), c, 1e-3);
+    }
+
+    SECTION("Rank mismatch throws") {
+        REQUIRE_THROWS_AS(convolve(a, cx_tensor({3, 3}, cx(1, 0))), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Overlap-save streaming filter...", "[convolve]") {
+    const auto h = sample(21, 0.7f);
+    const auto x = sample(3000, 0.13f);
+    const auto expected = naive_convolve(x, h);
+
+    SECTION("Any chunking gives the running convolution") {
+        for (size_t chunk : {size_t(1), size_t(37), size_t(256), size_t(3000)})
+        {
+            cx_overlap_save filter(h, 64);
+            REQUIRE(filter.block_size() == 44);
+            std::vector<cx> y(x.size());
+            for (size_t i = 0; i < x.size(); i += chunk)
+            {
+                const size_t n = std::min(chunk, x.size() - i);
+                filter.process(x.data() + i, n, y.data() + i);
+            }
+            for (size_t i = 0; i < y.size(); ++i)
+            {
+                REQUIRE(y[i].real == Approx(expected[i].real).margin(1e-3));
+                REQUIRE(y[i].imag == Approx(expected[i].imag).margin(1e-3));
+            }
+        }
+    }
+
+    SECTION("Reset starts a new stream") {
+        cx_overlap_save filter(h);
+        const std::vector<cx> first = filter.process(std::vector<cx>(x.begin(), x.begin() + 100));
+        filter.process(std::vector<cx>(x.begin() + 100, x.end()));
+        filter.reset();
+        REQUIRE(filter.process(std::vector<cx>(x.begin(), x.begin() + 100)) == first);
+    }
+
+    SECTION("Invalid kernels throw") {
+        REQUIRE_THROWS_AS(cx_overlap_save(std::vector<cx>()), std::invalid_argument);
+        REQUIRE_THROWS_AS(cx_overlap_save(h, 32), std::invalid_argument);
+    }
+}
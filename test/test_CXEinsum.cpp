@@ -0,0 +1,188 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "CXLibrary.h"
+#include "test_helpers.h"
+
+using namespace cx_lib;
+using namespace cx_test;
+
+namespace
+{
+    cx_tensor ramp(const std::vector<size_t>& shape, float phase)
+    {
+        cx_tensor t(shape, cx(0, 0));
+        for (size_t i = 0; i < t.size(); ++i)
+            t[i] = cx(static_cast<float>(i % 7) - 3.0f, static_cast<float>((i * 3) % 5) * phase);
+        return t;
+    }
+}
+
+TEST_CASE("einsum matrix products...", "[einsum]")
+{
+    cx_tensor a = ramp({5, 7}, 0.5f);
+    cx_tensor b = ramp({7, 3}, -1.0f);
+
+    cx_tensor expected({5, 3}, cx(0, 0));
+    for (size_t i = 0; i < 5; ++i)
+        for (size_t k = 0; k < 3; ++k)
+            for (size_t j = 0; j < 7; ++j)
+                expected.at({i, k}) += a.at({i, j}) * b.at({j, k});
+
+    require_close(einsum("ij,jk->ik", a, b), expected);
+    require_close(einsum("ij,jk", a, b), expected);
+    require_close(einsum("jk,ij->ik", b, a), expected);
+    require_close(einsum("ij,jk->ki", a, b), cx_tensor(expected.transpose({1, 0})));
+
+    SECTION("Transposed and sliced operands")
+    {
+        cx_tensor at = ramp({7, 5}, 0.5f);
+        cx_tensor big = ramp({9, 6}, -1.0f);
+        cx_tensor_view bs = big.slice({1, 2}, {8, 5});
+        cx_tensor ref = einsum("ij,jk->ik", cx_tensor(at.transpose({1, 0})), cx_tensor(bs));
+        require_close(einsum("ij,jk->ik", at.transpose({1, 0}), bs), ref);
+        require_close(einsum("ji,jk->ik", at, bs), ref);
+    }
+}
+
+TEST_CASE("einsum batches, traces and reductions...", "[einsum]")
+{
+    cx_tensor a = ramp({4, 3, 5}, 1.0f);
+    cx_tensor b = ramp({4, 5, 2}, -0.5f);
+
+    cx_tensor batched = einsum("bij,bjk->bik", a, b);
+    REQUIRE(batched.shape() == std::vector<size_t>{4, 3, 2});
+    for (size_t t = 0; t < 4; ++t)
+        for (size_t i = 0; i < 3; ++i)
+            for (size_t k = 0; k < 2; ++k)
+            {
+                cx expected(0, 0);
+                for (size_t j = 0; j < 5; ++j)
+                    expected += a.at({t, i, j}) * b.at({t, j, k});
+                REQUIRE(batched.at({t, i, k}).real == Approx(expected.real).margin(1e-3));
+                REQUIRE(batched.at({t, i, k}).imag == Approx(expected.imag).margin(1e-3));
+            }
+
+    cx_tensor m = ramp({4, 4}, 1.0f);
+    cx trace(0, 0);
+    for (size_t i = 0; i < 4; ++i)
+        trace += m.at({i, i});
+    cx_tensor tr = einsum("ii->", m);
+    REQUIRE(tr.shape() == std::vector<size_t>{1});
+    REQUIRE(tr[0] == trace);
+    cx_tensor diag = einsum("ii->i", m);
+    for (size_t i = 0; i < 4; ++i)
+        REQUIRE(diag[i] == m.at({i, i}));
+
+    require_close(einsum("bij->j", a), a.sum({0, 1}));
+    require_close(einsum("ij,ij->", m, m), cx_tensor(m.broadcast_mul(m).sum()));
+
+    cx_tensor u = ramp({3}, 1.0f), v = ramp({2}, -1.0f);
+    cx_tensor outer = einsum("i,j->ij", u, v);
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 2; ++j)
+            require_close(outer.at({i, j}), u[i] * v[j]);
+
+    SECTION("Pairs with nothing summed or nothing free")
+    {
+        cx_tensor p = ramp({4, 6}, -1.0f);
+        require_close(einsum("ij,ij->ij", m, m), m.broadcast_mul(m));
+        require_close(einsum("ij,ji->ij", m, m), m.broadcast_mul(m.transpose({1, 0})));
+
+        cx_tensor batched_outer = einsum("bi,bj->bij", m, p);
+        REQUIRE(batched_outer.shape() == std::vector<size_t>{4, 4, 6});
+        for (size_t t = 0; t < 4; ++t)
+            for (size_t i = 0; i < 4; ++i)
+                for (size_t j = 0; j < 6; ++j)
+                    require_close(batched_outer.at({t, i, j}), m.at({t, i}) * p.at({t, j}));
+
+        cx_tensor q = ramp({6, 4}, 0.5f);
+        cx_tensor dots = einsum("bj,jb->b", p, q);
+        REQUIRE(dots.shape() == std::vector<size_t>{4});
+        for (size_t t = 0; t < 4; ++t)
+        {
+            cx expected(0, 0);
+            for (size_t j = 0; j < 6; ++j)
+                expected += p.at({t, j}) * q.at({j, t});
+            require_close(dots[t], expected);
+        }
+    }
+}
+
+TEST_CASE("einsum chains of operands...", "[einsum]")
+{
+    cx_tensor a = ramp({6, 4}, 1.0f);
+    cx_tensor b = ramp({4, 5}, -1.0f);
+    cx_tensor c = ramp({5, 3}, 0.5f);
+
+    cx_tensor ab = einsum("ij,jk->ik", a, b);
+    require_close(einsum("ij,jk,kl->il", {a, b, c}), einsum("ik,kl->il", ab, c));
+
+    cx_tensor x = ramp({4}, 1.0f);
+    cx_tensor y = ramp({5}, -1.0f);
+    cx_tensor bilinear = einsum("i,ij,j->", {x, b, y});
+    cx expected(0, 0);
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 5; ++j)
+            expected += x[i] * b.at({i, j}) * y[j];
+    REQUIRE(bilinear[0].real == Approx(expected.real).margin(1e-3));
+    REQUIRE(bilinear[0].imag == Approx(expected.imag).margin(1e-3));
+}
+
+TEST_CASE("einsum invalid subscripts...", "[einsum]")
+{
+    cx_tensor a({2, 3}, cx(1, 0));
+    cx_tensor b({4, 2}, cx(1, 0));
+    REQUIRE_THROWS_AS(einsum("ij,jk->ik", a, b), std::invalid_argument);
+    REQUIRE_THROWS_AS(einsum("ijk->i", a), std::invalid_argument);
+    REQUIRE_THROWS_AS(einsum("ij->iz", a), std::invalid_argument);
+    REQUIRE_THROWS_AS(einsum("ij->ii", a), std::invalid_argument);
+    REQUIRE_THROWS_AS(einsum("i1->i", a), std::invalid_argument);
+    REQUIRE_THROWS_AS(einsum("ij,jk->ik", std::vector<cx_tensor_const_view>{a}), std::invalid_argument);
+    REQUIRE_THROWS_AS(einsum("ii->i", a), std::invalid_argument);
+}
+
+TEST_CASE("tensordot...", "[einsum]")
+{
+    cx_tensor a = ramp({3, 4, 5}, 1.0f);
+    cx_tensor b = ramp({4, 5, 2}, -1.0f);
+
+    cx_tensor r = tensordot(a, b, 2);
+    REQUIRE(r.shape() == std::vector<size_t>{3, 2});
+    require_close(r, einsum("ijk,jkl->il", a, b));
+    require_close(tensordot(a, b, {1, 2}, {0, 1}), r);
+    require_close(tensordot(a, b, {2, 1}, {1, 0}), r);
+
+    cx_tensor c = ramp({5, 3}, 0.5f);
+    require_close(tensordot(a, c, {0, 2}, {1, 0}), einsum("ijk,ki->j", a, c));
+    require_close(tensordot(a, b, 0), einsum("ijk,lmn->ijklmn", a, b));
+
+    REQUIRE_THROWS_AS(tensordot(a, b, {0}, {0}), std::invalid_argument);
+    REQUIRE_THROWS_AS(tensordot(a, b, {1, 1}, {0, 1}), std::invalid_argument);
+    REQUIRE_THROWS_AS(tensordot(a, b, 4), std::invalid_argument);
+}
+
+TEST_CASE("einsum large contractions match in parallel...", "[einsum]")
+{
+    cx_tensor a = ramp({8, 40, 48}, 1.0f);
+    cx_tensor b = ramp({48, 8, 36}, -0.5f);
+
+    enable_multithreading(false);
+    cx_tensor serial = einsum("bij,jbk->bik", a, b);
+    enable_multithreading(true);
+    set_num_threads(4);
+    cx_tensor parallel = einsum("bij,jbk->bik", a, b);
+    set_num_threads(0);
+    enable_multithreading(false);
+
+    require_close(serial, parallel);
+    for (size_t t = 0; t < 8; t += 7)
+        for (size_t i = 0; i < 40; i += 13)
+            for (size_t k = 0; k < 36; k += 11)
+            {
+                cx expected(0, 0);
+                for (size_t j = 0; j < 48; ++j)
+                    expected += a.at({t, i, j}) * b.at({j, t, k});
+                REQUIRE(serial.at({t, i, k}).real == Approx(expected.real).margin(1e-2));
+                REQUIRE(serial.at({t, i, k}).imag == Approx(expected.imag).margin(1e-2));
+            }
+}
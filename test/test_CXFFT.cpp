@@ -0,0 +1,270 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "CXLibrary.h"
+#include "test_helpers.h"
+
+using namespace cx_lib;
+using namespace cx_test;
+
+namespace
+{
+    // Direct O(n^2) transform in double precision.
+    template <typename C>
+    std::vector<cxd> naive_dft(const std::vector<C>& x, double sign)
+    {
+        const size_t n = x.size();
+        const double pi = 3.14159265358979323846;
+        std::vector<cxd> out(n, cxd(0, 0));
+        for (size_t k = 0; k < n; ++k)
+            for (size_t j = 0; j < n; ++j)
+            {
+                const double angle = sign * 2.0 * pi * static_cast<double>((j * k) % n) / static_cast<double>(n);
+                out[k] += cxd(x[j]) * cxd(std::cos(angle), std::sin(angle));
+            }
+        return out;
+    }
+
+    template <typename C>
+    void require_close(const std::vector<C>& a, const std::vector<cxd>& b, double margin)
+    {
+        REQUIRE(a.size() == b.size());
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            REQUIRE(a[i].real == Approx(b[i].real).margin(margin));
+            REQUIRE(a[i].imag == Approx(b[i].imag).margin(margin));
+        }
+    }
+
+    // Power-of-two, mixed-radix, generic prime and Bluestein sizes.
+    const std::vector<size_t> sizes = {1, 2, 3, 4, 5, 6, 7, 8, 12, 13, 16, 17, 30, 60, 64, 97, 100, 210, 256, 323, 1000, 1024};
+}
+
+TEST_CASE("FFT plans match the direct transform...", "[fft]") {
+    const __cx_simd_level__ saved = get_simd_level();
+
+    SECTION("Single precision, every SIMD level") {
+        for (auto level : simd_levels())
+        {
+            set_simd_level(level);
+            for (size_t n : sizes)
+            {
+                const auto x = sample<cx>(n, 0.37);
+                for (auto dir : {FFT_FORWARD, FFT_BACKWARD})
+                {
+                    std::vector<cx> out(n);
+                    fft_plan<float>(n, dir)->execute(x.data(), out.data());
+                    require_close(out, naive_dft(x, dir == FFT_FORWARD ? -1.0 : 1.0), 2e-3 * std::sqrt(double(n)));
+                }
+            }
+        }
+    }
+
+    SECTION("Double precision") {
+        for (size_t n : sizes)
+        {
+            const auto x = sample<cxd>(n, 1.3);
+            std::vector<cxd> out(n);
+            fft_plan<double>(n)->execute(x.data(), out.data());
+            require_close(out, naive_dft(x, -1.0), 1e-9);
+        }
+    }
+
+    SECTION("Bluestein is only used for large prime factors") {
+        REQUIRE_FALSE(cx_fft_plan(1000).uses_bluestein());
+        REQUIRE_FALSE(cx_fft_plan(13).uses_bluestein());
+        REQUIRE(cx_fft_plan(97).uses_bluestein());
+        REQUIRE(cx_fft_plan(323).uses_bluestein());
+    }
+
+    set_simd_level(saved);
+}
+
+TEST_CASE("FFT plan execution...", "[fft]") {
+    SECTION("In place equals out of place") {
+        for (size_t n : sizes)
+        {
+            auto x = sample<cx>(n, 0.9);
+            std::vector<cx> out(n);
+            auto plan = fft_plan<float>(n);
+            plan->execute(x.data(), out.data());
+            plan->execute(x.data());
+            REQUIRE(x == out);
+        }
+    }
+
+    SECTION("Caller-provided scratch") {
+        // Small and large scratch sizes, the latter not kept by the thread.
+        for (size_t n : {size_t(1000), size_t(1) << 17, size_t(40009)})
+        {
+            const auto x = sample<cx>(n, 0.3);
+            std::vector<cx> a(n), b(n);
+            auto plan = fft_plan<float>(n);
+            std::vector<cx> work(plan->work_size());
+            plan->execute(x.data(), a.data());
+            plan->execute(x.data(), b.data(), work.data());
+            REQUIRE(a == b);
+        }
+    }
+
+    SECTION("Plans are cached per size and direction") {
+        auto a = fft_plan<float>(48), b = fft_plan<float>(48);
+        REQUIRE(a == b);
+        REQUIRE(a != fft_plan<float>(48, FFT_BACKWARD));
+        REQUIRE(a->size() == 48);
+        REQUIRE(fft_plan<float>(48, FFT_BACKWARD)->direction() == FFT_BACKWARD);
+
+        clear_fft_plans();
+        REQUIRE(fft_plan<float>(48) != a);
+        REQUIRE(a->size() == 48);
+    }
+
+    SECTION("Zero length throws") {
+        REQUIRE_THROWS_AS(fft_plan<float>(0), std::invalid_argument);
+        REQUIRE_THROWS_AS(cxd_fft_plan(0), std::invalid_argument);
+    }
+
+    SECTION("Multithreaded transforms match the sequential ones") {
+        for (size_t n : {size_t(1) << 16, size_t(3) * 5 * 4096, size_t(40009)})
+        {
+            const auto x = sample<cx>(n, 0.11);
+            std::vector<cx> seq(n), par(n);
+            auto plan = fft_plan<float>(n);
+            plan->execute(x.data(), seq.data());
+            enable_multithreading(true);
+            plan->execute(x.data(), par.data());
+            enable_multithreading(false);
+            REQUIRE(seq == par);
+        }
+    }
+}
+
+TEST_CASE("FFT of vectors...", "[fft]") {
+    SECTION("fft and ifft round trip") {
+        cx_vector x(sample<cx>(360, 0.5));
+        cx_vector y = ifft(fft(x));
+        for (size_t i = 0; i < x.dim(); ++i)
+        {
+            REQUIRE(y[i].real == Approx(x[i].real).margin(1e-4));
+            REQUIRE(y[i].imag == Approx(x[i].imag).margin(1e-4));
+        }
+
+        cxd_vector xd(sample<cxd>(101, 0.5));
+        cxd_vector yd = ifft(fft(xd));
+        for (size_t i = 0; i < xd.dim(); ++i)
+        {
+            REQUIRE(yd[i].real == Approx(xd[i].real).margin(1e-12));
+            REQUIRE(yd[i].imag == Approx(xd[i].imag).margin(1e-12));
+        }
+    }
+
+    SECTION("Transform of an impulse and of a constant") {
+        cx_vector impulse(8, cx(0, 0));
+        impulse[0] = cx(1, 0);
+        require_close(fft(impulse).get(), std::vector<cxd>(8, cxd(1, 0)), 1e-6);
+
+        cx_vector constant(8, cx(1, 0));
+        fft_inplace(constant);
+        std::vector<cxd> spike(8, cxd(0, 0));
+        spike[0] = cxd(8, 0);
+        require_close(constant.get(), spike, 1e-6);
+        REQUIRE(constant.sum().real == Approx(8));
+        ifft_inplace(constant);
+        require_close(constant.get(), std::vector<cxd>(8, cxd(1, 0)), 1e-6);
+    }
+}
+
+namespace
+{
+    // Tensor with every line along axis replaced by its direct transform.
+    cx_tensor naive_axis(const cx_tensor& x, size_t axis)
+    {
+        cx_tensor out(x);
+        const size_t n = x.shape()[axis];
+        for (size_t l = 0; l < x.size(); ++l)
+        {
+            std::vector<size_t> index = x.unravel_index(l);
+            if (index[axis] != 0)
+                continue;
+            std::vector<cx> line;
+            for (size_t i = 0; i < n; ++i)
+            {
+                index[axis] = i;
+                line.push_back(x.at(index));
+            }
+            const std::vector<cxd> spectrum = naive_dft(line, -1.0);
+            for (size_t i = 0; i < n; ++i)
+            {
+                index[axis] = i;
+                out.at(index) = cx(spectrum[i]);
+            }
+        }
+        return out;
+    }
+}
+
+TEST_CASE("FFT of tensors...", "[fft]") {
+    const cx_tensor x({4, 6, 5}, sample<cx>(120, 0.21));
+
+    SECTION("Along each axis") {
+        for (size_t axis = 0; axis < 3; ++axis)
+            require_close(fft(x, {axis}), naive_axis(x, axis), 1e-3);
+    }
+
+    SECTION("Over several axes") {
+        require_close(fft(x, {0, 2}), naive_axis(naive_axis(x, 0), 2), 1e-3);
+        require_close(fft(x), naive_axis(naive_axis(naive_axis(x, 0), 1), 2), 1e-2);
+    }
+
+    SECTION("Views, in place and round trip") {
+        const cx_tensor transposed(x.transpose({2, 0, 1}));
+        require_close(fft(x.transpose({2, 0, 1}), {1}), naive_axis(transposed, 1), 1e-3);
+
+        cx_tensor y(x);
+        fft_inplace(y, {1, 2});
+        require_close(y, fft(x, {1, 2}), 0);
+        ifft_inplace(y, {1, 2});
+        require_close(y, x, 1e-5);
+
+        const cxd_tensor xd({3, 97}, sample<cxd>(291, 0.4));
+        const cxd_tensor yd = ifft(fft(xd));
+        for (size_t i = 0; i < xd.size(); ++i)
+            REQUIRE(yd[i].real == Approx(xd[i].real).margin(1e-12));
+    }
+
+    SECTION("Axes longer than a tile") {
+        // Lines of 9000 points, 3 elements apart: every tile holds one line.
+        const size_t n = 9000;
+        const cx_tensor tall({n, 3}, sample<cx>(3 * n, 0.13));
+        const cx_tensor y = fft(tall, {0});
+        for (size_t c = 0; c < 3; ++c)
+        {
+            std::vector<cx> line(n);
+            for (size_t i = 0; i < n; ++i)
+                line[i] = tall.at({i, c});
+            fft_plan<float>(n)->execute(line.data());
+            for (size_t i = 0; i < n; ++i)
+            {
+                REQUIRE(y.at({i, c}).real == line[i].real);
+                REQUIRE(y.at({i, c}).imag == line[i].imag);
+            }
+        }
+    }
+
+    SECTION("Invalid axes throw") {
+        REQUIRE_THROWS_AS(fft(x, {3}), std::invalid_argument);
+        cx_tensor y(x);
+        REQUIRE_THROWS_AS(ifft_inplace(y, {0, 5}), std::invalid_argument);
+    }
+
+    SECTION("Multithreaded transforms match the sequential ones") {
+        const cx_tensor big({64, 48, 40}, sample<cx>(64 * 48 * 40, 0.05));
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            cx_tensor seq = fft(big, {axis});
+            enable_multithreading(true);
+            cx_tensor par = fft(big, {axis});
+            enable_multithreading(false);
+            require_close(par, seq, 0);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "CXLibrary.h"
+#include "test_helpers.h"
+
+using namespace cx_lib;
+using namespace cx_test;
+
+TEST_CASE("simd level selection...", "[kernels]")
+{
+    const __cx_simd_level__ best = simd_detect();
+    REQUIRE(get_simd_level() == best);
+
+    set_simd_level(SIMD_SCALAR);
+    REQUIRE(get_simd_level() == SIMD_SCALAR);
+    set_simd_level(SIMD_AVX512);
+    REQUIRE(get_simd_level() == best);
+}
+
+TEST_CASE("kernels match the scalar definitions...", "[kernels]")
+{
+    // Lengths around every register width, read from unaligned offsets.
+    for (__cx_simd_level__ level : simd_levels())
+    {
+        set_simd_level(level);
+        for (size_t n : {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 100})
+        {
+            std::vector<cx> a = sample(n + 1, 0.37f), b = sample(n + 1, 1.21f);
+            const cx* pa = a.data() + 1;
+            const cx* pb = b.data() + 1;
+            const cx alpha(0.5f, -1.5f);
+
+            std::vector<cx> out(n + 1, cx(0, 0));
+            cx* po = out.data() + 1;
+
+            kernels::add(n, pa, pb, po);
+            for (size_t i = 0; i < n; ++i)
+                REQUIRE(po[i] == pa[i] + pb[i]);
+
+            kernels::sub(n, pa, pb, po);
+            for (size_t i = 0; i < n; ++i)
+                REQUIRE(po[i] == pa[i] - pb[i]);
+
+            kernels::mul(n, pa, pb, po);
+            for (size_t i = 0; i < n; ++i)
+                require_close(po[i], pa[i] * pb[i]);
+
+            kernels::conj_mul(n, pa, pb, po);
+            for (size_t i = 0; i < n; ++i)
+                require_close(po[i], pa[i].conjugate() * pb[i]);
+
+            kernels::scale(n, alpha, pa, po);
+            for (size_t i = 0; i < n; ++i)
+                require_close(po[i], alpha * pa[i]);
+
+            std::vector<cx> y(pb, pb + n);
+            kernels::axpy(n, alpha, pa, y.data());
+            for (size_t i = 0; i < n; ++i)
+                require_close(y[i], pb[i] + alpha * pa[i]);
+
+            cx dot(0, 0), dotc(0, 0);
+            for (size_t i = 0; i < n; ++i)
+            {
+                dot += pa[i] * pb[i];
+                dotc += pa[i].conjugate() * pb[i];
+            }
+            require_close(kernels::dot(n, pa, pb), dot, 1e-3f);
+            require_close(kernels::dotc(n, pa, pb), dotc, 1e-3f);
+            require_close(cx(kernels::dot_wide(n, pa, pb)), dot, 1e-3f);
+            require_close(cx(kernels::dotc_wide(n, pa, pb)), dotc, 1e-3f);
+
+            std::vector<float> mag(n + 1, 0.0f);
+            kernels::abs(n, pa, mag.data() + 1);
+            for (size_t i = 0; i < n; ++i)
+                REQUIRE(mag[i + 1] == Approx(pa[i].mod()));
+            kernels::abs2(n, pa, mag.data() + 1);
+            for (size_t i = 0; i < n; ++i)
+                REQUIRE(mag[i + 1] == Approx(pa[i].mod2()));
+
+            // In place
+            std::vector<cx> c(pa, pa + n);
+            kernels::mul(n, c.data(), pb, c.data());
+            for (size_t i = 0; i < n; ++i)
+                require_close(c[i], pa[i] * pb[i]);
+        }
+    }
+    set_simd_level(simd_detect());
+}
+
+TEST_CASE("vector, tensor and matrix paths use the kernels at every level...", "[kernels]")
+{
+    std::vector<cx> da = sample(37, 0.5f), db = sample(37, 0.9f);
+    cx_vector a(da), b(db);
+    cx_tensor ta({37}, da), tb({37}, db);
+
+    set_simd_level(SIMD_SCALAR);
+    const cx_vector sum_ref = a + b;
+    const cx dot_ref = a.dot(b);
+    const cx_tensor mul_ref = ta.broadcast_mul(tb);
+
+    for (__cx_simd_level__ level : simd_levels())
+    {
+        set_simd_level(level);
+        cx_vector s = a + b;
+        for (size_t i = 0; i < 37; ++i)
+            REQUIRE(s[i] == sum_ref[i]);
+        require_close(a.dot(b), dot_ref, 1e-3f);
+        REQUIRE(a.mod() == Approx(std::sqrt(a.dot(a).real)));
+
+        cx_tensor m = ta.broadcast_mul(tb);
+        for (size_t i = 0; i < 37; ++i)
+            require_close(m[i], mul_ref[i]);
+    }
+    set_simd_level(simd_detect());
+}
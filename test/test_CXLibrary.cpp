@@ -95,3 +95,209 @@ TEST_CASE("tensor_prod...") {
     REQUIRE(r[2] == cx(0,1)*cx(2,2));
     REQUIRE(r[3] == cx(0,1)*cx(3,3));
 }
+
+TEST_CASE("tensor_prod of tensors...") {
+    cx_tensor a({2, 3}, cx(0, 0));
+    cx_tensor b({4, 1, 5}, cx(0, 0));
+    for (size_t i = 0; i < a.size(); ++i)
+        a[i] = cx(static_cast<float>(i), 1);
+    for (size_t j = 0; j < b.size(); ++j)
+        b[j] = cx(1, static_cast<float>(j));
+
+    cx_tensor r = cx_lib::tensor_prod(a, b);
+    REQUIRE(r.shape() == std::vector<size_t>{2, 3, 4, 1, 5});
+    for (size_t i = 0; i < a.size(); ++i)
+        for (size_t j = 0; j < b.size(); ++j)
+            REQUIRE(r[i * b.size() + j] == a[i] * b[j]);
+
+    cx_tensor_view at = a.transpose({1, 0});
+    cx_tensor rt = cx_lib::tensor_prod(at, b.slice({1, 0, 2}, {3, 1, 4}));
+    REQUIRE(rt.shape() == std::vector<size_t>{3, 2, 2, 1, 2});
+    REQUIRE(rt.at({2, 1, 1, 0, 1}) == a.at({1, 2}) * b.at({2, 0, 3}));
+}
+
+TEST_CASE("kron...") {
+    std::vector<std::vector<cx>> dataA = {
+        {cx(1,0), cx(0,1), cx(2,0)},
+        {cx(0,0), cx(3,-1), cx(1,1)}
+    };
+    std::vector<std::vector<cx>> dataB = {
+        {cx(1,1), cx(2,0)},
+        {cx(0,-1), cx(4,0)},
+        {cx(5,0), cx(0,2)}
+    };
+    cx_matrix A(dataA), B(dataB);
+    cx_matrix K = cx_lib::kron(A, B);
+    REQUIRE(K.rows() == 6);
+    REQUIRE(K.cols() == 6);
+    for (size_t i = 0; i < 2; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            for (size_t k = 0; k < 3; ++k)
+                for (size_t l = 0; l < 2; ++l)
+                    REQUIRE(K(i * 3 + k, j * 2 + l) == A(i, j) * B(k, l));
+
+    cx_matrix I = cx_matrix::get_identity(2);
+    cx_matrix KI = cx_lib::kron(I, B);
+    REQUIRE(KI(3, 0) == cx(0, 0));
+    REQUIRE(KI(4, 3) == B(1, 1));
+}
+
+TEST_CASE("matmul with complex entries...") {
+    std::vector<std::vector<cx>> dataA = {
+        {cx(1,1), cx(0,2)},
+        {cx(3,0), cx(1,-1)}
+    };
+    std::vector<std::vector<cx>> dataB = {
+        {cx(2,0), cx(0,1)},
+        {cx(1,1), cx(1,0)}
+    };
+    const cx_matrix A(dataA), B(dataB);
+    const cx_vector v(std::vector<cx>{cx(1,2), cx(0,-1)});
+
+    SECTION("matmul conjugates the right operand") {
+        cx_matrix C = cx_lib::matmul(A, B);
+        REQUIRE(C(0,0) == cx(1,1)*cx(2,0) + cx(0,2)*cx(1,-1));
+        REQUIRE(C(0,1) == cx(1,1)*cx(0,-1) + cx(0,2)*cx(1,0));
+        REQUIRE(C(1,0) == cx(3,0)*cx(2,0) + cx(1,-1)*cx(1,-1));
+        REQUIRE(C(1,1) == cx(3,0)*cx(0,-1) + cx(1,-1)*cx(1,0));
+        REQUIRE(C(1,0) == cx_vector(dataA[1]).dot(B.get_col(0)));
+
+        cx_vector Av = cx_lib::matmul(A, v);
+        REQUIRE(Av[0] == cx_vector(dataA[0]).dot(v));
+        REQUIRE(Av[1] == cx_vector(dataA[1]).dot(v));
+        cx_vector vB = cx_lib::matmul(v, B);
+        REQUIRE(vB[0] == v.dot(B.get_col(0)));
+        REQUIRE(vB[1] == v.dot(B.get_col(1)));
+    }
+
+    SECTION("matprod is the plain product") {
+        cx_matrix C = cx_lib::matprod(A, B);
+        REQUIRE(C(0,0) == cx(1,1)*cx(2,0) + cx(0,2)*cx(1,1));
+        REQUIRE(C(0,1) == cx(1,1)*cx(0,1) + cx(0,2)*cx(1,0));
+        REQUIRE(C(1,0) == cx(3,0)*cx(2,0) + cx(1,-1)*cx(1,1));
+        REQUIRE(C(1,1) == cx(3,0)*cx(0,1) + cx(1,-1)*cx(1,0));
+
+        cx_vector Av = cx_lib::matprod(A, v);
+        REQUIRE(Av[1] == cx(3,0)*cx(1,2) + cx(1,-1)*cx(0,-1));
+        cx_vector vB = cx_lib::matprod(v, B);
+        REQUIRE(vB[0] == cx(1,2)*cx(2,0) + cx(0,-1)*cx(1,1));
+        REQUIRE_THROWS(cx_lib::matprod(v, cx_matrix(3, 2, cx(0,0))));
+    }
+}
+
+TEST_CASE("gemm on raw buffers...") {
+    // Sizes chosen so that every block and register tile has a remainder.
+    const size_t m = 37, n = 29, k = 300;
+    std::vector<cx> a(m * k), b(k * n), c(m * n);
+    for (size_t i = 0; i < a.size(); i++)
+        a[i] = cx(static_cast<float>(i % 7) - 3, static_cast<float>(i % 5) - 2);
+    for (size_t i = 0; i < b.size(); i++)
+        b[i] = cx(static_cast<float>(i % 3) - 1, static_cast<float>(i % 11) - 5);
+    for (size_t i = 0; i < c.size(); i++)
+        c[i] = cx(1, static_cast<float>(i % 2));
+
+    auto check = [&](const std::vector<cx>& got, const std::vector<cx>& c0, cx alpha, cx beta,
+                     auto opa, auto opb) {
+        for (size_t i = 0; i < m; i++)
+            for (size_t j = 0; j < n; j++)
+            {
+                cx sum_(0, 0);
+                for (size_t p = 0; p < k; p++)
+                    sum_ += opa(i, p) * opb(p, j);
+                cx expected = alpha * sum_ + beta * c0[i * n + j];
+                REQUIRE((got[i * n + j] - expected).mod() <= 1e-3f * (1 + expected.mod()));
+            }
+    };
+
+    SECTION("NO_TRANS x NO_TRANS with alpha and beta") {
+        std::vector<cx> got = c;
+        gemm(NO_TRANS, NO_TRANS, m, n, k, cx(0, 1), a.data(), k, b.data(), n, cx(2, 0), got.data(), n);
+        check(got, c, cx(0, 1), cx(2, 0),
+              [&](size_t i, size_t p) { return a[i * k + p]; },
+              [&](size_t p, size_t j) { return b[p * n + j]; });
+    }
+
+    SECTION("CONJ_TRANS x TRANS") {
+        // A is stored as k x m, B as n x k.
+        std::vector<cx> got = c;
+        gemm(CONJ_TRANS, TRANS, m, n, k, cx(1, 0), a.data(), m, b.data(), k, cx(0, 0), got.data(), n);
+        check(got, c, cx(1, 0), cx(0, 0),
+              [&](size_t i, size_t p) { return a[p * m + i].conjugate(); },
+              [&](size_t p, size_t j) { return b[j * k + p]; });
+    }
+}
+
+TEST_CASE("multithreaded products match the serial path...") {
+    const size_t n = 160;
+    cx_matrix A(n, n, cx(0, 0)), B(n, n, cx(0, 0));
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+        {
+            A(i, j) = cx(static_cast<float>((i + j) % 5), static_cast<float>(i % 3) - 1);
+            B(i, j) = cx(static_cast<float>(i % 4) - 2, static_cast<float>((i * j) % 7));
+        }
+    std::vector<cx> data(n);
+    for (size_t i = 0; i < n; i++)
+        data[i] = cx(static_cast<float>(i % 6), 1);
+    cx_vector v(data);
+
+    cx_lib::enable_multithreading(false);
+    cx_matrix C_serial = cx_lib::matmul(A, B);
+    cx_vector Av_serial = cx_lib::matmul(A, v);
+    cx_vector vB_serial = cx_lib::matmul(v, B);
+    cx_matrix P_serial = cx_lib::matprod(A, B);
+    cx_vector vP_serial = cx_lib::matprod(v, B);
+    cx_matrix H_serial = cx_lib::hadamard_prod(A, B);
+    cx_vector T_serial = cx_lib::tensor_prod(v, v);
+
+    cx_lib::enable_multithreading(true);
+    cx_lib::set_num_threads(4);
+    REQUIRE(cx_lib::matmul(A, B) == C_serial);
+    REQUIRE(cx_lib::matmul(A, v) == Av_serial);
+    REQUIRE(cx_lib::matmul(v, B) == vB_serial);
+    REQUIRE(cx_lib::matprod(A, B) == P_serial);
+    REQUIRE(cx_lib::matprod(v, B) == vP_serial);
+    REQUIRE(cx_lib::hadamard_prod(A, B) == H_serial);
+    REQUIRE(cx_lib::tensor_prod(v, v) == T_serial);
+    cx_lib::set_num_threads(0);
+    cx_lib::enable_multithreading(false);
+}
+
+TEST_CASE("double precision products...") {
+    // 1 + 1e-10 is not representable in single precision.
+    const double eps = 1e-10;
+    cxd_matrix A(std::vector<std::vector<cxd>>{
+        {cxd(1 + eps, 0), cxd(0, 1)},
+        {cxd(2, 0), cxd(1, -eps)}
+    });
+    cxd_matrix B = cxd_matrix::get_identity(2);
+
+    cxd_matrix C = cx_lib::matmul(A, B);
+    REQUIRE(C(0,0) == cxd(1 + eps, 0));
+    REQUIRE(C(1,1) == cxd(1, -eps));
+
+    cxd_vector v(std::vector<cxd>{cxd(1, 0), cxd(1, 0)});
+    cxd_vector r = cx_lib::matmul(A, v);
+    REQUIRE(r[0] == cxd(1 + eps, 1));
+    REQUIRE(r[1] == cxd(3, -eps));
+
+    cxd_matrix K = cx_lib::kron(B, A);
+    REQUIRE(K(2,2) == cxd(1 + eps, 0));
+    REQUIRE(K(0,2) == cxd(0, 0));
+
+    cxd_tensor t({2}, {cxd(eps, 0), cxd(1, 0)});
+    cxd_tensor s = cx_lib::einsum("i->", t);
+    REQUIRE(s[0] == cxd(1 + eps, 0));
+}
+
+TEST_CASE("double accumulation of single precision mat-vec...") {
+    const size_t n = size_t(1) << 20;
+    cx_matrix A(2, n, cx(0.1f, 0));
+    cx_vector v(n, cx(1, 0));
+    const double exact = static_cast<double>(n) * static_cast<double>(0.1f);
+
+    enable_double_accumulation(true);
+    cx_vector r = cx_lib::matmul(A, v);
+    enable_double_accumulation(false);
+    REQUIRE(r[0].real == Approx(exact).epsilon(1e-7));
+}
@@ -0,0 +1,818 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "CXLibrary.h"
+
+using namespace cx_lib;
+
+namespace
+{
+    template <typename T>
+    basic_cx_matrix<T> sample(size_t rows, size_t cols, double seed)
+    {
+        // Uniform in [-1, 1) from a linear congruential generator.
+        unsigned long long state = static_cast<unsigned long long>(seed * 1e6) * 2654435761ull + 1;
+        auto next = [&]() {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<T>(static_cast<double>(state >> 11) / 4503599627370496.0 - 1.0);
+        };
+        basic_cx_matrix<T> m(rows, cols, basic_cx<T>(0, 0));
+        for (size_t i = 0; i < rows; ++i)
+            for (size_t j = 0; j < cols; ++j)
+            {
+                const T re = next();
+                m(i, j) = basic_cx<T>(re, next());
+            }
+        return m;
+    }
+
+    template <typename T>
+    void require_close(const basic_cx_matrix<T>& a, const basic_cx_matrix<T>& b, double margin)
+    {
+        REQUIRE(a.dim() == b.dim());
+        for (size_t i = 0; i < a.rows(); ++i)
+            for (size_t j = 0; j < a.cols(); ++j)
+            {
+                REQUIRE(a(i, j).real == Approx(b(i, j).real).margin(margin));
+                REQUIRE(a(i, j).imag == Approx(b(i, j).imag).margin(margin));
+            }
+    }
+
+    // Rows of a in the order given by perm.
+    template <typename T>
+    basic_cx_matrix<T> permute_rows(const basic_cx_matrix<T>& a, const std::vector<size_t>& perm)
+    {
+        basic_cx_matrix<T> out(a);
+        for (size_t i = 0; i < a.rows(); ++i)
+            for (size_t j = 0; j < a.cols(); ++j)
+                out(i, j) = a(perm[i], j);
+        return out;
+    }
+
+    // Panel boundaries and sizes around them.
+    const std::vector<size_t> sizes = {2, 3, 17, 63, 64, 65, 130, 200};
+}
+
+TEST_CASE("LU decomposition...", "[linalg]") {
+    SECTION("P A = L U, with |L| <= sqrt(2)") {
+        for (size_t n : sizes)
+        {
+            const cxd_matrix a = sample<double>(n, n, 0.37);
+            const cxd_lu f = lu(a);
+            REQUIRE(f.size() == n);
+            REQUIRE_FALSE(f.is_singular());
+            require_close(matprod(f.lower(), f.upper()), permute_rows(a, f.permutation()), 1e-10);
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < i; ++j)
+                    REQUIRE(f.factors()(i, j).mod() <= std::sqrt(2.0) + 1e-12);
+        }
+
+        const cx_matrix a = sample<float>(130, 130, 0.9);
+        const cx_lu f = lu(a);
+        require_close(matprod(f.lower(), f.upper()), permute_rows(a, f.permutation()), 1e-4);
+    }
+
+    SECTION("Factoring an expiring matrix reuses it") {
+        cxd_matrix a = sample<double>(70, 70, 1.1);
+        const cxd_lu expected = lu(a);
+        const cxd_lu f = lu(std::move(a));
+        REQUIRE(f.factors() == expected.factors());
+        REQUIRE(f.pivots() == expected.pivots());
+    }
+
+    SECTION("Multithreaded factorization matches the sequential one") {
+        const cx_matrix a = sample<float>(300, 300, 0.21);
+        const cx_lu seq = lu(a);
+        enable_multithreading(true);
+        const cx_lu par = lu(a);
+        enable_multithreading(false);
+        REQUIRE(par.factors() == seq.factors());
+        REQUIRE(par.pivots() == seq.pivots());
+    }
+
+    SECTION("Non-square matrices throw") {
+        REQUIRE_THROWS_AS(lu(cx_matrix(3, 4, cx(1, 0))), std::invalid_argument);
+        REQUIRE_THROWS_AS(det(cxd_matrix(4, 2, cxd(1, 0))), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Linear systems, determinant and inverse...", "[linalg]") {
+    SECTION("solve with a vector right-hand side") {
+        for (size_t n : sizes)
+        {
+            const cxd_matrix a = sample<double>(n, n, 0.53);
+            std::vector<cxd> xs;
+            for (size_t i = 0; i < n; ++i)
+                xs.push_back(cxd(1.0 + i % 3, 0.5 * (i % 4)));
+            const cxd_vector x(xs);
+            const cxd_vector y = solve(a, matprod(a, x));
+            for (size_t i = 0; i < n; ++i)
+            {
+                REQUIRE(y[i].real == Approx(x[i].real).margin(1e-8));
+                REQUIRE(y[i].imag == Approx(x[i].imag).margin(1e-8));
+            }
+        }
+
+        const cx_matrix a(std::vector<std::vector<cx>>{{cx(2, 0), cx(1, 1)}, {cx(0, -1), cx(3, 0)}});
+        const cx_vector x = solve(a, cx_vector(std::vector<cx>{cx(3, 1), cx(3, -1)}));
+        REQUIRE(x[0].real == Approx(1));
+        REQUIRE(x[0].imag == Approx(0).margin(1e-6));
+        REQUIRE(x[1].real == Approx(1));
+        REQUIRE(x[1].imag == Approx(0).margin(1e-6));
+    }
+
+    SECTION("solve with a matrix right-hand side") {
+        for (size_t n : sizes)
+        {
+            const cxd_matrix a = sample<double>(n, n, 0.61);
+            const cxd_matrix x = sample<double>(n, 70, 1.3);
+            require_close(solve(a, matprod(a, x)), x, 1e-8);
+        }
+
+        const cx_matrix a = sample<float>(150, 150, 0.61);
+        const cx_matrix x = sample<float>(150, 5, 1.3);
+        require_close(solve(a, matprod(a, x)), x, 2e-2);
+        enable_multithreading(true);
+        const cx_matrix par = solve(a, matprod(a, x));
+        enable_multithreading(false);
+        require_close(par, x, 2e-2);
+    }
+
+    SECTION("Determinant") {
+        const cxd_matrix a(std::vector<std::vector<cxd>>{{cxd(1, 2), cxd(3, 0)}, {cxd(0, 1), cxd(4, -1)}});
+        const cxd d = det(a);
+        REQUIRE(d.real == Approx(6));
+        REQUIRE(d.imag == Approx(4));
+
+        // A row swap flips the sign.
+        const cxd_matrix b(std::vector<std::vector<cxd>>{{cxd(0, 1), cxd(4, -1)}, {cxd(1, 2), cxd(3, 0)}});
+        REQUIRE(det(b).real == Approx(-6));
+        REQUIRE(det(b).imag == Approx(-4));
+
+        // det(A B) = det(A) det(B).
+        const cxd_matrix p = sample<double>(90, 90, 0.3), q = sample<double>(90, 90, 0.8);
+        const cxd lhs = det(matprod(p, q)), rhs = det(p) * det(q);
+        REQUIRE(lhs.real == Approx(rhs.real).epsilon(1e-8));
+        REQUIRE(lhs.imag == Approx(rhs.imag).epsilon(1e-8));
+
+        REQUIRE(det(cx_matrix::get_identity(5)) == cx(1, 0));
+    }
+
+    SECTION("Inverse") {
+        for (size_t n : {size_t(2), size_t(65), size_t(140)})
+        {
+            const cxd_matrix a = sample<double>(n, n, 0.47);
+            require_close(matprod(a, inverse(a)), cxd_matrix::get_identity(n), 1e-9);
+        }
+        const cx_matrix a = sample<float>(40, 40, 0.47);
+        require_close(matprod(inverse(a), a), cx_matrix::get_identity(40), 1e-3);
+    }
+
+    SECTION("Singular matrices") {
+        cx_matrix a = sample<float>(100, 100, 0.2);
+        for (size_t i = 0; i < 100; ++i)
+            a(i, 70) = cx(0, 0);
+        const cx_lu f = lu(a);
+        REQUIRE(f.is_singular());
+        REQUIRE(f.det() == cx(0, 0));
+        REQUIRE_THROWS_AS(f.solve(cx_vector(100, cx(1, 0))), std::runtime_error);
+        REQUIRE_THROWS_AS(inverse(a), std::runtime_error);
+        REQUIRE(det(cxd_matrix(3, 3, cxd(2, 1))) == cxd(0, 0));
+    }
+
+    SECTION("Dimension mismatches throw") {
+        const cx_lu f = lu(sample<float>(4, 4, 0.5));
+        REQUIRE_THROWS_AS(f.solve(cx_vector(3, cx(1, 0))), std::invalid_argument);
+        REQUIRE_THROWS_AS(solve(sample<float>(4, 4, 0.5), cx_matrix(5, 2, cx(1, 0))), std::invalid_argument);
+    }
+}
+
+namespace
+{
+    template <typename T>
+    basic_cx_matrix<T> adjoint(const basic_cx_matrix<T>& a)
+    {
+        basic_cx_matrix<T> out(a.cols(), a.rows(), basic_cx<T>(0, 0));
+        for (size_t i = 0; i < a.rows(); ++i)
+            for (size_t j = 0; j < a.cols(); ++j)
+                out(j, i) = a(i, j).conjugate();
+        return out;
+    }
+
+    // Least-squares solution from the normal equations, in double precision.
+    cxd_matrix normal_equations(const cxd_matrix& a, const cxd_matrix& b)
+    {
+        return solve(matprod(adjoint(a), a), matprod(adjoint(a), b));
+    }
+}
+
+TEST_CASE("QR decomposition...", "[linalg]") {
+    SECTION("A = Q R with orthonormal Q and upper triangular R") {
+        for (auto dims : std::vector<std::pair<size_t, size_t>>{{2, 2}, {5, 3}, {3, 5}, {40, 9}, {64, 64}, {100, 70}, {150, 150}, {90, 130}})
+        {
+            const size_t m = dims.first, n = dims.second, k = std::min(m, n);
+            const cxd_matrix a = sample<double>(m, n, 0.77);
+            const cxd_qr f = qr(a);
+            const cxd_matrix q = f.q(), r = f.r();
+            REQUIRE(q.dim() == std::make_pair(m, k));
+            REQUIRE(r.dim() == std::make_pair(k, n));
+            require_close(matprod(q, r), a, 1e-10);
+            require_close(matprod(adjoint(q), q), cxd_matrix::get_identity(k), 1e-10);
+            for (size_t i = 0; i < k; ++i)
+            {
+                REQUIRE(r(i, i).imag == Approx(0).margin(1e-12));
+                for (size_t j = 0; j < i; ++j)
+                    REQUIRE(r(i, j) == cxd(0, 0));
+            }
+        }
+
+        const cx_matrix a = sample<float>(200, 120, 0.4);
+        const cx_qr f = qr(a);
+        require_close(matprod(f.q(), f.r()), a, 1e-4);
+    }
+
+    SECTION("Q and Q^H applied to vectors and matrices") {
+        const cxd_matrix a = sample<double>(80, 30, 0.15);
+        const cxd_qr f = qr(a);
+        const cxd_matrix b = sample<double>(80, 4, 0.6);
+        require_close(f.apply_q(f.apply_qh(b)), b, 1e-12);
+
+        // The first columns of Q^H A are R, the rest is zero.
+        const cxd_matrix qha = f.apply_qh(a);
+        for (size_t i = 0; i < 80; ++i)
+            for (size_t j = 0; j < 30; ++j)
+            {
+                const cxd expected = i < 30 ? f.r()(i, j) : cxd(0, 0);
+                REQUIRE(qha(i, j).real == Approx(expected.real).margin(1e-10));
+                REQUIRE(qha(i, j).imag == Approx(expected.imag).margin(1e-10));
+            }
+
+        std::vector<cxd> xs(80);
+        for (size_t i = 0; i < 80; ++i)
+            xs[i] = b(i, 1);
+        const cxd_vector qv = f.apply_q(cxd_vector(xs));
+        const cxd_matrix qb = f.apply_q(b);
+        for (size_t i = 0; i < 80; ++i)
+            REQUIRE(qv[i].real == Approx(qb(i, 1).real).margin(1e-12));
+        REQUIRE_THROWS_AS(f.apply_qh(cxd_vector(79, cxd(1, 0))), std::invalid_argument);
+    }
+
+    SECTION("Factoring an expiring matrix reuses it") {
+        cx_matrix a = sample<float>(50, 20, 0.33);
+        const cx_qr expected = qr(a);
+        const cx_qr f = qr(std::move(a));
+        REQUIRE(f.factors() == expected.factors());
+        REQUIRE(f.tau() == expected.tau());
+    }
+}
+
+TEST_CASE("Least squares and orthonormalization...", "[linalg]") {
+    SECTION("lstsq matches the normal equations") {
+        for (auto dims : std::vector<std::pair<size_t, size_t>>{{2, 2}, {7, 3}, {300, 20}, {130, 100}})
+        {
+            const cxd_matrix a = sample<double>(dims.first, dims.second, 0.29);
+            const cxd_matrix b = sample<double>(dims.first, 3, 0.71);
+            require_close(lstsq(a, b), normal_equations(a, b), 1e-8);
+            require_close(qr(a).solve(b), normal_equations(a, b), 1e-8);
+        }
+    }
+
+    SECTION("TSQR for tall and skinny systems") {
+        // Enough rows for several levels of TSQR blocks.
+        const size_t m = 40000, n = 12;
+        const cxd_matrix a = sample<double>(m, n, 0.52);
+        const cxd_matrix b = sample<double>(m, 2, 0.18);
+        const cxd_matrix expected = normal_equations(a, b);
+        require_close(lstsq(a, b), expected, 1e-9);
+
+        std::vector<cxd> bs(m);
+        for (size_t i = 0; i < m; ++i)
+            bs[i] = b(i, 0);
+        const cxd_vector x = lstsq(a, cxd_vector(bs));
+        for (size_t j = 0; j < n; ++j)
+            REQUIRE(x[j].real == Approx(expected(j, 0).real).margin(1e-9));
+
+        // An exactly consistent system is solved exactly, with threads too.
+        const cx_matrix af = sample<float>(m, n, 0.52);
+        const cx_matrix xf = sample<float>(n, 2, 0.9);
+        set_num_threads(4);
+        enable_multithreading(true);
+        const cx_matrix par = lstsq(af, matprod(af, xf));
+        enable_multithreading(false);
+        set_num_threads(0);
+        require_close(par, xf, 1e-3);
+        require_close(lstsq(af, matprod(af, xf)), xf, 1e-3);
+    }
+
+    SECTION("Invalid systems throw") {
+        REQUIRE_THROWS_AS(lstsq(sample<float>(3, 5, 0.1), sample<float>(3, 2, 0.2)), std::invalid_argument);
+        REQUIRE_THROWS_AS(lstsq(sample<float>(6, 3, 0.1), cx_vector(5, cx(1, 0))), std::invalid_argument);
+        cxd_matrix a = sample<double>(10, 4, 0.3);
+        for (size_t i = 0; i < 10; ++i)
+            a(i, 2) = cxd(0, 0);
+        REQUIRE_THROWS_AS(lstsq(a, cxd_vector(10, cxd(1, 0))), std::runtime_error);
+    }
+
+    SECTION("orthonormalize") {
+        std::vector<cxd_vector> vectors;
+        for (size_t j = 0; j < 6; ++j)
+        {
+            std::vector<cxd> v(20);
+            for (size_t i = 0; i < 20; ++i)
+                v[i] = cxd(std::sin(0.3 * (i + 1) * (j + 1)), std::cos(0.5 * i + j));
+            vectors.emplace_back(v);
+        }
+        const std::vector<cxd_vector> basis = orthonormalize(vectors);
+        REQUIRE(basis.size() == 6);
+        for (size_t p = 0; p < 6; ++p)
+            for (size_t q = 0; q < 6; ++q)
+            {
+                cxd dot(0, 0);
+                for (size_t i = 0; i < 20; ++i)
+                    dot += basis[p][i].conjugate() * basis[q][i];
+                REQUIRE(dot.real == Approx(p == q ? 1.0 : 0.0).margin(1e-12));
+                REQUIRE(dot.imag == Approx(0).margin(1e-12));
+            }
+
+        // Gram-Schmidt: the first vector is normalized, the second loses its component along it.
+        cxd norm2(0, 0);
+        for (size_t i = 0; i < 20; ++i)
+            norm2 += vectors[0][i].conjugate() * vectors[0][i];
+        for (size_t i = 0; i < 20; ++i)
+        {
+            REQUIRE(basis[0][i].real == Approx(vectors[0][i].real / std::sqrt(norm2.real)).margin(1e-12));
+            REQUIRE(basis[0][i].imag == Approx(vectors[0][i].imag / std::sqrt(norm2.real)).margin(1e-12));
+        }
+        cxd proj(0, 0);
+        for (size_t i = 0; i < 20; ++i)
+            proj += basis[1][i].conjugate() * vectors[1][i];
+        REQUIRE(proj.imag == Approx(0).margin(1e-12));
+        REQUIRE(proj.real > 0);
+
+        const std::vector<cx_vector> single = orthonormalize(std::vector<cx_vector>{cx_vector(std::vector<cx>{cx(3, 0), cx(0, 4)})});
+        REQUIRE(single.size() == 1);
+        REQUIRE(single[0][0].real == Approx(0.6f));
+        REQUIRE(single[0][1].imag == Approx(0.8f));
+
+        REQUIRE_THROWS_AS(orthonormalize(std::vector<cx_vector>()), std::invalid_argument);
+        REQUIRE_THROWS_AS(orthonormalize(std::vector<cx_vector>(3, cx_vector(2, cx(1, 0)))), std::invalid_argument);
+    }
+}
+
+namespace
+{
+    // Covariance-like Hermitian matrix: B B^H / n plus a random Hermitian part.
+    template <typename T>
+    basic_cx_matrix<T> hermitian(size_t n, double seed)
+    {
+        const basic_cx_matrix<T> b = sample<T>(n, n, seed);
+        basic_cx_matrix<T> h = matprod(b, adjoint(b));
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                h(i, j) = h(i, j) * basic_cx<T>(T(1) / n, 0) + (b(i, j) + b(j, i).conjugate()) * basic_cx<T>(0.5, 0);
+        return h;
+    }
+
+    // A v = lambda v for every pair, and orthonormal eigenvectors.
+    template <typename T>
+    void require_eigenpairs(const basic_cx_matrix<T>& a, const basic_cx_eigh<T>& f, double margin)
+    {
+        const size_t n = a.rows(), k = f.size();
+        REQUIRE(f.vectors().size() == k);
+        for (size_t j = 0; j + 1 < k; ++j)
+            REQUIRE(f.values()[j] <= f.values()[j + 1]);
+        for (size_t j = 0; j < k; ++j)
+        {
+            const basic_cx_vector<T>& v = f.vectors()[j];
+            REQUIRE(v.dim() == n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                basic_cx<double> av(0, 0);
+                for (size_t c = 0; c < n; ++c)
+                    av += basic_cx<double>(a(i, c)) * basic_cx<double>(v[c]);
+                av -= basic_cx<double>(v[i]) * basic_cx<double>(f.values()[j], 0);
+                REQUIRE(av.real == Approx(0).margin(margin));
+                REQUIRE(av.imag == Approx(0).margin(margin));
+            }
+            for (size_t p = 0; p <= j; ++p)
+            {
+                basic_cx<double> dot(0, 0);
+                for (size_t i = 0; i < n; ++i)
+                    dot += basic_cx<double>(f.vectors()[p][i].conjugate()) * basic_cx<double>(v[i]);
+                REQUIRE(dot.real == Approx(p == j ? 1.0 : 0.0).margin(margin));
+                REQUIRE(dot.imag == Approx(0).margin(margin));
+            }
+        }
+    }
+}
+
+TEST_CASE("Hermitian eigendecomposition...", "[linalg]") {
+    SECTION("Whole spectrum, through QL and divide and conquer") {
+        for (size_t n : {2, 3, 17, 63, 64, 65, 130, 300})
+        {
+            const cxd_matrix a = hermitian<double>(n, 0.43);
+            const cxd_eigh f = eigh(a);
+            REQUIRE(f.size() == n);
+            require_eigenpairs(a, f, 1e-10);
+
+            const std::vector<double> values = eigvalsh(a);
+            for (size_t i = 0; i < n; ++i)
+                REQUIRE(values[i] == Approx(f.values()[i]).margin(1e-10));
+        }
+    }
+
+    SECTION("Only the lower triangle is read") {
+        cxd_matrix a = hermitian<double>(40, 0.2);
+        const cxd_eigh f = eigh(a);
+        for (size_t i = 0; i < 40; ++i)
+            for (size_t j = i + 1; j < 40; ++j)
+                a(i, j) = cxd(7, -3);
+        const std::vector<double> values = eigvalsh(a);
+        for (size_t i = 0; i < 40; ++i)
+            REQUIRE(values[i] == Approx(f.values()[i]).margin(1e-10));
+    }
+
+    SECTION("Known spectrum with repeated eigenvalues") {
+        // Q diag(lambda) Q^H with ten eigenvalues of multiplicity ten.
+        const size_t n = 100;
+        const cxd_matrix q = qr(sample<double>(n, n, 0.61)).q();
+        cxd_matrix scaled(q);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                scaled(i, j) = q(i, j) * cxd(double(j / 10) - 4.5, 0);
+        const cxd_matrix a = matprod(scaled, adjoint(q));
+
+        const cxd_eigh f = eigh(a);
+        for (size_t i = 0; i < n; ++i)
+            REQUIRE(f.values()[i] == Approx(double(i / 10) - 4.5).margin(1e-10));
+        require_eigenpairs(a, f, 1e-10);
+
+        // The 15 smallest cross a cluster, whose vectors are orthogonalized.
+        const cxd_eigh low = eigh(a, EIG_SMALLEST, 15);
+        REQUIRE(low.size() == 15);
+        require_eigenpairs(a, low, 1e-9);
+
+        const cxd_eigh identity = eigh(cxd_matrix::get_identity(70), EIG_SMALLEST, 5);
+        require_eigenpairs(cxd_matrix::get_identity(70), identity, 1e-12);
+    }
+
+    SECTION("A range of eigenvalues matches the whole spectrum") {
+        const size_t n = 200;
+        const cxd_matrix a = hermitian<double>(n, 0.83);
+        const std::vector<double> all = eigvalsh(a);
+        for (size_t count : {1, 8, 99, 150})
+        {
+            const cxd_eigh low = eigh(a, EIG_SMALLEST, count), high = eigh(a, EIG_LARGEST, count);
+            REQUIRE(low.size() == count);
+            REQUIRE(high.size() == count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                REQUIRE(low.values()[i] == Approx(all[i]).margin(1e-10));
+                REQUIRE(high.values()[i] == Approx(all[n - count + i]).margin(1e-10));
+            }
+            require_eigenpairs(a, low, 1e-9);
+            require_eigenpairs(a, high, 1e-9);
+
+            const std::vector<double> values = eigvalsh(a, EIG_LARGEST, count);
+            REQUIRE(values.size() == count);
+            REQUIRE(values.back() == Approx(all.back()).margin(1e-10));
+        }
+    }
+
+    SECTION("Single precision, with threads") {
+        const cx_matrix a = hermitian<float>(150, 0.37);
+        const cx_eigh seq = eigh(a);
+        require_eigenpairs(a, seq, 2e-3);
+        require_eigenpairs(a, eigh(a, EIG_LARGEST, 4), 2e-3);
+
+        set_num_threads(4);
+        enable_multithreading(true);
+        const cx_eigh par = eigh(a), top = eigh(a, EIG_LARGEST, 4);
+        enable_multithreading(false);
+        set_num_threads(0);
+        require_eigenpairs(a, par, 2e-3);
+        for (size_t i = 0; i < 4; ++i)
+            REQUIRE(top.values()[i] == Approx(seq.values()[146 + i]).margin(1e-3));
+    }
+
+    SECTION("Invalid arguments throw") {
+        REQUIRE_THROWS_AS(eigh(sample<float>(3, 4, 0.1)), std::invalid_argument);
+        REQUIRE_THROWS_AS(eigh(hermitian<float>(5, 0.1), EIG_SMALLEST, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(eigvalsh(hermitian<double>(5, 0.1), EIG_LARGEST, 6), std::invalid_argument);
+    }
+}
+
+namespace
+{
+    // Columns of z are orthonormal.
+    template <typename T>
+    void require_orthonormal(const std::vector<basic_cx_vector<T>>& z, double margin)
+    {
+        for (size_t p = 0; p < z.size(); ++p)
+            for (size_t q = 0; q <= p; ++q)
+            {
+                basic_cx<double> dot(0, 0);
+                for (size_t i = 0; i < z[p].dim(); ++i)
+                    dot += basic_cx<double>(z[q][i].conjugate()) * basic_cx<double>(z[p][i]);
+                REQUIRE(dot.real == Approx(p == q ? 1.0 : 0.0).margin(margin));
+                REQUIRE(dot.imag == Approx(0).margin(margin));
+            }
+    }
+
+    // A v = sigma u for every triplet, descending values, orthonormal vectors.
+    template <typename T>
+    void require_triplets(const basic_cx_matrix<T>& a, const basic_cx_svd<T>& f, double margin)
+    {
+        const size_t m = a.rows(), n = a.cols(), k = f.size();
+        REQUIRE(f.u().size() == k);
+        REQUIRE(f.v().size() == k);
+        for (size_t j = 0; j < k; ++j)
+        {
+            REQUIRE(f.values()[j] >= 0);
+            if (j + 1 < k)
+                REQUIRE(f.values()[j] >= f.values()[j + 1]);
+            REQUIRE(f.u()[j].dim() == m);
+            REQUIRE(f.v()[j].dim() == n);
+            for (size_t i = 0; i < m; ++i)
+            {
+                basic_cx<double> av(0, 0);
+                for (size_t c = 0; c < n; ++c)
+                    av += basic_cx<double>(a(i, c)) * basic_cx<double>(f.v()[j][c]);
+                av -= basic_cx<double>(f.u()[j][i]) * basic_cx<double>(f.values()[j], 0);
+                REQUIRE(av.real == Approx(0).margin(margin));
+                REQUIRE(av.imag == Approx(0).margin(margin));
+            }
+        }
+        require_orthonormal(f.u(), margin);
+        require_orthonormal(f.v(), margin);
+    }
+}
+
+TEST_CASE("Singular value decomposition...", "[linalg]") {
+    SECTION("Square, tall and wide matrices") {
+        const std::vector<std::pair<size_t, size_t>> dims = {
+            {2, 2}, {3, 2}, {2, 5}, {17, 17}, {64, 64}, {65, 65}, {130, 70}, {70, 130}, {200, 129}};
+        for (const auto& d : dims)
+        {
+            const cxd_matrix a = sample<double>(d.first, d.second, 0.29);
+            const cxd_svd f = svd(a);
+            REQUIRE(f.rows() == d.first);
+            REQUIRE(f.cols() == d.second);
+            REQUIRE(f.size() == std::min(d.first, d.second));
+            require_triplets(a, f, 1e-10);
+            require_close(f.reconstruct(), a, 1e-10);
+
+            const std::vector<double> values = svdvals(a);
+            for (size_t i = 0; i < f.size(); ++i)
+                REQUIRE(values[i] == Approx(f.values()[i]).margin(1e-10));
+        }
+    }
+
+    SECTION("Singular values are the square roots of the eigenvalues of A^H A") {
+        const cxd_matrix a = sample<double>(90, 60, 0.71);
+        const std::vector<double> values = svdvals(a);
+        const std::vector<double> eigenvalues = eigvalsh(matprod(adjoint(a), a));
+        for (size_t i = 0; i < 60; ++i)
+            REQUIRE(values[i] == Approx(std::sqrt(eigenvalues[59 - i])).margin(1e-10));
+    }
+
+    SECTION("Rank-deficient and special matrices") {
+        // Q diag(3, 2, 1, 0, ...) W^H.
+        const cxd_matrix q = qr(sample<double>(40, 40, 0.12)).q(), w = qr(sample<double>(40, 40, 0.34)).q();
+        cxd_matrix scaled(q);
+        for (size_t i = 0; i < 40; ++i)
+            for (size_t j = 0; j < 40; ++j)
+                scaled(i, j) = q(i, j) * cxd(j < 3 ? 3.0 - j : 0.0, 0);
+        const cxd_matrix a = matprod(scaled, adjoint(w));
+        const cxd_svd f = svd(a);
+        for (size_t i = 0; i < 40; ++i)
+            REQUIRE(f.values()[i] == Approx(i < 3 ? 3.0 - i : 0.0).margin(1e-12));
+        require_triplets(a, f, 1e-12);
+
+        const cxd_svd identity = svd(cxd_matrix::get_identity(6));
+        require_triplets(cxd_matrix::get_identity(6), identity, 1e-15);
+        const cxd_svd zero = svd(cxd_matrix(4, 3, cxd(0, 0)));
+        REQUIRE(zero.values() == std::vector<double>(3, 0.0));
+        require_close(zero.reconstruct(), cxd_matrix(4, 3, cxd(0, 0)), 0);
+    }
+
+    SECTION("Single precision, with threads") {
+        const cx_matrix a = sample<float>(150, 120, 0.53);
+        const cx_svd seq = svd(a);
+        require_triplets(a, seq, 1e-3);
+
+        set_num_threads(4);
+        enable_multithreading(true);
+        const cx_svd par = svd(a);
+        enable_multithreading(false);
+        set_num_threads(0);
+        require_triplets(a, par, 1e-3);
+        for (size_t i = 0; i < 120; ++i)
+            REQUIRE(par.values()[i] == Approx(seq.values()[i]).margin(1e-4));
+    }
+
+    SECTION("Values only") {
+        const cx_svd f(sample<float>(10, 8, 0.4), false);
+        REQUIRE(f.size() == 8);
+        REQUIRE(f.u().empty());
+        REQUIRE_THROWS_AS(f.reconstruct(), std::runtime_error);
+    }
+}
+
+TEST_CASE("Truncated SVD...", "[linalg]") {
+    SECTION("Exactly low-rank matrices are recovered") {
+        // 300 x 200 of rank 12.
+        const cxd_matrix a = matprod(sample<double>(300, 12, 0.18), sample<double>(12, 200, 0.76));
+        const cxd_svd full = svd(a);
+        // Exact as soon as rank + oversampling reaches the true rank.
+        for (size_t rank : {2, 5, 12})
+        {
+            const cxd_svd t = svd_truncated(a, rank);
+            REQUIRE(t.size() == rank);
+            for (size_t i = 0; i < rank; ++i)
+                REQUIRE(t.values()[i] == Approx(full.values()[i]).margin(1e-9));
+            require_triplets(a, t, 1e-9);
+        }
+        require_close(svd_truncated(a, 12, 0, 0).reconstruct(), a, 1e-9);
+    }
+
+    SECTION("Decaying spectrum, with power iterations and threads") {
+        // Singular values 2^-j.
+        const size_t n = 120;
+        const cxd_matrix q = qr(sample<double>(n, n, 0.47)).q(), w = qr(sample<double>(n, n, 0.91)).q();
+        cxd_matrix scaled(q);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                scaled(i, j) = q(i, j) * cxd(std::ldexp(1.0, -int(j)), 0);
+        const cxd_matrix a = matprod(scaled, adjoint(w));
+
+        set_num_threads(4);
+        enable_multithreading(true);
+        const cxd_svd t = svd_truncated(a, 8);
+        enable_multithreading(false);
+        set_num_threads(0);
+        for (size_t i = 0; i < 8; ++i)
+            REQUIRE(t.values()[i] == Approx(std::ldexp(1.0, -int(i))).margin(1e-10));
+        require_triplets(a, t, 1e-8);
+
+        const cx_matrix b = sample<float>(n, 40, 0.2);
+        const cx_svd f = svd_truncated(b, 3), full = svd(b);
+        REQUIRE(f.size() == 3);
+        REQUIRE(f.values()[0] == Approx(full.values()[0]).epsilon(1e-2));
+    }
+
+    SECTION("Invalid ranks throw") {
+        REQUIRE_THROWS_AS(svd_truncated(sample<float>(10, 6, 0.3), 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(svd_truncated(sample<double>(10, 6, 0.3), 7), std::invalid_argument);
+    }
+}
+
+namespace
+{
+    // Hermitian positive definite: B B^H / n + I / 2.
+    template <typename T>
+    basic_cx_matrix<T> positive_definite(size_t n, double seed)
+    {
+        const basic_cx_matrix<T> b = sample<T>(n, n, seed);
+        basic_cx_matrix<T> h = matprod(b, adjoint(b));
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                h(i, j) = h(i, j) * basic_cx<T>(T(1) / n, 0) + basic_cx<T>(i == j ? T(0.5) : T(0), 0);
+        return h;
+    }
+
+    // a + sign x x^H
+    cxd_matrix rank_one(const cxd_matrix& a, const cxd_vector& x, double sign)
+    {
+        cxd_matrix out(a);
+        for (size_t i = 0; i < a.rows(); ++i)
+            for (size_t j = 0; j < a.cols(); ++j)
+                out(i, j) += x[i] * x[j].conjugate() * cxd(sign, 0);
+        return out;
+    }
+}
+
+TEST_CASE("Cholesky decomposition...", "[linalg]") {
+    SECTION("A = L L^H with a real positive diagonal") {
+        for (size_t n : sizes)
+        {
+            const cxd_matrix a = positive_definite<double>(n, 0.57);
+            const cxd_cholesky f = cholesky(a);
+            REQUIRE(f.size() == n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                REQUIRE(f.lower()(i, i).real > 0);
+                REQUIRE(f.lower()(i, i).imag == 0);
+                for (size_t j = i + 1; j < n; ++j)
+                    REQUIRE(f.lower()(i, j) == cxd(0, 0));
+            }
+            require_close(matprod(f.lower(), f.upper()), a, 1e-12);
+            REQUIRE(f.det() == Approx(lu(a).det().real).epsilon(1e-8));
+        }
+
+        const cx_matrix a = positive_definite<float>(130, 0.9);
+        require_close(matprod(cholesky(a).lower(), cholesky(a).upper()), a, 1e-5);
+    }
+
+    SECTION("Only the lower triangle is read") {
+        cxd_matrix a = positive_definite<double>(70, 0.3);
+        const cxd_cholesky expected = cholesky(a);
+        for (size_t i = 0; i < 70; ++i)
+            for (size_t j = i + 1; j < 70; ++j)
+                a(i, j) = cxd(-9, 4);
+        REQUIRE(cholesky(a).lower() == expected.lower());
+        REQUIRE(cholesky(std::move(a)).lower() == expected.lower());
+    }
+
+    SECTION("Solves and inverse") {
+        const cxd_matrix a = positive_definite<double>(150, 0.44);
+        const cxd_cholesky f = cholesky(a);
+        const cxd_matrix b = sample<double>(150, 7, 0.8);
+        require_close(matprod(a, cho_solve(f, b)), b, 1e-10);
+        require_close(matprod(a, f.inverse()), cxd_matrix::get_identity(150), 1e-10);
+
+        std::vector<cxd> column(150);
+        for (size_t i = 0; i < 150; ++i)
+            column[i] = b(i, 0);
+        const cxd_vector x = cho_solve(f, cxd_vector(column));
+        const cxd_matrix xs = f.solve(b);
+        for (size_t i = 0; i < 150; ++i)
+        {
+            REQUIRE(x[i].real == Approx(xs(i, 0).real).margin(1e-10));
+            REQUIRE(x[i].imag == Approx(xs(i, 0).imag).margin(1e-10));
+        }
+    }
+
+    SECTION("Multithreaded factorization and solve") {
+        const cx_matrix a = positive_definite<float>(300, 0.21);
+        const cx_matrix b = sample<float>(300, 40, 0.6);
+        const cx_cholesky seq = cholesky(a);
+        const cx_matrix x = seq.solve(b);
+        set_num_threads(4);
+        enable_multithreading(true);
+        const cx_cholesky par = cholesky(a);
+        const cx_matrix y = par.solve(b);
+        enable_multithreading(false);
+        set_num_threads(0);
+        require_close(par.lower(), seq.lower(), 1e-5);
+        require_close(y, x, 1e-4);
+    }
+
+    SECTION("Rank-one updates and downdates") {
+        for (size_t n : {2, 17, 65, 200})
+        {
+            const cxd_matrix a = positive_definite<double>(n, 0.66);
+            std::vector<cxd> values(n);
+            for (size_t i = 0; i < n; ++i)
+                values[i] = cxd(std::sin(0.3 * i), std::cos(1.1 * i)) * cxd(0.5, 0);
+            const cxd_vector x(values);
+
+            cxd_cholesky f = cholesky(a);
+            f.update(x);
+            require_close(f.lower(), cholesky(rank_one(a, x, 1)).lower(), 1e-10);
+            f.downdate(x);
+            require_close(f.lower(), cholesky(a).lower(), 1e-10);
+
+            // The downdated matrix stays positive definite only while x is small enough.
+            const cxd_vector small = x * cxd(0.1, 0);
+            f.downdate(small);
+            require_close(f.lower(), cholesky(rank_one(a, small, -1)).lower(), 1e-10);
+            const cxd_matrix before = f.lower();
+            const cxd_vector large = x * cxd(10, 0);
+            REQUIRE_THROWS_AS(f.downdate(large), std::runtime_error);
+            REQUIRE(f.lower() == before);
+        }
+    }
+
+    SECTION("Tracking a covariance matrix sample by sample") {
+        const size_t n = 40;
+        const cx_matrix samples = sample<float>(300, n, 0.15);
+        cx_matrix r = cx_matrix::get_identity(n);
+        cx_cholesky f = cholesky(r);
+        for (size_t s = 0; s < samples.rows(); ++s)
+        {
+            std::vector<cx> row(n);
+            for (size_t i = 0; i < n; ++i)
+                row[i] = samples(s, i);
+            f.update(cx_vector(row));
+        }
+        for (size_t s = 0; s < samples.rows(); ++s)
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < n; ++j)
+                    r(i, j) += samples(s, i) * samples(s, j).conjugate();
+        require_close(matprod(f.lower(), f.upper()), r, 1e-3);
+    }
+
+    SECTION("Invalid matrices and dimensions throw") {
+        REQUIRE_THROWS_AS(cholesky(cx_matrix(3, 4, cx(1, 0))), std::invalid_argument);
+        REQUIRE_THROWS_AS(cholesky(sample<double>(5, 5, 0.2)), std::runtime_error);
+        cxd_matrix indefinite = cxd_matrix::get_identity(100);
+        indefinite(99, 99) = cxd(-1, 0);
+        REQUIRE_THROWS_AS(cholesky(indefinite), std::runtime_error);
+
+        cx_cholesky f = cholesky(positive_definite<float>(4, 0.5));
+        REQUIRE_THROWS_AS(f.solve(cx_vector(3, cx(1, 0))), std::invalid_argument);
+        REQUIRE_THROWS_AS(cho_solve(f, cx_matrix(5, 2, cx(1, 0))), std::invalid_argument);
+        REQUIRE_THROWS_AS(f.update(cx_vector(5, cx(1, 0))), std::invalid_argument);
+        REQUIRE_THROWS_AS(f.downdate(cx_vector(3, cx(1, 0))), std::invalid_argument);
+    }
+}
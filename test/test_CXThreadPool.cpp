@@ -0,0 +1,132 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "CXLibrary.h"
+#include <set>
+#include <chrono>
+
+using namespace cx_lib;
+
+TEST_CASE("cx_thread_pool configuration...", "[cx_thread_pool]")
+{
+    set_num_threads(3);
+    REQUIRE(get_num_threads() == 3);
+    REQUIRE(cx_thread_pool::instance().size() == 3);
+
+    set_num_threads(0);
+    REQUIRE(get_num_threads() == std::max(1u, std::thread::hardware_concurrency()));
+
+    set_thread_affinity(true);
+    REQUIRE(cx_thread_pool::instance().affinity());
+    set_thread_affinity(false);
+    REQUIRE_FALSE(cx_thread_pool::instance().affinity());
+    REQUIRE_FALSE(cx_thread_pool::in_worker());
+}
+
+TEST_CASE("parallel_for...", "[cx_thread_pool]")
+{
+    enable_multithreading(true);
+    set_num_threads(4);
+
+    SECTION("Every index is visited exactly once")
+    {
+        std::vector<std::atomic<int>> hits(10007);
+        parallel_for(0, hits.size(), 16, [&](size_t start, size_t end) {
+            for (size_t i = start; i < end; i++)
+                hits[i]++;
+        });
+        for (auto& h : hits)
+            REQUIRE(h == 1);
+    }
+
+    SECTION("Workers are reused across calls")
+    {
+        std::mutex m;
+        std::set<std::thread::id> ids;
+        for (int call = 0; call < 20; call++)
+            parallel_for(0, 64, 1, [&](size_t, size_t) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                std::lock_guard<std::mutex> lock(m);
+                ids.insert(std::this_thread::get_id());
+            });
+        REQUIRE(ids.size() <= 4);
+    }
+
+    SECTION("Nested loops run inline")
+    {
+        // Also on the submitting thread, which holds the pool while it runs tasks.
+        std::atomic<size_t> total(0), elsewhere(0), outside(0);
+        parallel_for(0, 8, 1, [&](size_t start, size_t end) {
+            if (!cx_thread_pool::in_parallel_region())
+                outside++;
+            const std::thread::id outer = std::this_thread::get_id();
+            for (size_t i = start; i < end; i++)
+            {
+                parallel_for(0, 100, 1, [&](size_t s, size_t e) {
+                    total += e - s;
+                    if (std::this_thread::get_id() != outer)
+                        elsewhere++;
+                });
+                cx_thread_pool::instance().run(3, [&](size_t) { total++; });
+            }
+        });
+        REQUIRE(total == 824);
+        REQUIRE(elsewhere == 0);
+        REQUIRE(outside == 0);
+        REQUIRE_FALSE(cx_thread_pool::in_parallel_region());
+    }
+
+    SECTION("Exceptions reach the caller")
+    {
+        REQUIRE_THROWS_AS(parallel_for(0, 100, 1, [](size_t start, size_t) {
+            if (start == 0)
+                throw std::runtime_error("boom");
+        }), std::runtime_error);
+
+        size_t count = 0;
+        parallel_for(0, 1, 1, [&](size_t start, size_t end) { count += end - start; });
+        REQUIRE(count == 1);
+    }
+
+    SECTION("Pool restarts after shutdown")
+    {
+        shutdown_thread_pool();
+        std::atomic<size_t> total(0);
+        parallel_for(0, 1000, 10, [&](size_t start, size_t end) { total += end - start; });
+        REQUIRE(total == 1000);
+    }
+
+    SECTION("Resizing and restarting between jobs")
+    {
+        // Respawned workers must not rejoin the jobs that ran before them.
+        for (size_t round = 0; round < 30; round++)
+        {
+            if (round % 3 == 0)
+                set_num_threads(2 + round % 4);
+            else if (round % 3 == 1)
+                set_thread_affinity(false);
+            else
+                shutdown_thread_pool();
+
+            for (int call = 0; call < 10; call++)
+            {
+                std::vector<size_t> hits(500, 0);
+                parallel_for(0, hits.size(), 1, [&](size_t start, size_t end) {
+                    for (size_t i = start; i < end; i++)
+                        hits[i]++;
+                });
+                REQUIRE(std::count(hits.begin(), hits.end(), size_t(1)) == 500);
+            }
+        }
+    }
+
+    SECTION("Small ranges run on the calling thread")
+    {
+        std::thread::id caller = std::this_thread::get_id();
+        bool inline_ = false;
+        parallel_for(0, 10, 100, [&](size_t, size_t) { inline_ = (std::this_thread::get_id() == caller); });
+        REQUIRE(inline_);
+    }
+
+    set_num_threads(0);
+    enable_multithreading(false);
+}
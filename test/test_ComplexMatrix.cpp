@@ -114,6 +114,38 @@ TEST_CASE("cx_matrix Accessors...", "[cx_matrix]")
         REQUIRE(dims.second == 2);
     }
 
+    SECTION("operator[] returns a non-owning view")
+    {
+        auto row1 = m[1];
+        REQUIRE(row1.dim() == 2);
+        REQUIRE(row1.data() == &m(1, 0));
+        row1[0] = cx(9, 9);
+        REQUIRE(m(1, 0) == cx(9, 9));
+        REQUIRE_THROWS(row1.at(2));
+
+        const cx_matrix& cm = m;
+        cx_const_row_view crow = cm[1];
+        REQUIRE(crow[1] == cx(4, 4));
+    }
+
+    SECTION("contiguous row-major storage")
+    {
+        REQUIRE(m.row_stride() == 2);
+        REQUIRE(m.col_stride() == 1);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(m.data()) % __cx_buffer_alignment__ == 0);
+        REQUIRE(m.data()[3] == m(1, 1));
+    }
+
+    SECTION("col_view()")
+    {
+        auto col1 = m.col_view(1);
+        REQUIRE(col1.dim() == 2);
+        REQUIRE(col1.stride() == m.row_stride());
+        REQUIRE(col1[0] == cx(2, 2));
+        REQUIRE(col1[1] == cx(4, 4));
+        REQUIRE_THROWS(m.col_view(2));
+    }
+
     SECTION("get_col()")
     {
         cx_vector col0 = m.get_col(0);
@@ -195,3 +227,49 @@ TEST_CASE("cx_matrix Utility Methods...", "[cx_matrix]")
         REQUIRE(matData[0][0] == cx(3, -2));
     }
 }
+
+TEST_CASE("cx_matrix In-place and move operations...", "[cx_matrix]")
+{
+    cx_matrix A(std::vector<std::vector<cx>>{{cx(1, 0), cx(2, 0)}, {cx(3, 0), cx(4, 0)}});
+    cx_matrix B(2, 2, cx(0, 1));
+
+    SECTION("Compound operators keep the buffer")
+    {
+        const cx* buf = A.data();
+        A += B;
+        REQUIRE(A(1, 0) == cx(3, 1));
+        A -= B;
+        A *= cx(0, 1);
+        REQUIRE(A(0, 1) == cx(0, 2));
+        A *= 2.0f;
+        REQUIRE(A(1, 1) == cx(0, 8));
+        REQUIRE(A.data() == buf);
+
+        cx_matrix C(3, 2, cx(0, 0));
+        REQUIRE_THROWS_AS(A += C, std::invalid_argument);
+    }
+
+    SECTION("axpy and axpby")
+    {
+        A.axpy(cx(2, 0), B);
+        REQUIRE(A(0, 0) == cx(1, 2));
+        A.axpby(cx(1, 0), B, cx(0, 0));
+        REQUIRE(A == B);
+    }
+
+    SECTION("Moves steal the buffer")
+    {
+        const cx* buf = A.data();
+        cx_matrix M(std::move(A));
+        REQUIRE(M.data() == buf);
+        REQUIRE(A.rows() == 0);
+
+        cx_matrix N = std::move(M) + B;
+        REQUIRE(N.data() == buf);
+        REQUIRE(N(0, 0) == cx(1, 1));
+
+        M = std::move(N);
+        REQUIRE(M.data() == buf);
+        REQUIRE(N.cols() == 0);
+    }
+}
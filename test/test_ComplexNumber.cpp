@@ -89,6 +89,19 @@ TEST_CASE("ComplexNumber operators...", "[cx]")
     {
         cx zero(0.0f, 0.0f);
         REQUIRE_THROWS_AS(a / zero, std::runtime_error);
+        REQUIRE_THROWS_AS(a /= zero, std::runtime_error);
+    }
+
+    SECTION("Unchecked division")
+    {
+        cx c = a.div(b);
+        cx d = a / b;
+        REQUIRE(c.real == Approx(d.real));
+        REQUIRE(c.imag == Approx(d.imag));
+
+        cx inf = a.div(cx(0.0f, 0.0f));
+        REQUIRE(!std::isfinite(inf.real));
+        REQUIRE(!std::isfinite(inf.imag));
     }
 
     SECTION("Unary minus operator")
@@ -99,6 +112,31 @@ TEST_CASE("ComplexNumber operators...", "[cx]")
     }
 }
 
+TEST_CASE("ComplexNumber compile-time arithmetic...", "[cx]")
+{
+    constexpr cx a(3.0f, 4.0f);
+    constexpr cx b(1.0f, -2.0f);
+
+    static_assert(std::is_trivially_copyable<cx>::value, "cx must stay trivially copyable");
+    static_assert(a + b == cx(4.0f, 2.0f), "");
+    static_assert(a - b == cx(2.0f, 6.0f), "");
+    static_assert(a * b == cx(11.0f, -2.0f), "");
+    static_assert((a * b).div(b) == a, "");
+    static_assert(a.mod2() == 25.0f, "");
+    static_assert(a.conjugate() == cx(3.0f, -4.0f), "");
+    static_assert(-a != a, "");
+
+    constexpr cx c = [] {
+        cx x(1.0f, 1.0f);
+        x += cx(1.0f, 0.0f);
+        x *= cx(0.0f, 1.0f);
+        x -= cx(1.0f, 1.0f);
+        return x;
+    }();
+    REQUIRE(c == cx(-2.0f, 1.0f));
+    REQUIRE(a.mod() == 5.0f);
+}
+
 TEST_CASE("ComplexNumber mathematical functions...", "[cx]")
 {
     cx a(3.0f, 4.0f);
@@ -1,6 +1,8 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include "CXLibrary.h"
+#include <type_traits>
+#include <utility>
 
 using namespace cx_lib;
 
@@ -84,4 +86,589 @@ TEST_CASE("cx_tensor transpose", "[cx_tensor]")
     REQUIRE(transposed[3].real == t[4].real);
     REQUIRE(transposed[4].real == t[2].real);
     REQUIRE(transposed[5].real == t[5].real);
-}
\ No newline at end of file
+}
+TEST_CASE("cx_tensor multithreaded element-wise ops", "[cx_tensor]")
+{
+    cx_tensor t1({50, 100}, cx(0, 0));
+    cx_tensor t2({50, 100}, cx(0, 0));
+    for (size_t i = 0; i < t1.size(); ++i)
+    {
+        t1[i] = cx(static_cast<float>(i), 1);
+        t2[i] = cx(1, static_cast<float>(i % 7));
+    }
+
+    enable_multithreading(true);
+    set_num_threads(4);
+    auto t_add = t1 + t2;
+    auto t_sub = t1 - t2;
+    auto t_mul = hadamard_prod(t1, t2);
+    set_num_threads(0);
+    enable_multithreading(false);
+
+    for (size_t i = 0; i < t1.size(); ++i)
+    {
+        REQUIRE(t_add[i] == t1[i] + t2[i]);
+        REQUIRE(t_sub[i] == t1[i] - t2[i]);
+        REQUIRE(t_mul[i] == t1[i] * t2[i]);
+    }
+}
+
+TEST_CASE("cx_tensor broadcast_add aligns trailing dimensions", "[cx_tensor]")
+{
+    cx_tensor m({2, 3}, cx(0, 0));
+    for (size_t i = 0; i < m.size(); ++i)
+        m[i] = cx(static_cast<float>(i), 0);
+
+    SECTION("Row vector is added to every row")
+    {
+        cx_tensor row({3}, std::vector<cx>{cx(10, 0), cx(20, 0), cx(30, 1)});
+        auto r = m.broadcast_add(row);
+        REQUIRE(r.shape() == std::vector<size_t>{2, 3});
+        REQUIRE(r.at({0, 0}) == cx(10, 0));
+        REQUIRE(r.at({0, 2}) == cx(32, 1));
+        REQUIRE(r.at({1, 0}) == cx(13, 0));
+        REQUIRE(r.at({1, 2}) == cx(35, 1));
+    }
+
+    SECTION("Column vector is added to every column")
+    {
+        cx_tensor col({2, 1}, std::vector<cx>{cx(100, 0), cx(200, 0)});
+        auto r = m.broadcast_add(col);
+        REQUIRE(r.shape() == std::vector<size_t>{2, 3});
+        REQUIRE(r.at({0, 1}) == cx(101, 0));
+        REQUIRE(r.at({1, 1}) == cx(204, 0));
+    }
+
+    SECTION("Both operands are expanded")
+    {
+        cx_tensor a({2, 1}, std::vector<cx>{cx(1, 0), cx(2, 0)});
+        cx_tensor b({1, 3}, std::vector<cx>{cx(0, 1), cx(0, 2), cx(0, 3)});
+        auto r = a.broadcast_add(b);
+        REQUIRE(r.shape() == std::vector<size_t>{2, 3});
+        REQUIRE(r.at({1, 2}) == cx(2, 3));
+        auto r2 = b.broadcast_add(a);
+        for (size_t i = 0; i < r.size(); ++i)
+            REQUIRE(r2[i] == r[i]);
+    }
+
+    SECTION("Incompatible shapes throw")
+    {
+        cx_tensor bad({2}, cx(1, 0));
+        REQUIRE_THROWS(m.broadcast_add(bad));
+    }
+
+    SECTION("Multithreaded result matches")
+    {
+        cx_tensor big({64, 40, 3}, cx(1, 1));
+        cx_tensor bias({40, 1}, cx(0, 0));
+        for (size_t i = 0; i < bias.size(); ++i)
+            bias[i] = cx(static_cast<float>(i), 0);
+        enable_multithreading(true);
+        set_num_threads(4);
+        auto r = big.broadcast_add(bias);
+        set_num_threads(0);
+        enable_multithreading(false);
+        for (size_t i = 0; i < 64; ++i)
+            for (size_t j = 0; j < 40; ++j)
+                for (size_t k = 0; k < 3; ++k)
+                    REQUIRE(r.at({i, j, k}) == cx(1 + static_cast<float>(j), 1));
+    }
+}
+
+TEST_CASE("cx_tensor element-wise engine", "[cx_tensor]")
+{
+    cx_tensor a({2, 3, 4}, cx(0, 0));
+    for (size_t i = 0; i < a.size(); ++i)
+        a[i] = cx(static_cast<float>(i) + 1, static_cast<float>(i % 3));
+    cx_tensor b({3, 1}, std::vector<cx>{cx(2, 0), cx(0, 1), cx(1, -1)});
+
+    SECTION("broadcast_sub / broadcast_mul / broadcast_div")
+    {
+        auto s = a.broadcast_sub(b);
+        auto m = a.broadcast_mul(b);
+        auto d = a.broadcast_div(b);
+        REQUIRE(s.shape() == a.shape());
+        for (size_t i = 0; i < 2; ++i)
+            for (size_t j = 0; j < 3; ++j)
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    cx x = a.at({i, j, k});
+                    cx y = b.at({j, 0});
+                    REQUIRE(s.at({i, j, k}) == x - y);
+                    REQUIRE(m.at({i, j, k}) == x * y);
+                    REQUIRE((d.at({i, j, k}) - x / y).mod() < 1e-5f);
+                }
+
+        cx_tensor zero({1}, cx(0, 0));
+        REQUIRE_THROWS(a.broadcast_div(zero));
+    }
+
+    SECTION("operator + / - and hadamard_prod broadcast")
+    {
+        cx_tensor scalar({1}, cx(1, 1));
+        auto p = a + scalar;
+        auto q = scalar - a;
+        auto h = hadamard_prod(a, b);
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            REQUIRE(p[i] == a[i] + cx(1, 1));
+            REQUIRE(q[i] == cx(1, 1) - a[i]);
+        }
+        REQUIRE(h.at({1, 2, 3}) == a.at({1, 2, 3}) * b.at({2, 0}));
+        REQUIRE_THROWS(a + cx_tensor({3}, cx(0, 0)));
+    }
+
+    SECTION("User-supplied functors")
+    {
+        auto conj = a.apply([](const cx& x) { return x.conjugate(); });
+        REQUIRE(conj.shape() == a.shape());
+        for (size_t i = 0; i < a.size(); ++i)
+            REQUIRE(conj[i] == a[i].conjugate());
+
+        auto fma = a.apply(b, [](const cx& x, const cx& y) { return x * y + x; });
+        REQUIRE(fma.at({0, 1, 2}) == a.at({0, 1, 2}) * b.at({1, 0}) + a.at({0, 1, 2}));
+    }
+
+    SECTION("Multithreaded high-rank broadcast")
+    {
+        cx_tensor big({3, 5, 7, 11, 13}, cx(1, 0));
+        for (size_t i = 0; i < big.size(); ++i)
+            big[i] = cx(static_cast<float>(i % 101), 0);
+        cx_tensor bias({7, 1, 13}, cx(0, 0));
+        for (size_t i = 0; i < bias.size(); ++i)
+            bias[i] = cx(0, static_cast<float>(i));
+
+        enable_multithreading(true);
+        set_num_threads(4);
+        auto r = big + bias;
+        set_num_threads(0);
+        enable_multithreading(false);
+
+        for (size_t i = 0; i < big.size(); ++i)
+        {
+            auto idx = big.unravel_index(i);
+            REQUIRE(r[i] == big[i] + bias.at({idx[2], 0, idx[4]}));
+        }
+    }
+}
+
+TEST_CASE("cx_tensor_view strided views", "[cx_tensor]")
+{
+    cx_tensor t({3, 4, 5}, cx(0, 0));
+    for (size_t i = 0; i < t.size(); ++i)
+        t[i] = cx(static_cast<float>(i), -static_cast<float>(i));
+
+    SECTION("Slices share storage with the tensor")
+    {
+        cx_tensor_view s = t.slice({1, 1, 2}, {3, 3, 5});
+        REQUIRE(s.shape() == std::vector<size_t>{2, 2, 3});
+        REQUIRE_FALSE(s.is_contiguous());
+        for (size_t i = 0; i < s.size(); ++i)
+        {
+            auto idx = s.unravel_index(i);
+            REQUIRE(s[i] == t.at({idx[0] + 1, idx[1] + 1, idx[2] + 2}));
+        }
+
+        s.at({0, 0, 0}) = cx(100, 100);
+        REQUIRE(t.at({1, 1, 2}) == cx(100, 100));
+    }
+
+    SECTION("Transpose permutes strides")
+    {
+        cx_tensor_view tr = t.transpose({2, 0, 1});
+        REQUIRE(tr.shape() == std::vector<size_t>{5, 3, 4});
+        REQUIRE(tr.strides() == std::vector<ptrdiff_t>{1, 20, 5});
+        REQUIRE(tr.at({4, 2, 3}) == t.at({2, 3, 4}));
+        REQUIRE_THROWS(t.transpose({0, 0, 1}));
+        REQUIRE_THROWS(t.transpose({0, 1}));
+    }
+
+    SECTION("Reshape and flatten avoid copies when possible")
+    {
+        cx_tensor_view r = t.view().reshape({12, 5});
+        REQUIRE(r.data() == t.view().data());
+        REQUIRE(r.at({7, 3}) == t[7 * 5 + 3]);
+
+        cx_tensor_view rows = t.slice({1, 0, 0}, {3, 4, 5}).flatten();
+        REQUIRE(rows.offset() == 20);
+        REQUIRE(rows.is_contiguous());
+
+        cx_tensor_view tr = t.transpose({1, 0, 2});
+        cx_tensor_view split = tr.reshape({2, 2, 3, 5});
+        REQUIRE(split.data() == t.view().data());
+
+        cx_tensor_view flat = tr.flatten();
+        REQUIRE(flat.data() != t.view().data());
+        REQUIRE(flat.shape() == std::vector<size_t>{60});
+        for (size_t i = 0; i < flat.size(); ++i)
+            REQUIRE(flat[i] == tr[i]);
+    }
+
+    SECTION("contiguous() copies the elements")
+    {
+        cx_tensor_view tr = t.transpose({2, 1, 0});
+        cx_tensor dense = tr.contiguous();
+        REQUIRE(dense.shape() == tr.shape());
+        for (size_t i = 0; i < dense.size(); ++i)
+            REQUIRE(dense[i] == tr[i]);
+
+        dense[0] = cx(-1, -1);
+        REQUIRE(t[0] == cx(0, 0));
+    }
+
+    SECTION("Element-wise operations accept views")
+    {
+        cx_tensor_view a = t.slice({0, 0, 0}, {3, 4, 1});
+        cx_tensor_view b = t.transpose({0, 2, 1}).slice({0, 4, 0}, {3, 5, 1});
+        cx_tensor r = a + b;
+        REQUIRE(r.shape() == std::vector<size_t>{3, 4, 1});
+        for (size_t i = 0; i < r.size(); ++i)
+        {
+            auto idx = r.unravel_index(i);
+            REQUIRE(r[i] == t.at({idx[0], idx[1], 0}) + t.at({idx[0], 0, 4}));
+        }
+
+        cx_tensor h = hadamard_prod(t.transpose({2, 1, 0}), t.transpose({2, 1, 0}));
+        REQUIRE(h.at({3, 2, 1}) == t.at({1, 2, 3}) * t.at({1, 2, 3}));
+    }
+
+    SECTION("Views keep the storage alive")
+    {
+        cx_tensor_view v = cx_tensor({2, 2}, cx(7, 7)).transpose({1, 0});
+        REQUIRE(v.at({1, 0}) == cx(7, 7));
+    }
+
+    SECTION("Views of const tensors are read-only")
+    {
+        const cx_tensor& c = t;
+        static_assert(std::is_same<decltype(c.view()), cx_tensor_const_view>::value, "const view type");
+        static_assert(std::is_same<decltype(c.slice({0, 0, 0}, {1, 1, 1})), cx_tensor_const_view>::value, "const slice type");
+        static_assert(std::is_same<decltype(c.transpose({2, 1, 0})), cx_tensor_const_view>::value, "const transpose type");
+        static_assert(std::is_same<decltype(c.diagonal(0, 1)), cx_tensor_const_view>::value, "const diagonal type");
+        static_assert(!std::is_constructible<cx_tensor_view, const cx_tensor&>::value, "no mutable view of a const tensor");
+
+        static_assert(!std::is_assignable<decltype(std::declval<cx_tensor_const_view&>()[0]), cx>::value, "operator[]");
+        static_assert(!std::is_assignable<decltype(std::declval<cx_tensor_const_view&>().at({0})), cx>::value, "at");
+        static_assert(!std::is_assignable<decltype(*std::declval<cx_tensor_const_view&>().data()), cx>::value, "data");
+        static_assert(!std::is_assignable<decltype(std::declval<const cx_tensor_view&>()[0]), cx>::value, "const cx_tensor_view");
+        static_assert(std::is_assignable<decltype(std::declval<cx_tensor_view&>()[0]), cx>::value, "mutable view");
+
+        cx_tensor_const_view v = c.transpose({2, 1, 0});
+        REQUIRE(v.at({4, 3, 2}) == t.at({2, 3, 4}));
+        REQUIRE(v.slice({0, 0, 0}, {1, 1, 1}).flatten()[0] == t[0]);
+        REQUIRE(c.view().data() == t.view().data());
+
+        t.view()[0] = cx(42, 42);
+        REQUIRE(v[0] == cx(42, 42));
+    }
+
+    SECTION("Copying a tensor copies its elements")
+    {
+        cx_tensor copy_ = t;
+        copy_[0] = cx(5, 5);
+        REQUIRE(t[0] == cx(0, 0));
+    }
+}
+
+TEST_CASE("cx_tensor_view contiguous() permutes in tiles", "[cx_tensor]")
+{
+    cx_tensor t({5, 37, 3, 70}, cx(0, 0));
+    for (size_t i = 0; i < t.size(); ++i)
+        t[i] = cx(static_cast<float>(i), static_cast<float>(i % 7));
+
+    std::vector<std::vector<size_t>> perms = {
+        {0, 1, 3, 2}, {0, 2, 1, 3}, {3, 2, 1, 0}, {1, 0, 3, 2}, {2, 3, 0, 1}, {0, 1, 2, 3}
+    };
+
+    auto check = [&](const std::vector<size_t>& axes) {
+        cx_tensor_view v = t.transpose(axes);
+        cx_tensor dense = v.contiguous();
+        REQUIRE(dense.shape() == v.shape());
+        for (size_t i = 0; i < dense.size(); ++i)
+        {
+            auto idx = dense.unravel_index(i);
+            std::vector<size_t> src(4);
+            for (size_t d = 0; d < 4; ++d)
+                src[axes[d]] = idx[d];
+            REQUIRE(dense[i] == t.at(src));
+        }
+    };
+
+    SECTION("Single thread")
+    {
+        for (const auto& axes : perms)
+            check(axes);
+    }
+
+    SECTION("Multithreaded")
+    {
+        enable_multithreading(true);
+        set_num_threads(4);
+        for (const auto& axes : perms)
+            check(axes);
+        set_num_threads(0);
+        enable_multithreading(false);
+    }
+
+    SECTION("Sliced and transposed")
+    {
+        cx_tensor_view v = t.slice({1, 2, 0, 3}, {4, 35, 2, 69}).transpose({3, 1, 0, 2});
+        cx_tensor dense(v);
+        for (size_t i = 0; i < dense.size(); ++i)
+            REQUIRE(dense[i] == v[i]);
+    }
+}
+
+TEST_CASE("cx_tensor reductions", "[cx_tensor]")
+{
+    cx_tensor t({2, 3, 4}, cx(0, 0));
+    for (size_t i = 0; i < t.size(); ++i)
+        t[i] = cx(static_cast<float>(i), static_cast<float>(i % 3));
+
+    SECTION("Sum over one axis")
+    {
+        cx_tensor s = t.sum({1});
+        REQUIRE(s.shape() == std::vector<size_t>{2, 4});
+        for (size_t i = 0; i < 2; ++i)
+            for (size_t k = 0; k < 4; ++k)
+            {
+                cx expected(0, 0);
+                for (size_t j = 0; j < 3; ++j)
+                    expected += t.at({i, j, k});
+                REQUIRE(s.at({i, k}) == expected);
+            }
+        REQUIRE(t.reduce_sum(1).shape() == s.shape());
+    }
+
+    SECTION("Sum over several axes and keepdims")
+    {
+        cx_tensor s = t.sum({0, 2}, true);
+        REQUIRE(s.shape() == std::vector<size_t>{1, 3, 1});
+        for (size_t j = 0; j < 3; ++j)
+        {
+            cx expected(0, 0);
+            for (size_t i = 0; i < 2; ++i)
+                for (size_t k = 0; k < 4; ++k)
+                    expected += t.at({i, j, k});
+            REQUIRE(s.at({0, j, 0}) == expected);
+        }
+
+        cx_tensor all = t.sum();
+        REQUIRE(all.shape() == std::vector<size_t>{1});
+        REQUIRE(all[0] == cx(276, 24));
+    }
+
+    SECTION("Mean, prod and norm")
+    {
+        cx_tensor m = t.mean({2});
+        REQUIRE(m.at({0, 0}).real == Approx(1.5f));
+        REQUIRE(m.at({1, 2}).real == Approx(21.5f));
+
+        cx_tensor p = cx_tensor({2, 2}, {cx(1, 1), cx(2, 0), cx(0, 1), cx(3, 0)}).prod({0});
+        REQUIRE(p[0] == cx(-1, 1));
+        REQUIRE(p[1] == cx(6, 0));
+
+        cx_tensor n = cx_tensor({2}, {cx(3, 0), cx(0, 4)}).norm();
+        REQUIRE(n[0].real == Approx(5.0f));
+        REQUIRE(n[0].imag == 0);
+    }
+
+    SECTION("Max, min, argmax and argmin")
+    {
+        cx_tensor mx = t.max(BY_REAL, {0, 1});
+        REQUIRE(mx.shape() == std::vector<size_t>{4});
+        for (size_t k = 0; k < 4; ++k)
+            REQUIRE(mx[k] == t.at({1, 2, k}));
+
+        REQUIRE(t.min(BY_IMAG)[0].imag == 0);
+        REQUIRE(t.argmin(BY_IMAG) == std::vector<size_t>{0});
+        REQUIRE(t.argmax(BY_IMAG) == std::vector<size_t>{2});
+        REQUIRE(t.argmax(BY_MOD, {2}) == std::vector<size_t>(6, 3));
+        REQUIRE(t.argmin(BY_REAL, {1}) == std::vector<size_t>(8, 0));
+    }
+
+    SECTION("Strided views")
+    {
+        cx_tensor_view v = t.transpose({2, 0, 1}).slice({1, 0, 0}, {4, 2, 3});
+        cx_tensor dense = v.contiguous();
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            cx_tensor a = v.sum({axis}, true);
+            cx_tensor b = dense.sum({axis}, true);
+            REQUIRE(a.shape() == b.shape());
+            for (size_t i = 0; i < a.size(); ++i)
+                REQUIRE(a[i] == b[i]);
+            REQUIRE(v.argmax(BY_REAL, {axis}) == dense.argmax(BY_REAL, {axis}));
+        }
+    }
+
+    SECTION("Invalid axes")
+    {
+        REQUIRE_THROWS_AS(t.sum({3}), std::invalid_argument);
+        REQUIRE_THROWS_AS(t.sum({1, 1}), std::invalid_argument);
+        REQUIRE_THROWS_AS(cx_tensor().sum(), std::invalid_argument);
+    }
+}
+
+TEST_CASE("cx_tensor reductions are pairwise and parallel", "[cx_tensor]")
+{
+    const size_t n = size_t(1) << 20;
+    cx_tensor t({n}, cx(0.1f, -0.1f));
+
+    auto check = [&]() {
+        cx_tensor s = t.sum();
+        REQUIRE(s[0].real == Approx(0.1 * n).epsilon(1e-5));
+        REQUIRE(s[0].imag == Approx(-0.1 * n).epsilon(1e-5));
+
+        cx_tensor rows = t.reshape({1024, 1024}).sum({0});
+        cx_tensor cols = t.sum({1});
+        t.reshape({n});
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            REQUIRE(rows[i].real == Approx(102.4).epsilon(1e-5));
+            REQUIRE(cols[i].real == Approx(102.4).epsilon(1e-5));
+        }
+
+        t[n - 7] = cx(5, 0);
+        t[n - 3] = cx(5, 0);
+        REQUIRE(t.argmax(BY_REAL) == std::vector<size_t>{n - 7});
+        t[n - 7] = cx(0.1f, -0.1f);
+        t[n - 3] = cx(0.1f, -0.1f);
+    };
+
+    SECTION("Single thread")
+    {
+        check();
+    }
+
+    SECTION("Multithreaded")
+    {
+        enable_multithreading(true);
+        set_num_threads(4);
+        check();
+        set_num_threads(0);
+        enable_multithreading(false);
+    }
+}
+
+TEST_CASE("cxd_tensor double precision", "[cx_tensor]")
+{
+    const double eps = 1e-12;
+    cxd_tensor a({2, 2}, {cxd(1, eps), cxd(2, 0), cxd(3, 0), cxd(4, -eps)});
+    cxd_tensor b({2}, {cxd(eps, 0), cxd(0, 0)});
+
+    cxd_tensor c = a.broadcast_add(b);
+    REQUIRE(c[0] == cxd(1 + eps, eps));
+    REQUIRE(c[3] == cxd(4, -eps));
+
+    cxd_tensor s = a.sum({0});
+    REQUIRE(s[0] == cxd(4, eps));
+    REQUIRE(a.transpose({1, 0}).contiguous()[1] == cxd(3, 0));
+    REQUIRE(a.argmax(BY_IMAG) == std::vector<size_t>{0});
+}
+
+TEST_CASE("cx_tensor double accumulation", "[cx_tensor]")
+{
+    const size_t n = size_t(1) << 22;
+    cx_tensor t({n}, cx(0.1f, -0.2f));
+    const double exact_re = static_cast<double>(n) * static_cast<double>(0.1f);
+    const double exact_im = static_cast<double>(n) * static_cast<double>(-0.2f);
+
+    enable_double_accumulation(true);
+    cx_tensor sum = t.sum();
+    cx_tensor mean = t.mean();
+    cx_tensor norm = t.norm();
+    enable_double_accumulation(false);
+
+    REQUIRE(sum[0].real == Approx(exact_re).epsilon(1e-7));
+    REQUIRE(sum[0].imag == Approx(exact_im).epsilon(1e-7));
+    REQUIRE(mean[0] == cx(0.1f, -0.2f));
+    REQUIRE(norm[0].real == Approx(std::sqrt(n * (0.01 + 0.04))).epsilon(1e-6));
+}
+
+TEST_CASE("cx_tensor in-place and move operations", "[cx_tensor]")
+{
+    cx_tensor t({2, 3}, {cx(0, 0), cx(1, 0), cx(2, 0), cx(3, 0), cx(4, 0), cx(5, 0)});
+    cx_tensor row({3}, {cx(0, 1), cx(0, 2), cx(0, 3)});
+
+    SECTION("Compound operators broadcast into the tensor")
+    {
+        const cx* buf = t.view().data();
+        cx_tensor_view v = t.slice({1, 0}, {2, 3});
+        t += row;
+        REQUIRE(t[4] == cx(4, 2));
+        REQUIRE(v[1] == cx(4, 2));
+        t -= row;
+        t *= cx(2, 0);
+        REQUIRE(t[5] == cx(10, 0));
+        t *= row;
+        REQUIRE(t[5] == cx(0, 30));
+        REQUIRE(t.view().data() == buf);
+
+        REQUIRE_THROWS_AS(row += t, std::invalid_argument);
+    }
+
+    SECTION("Operands overlapping the buffer")
+    {
+        cx_tensor sq({2, 2}, {cx(1, 0), cx(2, 0), cx(3, 0), cx(4, 0)});
+        sq += sq.transpose({1, 0});
+        REQUIRE(sq[1] == cx(5, 0));
+        REQUIRE(sq[2] == cx(5, 0));
+
+        sq -= sq;
+        REQUIRE(sq[3] == cx(0, 0));
+    }
+
+    SECTION("axpy and axpby")
+    {
+        t.axpy(cx(2, 0), row);
+        REQUIRE(t[2] == cx(2, 6));
+        t.axpby(cx(1, 0), row, cx(0, 0));
+        REQUIRE(t[3] == cx(0, 1));
+    }
+
+    SECTION("Moves and expiring operands reuse the buffer")
+    {
+        const cx* buf = t.view().data();
+        cx_tensor m(std::move(t));
+        REQUIRE(m.view().data() == buf);
+        REQUIRE(t.size() == 0);
+
+        // Moved-from tensors are empty and still usable.
+        t *= cx(2, 0);
+        t += t.view();
+        REQUIRE_THROWS_AS(t.sum(), std::invalid_argument);
+        REQUIRE(t.shape().empty());
+        REQUIRE(t.view().size() == 0);
+        cx_tensor other({2, 2}, cx(1, 0));
+        cx_tensor target(std::move(other));
+        other = std::move(target);
+        REQUIRE(target.size() == 0);
+        target *= cx(3, 0);
+        target = other;
+        REQUIRE(target[3] == cx(1, 0));
+        // Empty tensors share one buffer, which assignments never write into.
+        cx_tensor fresh;
+        REQUIRE(t.size() == 0);
+        REQUIRE(fresh.size() == 0);
+        fresh = cx_tensor({3}, cx(4, 0));
+        REQUIRE(fresh[2] == cx(4, 0));
+        REQUIRE(cx_tensor().view().size() == 0);
+
+        cx_tensor s = std::move(m) + row;
+        REQUIRE(s.view().data() == buf);
+        REQUIRE(s[5] == cx(5, 3));
+
+        cx_tensor copy({2, 3}, cx(0, 0));
+        const cx* copy_buf = copy.view().data();
+        copy = s;
+        REQUIRE(copy.view().data() == copy_buf);
+        REQUIRE(copy[5] == cx(5, 3));
+
+        // A view keeps the buffer shared, so the result is a new tensor.
+        cx_tensor_view keep = s.view();
+        cx_tensor r = std::move(s) - row;
+        REQUIRE(r.view().data() != buf);
+        REQUIRE(keep[5] == cx(5, 3));
+    }
+}
@@ -1,6 +1,7 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include "CXLibrary.h"
+#include <sstream>
 
 using namespace cx_lib;
 
@@ -65,6 +66,62 @@ TEST_CASE("ComplexVector operators...", "[cx_vector]") {
         REQUIRE(v1 == v3);
         REQUIRE(v1 != v2);
     }
+
+    SECTION("Fused expressions") {
+        cx_vector v3(std::vector<cx>{cx(0, 1), cx(1, 0), cx(2, 2)});
+        cx_vector result = v1 + v2 * cx(0, 1) - v3 * 2.0f;
+        for (size_t i = 0; i < 3; i++)
+            REQUIRE(result[i] == v1[i] + v2[i] * cx(0, 1) - v3[i] * cx(2, 0));
+
+        REQUIRE((v1 - v2)[1] == cx(-1, 2));
+        REQUIRE(result.sum() == result[0] + result[1] + result[2]);
+
+        std::ostringstream lazy, dense;
+        lazy << v1 + v2 * cx(0, 1) - v3 * 2.0f;
+        dense << result;
+        REQUIRE(lazy.str() == dense.str());
+    }
+
+    SECTION("Assignment may alias the operands") {
+        cx_vector acc(3, cx(0, 0));
+        for (int k = 0; k < 4; k++)
+            acc = acc + v1 * 0.5f;
+        REQUIRE(acc[0] == cx(2, 2));
+        REQUIRE(acc.sum() == cx(6, 6));
+
+        acc = acc - acc;
+        REQUIRE(acc == cx_vector::null_vector(3));
+    }
+
+    SECTION("In-place and move operations") {
+        cx_vector acc(3, cx(1, 0));
+        const cx* buf = &acc[0];
+        acc += v1 * 2.0f - v2;
+        REQUIRE(acc[0] == cx(1, 3));
+        acc -= v1;
+        acc *= cx(0, 1);
+        REQUIRE(acc[2] == cx(-2, 0));
+        acc.axpy(cx(2, 0), v1);
+        REQUIRE(acc[1] == cx(0, 2));
+        acc.axpby(cx(1, 0), v2, cx(0, 0));
+        REQUIRE(acc == v2);
+        REQUIRE(&acc[0] == buf);
+
+        cx_vector moved = std::move(acc) + v1;
+        REQUIRE(&moved[0] == buf);
+        REQUIRE(moved[0] == cx(3, 0));
+        REQUIRE(moved.sum() == cx(9, 0));
+
+        moved = std::move(moved) * 2.0f - v1;
+        REQUIRE(&moved[0] == buf);
+        REQUIRE(moved[2] == cx(5, -1));
+    }
+
+    SECTION("Mismatched dimensions throw") {
+        cx_vector v4(4, cx(1, 1));
+        REQUIRE_THROWS_AS(v1 + v4, std::runtime_error);
+        REQUIRE_THROWS_AS(v1 * 2.0f - v4, std::runtime_error);
+    }
 }
 
 TEST_CASE("ComplexVector methods...", "[cx_vector]") {
@@ -128,3 +185,108 @@ TEST_CASE("ComplexVector methods...", "[cx_vector]") {
         REQUIRE(null_vec[0] == cx(0, 0));
     }
 }
+
+TEST_CASE("ComplexVector double precision...", "[cx_vector]") {
+    SECTION("cxd_vector") {
+        const double eps = 1e-12;
+        cxd_vector a(std::vector<cxd>{cxd(1, eps), cxd(0, 1)});
+        cxd_vector b(std::vector<cxd>{cxd(eps, 0), cxd(0, 0)});
+
+        REQUIRE((a + b)[0] == cxd(1 + eps, eps));
+        REQUIRE(a.sum() == cxd(1, 1 + eps));
+        REQUIRE(a.dot(b) == cxd(eps, eps * eps));
+        REQUIRE(a.mod() == Approx(std::sqrt(2.0)));
+    }
+
+    SECTION("Double accumulation of single precision data") {
+        const size_t n = 10000000;
+        const double exact = static_cast<double>(n) * static_cast<double>(0.1f);
+
+        enable_double_accumulation(true);
+        cx_vector v(n, cx(0.1f, 0));
+        cx sum = v.sum();
+        float mod = v.mod();
+        cx dot = v.dot(cx_vector(n, cx(1, 0)));
+        enable_double_accumulation(false);
+
+        REQUIRE(sum.real == Approx(exact).epsilon(1e-7));
+        REQUIRE(v.mean() == cx(0.1f, 0));
+        REQUIRE(mod == Approx(std::sqrt(n * 0.01)).epsilon(1e-6));
+        REQUIRE(dot.real == Approx(exact).epsilon(1e-7));
+    }
+}
+
+TEST_CASE("ComplexVector incremental statistics...", "[cx_vector]") {
+    const size_t n = 37;
+    cx_vector window(n, cx(0, 0)), reference(n, cx(0, 0));
+    for (size_t i = 0; i < n; i++)
+        window[i] = reference[i] = cx(static_cast<float>(i % 7), static_cast<float>(i % 3));
+    window.set_stats_mode(STATS_INCREMENTAL);
+
+    SECTION("Matches a full recomputation after every write") {
+        REQUIRE(window.get_stats_mode() == STATS_INCREMENTAL);
+        REQUIRE(window.max() == reference.max());
+        for (size_t tick = 0; tick < 200; tick++)
+        {
+            const size_t i = (tick * 11) % n;
+            const cx sample(static_cast<float>((tick * 5) % 13) - 6, static_cast<float>(tick % 4));
+            window.set(i, sample);
+            reference[i] = sample;
+
+            REQUIRE(window.sum().real == Approx(reference.sum().real));
+            REQUIRE(window.sum().imag == Approx(reference.sum().imag));
+            REQUIRE(window.mean().real == Approx(reference.mean().real));
+            REQUIRE(window.max().mod() == reference.max().mod());
+            REQUIRE(window.min().mod() == reference.min().mod());
+        }
+    }
+
+    SECTION("Ties resolve to the first element like the full scan") {
+        cx_vector v(4, cx(1, 0));
+        v.set_stats_mode(STATS_INCREMENTAL);
+        v.set(2, cx(0, 3));
+        v.set(3, cx(-3, 0));
+        v.set(0, cx(0, -1));
+        REQUIRE(v.max() == cx(0, 3));
+        REQUIRE(v.min() == cx(0, -1));
+    }
+
+    SECTION("Untracked writes, copies and the lazy mode") {
+        window[0] = cx(100, 0);
+        reference[0] = cx(100, 0);
+        REQUIRE(window.max() == cx(100, 0));
+        window.set(1, cx(0, 0));
+        reference[1] = cx(0, 0);
+        REQUIRE(window.min() == cx(0, 0));
+
+        cx_vector copy(window);
+        copy.set(0, cx(1, 1));
+        REQUIRE(copy.max() != cx(100, 0));
+        REQUIRE(window.max() == cx(100, 0));
+
+        window.set_stats_mode(STATS_LAZY);
+        window.set(0, cx(1, 1));
+        reference[0] = cx(1, 1);
+        REQUIRE(window.max() == reference.max());
+        REQUIRE(window.sum() == reference.sum());
+    }
+
+    SECTION("Moves carry the statistics and leave the source empty") {
+        REQUIRE(window.sum() == reference.sum());
+        cx_vector moved(std::move(window));
+        REQUIRE(window.dim() == 0);
+        REQUIRE(window.sum() == cx(0, 0));
+        REQUIRE(window.max() == cx(0, 0));
+        moved.set(0, cx(50, 0));
+        reference[0] = cx(50, 0);
+        REQUIRE(moved.max() == cx(50, 0));
+
+        cx_vector target(3, cx(1, 0));
+        REQUIRE(target.sum() == cx(3, 0));
+        target = std::move(moved);
+        REQUIRE(moved.dim() == 0);
+        REQUIRE(moved.sum() == cx(0, 0));
+        REQUIRE(target.sum().real == Approx(reference.sum().real));
+        REQUIRE(target.get_stats_mode() == STATS_INCREMENTAL);
+    }
+}
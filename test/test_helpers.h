@@ -0,0 +1,48 @@
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include <cmath>
+#include <vector>
+#include "catch.hpp"
+#include "CXLibrary.h"
+
+// Helpers shared by the test programs.
+namespace cx_test
+{
+    // Deterministic samples with no short period, in the element type C.
+    template <typename C = cx_lib::cx>
+    inline std::vector<C> sample(size_t n, double seed)
+    {
+        std::vector<C> v;
+        for (size_t i = 0; i < n; ++i)
+            v.push_back(C(cx_lib::cxd(std::sin(seed * (i + 1)) * 3.0, std::cos(seed + 0.7 * i) * 2.0)));
+        return v;
+    }
+
+    // Every SIMD level the CPU supports, the scalar one included.
+    inline std::vector<cx_lib::__cx_simd_level__> simd_levels()
+    {
+        std::vector<cx_lib::__cx_simd_level__> out;
+        for (int l = cx_lib::SIMD_SCALAR; l <= cx_lib::simd_detect(); ++l)
+            out.push_back(static_cast<cx_lib::__cx_simd_level__>(l));
+        return out;
+    }
+
+    inline void require_close(const cx_lib::cx& a, const cx_lib::cx& b, double margin = 1e-4)
+    {
+        REQUIRE(a.real == Approx(b.real).margin(margin));
+        REQUIRE(a.imag == Approx(b.imag).margin(margin));
+    }
+
+    inline void require_close(const cx_lib::cx_tensor& a, const cx_lib::cx_tensor& b, double margin = 1e-3)
+    {
+        REQUIRE(a.shape() == b.shape());
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            REQUIRE(a[i].real == Approx(b[i].real).margin(margin));
+            REQUIRE(a[i].imag == Approx(b[i].imag).margin(margin));
+        }
+    }
+}
+
+#endif